@@ -35,7 +35,7 @@
 // Constructor
 Minkowski::Minkowski(std::shared_ptr <Domain> dm):
 	kstart(0), kfinish(0), isovalue(0), Volume(0),
-    LOGFILE(NULL), Dm(dm), Vi(0), Vi_global(0)
+    LOGFILE(NULL), request(MPI_REQUEST_NULL), Dm(dm), Vi(0), Vi_global(0), NonBlocking(false)
 {
 	Nx=dm->Nx; Ny=dm->Ny; Nz=dm->Nz;
 	Volume=double((Nx-2)*(Ny-2)*(Nz-2))*double(Dm->nprocx()*Dm->nprocy()*Dm->nprocz());
@@ -59,6 +59,7 @@ Minkowski::Minkowski(std::shared_ptr <Domain> dm):
 // Destructor
 Minkowski::~Minkowski()
 {
+    WaitGlobal();
     if ( LOGFILE!=NULL ) { fclose(LOGFILE); }
 }
 
@@ -139,17 +140,37 @@ void Minkowski::ComputeScalar(const DoubleArray& Field, const double isovalue)
 	// convert X for 2D manifold to 3D object
 	Xi *= 0.5;
 	
-	MPI_Barrier(Dm->Comm);
-	// Phase averages
-	MPI_Allreduce(&Vi,&Vi_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&Xi,&Xi_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&Ai,&Ai_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&Ji,&Ji_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Barrier(Dm->Comm);
+	// Phase averages (one reduction for all four measures)
+	WaitGlobal();
+	local_values[0] = Vi;
+	local_values[1] = Xi;
+	local_values[2] = Ai;
+	local_values[3] = Ji;
+	if (NonBlocking){
+		MPI_Iallreduce(local_values,global_values,4,MPI_DOUBLE,MPI_SUM,Dm->Comm,&request);
+	}
+	else {
+		MPI_Allreduce(local_values,global_values,4,MPI_DOUBLE,MPI_SUM,Dm->Comm);
+		Vi_global = global_values[0];
+		Xi_global = global_values[1];
+		Ai_global = global_values[2];
+		Ji_global = global_values[3];
+	}
     PROFILE_STOP("ComputeScalar");
 }
 
 
+void Minkowski::WaitGlobal(){
+	if (request == MPI_REQUEST_NULL)
+		return;
+	MPI_Wait(&request,MPI_STATUS_IGNORE);
+	Vi_global = global_values[0];
+	Xi_global = global_values[1];
+	Ai_global = global_values[2];
+	Ji_global = global_values[3];
+}
+
+
 void Minkowski::MeasureObject(){
 	/*
 	 *  compute the distance to an object 
@@ -236,7 +257,6 @@ int Minkowski::MeasureConnectedPathway(){
 	double vF=0.0; 
 	n_connected_components = ComputeGlobalBlobIDs(Nx-2,Ny-2,Nz-2,Dm->rank_info,distance,distance,vF,vF,label,Dm->Comm);
 //	int n_connected_components = ComputeGlobalPhaseComponent(Nx-2,Ny-2,Nz-2,Dm->rank_info,const IntArray &PhaseID, int &VALUE, BlobIDArray &GlobalBlobID, Dm->Comm )
-	MPI_Barrier(Dm->Comm);
 	
 	for (int k=0; k<Nz; k++){
 		for (int j=0; j<Ny; j++){
@@ -280,7 +300,6 @@ int Minkowski::MeasureConnectedPathway(double factor, const DoubleArray &Phi){
 	double vF=0.0; 
 	n_connected_components = ComputeGlobalBlobIDs(Nx-2,Ny-2,Nz-2,Dm->rank_info,distance,distance,vF,vF,label,Dm->Comm);
 //	int n_connected_components = ComputeGlobalPhaseComponent(Nx-2,Ny-2,Nz-2,Dm->rank_info,const IntArray &PhaseID, int &VALUE, BlobIDArray &GlobalBlobID, Dm->Comm )
-	MPI_Barrier(Dm->Comm);
 	
 	for (int k=0; k<Nz; k++){
 		for (int j=0; j<Ny; j++){
@@ -301,6 +320,7 @@ int Minkowski::MeasureConnectedPathway(double factor, const DoubleArray &Phi){
 
 void Minkowski::PrintAll()
 {
+	WaitGlobal();
 	if (Dm->rank()==0){
 		fprintf(LOGFILE,"%.5g %.5g %.5g %.5g\n",Vi_global, Ai_global, Ji_global, Xi_global);			// minkowski measures
 		fflush(LOGFILE);
@@ -45,6 +45,10 @@ class Minkowski{
 	// CSV / text file where time history of averages is saved
 	FILE *LOGFILE;
 
+	// Pending reduction of the global averages
+	MPI_Request request;
+	double local_values[4], global_values[4];
+
 public:
 	//...........................................................................
 	std::shared_ptr <Domain> Dm;
@@ -59,6 +63,9 @@ public:
 	// Global averages (all processes)
 	double Ai_global,Ji_global,Xi_global,Vi_global;
 	int n_connected_components;
+	// Reduce the global averages with a non-blocking collective that is completed
+	// by the next call to ComputeScalar (or WaitGlobal)
+	bool NonBlocking;
 	//...........................................................................
 	int Nx,Ny,Nz;
 	double V(){
@@ -75,7 +82,7 @@ public:
 	}
 		
 	//..........................................................................
-	Minkowski(){};//NULL CONSTRUCTOR
+	Minkowski(): LOGFILE(NULL), request(MPI_REQUEST_NULL), NonBlocking(false) {};//NULL CONSTRUCTOR
 	Minkowski(std::shared_ptr <Domain> Dm);
 	~Minkowski();
 	void MeasureObject();
@@ -83,6 +90,7 @@ public:
 	int MeasureConnectedPathway();
 	int MeasureConnectedPathway(double factor, const DoubleArray &Phi);
 	void ComputeScalar(const DoubleArray& Field, const double isovalue);
+	void WaitGlobal();
 
 	void PrintAll();
 
@@ -10,6 +10,10 @@ SubPhase::SubPhase(std::shared_ptr <Domain> dm):
 	morph_w = std::shared_ptr<Minkowski>(new Minkowski(Dm));
 	morph_n = std::shared_ptr<Minkowski>(new Minkowski(Dm));
 	morph_i = std::shared_ptr<Minkowski>(new Minkowski(Dm));
+	// the global Minkowski measures are not used here, so do not wait for them
+	morph_w->NonBlocking = true;
+	morph_n->NonBlocking = true;
+	morph_i->NonBlocking = true;
 
 	// Global arrays
 	PhaseID.resize(Nx,Ny,Nz);       PhaseID.fill(0);
@@ -229,25 +233,29 @@ void SubPhase::Basic(){
 			}
 		}
 	}
-	gwb.V=sumReduce( Dm->Comm, wb.V);
-	gnb.V=sumReduce( Dm->Comm, nb.V);
-	gwb.M=sumReduce( Dm->Comm, wb.M);
-	gnb.M=sumReduce( Dm->Comm, nb.M);
-	gwb.Px=sumReduce( Dm->Comm, wb.Px);
-	gwb.Py=sumReduce( Dm->Comm, wb.Py);
-	gwb.Pz=sumReduce( Dm->Comm, wb.Pz);
-	gnb.Px=sumReduce( Dm->Comm, nb.Px);
-	gnb.Py=sumReduce( Dm->Comm, nb.Py);
-	gnb.Pz=sumReduce( Dm->Comm, nb.Pz);
+	// compute global entities with a single reduction
+	std::vector<double> local = { wb.V, nb.V, wb.M, nb.M, wb.Px, wb.Py, wb.Pz, nb.Px, nb.Py, nb.Pz,
+		count_w, count_n, wb.p, nb.p };
+	auto global = sumReduce( Dm->Comm, local );
+	gwb.V=global[0];
+	gnb.V=global[1];
+	gwb.M=global[2];
+	gnb.M=global[3];
+	gwb.Px=global[4];
+	gwb.Py=global[5];
+	gwb.Pz=global[6];
+	gnb.Px=global[7];
+	gnb.Py=global[8];
+	gnb.Pz=global[9];
 	
-	count_w=sumReduce( Dm->Comm, count_w);
-	count_n=sumReduce( Dm->Comm, count_n);
+	count_w=global[10];
+	count_n=global[11];
 	if (count_w > 0.0)
-		gwb.p=sumReduce( Dm->Comm, wb.p) / count_w;
+		gwb.p=global[12] / count_w;
 	else 
 		gwb.p = 0.0;
 	if (count_n > 0.0)
-		gnb.p=sumReduce( Dm->Comm, nb.p) / count_n;
+		gnb.p=global[13] / count_n;
 	else 
 		gnb.p = 0.0;
 
@@ -444,15 +452,6 @@ void SubPhase::Full(){
 	nd.H -= nc.H;
 	nd.X -= nc.X;
 
-	// compute global entities
-	gnc.V=sumReduce( Dm->Comm, nc.V);
-	gnc.A=sumReduce( Dm->Comm, nc.A);
-	gnc.H=sumReduce( Dm->Comm, nc.H);
-	gnc.X=sumReduce( Dm->Comm, nc.X);
-	gnd.V=sumReduce( Dm->Comm, nd.V);
-	gnd.A=sumReduce( Dm->Comm, nd.A);
-	gnd.H=sumReduce( Dm->Comm, nd.H);
-	gnd.X=sumReduce( Dm->Comm, nd.X);
 	gnd.Nc = nd.Nc;
  	// wetting
 	for (k=0; k<Nz; k++){
@@ -491,15 +490,6 @@ void SubPhase::Full(){
 	wd.A -= wc.A;
 	wd.H -= wc.H;
 	wd.X -= wc.X;
-	// compute global entities
-	gwc.V=sumReduce( Dm->Comm, wc.V);
-	gwc.A=sumReduce( Dm->Comm, wc.A);
-	gwc.H=sumReduce( Dm->Comm, wc.H);
-	gwc.X=sumReduce( Dm->Comm, wc.X);
-	gwd.V=sumReduce( Dm->Comm, wd.V);
-	gwd.A=sumReduce( Dm->Comm, wd.A);
-	gwd.H=sumReduce( Dm->Comm, wd.H);
-	gwd.X=sumReduce( Dm->Comm, wd.X);
 	gwd.Nc = wd.Nc;
 	
  	/*  Set up geometric analysis of interface region */
@@ -527,20 +517,12 @@ void SubPhase::Full(){
 	iwn.A = morph_i->A(); 
 	iwn.H = morph_i->H(); 
 	iwn.X = morph_i->X(); 
-	giwn.V=sumReduce( Dm->Comm, iwn.V);
-	giwn.A=sumReduce( Dm->Comm, iwn.A);
-	giwn.H=sumReduce( Dm->Comm, iwn.H);
-	giwn.X=sumReduce( Dm->Comm, iwn.X);
 	// measure only the connected part
 	iwnc.Nc = morph_i->MeasureConnectedPathway();
 	iwnc.V = morph_i->V(); 
 	iwnc.A = morph_i->A(); 
 	iwnc.H = morph_i->H(); 
 	iwnc.X = morph_i->X(); 
-	giwnc.V=sumReduce( Dm->Comm, iwnc.V);
-	giwnc.A=sumReduce( Dm->Comm, iwnc.A);
-	giwnc.H=sumReduce( Dm->Comm, iwnc.H);
-	giwnc.X=sumReduce( Dm->Comm, iwnc.X);
 	giwnc.Nc = iwnc.Nc;
 
 	double vol_nc_bulk = 0.0;
@@ -631,46 +613,56 @@ void SubPhase::Full(){
 		}
 	}
 
-	gnd.M=sumReduce( Dm->Comm, nd.M);
-	gnd.Px=sumReduce( Dm->Comm, nd.Px);
-	gnd.Py=sumReduce( Dm->Comm, nd.Py);
-	gnd.Pz=sumReduce( Dm->Comm, nd.Pz);
-	gnd.K=sumReduce( Dm->Comm, nd.K);
-
-	gwd.M=sumReduce( Dm->Comm, wd.M);
-	gwd.Px=sumReduce( Dm->Comm, wd.Px);
-	gwd.Py=sumReduce( Dm->Comm, wd.Py);
-	gwd.Pz=sumReduce( Dm->Comm, wd.Pz);
-	gwd.K=sumReduce( Dm->Comm, wd.K);
-	
-	gnc.M=sumReduce( Dm->Comm, nc.M);
-	gnc.Px=sumReduce( Dm->Comm, nc.Px);
-	gnc.Py=sumReduce( Dm->Comm, nc.Py);
-	gnc.Pz=sumReduce( Dm->Comm, nc.Pz);
-	gnc.K=sumReduce( Dm->Comm, nc.K);
-
-	gwc.M=sumReduce( Dm->Comm, wc.M);
-	gwc.Px=sumReduce( Dm->Comm, wc.Px);
-	gwc.Py=sumReduce( Dm->Comm, wc.Py);
-	gwc.Pz=sumReduce( Dm->Comm, wc.Pz);
-	gwc.K=sumReduce( Dm->Comm, wc.K);
-	
-	giwn.Mn=sumReduce( Dm->Comm, iwn.Mn);
-	giwn.Pnx=sumReduce( Dm->Comm, iwn.Pnx);
-	giwn.Pny=sumReduce( Dm->Comm, iwn.Pny);
-	giwn.Pnz=sumReduce( Dm->Comm, iwn.Pnz);
-	giwn.Kn=sumReduce( Dm->Comm, iwn.Kn);
-	giwn.Mw=sumReduce( Dm->Comm, iwn.Mw);
-	giwn.Pwx=sumReduce( Dm->Comm, iwn.Pwx);
-	giwn.Pwy=sumReduce( Dm->Comm, iwn.Pwy);
-	giwn.Pwz=sumReduce( Dm->Comm, iwn.Pwz);
-	giwn.Kw=sumReduce( Dm->Comm, iwn.Kw);
+	// compute global entities with a single reduction
+	std::vector<double> local = {
+		nc.V, nc.A, nc.H, nc.X, nd.V, nd.A, nd.H, nd.X,
+		wc.V, wc.A, wc.H, wc.X, wd.V, wd.A, wd.H, wd.X,
+		iwn.V, iwn.A, iwn.H, iwn.X, iwnc.V, iwnc.A, iwnc.H, iwnc.X,
+		nd.M, nd.Px, nd.Py, nd.Pz, nd.K,
+		wd.M, wd.Px, wd.Py, wd.Pz, wd.K,
+		nc.M, nc.Px, nc.Py, nc.Pz, nc.K,
+		wc.M, wc.Px, wc.Py, wc.Pz, wc.K,
+		iwn.Mn, iwn.Pnx, iwn.Pny, iwn.Pnz, iwn.Kn,
+		iwn.Mw, iwn.Pwx, iwn.Pwy, iwn.Pwz, iwn.Kw,
+		nc.p, nd.p, wc.p, wd.p,
+		vol_wc_bulk, vol_wd_bulk, vol_nc_bulk, vol_nd_bulk };
+	auto global = sumReduce( Dm->Comm, local );
+	auto value = global.begin();
+	for ( auto g : { &gnc, &gnd, &gwc, &gwd } ) {
+		g->V = *value++;
+		g->A = *value++;
+		g->H = *value++;
+		g->X = *value++;
+	}
+	for ( auto g : { &giwn, &giwnc } ) {
+		g->V = *value++;
+		g->A = *value++;
+		g->H = *value++;
+		g->X = *value++;
+	}
+	for ( auto g : { &gnd, &gwd, &gnc, &gwc } ) {
+		g->M = *value++;
+		g->Px = *value++;
+		g->Py = *value++;
+		g->Pz = *value++;
+		g->K = *value++;
+	}
+	giwn.Mn=*value++;
+	giwn.Pnx=*value++;
+	giwn.Pny=*value++;
+	giwn.Pnz=*value++;
+	giwn.Kn=*value++;
+	giwn.Mw=*value++;
+	giwn.Pwx=*value++;
+	giwn.Pwy=*value++;
+	giwn.Pwz=*value++;
+	giwn.Kw=*value++;
 	
 	// pressure averaging
-	gnc.p=sumReduce( Dm->Comm, nc.p);
-	gnd.p=sumReduce( Dm->Comm, nd.p);
-	gwc.p=sumReduce( Dm->Comm, wc.p);
-	gwd.p=sumReduce( Dm->Comm, wd.p);
+	gnc.p=*value++;
+	gnd.p=*value++;
+	gwc.p=*value++;
+	gwd.p=*value++;
 
 	if (vol_wc_bulk > 0.0)
 		wc.p = wc.p /vol_wc_bulk;
@@ -681,10 +673,10 @@ void SubPhase::Full(){
 	if (vol_nd_bulk > 0.0)
 		nd.p = nd.p /vol_nd_bulk;
 
-	vol_wc_bulk=sumReduce( Dm->Comm, vol_wc_bulk);
-	vol_wd_bulk=sumReduce( Dm->Comm, vol_wd_bulk);
-	vol_nc_bulk=sumReduce( Dm->Comm, vol_nc_bulk);
-	vol_nd_bulk=sumReduce( Dm->Comm, vol_nd_bulk);
+	vol_wc_bulk=*value++;
+	vol_wd_bulk=*value++;
+	vol_nc_bulk=*value++;
+	vol_nd_bulk=*value++;
 	
 	if (vol_wc_bulk > 0.0)
 		gwc.p = gwc.p /vol_wc_bulk;
@@ -697,7 +689,7 @@ void SubPhase::Full(){
 }
 
 
-void SubPhase::AggregateLabels( const std::string& filename )
+void SubPhase::AggregateLabels( const std::string& filename, bool compress )
 {
 	
 	int nx = Dm->Nx;
@@ -722,7 +714,7 @@ void SubPhase::AggregateLabels( const std::string& filename )
 	}
 	MPI_Barrier(Dm->Comm);
 
-	Dm->AggregateLabels( filename );
+	Dm->AggregateLabels( filename, compress );
 
 }
 
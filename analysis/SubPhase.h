@@ -101,7 +101,7 @@ public:
 	void Basic();
 	void Full();
 	void Write(int time);
-    void AggregateLabels( const std::string& filename );
+    void AggregateLabels( const std::string& filename, bool compress = false );
 
 private:
 	FILE *TIMELOG;
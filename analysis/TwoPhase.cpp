@@ -399,49 +399,34 @@ void TwoPhase::UpdateSolid()
 void TwoPhase::UpdateMeshValues()
 {
 	int i,j,k,n;
+	// Gradients of the signed distance fields and curvature of SDn over a box of cells
+	auto ComputeMeshBox = [&]( int imin, int imax, int jmin, int jmax, int kmin, int kmax ) {
+		pmmc_MeshGradient(SDn,SDn_x,SDn_y,SDn_z,imin,imax,jmin,jmax,kmin,kmax);
+		pmmc_MeshGradient(SDs,SDs_x,SDs_y,SDs_z,imin,imax,jmin,jmax,kmin,kmax);
+		pmmc_MeshCurvature(SDn,MeanCurvature,GaussCurvature,imin,imax,jmin,jmax,kmin,kmax);
+	};
 	//...........................................................................
-	Dm->CommunicateMeshHalo(SDn);
-	//...........................................................................
+	// Communicate the halos of all of the input fields at once
+	Dm->StartMeshHalo({&SDn,&SDs,&Press,&Vel_x,&Vel_y,&Vel_z,&DelPhi});
 	// Compute the gradients of the phase indicator and signed distance fields
-	pmmc_MeshGradient(SDn,SDn_x,SDn_y,SDn_z,Nx,Ny,Nz);
-	//...........................................................................
-	// Gradient of the phase indicator field
-	//...........................................................................
-	Dm->CommunicateMeshHalo(SDn_x);
-	//...........................................................................
-	Dm->CommunicateMeshHalo(SDn_y);
-	//...........................................................................
-	Dm->CommunicateMeshHalo(SDn_z);
-	//...........................................................................
-	Dm->CommunicateMeshHalo(SDs);
-	pmmc_MeshGradient(SDs,SDs_x,SDs_y,SDs_z,Nx,Ny,Nz);
-	//...........................................................................
-	Dm->CommunicateMeshHalo(SDs_x);
-	//...........................................................................
-	Dm->CommunicateMeshHalo(SDs_y);
-	//...........................................................................
-	Dm->CommunicateMeshHalo(SDs_z);
-	//...........................................................................
-	// Compute the mesh curvature of the phase indicator field
-	pmmc_MeshCurvature(SDn, MeanCurvature, GaussCurvature, Nx, Ny, Nz);
+	// and the mesh curvature on the cells that do not need the halo
+	ComputeMeshBox(2,Nx-2,2,Ny-2,2,Nz-2);
 	//...........................................................................
 	// Update the time derivative of non-dimensional density field
 	// Map Phase_tplus and Phase_tminus
 	for (int n=0; n<Nx*Ny*Nz; n++)	dPdt(n) = 0.125*(Phase_tplus(n) - Phase_tminus(n));
 	//...........................................................................
-	Dm->CommunicateMeshHalo(Press);
-	//...........................................................................
-	Dm->CommunicateMeshHalo(Vel_x);
-	//...........................................................................
-	Dm->CommunicateMeshHalo(Vel_y);
+	Dm->WaitMeshHalo();
+	// Finish the gradients and curvature on the cells next to the halo
+	ComputeMeshBox(1,Nx-1,1,Ny-1,1,2);
+	ComputeMeshBox(1,Nx-1,1,Ny-1,Nz-2,Nz-1);
+	ComputeMeshBox(1,Nx-1,1,2,2,Nz-2);
+	ComputeMeshBox(1,Nx-1,Ny-2,Ny-1,2,Nz-2);
+	ComputeMeshBox(1,2,2,Ny-2,2,Nz-2);
+	ComputeMeshBox(Nx-2,Nx-1,2,Ny-2,2,Nz-2);
 	//...........................................................................
-	Dm->CommunicateMeshHalo(Vel_z);
-	//...........................................................................
-	Dm->CommunicateMeshHalo(MeanCurvature);
-	//...........................................................................
-	Dm->CommunicateMeshHalo(GaussCurvature);
-	//...........................................................................
-	Dm->CommunicateMeshHalo(DelPhi);
+	// Communicate the halos of the derived fields while the phase ID is set
+	Dm->StartMeshHalo({&SDn_x,&SDn_y,&SDn_z,&SDs_x,&SDs_y,&SDs_z,&MeanCurvature,&GaussCurvature});
 	//...........................................................................
 	// Initializing the blob ID
 	for (k=0; k<Nz; k++){
@@ -463,6 +448,7 @@ void TwoPhase::UpdateMeshValues()
 			}
 		}
 	}
+	Dm->WaitMeshHalo();
 }
 void TwoPhase::ComputeLocal()
 {
@@ -914,7 +900,6 @@ void TwoPhase::ComponentAverages()
 		}
 	}
 
-	MPI_Barrier(Dm->Comm);
 	if (Dm->rank()==0){
 		printf("Component averages computed locally -- reducing result... \n");
 	}
@@ -927,7 +912,6 @@ void TwoPhase::ComponentAverages()
 		for (int idx=0; idx<BLOB_AVG_COUNT; idx++) ComponentAverages_NWP(idx,b)=RecvBuffer(idx);
 	}
 	*/
-	MPI_Barrier(Dm->Comm);
 	MPI_Allreduce(ComponentAverages_NWP.data(),RecvBuffer.data(),BLOB_AVG_COUNT*NumberComponents_NWP,					MPI_DOUBLE,MPI_SUM,Dm->Comm);
 	//	MPI_Reduce(ComponentAverages_NWP.data(),RecvBuffer.data(),BLOB_AVG_COUNT,MPI_DOUBLE,MPI_SUM,0,Dm->Comm);
 
@@ -1023,12 +1007,11 @@ void TwoPhase::ComponentAverages()
 		printf("reduce WP averages... \n");
 	}
 
-	// reduce the wetting phase averages
+	// reduce the wetting phase averages (all components at once)
+	RecvBuffer.resize(BLOB_AVG_COUNT,NumberComponents_WP);
+	MPI_Reduce(ComponentAverages_WP.data(),RecvBuffer.data(),BLOB_AVG_COUNT*NumberComponents_WP,MPI_DOUBLE,MPI_SUM,0,Dm->Comm);
 	for (int b=0; b<NumberComponents_WP; b++){
-		MPI_Barrier(Dm->Comm);
-//		MPI_Allreduce(&ComponentAverages_WP(0,b),RecvBuffer.data(),BLOB_AVG_COUNT,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-		MPI_Reduce(&ComponentAverages_WP(0,b),RecvBuffer.data(),BLOB_AVG_COUNT,MPI_DOUBLE,MPI_SUM,0,Dm->Comm);
-		for (int idx=0; idx<BLOB_AVG_COUNT; idx++) ComponentAverages_WP(idx,b)=RecvBuffer(idx);
+		for (int idx=0; idx<BLOB_AVG_COUNT; idx++) ComponentAverages_WP(idx,b)=RecvBuffer(idx,b);
 	}
 	
 	for (int b=0; b<NumberComponents_WP; b++){
@@ -1110,43 +1093,38 @@ void TwoPhase::Reduce()
 	int i;
 	double iVol_global=1.0/Volume;
 	//...........................................................................
-	MPI_Barrier(Dm->Comm);
-	MPI_Allreduce(&nwp_volume,&nwp_volume_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&wp_volume,&wp_volume_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&awn,&awn_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&ans,&ans_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&aws,&aws_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&lwns,&lwns_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&As,&As_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&Jwn,&Jwn_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&Kwn,&Kwn_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&KGwns,&KGwns_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&KNwns,&KNwns_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&efawns,&efawns_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&wwndnw,&wwndnw_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&wwnsdnwn,&wwnsdnwn_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&Jwnwwndnw,&Jwnwwndnw_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	// Phase averages
-	MPI_Allreduce(&vol_w,&vol_w_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&vol_n,&vol_n_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&paw,&paw_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&pan,&pan_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&vaw(0),&vaw_global(0),3,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&van(0),&van_global(0),3,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&vawn(0),&vawn_global(0),3,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&vawns(0),&vawns_global(0),3,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&Gwn(0),&Gwn_global(0),6,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&Gns(0),&Gns_global(0),6,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&Gws(0),&Gws_global(0),6,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&trawn,&trawn_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&trJwn,&trJwn_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&trRwn,&trRwn_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&euler,&euler_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&An,&An_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&Jn,&Jn_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-	MPI_Allreduce(&Kn,&Kn_global,1,MPI_DOUBLE,MPI_SUM,Dm->Comm);
-
-	MPI_Barrier(Dm->Comm);
+	// Pack the local sums and reduce them with a single collective
+	struct { double *local, *global; int N; } sums[] = {
+		{ &nwp_volume, &nwp_volume_global, 1 },		{ &wp_volume, &wp_volume_global, 1 },
+		{ &awn, &awn_global, 1 },					{ &ans, &ans_global, 1 },
+		{ &aws, &aws_global, 1 },					{ &lwns, &lwns_global, 1 },
+		{ &As, &As_global, 1 },						{ &Jwn, &Jwn_global, 1 },
+		{ &Kwn, &Kwn_global, 1 },					{ &KGwns, &KGwns_global, 1 },
+		{ &KNwns, &KNwns_global, 1 },				{ &efawns, &efawns_global, 1 },
+		{ &wwndnw, &wwndnw_global, 1 },				{ &wwnsdnwn, &wwnsdnwn_global, 1 },
+		{ &Jwnwwndnw, &Jwnwwndnw_global, 1 },
+		// Phase averages
+		{ &vol_w, &vol_w_global, 1 },				{ &vol_n, &vol_n_global, 1 },
+		{ &paw, &paw_global, 1 },					{ &pan, &pan_global, 1 },
+		{ &vaw(0), &vaw_global(0), 3 },				{ &van(0), &van_global(0), 3 },
+		{ &vawn(0), &vawn_global(0), 3 },			{ &vawns(0), &vawns_global(0), 3 },
+		{ &Gwn(0), &Gwn_global(0), 6 },				{ &Gns(0), &Gns_global(0), 6 },
+		{ &Gws(0), &Gws_global(0), 6 },
+		{ &trawn, &trawn_global, 1 },				{ &trJwn, &trJwn_global, 1 },
+		{ &trRwn, &trRwn_global, 1 },
+		{ &euler, &euler_global, 1 },				{ &An, &An_global, 1 },
+		{ &Jn, &Jn_global, 1 },						{ &Kn, &Kn_global, 1 }
+	};
+	std::vector<double> send, recv;
+	for (const auto& sum : sums)
+		send.insert(send.end(),sum.local,sum.local+sum.N);
+	recv.resize(send.size());
+	MPI_Allreduce(send.data(),recv.data(),send.size(),MPI_DOUBLE,MPI_SUM,Dm->Comm);
+	size_t offset=0;
+	for (const auto& sum : sums){
+		std::copy(&recv[offset],&recv[offset]+sum.N,sum.global);
+		offset += sum.N;
+	}
 
 	// Normalize the phase averages
 	// (density of both components = 1.0)
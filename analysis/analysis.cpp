@@ -18,7 +18,9 @@
 #include "ProfilerApp.h"
 
 #include <algorithm>
+#include <array>
 #include <iostream>
+#include <unordered_map>
 
 
 template<class TYPE>
@@ -113,13 +115,19 @@ int ComputeBlob( const Array<bool>& isPhase, BlobIDArray& LocalBlobID, bool peri
                     // We have one neighbor
                     LocalBlobIDPtr[index] = neighbor_ids[0];
                 } else {
-                    // We have multiple neighbors
+                    // We have multiple neighbors: merge their roots (the smallest id of each set)
+                    for (int i=0; i<N_list; i++) {
+                        int root = neighbor_ids[i];
+                        while ( map[root-start_id] != root )
+                            root = map[root-start_id];
+                        neighbor_ids[i] = root;
+                    }
                     int id = neighbor_ids[0];
                     for (int i=1; i<N_list; i++)
                         id = std::min(id,neighbor_ids[i]);
                     LocalBlobIDPtr[index] = id;
                     for (int i=0; i<N_list; i++)
-                        map[neighbor_ids[i]-start_id] = std::min(map[neighbor_ids[i]-start_id],id);
+                        map[neighbor_ids[i]-start_id] = id;
                 }
             }
         }
@@ -264,60 +272,87 @@ void ReorderBlobIDs( BlobIDArray& ID, MPI_Comm comm )
 
 /******************************************************************
 * Compute the global blob ids                                     *
+*   The local ids are offset to give temporary global ids.  Only  *
+*   the blobs that cross a subdomain boundary need to be merged,  *
+*   so the equivalences seen through the halos are merged with a  *
+*   union-find that is reduced up a binomial tree of the ranks    *
+*   (log(nprocs) messages whose size scales with the number of    *
+*   boundary crossing blobs) and the final ids and sizes are sent *
+*   back down the tree.  The blobs are then numbered by size with *
+*   a sparse prefix sum of the size histogram over the same tree. *
 ******************************************************************/
-struct global_id_info_struct {
-    int64_t new_id;
-    std::set<int64_t> remote_ids;
+// Binomial tree over the ranks: the subtree of each rank is the range [rank,end)
+struct blob_tree_struct {
+    int parent;
+    std::vector<int> children;  // children in order of increasing subtree size
+    blob_tree_struct( int rank, int nprocs ): parent(-1) {
+        for (int step=1; step<nprocs; step*=2) {
+            if ( rank & step ) {
+                parent = rank - step;
+                break;
+            }
+            if ( rank+step < nprocs )
+                children.push_back( rank+step );
+        }
+    }
 };
-// Send the local ids and their new value to all neighbors
-static void updateRemoteIds( 
-    const std::map<int64_t,global_id_info_struct>& map,
-    const std::vector<int>& neighbors,
-    int N_send, const std::vector<int>& N_recv,
-    int64_t *send_buf, std::vector<int64_t*>& recv_buf,
-    std::map<int64_t,int64_t>& remote_map,
-    MPI_Comm comm )
+static void sendIDs( const std::vector<int64_t>& data, int dest, int tag, MPI_Comm comm )
 {
-    std::vector<MPI_Request> send_req(neighbors.size());
-    std::vector<MPI_Request> recv_req(neighbors.size());
-    std::vector<MPI_Status> status(neighbors.size());
-    std::map<int64_t,global_id_info_struct>::const_iterator it = map.begin();
-    ASSERT(N_send==(int)map.size());
-    for (size_t i=0; i<map.size(); i++, ++it) {
-        send_buf[2*i+0] = it->first;
-        send_buf[2*i+1] = it->second.new_id;
-    }
-    for (size_t i=0; i<neighbors.size(); i++) {
-        MPI_Isend( send_buf,    2*N_send,    MPI_LONG_LONG, neighbors[i], 0, comm, &send_req[i] );
-        MPI_Irecv( recv_buf[i], 2*N_recv[i], MPI_LONG_LONG, neighbors[i], 0, comm, &recv_req[i] );
-    }
-    for (it=map.begin(); it!=map.end(); ++it) {
-        remote_map[it->first] = it->second.new_id;
-    }
-    for (size_t i=0; i<neighbors.size(); i++) {
-        MPI_Wait(&recv_req[i],&status[i]);
-        for (int j=0; j<N_recv[i]; j++)
-            remote_map[recv_buf[i][2*j+0]] = recv_buf[i][2*j+1];
-    }
-    MPI_Waitall(neighbors.size(),getPtr(send_req),getPtr(status));
+    MPI_Send( getPtr(data), data.size(), MPI_LONG_LONG, dest, tag, comm );
 }
-// Compute a new local id for each local id
-static bool updateLocalIds( const std::map<int64_t,int64_t>& remote_map, 
-    std::map<int64_t,global_id_info_struct>& map )
+static std::vector<int64_t> recvIDs( int source, int tag, MPI_Comm comm )
 {
-    bool changed = false;
-    std::map<int64_t,global_id_info_struct>::iterator it;
-    for (it=map.begin(); it!=map.end(); ++it) {
-        int64_t id = it->second.new_id;
-        std::set<int64_t>::const_iterator it2;
-        for (it2=it->second.remote_ids.begin(); it2!=it->second.remote_ids.end(); ++it2) {
-            int64_t id2 = remote_map.find(*it2)->second;
-            id = std::min(id,id2);
+    MPI_Status status;
+    MPI_Probe( source, tag, comm, &status );
+    int N = 0;
+    MPI_Get_count( &status, MPI_LONG_LONG, &N );
+    std::vector<int64_t> data(N);
+    MPI_Recv( getPtr(data), N, MPI_LONG_LONG, source, tag, comm, MPI_STATUS_IGNORE );
+    return data;
+}
+// Union-find over the boundary crossing ids; the root of a set is its smallest id
+struct blob_union_find {
+    std::unordered_map<int64_t,int64_t> parent;
+    std::unordered_map<int64_t,int64_t> size;   // number of cells of each id
+    int64_t find( int64_t id ) {
+        auto it = parent.find(id);
+        if ( it == parent.end() ) {
+            parent[id] = id;
+            return id;
+        }
+        while ( it->second != id ) {
+            // path halving
+            auto it2 = parent.find(it->second);
+            it->second = it2->second;
+            id = it->second;
+            it = parent.find(id);
         }
-        changed = changed || it->second.new_id!=id;
-        it->second.new_id = id;
+        return id;
+    }
+    void merge( int64_t id1, int64_t id2 ) {
+        id1 = find(id1);
+        id2 = find(id2);
+        if ( id1 < id2 )
+            parent[id2] = id1;
+        else if ( id2 < id1 )
+            parent[id1] = id2;
+    }
+};
+// Sparse histogram of the blob sizes (size, count) stored as sorted pairs in a vector
+static void addHistogram( std::map<int64_t,int64_t>& hist, const std::vector<int64_t>& data )
+{
+    for (size_t i=0; i<data.size(); i+=2)
+        hist[data[i]] += data[i+1];
+}
+static std::vector<int64_t> packHistogram( const std::map<int64_t,int64_t>& hist )
+{
+    std::vector<int64_t> data;
+    data.reserve(2*hist.size());
+    for (const auto& it : hist) {
+        data.push_back(it.first);
+        data.push_back(it.second);
     }
-    return changed;
+    return data;
 }
 static int LocalToGlobalIDs( int nx, int ny, int nz, const RankInfoStruct& rank_info, 
     int nblobs, BlobIDArray& IDs, MPI_Comm comm )
@@ -328,17 +363,12 @@ static int LocalToGlobalIDs( int nx, int ny, int nz, const RankInfoStruct& rank_
     const int ngx = (IDs.size(0)-nx)/2;
     const int ngy = (IDs.size(1)-ny)/2;
     const int ngz = (IDs.size(2)-nz)/2;
-    // Get the number of blobs for each rank
-    std::vector<int> N_blobs(nprocs,0);
-    PROFILE_START("LocalToGlobalIDs-Allgather",1);
-    MPI_Allgather(&nblobs,1,MPI_INT,getPtr(N_blobs),1,MPI_INT,comm);
-    PROFILE_STOP("LocalToGlobalIDs-Allgather",1);
-    int64_t N_blobs_tot = 0;
-    int offset = 0;
-    for (int i=0; i<rank; i++)
-        offset += N_blobs[i];
-    for (int i=0; i<nprocs; i++)
-        N_blobs_tot += N_blobs[i];
+    // Get the offset of the ids of this rank
+    int64_t N_local = nblobs, offset = 0, N_blobs_tot = 0;
+    MPI_Exscan(&N_local,&offset,1,MPI_LONG_LONG,MPI_SUM,comm);
+    MPI_Allreduce(&N_local,&N_blobs_tot,1,MPI_LONG_LONG,MPI_SUM,comm);
+    if ( rank == 0 )
+        offset = 0;
     INSIST(N_blobs_tot<0x80000000,"Maximum number of blobs exceeded");
     // Compute temporary global ids
     for (size_t i=0; i<IDs.length(); i++) {
@@ -349,89 +379,199 @@ static int LocalToGlobalIDs( int nx, int ny, int nz, const RankInfoStruct& rank_
     // Copy the ids and get the neighbors through the halos
     fillHalo<BlobIDType> fillData(comm,rank_info,{nx,ny,nz},{1,1,1},0,1,{true,true,true});
     fillData.fill(IDs);
-    // Create a list of all neighbor ranks (excluding self)
-    std::vector<int> neighbors;
-    neighbors.push_back( rank_info.rank[0][1][1] );
-    neighbors.push_back( rank_info.rank[2][1][1] );
-    neighbors.push_back( rank_info.rank[1][0][1] );
-    neighbors.push_back( rank_info.rank[1][2][1] );
-    neighbors.push_back( rank_info.rank[1][1][0] );
-    neighbors.push_back( rank_info.rank[1][1][2] );
-    std::sort( neighbors.begin(), neighbors.end() );
-    neighbors.erase( std::unique( neighbors.begin(), neighbors.end() ), neighbors.end() );
-    // Create a map of all local ids to the neighbor ids
-    std::map<int64_t,global_id_info_struct> map;
-    std::set<int64_t> local;
-    for (size_t i=0; i<LocalIDs.length(); i++) {
-        if ( LocalIDs(i)>=0 ) {
-            local.insert(LocalIDs(i));
-            if ( LocalIDs(i)!=IDs(i) && IDs(i)>=0 )
-                map[LocalIDs(i)].remote_ids.insert(IDs(i));
+    // Count the cells of each local blob
+    std::vector<int64_t> local_size(nblobs,0);
+    for (size_t k=ngz; k<IDs.size(2)-ngz; k++) {
+        for (size_t j=ngy; j<IDs.size(1)-ngy; j++) {
+            for (size_t i=ngx; i<IDs.size(0)-ngx; i++) {
+                BlobIDType id = LocalIDs(i,j,k);
+                if ( id >= 0 )
+                    local_size[id-offset]++;
+            }
+        }
+    }
+    // Merge the local ids with the neighbor ids they touch through the halos.  All local ids
+    // in the ghost cells and the first interior layer are added (the neighbor may be the only
+    // rank that sees the connection), so that each rank gets the final root of its boundary blobs
+    PROFILE_START("LocalToGlobalIDs-merge",1);
+    blob_union_find uf;
+    for (size_t k=0; k<IDs.size(2); k++) {
+        bool bz = k<=(size_t)ngz || k+ngz+1>=IDs.size(2);
+        for (size_t j=0; j<IDs.size(1); j++) {
+            bool by = j<=(size_t)ngy || j+ngy+1>=IDs.size(1);
+            for (size_t i=0; i<IDs.size(0); i++) {
+                bool bx = i<=(size_t)ngx || i+ngx+1>=IDs.size(0);
+                BlobIDType id = LocalIDs(i,j,k);
+                if ( id<0 || !(bx || by || bz) )
+                    continue;
+                uf.find(id);
+                if ( IDs(i,j,k)>=0 && IDs(i,j,k)!=id )
+                    uf.merge(id,IDs(i,j,k));
+            }
+        }
+    }
+    for (const auto& it : uf.parent) {
+        if ( it.first>=offset && it.first<offset+nblobs )
+            uf.size[it.first] = local_size[it.first-offset];
+    }
+    // Reduce the equivalences up the tree: (id, root, size of the set if id is the root)
+    blob_tree_struct tree(rank,nprocs);
+    std::vector<std::vector<int64_t>> child_keys(tree.children.size());
+    for (size_t c=0; c<tree.children.size(); c++) {
+        auto data = recvIDs( tree.children[c], 1, comm );
+        for (size_t i=0; i<data.size(); i+=3) {
+            uf.merge(data[i],data[i+1]);
+            uf.size[data[i]] += data[i+2];
+            child_keys[c].push_back(data[i]);
+        }
+    }
+    std::vector<int64_t> keys;
+    keys.reserve(uf.parent.size());
+    for (const auto& it : uf.parent)
+        keys.push_back(it.first);
+    std::unordered_map<int64_t,int64_t> set_size;
+    for (auto key : keys)
+        set_size[uf.find(key)] += uf.size[key];
+    // Final root and size of each key
+    std::unordered_map<int64_t,std::pair<int64_t,int64_t>> final_root;
+    if ( tree.parent >= 0 ) {
+        std::vector<int64_t> data(3*keys.size());
+        for (size_t i=0; i<keys.size(); i++) {
+            int64_t root = uf.find(keys[i]);
+            data[3*i+0] = keys[i];
+            data[3*i+1] = root;
+            data[3*i+2] = root==keys[i] ? set_size[root]:0;
         }
+        sendIDs( data, tree.parent, 1, comm );
+        data = recvIDs( tree.parent, 2, comm );
+        for (size_t i=0; i<keys.size(); i++)
+            final_root[keys[i]] = std::pair<int64_t,int64_t>(data[2*i],data[2*i+1]);
+    } else {
+        for (auto key : keys)
+            final_root[key] = std::pair<int64_t,int64_t>(uf.find(key),set_size[uf.find(key)]);
     }
-    std::map<int64_t,global_id_info_struct>::iterator it;
-    for (it=map.begin(); it!=map.end(); ++it) {
-        it->second.new_id = it->first;
-        local.erase(it->first);
-    }
-    // Get the number of ids we will recieve from each rank
-    int N_send = map.size();
-    std::vector<int> N_recv(neighbors.size(),0);
-    std::vector<MPI_Request> send_req(neighbors.size());
-    std::vector<MPI_Request> recv_req(neighbors.size());
-    std::vector<MPI_Status> status(neighbors.size());
-    for (size_t i=0; i<neighbors.size(); i++) {
-        MPI_Isend( &N_send,    1, MPI_INT, neighbors[i], 0, comm, &send_req[i] );
-        MPI_Irecv( &N_recv[i], 1, MPI_INT, neighbors[i], 0, comm, &recv_req[i] );
-    }
-    MPI_Waitall(neighbors.size(),getPtr(send_req),getPtr(status));
-    MPI_Waitall(neighbors.size(),getPtr(recv_req),getPtr(status));
-    // Allocate memory for communication
-    int64_t *send_buf = new int64_t[2*N_send];
-    std::vector<int64_t*> recv_buf(neighbors.size());
-    for (size_t i=0; i<neighbors.size(); i++)
-        recv_buf[i] = new int64_t[2*N_recv[i]];
-    // Compute a map for the remote ids, and new local id for each id
-    std::map<int64_t,int64_t> remote_map;
-    for (it=map.begin(); it!=map.end(); ++it) {
-        int64_t id = it->first;
-        std::set<int64_t>::const_iterator it2;
-        for (it2=it->second.remote_ids.begin(); it2!=it->second.remote_ids.end(); ++it2) {
-            int64_t id2 = *it2;
-            id = std::min(id,id2);
-            remote_map.insert(std::pair<int64_t,int64_t>(id2,id2));
+    for (size_t c=0; c<tree.children.size(); c++) {
+        std::vector<int64_t> data(2*child_keys[c].size());
+        for (size_t i=0; i<child_keys[c].size(); i++) {
+            const auto& result = final_root[child_keys[c][i]];
+            data[2*i+0] = result.first;
+            data[2*i+1] = result.second;
+        }
+        sendIDs( data, tree.children[c], 2, comm );
+    }
+    // Root and global size of each local id; a blob is owned by the rank of its root
+    std::vector<int64_t> root(nblobs), global_size(nblobs);
+    for (int i=0; i<nblobs; i++) {
+        auto it = uf.parent.find(i+offset);
+        if ( it == uf.parent.end() ) {
+            root[i] = i+offset;
+            global_size[i] = local_size[i];
+        } else {
+            const auto& result = final_root[uf.find(i+offset)];
+            root[i] = result.first;
+            global_size[i] = result.second;
         }
-        it->second.new_id = id;
-    }
-    // Iterate until we are done
-    int iteration = 1;
-    PROFILE_START("LocalToGlobalIDs-loop",1);
-    while ( 1 ) {
-        iteration++;
-        // Send the local ids and their new value to all neighbors
-        updateRemoteIds( map, neighbors, N_send, N_recv,send_buf, recv_buf, remote_map, comm );
-        // Compute a new local id for each local id
-        bool changed = updateLocalIds( remote_map, map );
-        // Check if we are finished
-        int test = changed ? 1:0;
-        int result = 0;
-        MPI_Allreduce(&test,&result,1,MPI_INT,MPI_SUM,comm);
-        if ( result==0 )
-            break;
-    }
-    PROFILE_STOP("LocalToGlobalIDs-loop",1);
+    }
+    PROFILE_STOP("LocalToGlobalIDs-merge",1);
+    // Number the blobs by decreasing size (and decreasing id for equal sizes):
+    //    the new id is the number of blobs that are larger, plus the number of blobs of
+    //    the same size on the following ranks (which have larger ids), plus the number
+    //    of local blobs of the same size with a larger id
+    PROFILE_START("LocalToGlobalIDs-reorder",1);
+    std::vector<std::pair<int64_t,int64_t>> owned;
+    std::map<int64_t,int64_t> hist;
+    for (int i=0; i<nblobs; i++) {
+        if ( root[i]==i+offset && global_size[i]>0 ) {
+            owned.push_back( std::pair<int64_t,int64_t>(global_size[i],i+offset) );
+            hist[global_size[i]]++;
+        }
+    }
+    // Up-sweep of the histograms of the subtrees
+    std::vector<std::map<int64_t,int64_t>> child_hist(tree.children.size());
+    std::map<int64_t,int64_t> subtree = hist;
+    for (size_t c=0; c<tree.children.size(); c++) {
+        addHistogram( child_hist[c], recvIDs( tree.children[c], 3, comm ) );
+        addHistogram( subtree, packHistogram( child_hist[c] ) );
+    }
+    // Down-sweep of the histogram of the ranks after each subtree and the total histogram
+    std::map<int64_t,int64_t> after, total;
+    if ( tree.parent >= 0 ) {
+        sendIDs( packHistogram(subtree), tree.parent, 3, comm );
+        addHistogram( after, recvIDs( tree.parent, 4, comm ) );
+        addHistogram( total, recvIDs( tree.parent, 5, comm ) );
+    } else {
+        total = subtree;
+    }
+    auto total_data = packHistogram( total );
+    for (int c=tree.children.size()-1; c>=0; c--) {
+        sendIDs( packHistogram(after), tree.children[c], 4, comm );
+        sendIDs( total_data, tree.children[c], 5, comm );
+        addHistogram( after, packHistogram( child_hist[c] ) );
+    }
+    int64_t N_blobs_global = 0;
+    std::map<int64_t,int64_t> larger;   // number of blobs larger than each size
+    for (auto it=total.rbegin(); it!=total.rend(); ++it) {
+        larger[it->first] = N_blobs_global;
+        N_blobs_global += it->second;
+    }
+    std::sort( owned.begin(), owned.end() );
+    std::unordered_map<int64_t,int64_t> new_id;
+    int64_t count = 0;
+    for (int i=owned.size()-1; i>=0; i--) {
+        if ( i==(int)owned.size()-1 || owned[i].first!=owned[i+1].first )
+            count = 0;
+        int64_t size = owned[i].first;
+        new_id[owned[i].second] = larger[size] + after[size] + count;
+        count++;
+    }
+    // Send the new ids of the boundary crossing blobs up the tree and back down to the keys
+    std::vector<int64_t> data;
+    for (const auto& it : new_id) {
+        if ( uf.parent.find(it.first) != uf.parent.end() ) {
+            data.push_back(it.first);
+            data.push_back(it.second);
+        }
+    }
+    std::unordered_map<int64_t,int64_t> root_id;   // new id of the boundary crossing roots
+    for (size_t i=0; i<data.size(); i+=2)
+        root_id[data[i]] = data[i+1];
+    for (size_t c=0; c<tree.children.size(); c++) {
+        auto data2 = recvIDs( tree.children[c], 6, comm );
+        for (size_t i=0; i<data2.size(); i+=2)
+            root_id[data2[i]] = data2[i+1];
+        data.insert( data.end(), data2.begin(), data2.end() );
+    }
+    std::unordered_map<int64_t,int64_t> key_id;
+    if ( tree.parent >= 0 ) {
+        sendIDs( data, tree.parent, 6, comm );
+        data = recvIDs( tree.parent, 7, comm );
+        for (size_t i=0; i<keys.size(); i++)
+            key_id[keys[i]] = data[i];
+    } else {
+        for (auto key : keys)
+            key_id[key] = root_id[final_root[key].first];
+    }
+    for (size_t c=0; c<tree.children.size(); c++) {
+        std::vector<int64_t> data2(child_keys[c].size());
+        for (size_t i=0; i<child_keys[c].size(); i++)
+            data2[i] = key_id[child_keys[c][i]];
+        sendIDs( data2, tree.children[c], 7, comm );
+    }
+    PROFILE_STOP("LocalToGlobalIDs-reorder",1);
     // Relabel the ids
-    std::vector<int> final_map(nblobs,-1);
-    for (it=map.begin(); it!=map.end(); ++it)
-        final_map[it->first-offset] = it->second.new_id;
-    for (std::set<int64_t>::const_iterator it2=local.begin(); it2!=local.end(); ++it2)
-        final_map[*it2-offset] = *it2;
-    for (size_t i=0; i<final_map.size(); i++)
-        ASSERT(final_map[i]>=0);
+    std::vector<BlobIDType> final_map(nblobs,-1);
+    for (int i=0; i<nblobs; i++) {
+        if ( global_size[i] == 0 )
+            continue;
+        if ( uf.parent.find(i+offset) == uf.parent.end() )
+            final_map[i] = new_id[i+offset];
+        else
+            final_map[i] = key_id[uf.find(i+offset)];
+    }
     for (size_t k=ngz; k<IDs.size(2)-ngz; k++) {
         for (size_t j=ngy; j<IDs.size(1)-ngy; j++) {
             for (size_t i=ngx; i<IDs.size(0)-ngx; i++) {
-                BlobIDType id = IDs(i,j,k);
+                BlobIDType id = LocalIDs(i,j,k);
                 if ( id >= 0 )
                     IDs(i,j,k) = final_map[id-offset];
             }
@@ -440,12 +580,6 @@ static int LocalToGlobalIDs( int nx, int ny, int nz, const RankInfoStruct& rank_
     // Fill the ghosts
     fillHalo<BlobIDType> fillData2(comm,rank_info,{nx,ny,nz},{1,1,1},0,1,{true,true,true});
     fillData2.fill(IDs);
-    // Reorder based on size (and compress the id space
-    int N_blobs_global = ReorderBlobIDs2(IDs,N_blobs_tot,ngx,ngy,ngz,comm);
-    // Finished
-    delete [] send_buf;
-    for (size_t i=0; i<neighbors.size(); i++)
-        delete [] recv_buf[i];
     PROFILE_STOP("LocalToGlobalIDs",1);
     return N_blobs_global;
 }
@@ -478,70 +612,61 @@ int ComputeGlobalPhaseComponent( int nx, int ny, int nz, const RankInfoStruct& r
 * Compute the mapping of blob ids between timesteps               *
 ******************************************************************/
 typedef std::map<BlobIDType,std::map<BlobIDType,int64_t> > map_type;
-template<class TYPE> inline MPI_Datatype getMPIType();
-template<> inline MPI_Datatype getMPIType<int32_t>() { return MPI_INT; }
-template<> inline MPI_Datatype getMPIType<int64_t>() { 
-    if ( sizeof(int64_t)==sizeof(long int) )
-        return MPI_LONG;
-    else if ( sizeof(int64_t)==sizeof(double) )
-        return MPI_DOUBLE;
+// Records exchanged between the ranks: (type, id1, id2, count)
+enum class IDMapRecord : int64_t { overlap_dst=0, overlap_src=1, src=2, dst=3,
+    created=4, destroyed=5, src_dst=6, single_dst=7 };
+static inline void addRecord( std::vector<int64_t>& data, IDMapRecord type, int64_t id1, int64_t id2, int64_t count )
+{
+    data.push_back(static_cast<int64_t>(type));
+    data.push_back(id1);
+    data.push_back(id2);
+    data.push_back(count);
 }
-template<class TYPE>
-void gatherSet( std::set<TYPE>& set, MPI_Comm comm )
+// Send the records to the rank given in the first index and receive the records sent to this rank
+static std::vector<int64_t> exchangeRecords( const std::vector<std::vector<int64_t>>& send, MPI_Comm comm )
 {
     int nprocs = comm_size(comm);
-    MPI_Datatype type = getMPIType<TYPE>();
-    std::vector<TYPE> send_data(set.begin(),set.end());
-    int send_count = send_data.size();
-    std::vector<int> recv_count(nprocs,0), recv_disp(nprocs,0);
-    MPI_Allgather(&send_count,1,MPI_INT,getPtr(recv_count),1,MPI_INT,comm);
-    for (int i=1; i<nprocs; i++)
-        recv_disp[i] = recv_disp[i-1] + recv_count[i-1];
-    std::vector<TYPE> recv_data(recv_disp[nprocs-1]+recv_count[nprocs-1]);
-    MPI_Allgatherv(getPtr(send_data),send_count,type,
-        getPtr(recv_data),getPtr(recv_count),getPtr(recv_disp),type,comm);
-    for (size_t i=0; i<recv_data.size(); i++)
-        set.insert(recv_data[i]);
+    std::vector<int> send_count(nprocs), send_disp(nprocs+1,0), recv_count(nprocs), recv_disp(nprocs+1,0);
+    for (int i=0; i<nprocs; i++) {
+        send_count[i] = send[i].size();
+        send_disp[i+1] = send_disp[i] + send_count[i];
+    }
+    MPI_Alltoall(getPtr(send_count),1,MPI_INT,getPtr(recv_count),1,MPI_INT,comm);
+    for (int i=0; i<nprocs; i++)
+        recv_disp[i+1] = recv_disp[i] + recv_count[i];
+    std::vector<int64_t> send_data(send_disp[nprocs]), recv_data(recv_disp[nprocs]);
+    for (int i=0; i<nprocs; i++)
+        std::copy(send[i].begin(),send[i].end(),send_data.begin()+send_disp[i]);
+    MPI_Alltoallv(getPtr(send_data),getPtr(send_count),getPtr(send_disp),MPI_LONG_LONG,
+        getPtr(recv_data),getPtr(recv_count),getPtr(recv_disp),MPI_LONG_LONG,comm);
+    return recv_data;
 }
-void gatherSrcIDMap( map_type& src_map, MPI_Comm comm )
+// Gather the records of all ranks
+static std::vector<int64_t> gatherRecords( const std::vector<int64_t>& send, MPI_Comm comm )
 {
     int nprocs = comm_size(comm);
-    MPI_Datatype type = getMPIType<int64_t>();
-    std::vector<int64_t> send_data;
-    for (map_type::const_iterator it=src_map.begin(); it!=src_map.end(); ++it) {
-        int id = it->first;
-        const std::map<BlobIDType,int64_t>& src_ids = it->second;
-        send_data.push_back(id);
-        send_data.push_back(src_ids.size());
-        std::map<BlobIDType,int64_t>::const_iterator it2;
-        for (it2=src_ids.begin(); it2!=src_ids.end(); ++it2) {
-            send_data.push_back(it2->first);
-            send_data.push_back(it2->second);
-        }
-    }
-    int send_count = send_data.size();
-    std::vector<int> recv_count(nprocs,0), recv_disp(nprocs,0);
+    int send_count = send.size();
+    std::vector<int> recv_count(nprocs,0), recv_disp(nprocs+1,0);
     MPI_Allgather(&send_count,1,MPI_INT,getPtr(recv_count),1,MPI_INT,comm);
-    for (int i=1; i<nprocs; i++)
-        recv_disp[i] = recv_disp[i-1] + recv_count[i-1];
-    std::vector<int64_t> recv_data(recv_disp[nprocs-1]+recv_count[nprocs-1]);
-    MPI_Allgatherv(getPtr(send_data),send_count,type,
-        getPtr(recv_data),getPtr(recv_count),getPtr(recv_disp),type,comm);
-    size_t i=0;
-    src_map.clear();
-    while ( i < recv_data.size() ) {
-        BlobIDType id = recv_data[i];
-        size_t count = recv_data[i+1];
-        i += 2;
-        std::map<BlobIDType,int64_t>& src_ids = src_map[id];
-        for (size_t j=0; j<count; j++,i+=2) {
-            std::map<BlobIDType,int64_t>::iterator it = src_ids.find(recv_data[i]);
-            if ( it == src_ids.end() )
-                src_ids.insert(std::pair<BlobIDType,int64_t>(recv_data[i],recv_data[i+1]));
-            else
-                it->second += recv_data[i+1];
-        }
+    for (int i=0; i<nprocs; i++)
+        recv_disp[i+1] = recv_disp[i] + recv_count[i];
+    std::vector<int64_t> recv_data(recv_disp[nprocs]);
+    MPI_Allgatherv(getPtr(send),send_count,MPI_LONG_LONG,
+        getPtr(recv_data),getPtr(recv_count),getPtr(recv_disp),MPI_LONG_LONG,comm);
+    return recv_data;
+}
+// Sort (id1,id2,count) triples and add the counts of duplicate pairs
+static void reduceOverlaps( std::vector<std::array<int64_t,3>>& overlaps )
+{
+    std::sort( overlaps.begin(), overlaps.end() );
+    size_t N = 0;
+    for (size_t i=0; i<overlaps.size(); i++) {
+        if ( N>0 && overlaps[N-1][0]==overlaps[i][0] && overlaps[N-1][1]==overlaps[i][1] )
+            overlaps[N-1][2] += overlaps[i][2];
+        else
+            overlaps[N++] = overlaps[i];
     }
+    overlaps.resize(N);
 }
 void addSrcDstIDs( BlobIDType src_id, map_type& src_map, map_type& dst_map, 
     std::set<BlobIDType>& src, std::set<BlobIDType>& dst )
@@ -558,80 +683,132 @@ ID_map_struct computeIDMap( int nx, int ny, int nz,
 {
     ASSERT(ID1.size()==ID2.size());
     PROFILE_START("computeIDMap");
+    const int nprocs = comm_size(comm);
     const int ngx = (ID1.size(0)-nx)/2;
     const int ngy = (ID1.size(1)-ny)/2;
     const int ngz = (ID1.size(2)-nz)/2;
 
-    // Get a global list of all src/dst ids and the src map for each local blob
-    std::set<BlobIDType> src_set, dst_set;
-    map_type src_map;   // Map of the src ids for each dst id
+    // Get the local src/dst ids and the overlap of each pair from sorted lists of the cells
+    std::vector<int64_t> src_cells, dst_cells, pair_cells;
     for (int k=ngz; k<ngz+nz; k++) {
         for (int j=ngy; j<ngy+ny; j++) {
             for (int i=ngx; i<ngx+nx; i++) {
-                int id1 = ID1(i,j,k);
-                int id2 = ID2(i,j,k);
+                int64_t id1 = ID1(i,j,k);
+                int64_t id2 = ID2(i,j,k);
                 if ( id1>=0 )
-                    src_set.insert(id1);
+                    src_cells.push_back(id1);
                 if ( id2>=0 )
-                    dst_set.insert(id2);
-                if ( id1>=0 && id2>=0 ) {
-                    std::map<BlobIDType,int64_t>& src_ids = src_map[id2];
-                    std::map<BlobIDType,int64_t>::iterator it = src_ids.find(id1);
-                    if ( it == src_ids.end() ) {
-                        src_ids.insert(std::pair<BlobIDType,int64_t>(id1,0));
-                        it = src_ids.find(id1);
-                    }
-                    it->second++;
-                }
+                    dst_cells.push_back(id2);
+                if ( id1>=0 && id2>=0 )
+                    pair_cells.push_back( (id1<<32) | id2 );
             }
         }
     }
-    // Communicate the src/dst ids and src id map to all processors and reduce
-    gatherSet( src_set, comm );
-    gatherSet( dst_set, comm );
-    gatherSrcIDMap( src_map, comm );
-    // Compute the dst id map
-    map_type dst_map;   // Map of the dst ids for each src id
-    for (map_type::const_iterator it=src_map.begin(); it!=src_map.end(); ++it) {
-        BlobIDType id = it->first;
-        const std::map<BlobIDType,int64_t>& src_ids = it->second;
-        for (std::map<BlobIDType,int64_t>::const_iterator it2=src_ids.begin(); it2!=src_ids.end(); ++it2) {
-            std::map<BlobIDType,int64_t>& dst_ids = dst_map[it2->first];
-            dst_ids.insert(std::pair<BlobIDType,int64_t>(id,it2->second));
+    std::sort( src_cells.begin(), src_cells.end() );
+    std::sort( dst_cells.begin(), dst_cells.end() );
+    std::sort( pair_cells.begin(), pair_cells.end() );
+    src_cells.erase( std::unique( src_cells.begin(), src_cells.end() ), src_cells.end() );
+    dst_cells.erase( std::unique( dst_cells.begin(), dst_cells.end() ), dst_cells.end() );
+
+    // Send the overlaps and ids to the rank that owns each id (id%nprocs):
+    //    the owner of a dst id gets its src overlaps, the owner of a src id its dst overlaps
+    std::vector<std::vector<int64_t>> send(nprocs);
+    for (auto id : src_cells)
+        addRecord( send[id%nprocs], IDMapRecord::src, id, -1, 0 );
+    for (auto id : dst_cells)
+        addRecord( send[id%nprocs], IDMapRecord::dst, -1, id, 0 );
+    for (size_t i=0; i<pair_cells.size(); ) {
+        size_t j = i;
+        while ( j<pair_cells.size() && pair_cells[j]==pair_cells[i] )
+            j++;
+        int64_t id1 = pair_cells[i]>>32;
+        int64_t id2 = pair_cells[i]&0xFFFFFFFF;
+        addRecord( send[id2%nprocs], IDMapRecord::overlap_dst, id1, id2, j-i );
+        addRecord( send[id1%nprocs], IDMapRecord::overlap_src, id1, id2, j-i );
+        i = j;
+    }
+    std::vector<int64_t> recv = exchangeRecords( send, comm );
+    std::vector<int64_t> src_ids, dst_ids;
+    std::vector<std::array<int64_t,3>> src_overlap, dst_overlap;    // (dst,src,count) and (src,dst,count)
+    for (size_t i=0; i<recv.size(); i+=4) {
+        auto type = static_cast<IDMapRecord>(recv[i]);
+        if ( type == IDMapRecord::src )
+            src_ids.push_back(recv[i+1]);
+        else if ( type == IDMapRecord::dst )
+            dst_ids.push_back(recv[i+2]);
+        else if ( type == IDMapRecord::overlap_dst )
+            src_overlap.push_back( { recv[i+2], recv[i+1], recv[i+3] } );
+        else if ( type == IDMapRecord::overlap_src )
+            dst_overlap.push_back( { recv[i+1], recv[i+2], recv[i+3] } );
+    }
+    std::sort( src_ids.begin(), src_ids.end() );
+    std::sort( dst_ids.begin(), dst_ids.end() );
+    src_ids.erase( std::unique( src_ids.begin(), src_ids.end() ), src_ids.end() );
+    dst_ids.erase( std::unique( dst_ids.begin(), dst_ids.end() ), dst_ids.end() );
+    reduceOverlaps( src_overlap );
+    reduceOverlaps( dst_overlap );
+
+    // Classify the owned ids: blobs that were created or destroyed, and src ids with a single dst
+    std::vector<int64_t> summary;
+    std::vector<std::vector<int64_t>> single(nprocs);
+    for (auto id : dst_ids) {
+        auto it = std::lower_bound( src_overlap.begin(), src_overlap.end(), std::array<int64_t,3>({id,-1,-1}) );
+        if ( it==src_overlap.end() || (*it)[0]!=id )
+            addRecord( summary, IDMapRecord::created, -1, id, 0 );
+    }
+    for (size_t i=0, j=0; i<src_ids.size(); i++) {
+        while ( j<dst_overlap.size() && dst_overlap[j][0]<src_ids[i] )
+            j++;
+        size_t count = 0;
+        while ( j+count<dst_overlap.size() && dst_overlap[j+count][0]==src_ids[i] )
+            count++;
+        if ( count == 0 )
+            addRecord( summary, IDMapRecord::destroyed, src_ids[i], -1, 0 );
+        else if ( count == 1 )
+            addRecord( single[dst_overlap[j][1]%nprocs], IDMapRecord::single_dst, src_ids[i], dst_overlap[j][1], 0 );
+    }
+    // A dst id with a single src whose only dst is this id is a 1-1 mapping, the overlaps
+    // of the other dst ids are part of a merge/split
+    recv = exchangeRecords( single, comm );
+    std::set<std::pair<int64_t,int64_t>> single_dst;
+    for (size_t i=0; i<recv.size(); i+=4)
+        single_dst.insert( std::pair<int64_t,int64_t>(recv[i+1],recv[i+2]) );
+    for (size_t i=0; i<src_overlap.size(); ) {
+        size_t j = i;
+        while ( j<src_overlap.size() && src_overlap[j][0]==src_overlap[i][0] )
+            j++;
+        int64_t dst = src_overlap[i][0];
+        if ( j==i+1 && single_dst.count(std::pair<int64_t,int64_t>(src_overlap[i][1],dst)) ) {
+            addRecord( summary, IDMapRecord::src_dst, src_overlap[i][1], dst, 0 );
+        } else {
+            for (size_t k=i; k<j; k++)
+                addRecord( summary, IDMapRecord::overlap_dst, src_overlap[k][1], dst, src_overlap[k][2] );
         }
+        i = j;
     }
 
-    // Perform the mapping of ids
+    // Gather the summary and find the connected src/dst ids of each merge/split
+    summary = gatherRecords( summary, comm );
     ID_map_struct id_map;
-    // Find new blobs
-    for (std::set<BlobIDType>::const_iterator it=dst_set.begin(); it!=dst_set.end(); ++it) {
-        if ( src_map.find(*it)==src_map.end() )
-            id_map.created.push_back(*it);
-    }
-    // Fine blobs that disappeared
-    for (std::set<BlobIDType>::const_iterator it=src_set.begin(); it!=src_set.end(); ++it) {
-        if ( dst_map.find(*it)==dst_map.end() )
-            id_map.destroyed.push_back(*it);
-    }
-    // Find blobs with a 1-to-1 mapping
-    std::vector<BlobIDType> dst_list;
-    dst_list.reserve(src_map.size());
-    for (map_type::const_iterator it=src_map.begin(); it!=src_map.end(); ++it)
-        dst_list.push_back(it->first);
-    for (size_t i=0; i<dst_list.size(); i++) {
-        int dst_id = dst_list[i];
-        const std::map<BlobIDType,int64_t>& src_ids = src_map[dst_id];
-        if ( src_ids.size()==1 ) {
-            int src_id = src_ids.begin()->first;
-            const std::map<BlobIDType,int64_t>& dst_ids = dst_map[src_id];
-            if ( dst_ids.size()==1 ) {
-                ASSERT(dst_ids.begin()->first==dst_id);
-                src_map.erase(dst_id);
-                dst_map.erase(src_id);
-                id_map.src_dst.push_back(std::pair<BlobIDType,BlobIDType>(src_id,dst_id));
-            }
+    map_type src_map, dst_map;      // src ids of each dst id and dst ids of each src id
+    for (size_t i=0; i<summary.size(); i+=4) {
+        auto type = static_cast<IDMapRecord>(summary[i]);
+        BlobIDType id1 = summary[i+1], id2 = summary[i+2];
+        if ( type == IDMapRecord::created ) {
+            id_map.created.push_back(id2);
+        } else if ( type == IDMapRecord::destroyed ) {
+            id_map.destroyed.push_back(id1);
+        } else if ( type == IDMapRecord::src_dst ) {
+            id_map.src_dst.push_back(std::pair<BlobIDType,BlobIDType>(id1,id2));
+        } else {
+            src_map[id2][id1] = summary[i+3];
+            dst_map[id1][id2] = summary[i+3];
         }
     }
+    std::sort( id_map.created.begin(), id_map.created.end() );
+    std::sort( id_map.destroyed.begin(), id_map.destroyed.end() );
+    std::sort( id_map.src_dst.begin(), id_map.src_dst.end(),
+        []( const std::pair<BlobIDType,BlobIDType>& a, const std::pair<BlobIDType,BlobIDType>& b ) { return a.second < b.second; } );
     // Handle merge/splits
     while ( !dst_map.empty() ) {
         // Get a lit of the src-dst ids
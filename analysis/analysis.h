@@ -130,7 +130,10 @@ struct ID_map_struct {
 
 /*!
  * @brief  Get the mapping of blob ids between iterations
- * @details  This functions computes the map of blob ids between iterations
+ * @details  This functions computes the map of blob ids between iterations.
+ *    The overlaps are distributed over the ranks by blob id (id%nprocs), so
+ *    that each rank only stores the overlaps of its local blobs and the
+ *    returned map, which is the same on all ranks.  This is a collective call.
  * @return  Returns the map of the blob ids.  Each final blob may have no source
  *    ids, one parent, or multiple parents.  Each src id may be a parent for multiple blobs.
  * @param[in] ID1           The blob ids at the first timestep
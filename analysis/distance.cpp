@@ -19,23 +19,188 @@
 
 
 /******************************************************************
-* A fast distance calculation                                     *
+* Exact squared Euclidean distance transform                      *
 ******************************************************************/
+// Lower envelope of the parabolas (x-(p+shift)h)^2 + g[p] of a line of n values,
+// evaluated at x = qh for q0 <= q < q0+nq
+static void calcSquaredEDT1D( const double *g, int n, double h, double shift, double *d, int q0, int nq,
+    std::vector<int> &v, std::vector<double> &z )
+{
+    int k = 0;
+    v[0] = 0;
+    z[0] = -1e300;
+    z[1] = 1e300;
+    for (int q=1; q<n; q++) {
+        // z[0] is below any intersection, so the envelope never empties
+        double xq = (q+shift)*h;
+        double xv = (v[k]+shift)*h;
+        double s = ( (g[q]+xq*xq) - (g[v[k]]+xv*xv) ) / ( 2.0*(xq-xv) );
+        while ( s <= z[k] ) {
+            k--;
+            xv = (v[k]+shift)*h;
+            s = ( (g[q]+xq*xq) - (g[v[k]]+xv*xv) ) / ( 2.0*(xq-xv) );
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k+1] = 1e300;
+    }
+    k = 0;
+    for (int q=q0; q<q0+nq; q++) {
+        while ( z[k+1] < q*h )
+            k++;
+        double r = q*h - (v[k]+shift)*h;
+        d[q-q0] = r*r + g[v[k]];
+    }
+}
+void CalcSquaredEDT( Array<double> &f, const std::array<double,3>& dx )
+{
+    std::array<int,3> n = { (int) f.size(0), (int) f.size(1), (int) f.size(2) };
+    int N = std::max( std::max( n[0], n[1] ), n[2] );
+    std::vector<double> g(N), d(N), z(N+1);
+    std::vector<int> v(N);
+    double *data = f.data();
+    for (int dim=0; dim<3; dim++) {
+        size_t stride = dim==0 ? 1 : ( dim==1 ? n[0] : (size_t) n[0]*n[1] );
+        int na = n[dim];
+        size_t lines = f.length() / na;
+        for (size_t l=0; l<lines; l++) {
+            // First cell of line l (the lines are numbered in memory order of the other two indices)
+            size_t b = dim==0 ? l*n[0] : ( dim==1 ? (l%n[0]) + (l/n[0])*stride*na : l );
+            for (int q=0; q<na; q++)
+                g[q] = data[b+q*stride];
+            calcSquaredEDT1D( g.data(), na, dx[dim], 0.0, d.data(), 0, na, v, z );
+            for (int q=0; q<na; q++)
+                data[b+q*stride] = d[q];
+        }
+    }
+}
+
+
+/******************************************************************
+* Exact distance calculation                                      *
+* The distance to the faces between cells with different ids is  *
+* the minimum of three squared EDTs, one for the faces normal to  *
+* each direction (whose parabolas are shifted by half a cell      *
+* along that direction).  Each direction is transformed on        *
+* complete lines gathered with a pencil transpose within the      *
+* processor row, so the communication is a fixed number of        *
+* all-to-all exchanges independent of the process grid.           *
+******************************************************************/
+static void calcSquaredEDTAxis( std::vector<double> &f, const std::array<int,3> &n, int dim,
+    MPI_Comm row, bool periodic, double h, double shift )
+{
+    int P, p;
+    MPI_Comm_size( row, &P );
+    MPI_Comm_rank( row, &p );
+    // Local lines, split evenly among the row
+    size_t N = (size_t) n[0]*n[1]*n[2];
+    int na = n[dim];
+    size_t stride = dim==0 ? 1 : ( dim==1 ? n[0] : (size_t) n[0]*n[1] );
+    size_t lines = N / na;
+    auto first = [&]( size_t l ) {
+        return dim==0 ? l*n[0] : ( dim==1 ? (l%n[0]) + (l/n[0])*stride*na : l );
+    };
+    auto start = [&]( int r ) { return lines*r/P; };
+    size_t my_lines = start(p+1) - start(p);
+    std::vector<int> send_count(P), send_disp(P), recv_count(P), recv_disp(P);
+    for (int r=0; r<P; r++) {
+        send_count[r] = (start(r+1)-start(r))*na;
+        send_disp[r] = start(r)*na;
+        recv_count[r] = my_lines*na;
+        recv_disp[r] = r*my_lines*na;
+    }
+    std::vector<double> local(lines*na), pencil(P*my_lines*na);
+    for (size_t l=0; l<lines; l++) {
+        size_t b = first(l);
+        for (int q=0; q<na; q++)
+            local[l*na+q] = f[b+q*stride];
+    }
+    MPI_Alltoallv( local.data(), send_count.data(), send_disp.data(), MPI_DOUBLE,
+        pencil.data(), recv_count.data(), recv_disp.data(), MPI_DOUBLE, row );
+    // Transform the complete lines (periodic lines are extended by half their length on both sides)
+    int L = P*na;
+    int ext = periodic ? L/2+1 : 0;
+    std::vector<double> g(L+2*ext), d(L), z(L+2*ext+1);
+    std::vector<int> v(L+2*ext);
+    for (size_t m=0; m<my_lines; m++) {
+        for (int q=0; q<L+2*ext; q++) {
+            int x = ( (q-ext)%L + L ) % L;
+            g[q] = pencil[(x/na)*my_lines*na + m*na + x%na];
+        }
+        calcSquaredEDT1D( g.data(), L+2*ext, h, shift, d.data(), ext, L, v, z );
+        for (int x=0; x<L; x++)
+            pencil[(x/na)*my_lines*na + m*na + x%na] = d[x];
+    }
+    MPI_Alltoallv( pencil.data(), recv_count.data(), recv_disp.data(), MPI_DOUBLE,
+        local.data(), send_count.data(), send_disp.data(), MPI_DOUBLE, row );
+    for (size_t l=0; l<lines; l++) {
+        size_t b = first(l);
+        for (int q=0; q<na; q++)
+            f[b+q*stride] = local[l*na+q];
+    }
+}
 template<class TYPE>
 void CalcDist( Array<TYPE> &Distance, const Array<char> &ID, const Domain &Dm,
     const std::array<bool,3>& periodic, const std::array<double,3>& dx )
 {
     ASSERT( Distance.size() == ID.size() );
+    std::array<int,3> N = { Dm.Nx, Dm.Ny, Dm.Nz };
     std::array<int,3> n = { Dm.Nx-2, Dm.Ny-2, Dm.Nz-2 };
-    fillHalo<int> fillData(  Dm.Comm, Dm.rank_info, n, {1,1,1}, 50, 1, {true,false,false}, periodic );
+    // Segmentation with the ghosts of the neighbors (or the nearest cell on non-periodic boundaries)
     Array<int> id(ID.size());
-    Array<Vec> vecDist(Distance.size());
     for (size_t i=0; i<ID.length(); i++)
         id(i) = ID(i) == 0 ? -1:1;
+    for (int k=0; k<N[2]; k++) {
+        for (int j=0; j<N[1]; j++) {
+            for (int i=0; i<N[0]; i++) {
+                int i2 = std::min( std::max( i, 1 ), N[0]-2 );
+                int j2 = std::min( std::max( j, 1 ), N[1]-2 );
+                int k2 = std::min( std::max( k, 1 ), N[2]-2 );
+                id(i,j,k) = id(i2,j2,k2);
+            }
+        }
+    }
+    fillHalo<int> fillData( Dm.Comm, Dm.rank_info, n, {1,1,1}, 50, 1, {true,false,false}, periodic );
     fillData.fill( id );
-    CalcVecDist( vecDist, id, Dm, periodic, dx );
-    for (size_t i=0; i<Distance.length(); i++)
-        Distance(i) = id(i)*vecDist(i).norm();
+    // Processor rows along x, y and z
+    const RankInfoStruct &info = Dm.rank_info;
+    MPI_Comm row[3];
+    MPI_Comm_split( Dm.Comm, info.jy+info.kz*info.ny, info.ix, &row[0] );
+    MPI_Comm_split( Dm.Comm, info.ix+info.kz*info.nx, info.jy, &row[1] );
+    MPI_Comm_split( Dm.Comm, info.ix+info.jy*info.nx, info.kz, &row[2] );
+    // Squared distance to the faces on the low side of the cells in x, y and z
+    size_t Nl = (size_t) n[0]*n[1]*n[2];
+    std::vector<double> f(Nl), dist2(Nl,1e50);
+    for (int c=0; c<3; c++) {
+        for (int k=1; k<N[2]-1; k++) {
+            for (int j=1; j<N[1]-1; j++) {
+                for (int i=1; i<N[0]-1; i++) {
+                    int neighbor = c==0 ? id(i-1,j,k) : ( c==1 ? id(i,j-1,k) : id(i,j,k-1) );
+                    f[(k-1)*n[0]*n[1]+(j-1)*n[0]+i-1] = id(i,j,k) != neighbor ? 0.0 : 1e50;
+                }
+            }
+        }
+        for (int dim=0; dim<3; dim++)
+            calcSquaredEDTAxis( f, n, dim, row[dim], periodic[dim], dx[dim], dim==c ? -0.5:0.0 );
+        for (size_t m=0; m<Nl; m++)
+            dist2[m] = std::min( dist2[m], f[m] );
+    }
+    for (int dim=0; dim<3; dim++)
+        MPI_Comm_free( &row[dim] );
+    for (int k=0; k<N[2]; k++) {
+        for (int j=0; j<N[1]; j++) {
+            for (int i=0; i<N[0]; i++) {
+                int i2 = std::min( std::max( i, 1 ), N[0]-2 );
+                int j2 = std::min( std::max( j, 1 ), N[1]-2 );
+                int k2 = std::min( std::max( k, 1 ), N[2]-2 );
+                size_t m = (k2-1)*n[0]*n[1] + (j2-1)*n[0] + i2-1;
+                Distance(i,j,k) = id(i2,j2,k2)*sqrt( dist2[m] );
+            }
+        }
+    }
+    fillHalo<TYPE> fillDist( Dm.Comm, Dm.rank_info, n, {1,1,1}, 50, 1, {true,true,true}, periodic );
+    fillDist.fill( Distance );
 }
 
 
@@ -198,147 +363,167 @@ void CalcVecDist( Array<Vec> &d, const Array<int> &ID0, const Domain &Dm,
     }
 }
 
-double Eikonal(DoubleArray &Distance, const Array<char> &ID, Domain &Dm, int timesteps, const std::array<bool,3>& periodic){
+/******************************************************************
+* Fast sweeping solution of the Eikonal equation                  *
+******************************************************************/
+// Godunov upwind update of |grad u| = 1 from the smallest neighbor in each direction
+static inline double eikonalUpdate( double a, double b, double c )
+{
+    if ( a > b ) std::swap( a, b );
+    if ( b > c ) std::swap( b, c );
+    if ( a > b ) std::swap( a, b );
+    double u = a + 1.0;
+    if ( u > b ) {
+        u = 0.5 * ( a + b + sqrt( 2.0 - (a-b)*(a-b) ) );
+        if ( u > c ) {
+            double s = a + b + c;
+            u = ( s + sqrt( s*s - 3.0*(a*a+b*b+c*c-1.0) ) ) / 3.0;
+        }
+    }
+    return u;
+}
+double Eikonal(DoubleArray &Distance, const Array<char> &ID, Domain &Dm, int timesteps, const std::array<bool,3>& periodic,
+    double band ){
 
   /*
    * This routine converts the data in the Distance array to a signed distance
-   * by solving the equation df/dt = sign(1-|grad f|), where Distance provides
-   * the values of f on the mesh associated with domain Dm
-   * It has been tested with segmented data initialized to values [-1,1]
-   * and will converge toward the signed distance to the surface bounding the associated phases
+   * to the surface bounding the phases in ID, using the values of Distance to
+   * locate the surface within the cells adjacent to it
    *
    * Reference:
-   * Min C (2010) On reinitializing level set functions, Journal of Computational Physics229
+   * Zhao H (2005) A fast sweeping method for Eikonal equations, Mathematics of Computation 74
    */
+  const double large = 1e30;
+  int Nx = Dm.Nx;
+  int Ny = Dm.Ny;
+  int Nz = Dm.Nz;
+  std::array<int,3> n = { Nx-2, Ny-2, Nz-2 };
+  fillHalo<double> fillData( Dm.Comm, Dm.rank_info, n, {1,1,1}, 50, 1, {true,true,true}, periodic );
+  fillHalo<char> fillSign( Dm.Comm, Dm.rank_info, n, {1,1,1}, 50, 1, {true,false,false}, periodic );
+
+  // Phase of each cell (the nearest interior cell on non-periodic boundaries)
+  Array<char> sign(Nx,Ny,Nz);
+  for (int k=0; k<Nz; k++){
+    for (int j=0; j<Ny; j++){
+      for (int i=0; i<Nx; i++){
+        int i2 = std::min( std::max( i, 1 ), Nx-2 );
+        int j2 = std::min( std::max( j, 1 ), Ny-2 );
+        int k2 = std::min( std::max( k, 1 ), Nz-2 );
+        sign(i,j,k) = ID(i2,j2,k2) == 1 ? 1 : -1;
+      }
+    }
+  }
+  fillSign.fill( sign );
+  fillData.fill( Distance );
+
+  // Interface cells are fixed at the distance to the zero crossing, the other cells of the band
+  // start from a large value and cells outside the band are clamped
+  Array<char> fixed(Nx,Ny,Nz);
+  fixed.fill( 1 );
+  DoubleArray u(Nx,Ny,Nz);
+  u.fill( large );
+  for (int k=1; k<Nz-1; k++){
+    for (int j=1; j<Ny-1; j++){
+      for (int i=1; i<Nx-1; i++){
+        double phi = Distance(i,j,k);
+        int s = sign(i,j,k);
+        double theta[3] = { large, large, large };
+        int nb[6][3] = { {i-1,j,k}, {i+1,j,k}, {i,j-1,k}, {i,j+1,k}, {i,j,k-1}, {i,j,k+1} };
+        for (int q=0; q<6; q++){
+          int ii = nb[q][0], jj = nb[q][1], kk = nb[q][2];
+          if ( sign(ii,jj,kk) == s )
+            continue;
+          // fraction of the distance to the neighbor at the zero crossing
+          double phi2 = Distance(ii,jj,kk);
+          double t = 0.5;
+          if ( phi*s > 0.0 && phi2*s < 0.0 )
+            t = fabs(phi) / ( fabs(phi) + fabs(phi2) );
+          theta[q/2] = std::min( theta[q/2], t );
+        }
+        if ( theta[0] < large || theta[1] < large || theta[2] < large ) {
+          double sum = 0.0;
+          for (int d=0; d<3; d++){
+            if ( theta[d] < large ) sum += 1.0/(theta[d]*theta[d]);
+          }
+          u(i,j,k) = 1.0/sqrt(sum);
+        } else if ( band > 0.0 && fabs(phi) >= band ) {
+          u(i,j,k) = band;
+        } else {
+          fixed(i,j,k) = 0;
+        }
+      }
+    }
+  }
 
-  int i,j,k;
-  double dt=0.1;
-  double Dx,Dy,Dz;
-  double Dxp,Dxm,Dyp,Dym,Dzp,Dzm;
-  double Dxxp,Dxxm,Dyyp,Dyym,Dzzp,Dzzm;
-  double sign,norm;
-  double LocalVar,GlobalVar,LocalMax,GlobalMax;
-
-  int xdim,ydim,zdim;
-  xdim=Dm.Nx-2;
-  ydim=Dm.Ny-2;
-  zdim=Dm.Nz-2;
-  //fillHalo<double> fillData(Dm.Comm, Dm.rank_info,xdim,ydim,zdim,1,1,1,0,1);
-  fillHalo<double> fillData(  Dm.Comm, Dm.rank_info, {xdim, ydim, zdim}, {1,1,1}, 50, 1, {true,true,true}, periodic );
-
-  // Arrays to store the second derivatives
-  DoubleArray Dxx(Dm.Nx,Dm.Ny,Dm.Nz);
-  DoubleArray Dyy(Dm.Nx,Dm.Ny,Dm.Nz);
-  DoubleArray Dzz(Dm.Nx,Dm.Ny,Dm.Nz);
-
+  // Sets of sweeps in the eight orderings, exchanging the halo after each set
+  double GlobalMax = large;
   int count = 0;
-  while (count < timesteps){
-
-    // Communicate the halo of values
-    fillData.fill(Distance);
-
-    // Compute second order derivatives
-    for (k=1;k<Dm.Nz-1;k++){
-      for (j=1;j<Dm.Ny-1;j++){
-	for (i=1;i<Dm.Nx-1;i++){
-	  Dxx(i,j,k) = Distance(i+1,j,k) + Distance(i-1,j,k) - 2*Distance(i,j,k);
-	  Dyy(i,j,k) = Distance(i,j+1,k) + Distance(i,j-1,k) - 2*Distance(i,j,k);
-	  Dzz(i,j,k) = Distance(i,j,k+1) + Distance(i,j,k-1) - 2*Distance(i,j,k);
-	}
+  const RankInfoStruct &info = Dm.rank_info;
+  bool lower[3] = { !periodic[0] && info.ix==0, !periodic[1] && info.jy==0, !periodic[2] && info.kz==0 };
+  bool upper[3] = { !periodic[0] && info.ix==info.nx-1, !periodic[1] && info.jy==info.ny-1, !periodic[2] && info.kz==info.nz-1 };
+  while ( count < timesteps && GlobalMax > 1e-8 ) {
+    // halo values from the neighbors (none before the first exchange or on non-periodic boundaries)
+    for (int k=0; k<Nz; k++){
+      for (int j=0; j<Ny; j++){
+        for (int i=0; i<Nx; i++){
+          if ( i>0 && j>0 && k>0 && i<Nx-1 && j<Ny-1 && k<Nz-1 )
+            continue;
+          bool boundary = (i==0 && lower[0]) || (i==Nx-1 && upper[0]) || (j==0 && lower[1]) ||
+            (j==Ny-1 && upper[1]) || (k==0 && lower[2]) || (k==Nz-1 && upper[2]);
+          u(i,j,k) = ( count==0 || boundary ) ? large : fabs( Distance(i,j,k) );
+        }
       }
     }
-    fillData.fill(Dxx);
-    fillData.fill(Dyy);
-    fillData.fill(Dzz);
-
-    LocalMax=LocalVar=0.0;
-    // Execute the next timestep
-    for (k=1;k<Dm.Nz-1;k++){
-      for (j=1;j<Dm.Ny-1;j++){
-	for (i=1;i<Dm.Nx-1;i++){
-
-	  int n = k*Dm.Nx*Dm.Ny + j*Dm.Nx + i;
-
-	  sign = -1;
-	  if (ID(i,j,k) == 1) sign = 1;
-
-	  // local second derivative terms
-	  Dxxp = minmod(Dxx(i,j,k),Dxx(i+1,j,k));
-	  Dyyp = minmod(Dyy(i,j,k),Dyy(i,j+1,k));
-	  Dzzp = minmod(Dzz(i,j,k),Dzz(i,j,k+1));
-	  Dxxm = minmod(Dxx(i,j,k),Dxx(i-1,j,k));
-	  Dyym = minmod(Dyy(i,j,k),Dyy(i,j-1,k));
-	  Dzzm = minmod(Dzz(i,j,k),Dzz(i,j,k-1));
-
-	  /* //............Compute upwind derivatives ...................
-                    Dxp = Distance(i+1,j,k) - Distance(i,j,k) + 0.5*Dxxp;
-                    Dyp = Distance(i,j+1,k) - Distance(i,j,k) + 0.5*Dyyp;
-                    Dzp = Distance(i,j,k+1) - Distance(i,j,k) + 0.5*Dzzp;
-                    Dxm = Distance(i,j,k) - Distance(i-1,j,k) + 0.5*Dxxm;
-                    Dym = Distance(i,j,k) - Distance(i,j-1,k) + 0.5*Dyym;
-                    Dzm = Distance(i,j,k) - Distance(i,j,k-1) + 0.5*Dzzm;
-	  */
-	  Dxp = Distance(i+1,j,k)- Distance(i,j,k) - 0.5*Dxxp;
-	  Dyp = Distance(i,j+1,k)- Distance(i,j,k) - 0.5*Dyyp;
-	  Dzp = Distance(i,j,k+1)- Distance(i,j,k) - 0.5*Dzzp;
-
-	  Dxm = Distance(i,j,k) - Distance(i-1,j,k) + 0.5*Dxxm;
-	  Dym = Distance(i,j,k) - Distance(i,j-1,k) + 0.5*Dyym;
-	  Dzm = Distance(i,j,k) - Distance(i,j,k-1) + 0.5*Dzzm;
-
-	  // Compute upwind derivatives for Godunov Hamiltonian
-	  if (sign < 0.0){
-	    if (Dxp + Dxm > 0.f)  Dx = Dxp*Dxp;
-	    else Dx = Dxm*Dxm;
-
-	    if (Dyp + Dym > 0.f)  Dy = Dyp*Dyp;
-	    else Dy = Dym*Dym;
-
-	    if (Dzp + Dzm > 0.f)  Dz = Dzp*Dzp;
-	    else Dz = Dzm*Dzm;
-	  }
-	  else{
-
-	    if (Dxp + Dxm < 0.f)  Dx = Dxp*Dxp;
-	    else Dx = Dxm*Dxm;
-
-	    if (Dyp + Dym < 0.f)  Dy = Dyp*Dyp;
-	    else Dy = Dym*Dym;
-
-	    if (Dzp + Dzm < 0.f)  Dz = Dzp*Dzp;
-	    else Dz = Dzm*Dzm;
-	  }
-
-	  //Dx = max(Dxp*Dxp,Dxm*Dxm);
-	  //Dy = max(Dyp*Dyp,Dym*Dym);
-	  //Dz = max(Dzp*Dzp,Dzm*Dzm);
-
-	  norm=sqrt(Dx + Dy + Dz);
-	  if (norm > 1.0) norm=1.0;
-
-	  Distance(i,j,k) += dt*sign*(1.0 - norm);
-	  LocalVar +=  dt*sign*(1.0 - norm);
-
-	  if (fabs(dt*sign*(1.0 - norm)) > LocalMax)
-	    LocalMax = fabs(dt*sign*(1.0 - norm));
-	}
+    double LocalMax = 0.0;
+    for (int sweep=0; sweep<8; sweep++){
+      int di = (sweep&1) ? -1:1;
+      int dj = (sweep&2) ? -1:1;
+      int dk = (sweep&4) ? -1:1;
+      for (int k=(dk>0?1:Nz-2); k>0 && k<Nz-1; k+=dk){
+        for (int j=(dj>0?1:Ny-2); j>0 && j<Ny-1; j+=dj){
+          for (int i=(di>0?1:Nx-2); i>0 && i<Nx-1; i+=di){
+            if ( fixed(i,j,k) )
+              continue;
+            double a = std::min( u(i-1,j,k), u(i+1,j,k) );
+            double b = std::min( u(i,j-1,k), u(i,j+1,k) );
+            double c = std::min( u(i,j,k-1), u(i,j,k+1) );
+            double value = eikonalUpdate( a, b, c );
+            if ( band > 0.0 ) value = std::min( value, band );
+            if ( value < u(i,j,k) ) {
+              if ( u(i,j,k) < large ) LocalMax = std::max( LocalMax, u(i,j,k)-value );
+              else LocalMax = large;
+              u(i,j,k) = value;
+            }
+          }
+        }
       }
     }
-
-    MPI_Allreduce(&LocalVar,&GlobalVar,1,MPI_DOUBLE,MPI_SUM,Dm.Comm);
-    MPI_Allreduce(&LocalMax,&GlobalMax,1,MPI_DOUBLE,MPI_MAX,Dm.Comm);
-    GlobalVar /= Dm.Volume;
+    for (int k=1; k<Nz-1; k++){
+      for (int j=1; j<Ny-1; j++){
+        for (int i=1; i<Nx-1; i++){
+          Distance(i,j,k) = sign(i,j,k)*u(i,j,k);
+        }
+      }
+    }
+    fillData.fill( Distance );
+    GlobalMax = maxReduce( Dm.Comm, LocalMax );
     count++;
-
-    if (count%50 == 0 && Dm.rank()==0 )
-      printf("Time=%i, Max variation=%f, Global variation=%f \n",count,GlobalMax,GlobalVar);
-
-    if (fabs(GlobalMax) < 1e-5){
-      if (Dm.rank()==0) printf("Exiting with max tolerance of 1e-5 \n");
-      count=timesteps;
+  }
+  if ( Dm.rank()==0 )
+    printf("Eikonal: %i sets of sweeps, max variation=%f \n",count,GlobalMax);
+
+  // Copy the nearest interior cell to the non-periodic boundaries
+  for (int k=0; k<Nz; k++){
+    for (int j=0; j<Ny; j++){
+      for (int i=0; i<Nx; i++){
+        int i2 = (i==0 && lower[0]) ? 1 : ( (i==Nx-1 && upper[0]) ? Nx-2 : i );
+        int j2 = (j==0 && lower[1]) ? 1 : ( (j==Ny-1 && upper[1]) ? Ny-2 : j );
+        int k2 = (k==0 && lower[2]) ? 1 : ( (k==Nz-1 && upper[2]) ? Nz-2 : k );
+        Distance(i,j,k) = Distance(i2,j2,k2);
+      }
     }
   }
-  return GlobalVar;
+  return GlobalMax;
 }
 
 // Explicit instantiations
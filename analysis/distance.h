@@ -44,8 +44,11 @@ inline double minmod(double &a, double &b){
 }
 
 /*!
- * @brief  Calculate the distance using a simple method
- * @details  This routine calculates the vector distance to the nearest domain surface.
+ * @brief  Calculate the signed distance
+ * @details  This routine calculates the exact signed distance from each cell center to the
+ *    nearest face between cells of different phase (negative where ID is 0).  Each direction
+ *    is transformed on complete lines gathered from the processor row, so the number of
+ *    communication steps does not depend on the process grid.
  * @param[out] Distance     Distance function
  * @param[in] ID            Segmentation id
  * @param[in] Dm            Domain information
@@ -67,15 +70,37 @@ void CalcVecDist( Array<Vec> &Distance, const Array<int> &ID, const Domain &Dm,
     const std::array<bool,3>& periodic = {true,true,true}, const std::array<double,3>& dx = {1,1,1} );
 
 
+/*!
+ * @brief  Calculate the exact squared Euclidean distance transform
+ * @details  This routine replaces each value of f (0 at the seed cells and a large
+ *    value elsewhere) with the squared distance to the nearest seed cell, using the
+ *    separable lower envelope algorithm of Felzenszwalb and Huttenlocher (one pass
+ *    per direction, O(N)).  The transform is local to the array: the caller supplies
+ *    any seeds from the neighboring processors in a sufficiently wide halo.
+ * @param[in,out] f         Squared distance function
+ * @param[in] dx            Grid spacing
+ */
+void CalcSquaredEDT( Array<double> &f, const std::array<double,3>& dx = {1,1,1} );
+
+
 /*!
  * @brief  Calculate the distance based on solution of Eikonal equation
- * @details  This routine calculates the signed distance to the nearest domain surface.
- * @param[out] Distance     Distance function
+ * @details  This routine reinitializes Distance to the signed distance to the surface bounding
+ *    the phases (positive where ID is 1).  Cells with a face neighbor in the other phase keep a
+ *    subcell estimate of the distance from the zero crossing of the input function; the others
+ *    solve |grad f| = 1 with the fast sweeping method (Gauss-Seidel sweeps in the eight
+ *    alternating orderings of the Godunov upwind scheme).  The halo is exchanged once per set
+ *    of eight sweeps.
+ * @param[in,out] Distance  Level set function / signed distance
  * @param[in] ID            Domain id
  * @param[in] Dm            Domain information
- * @param[in] timesteps      number of timesteps to run for Eikonal solver
- * @param[in] periodic      Directions that are periodic 
+ * @param[in] timesteps     Maximum number of sets of eight sweeps
+ * @param[in] periodic      Directions that are periodic
+ * @param[in] band          Narrow band: only cells with |Distance| < band are updated and the
+ *                          others are set to +/- band (0 to update all cells)
+ * @return                  Maximum change of the last set of sweeps
  */
-double Eikonal(DoubleArray &Distance,  const Array<char> &ID, Domain &Dm, int timesteps, const std::array<bool,3>& periodic);
+double Eikonal(DoubleArray &Distance,  const Array<char> &ID, Domain &Dm, int timesteps, const std::array<bool,3>& periodic,
+    double band = 0.0);
 
 #endif
@@ -16,6 +16,8 @@
 */
 #include "analysis/filters.h"
 #include "math.h"
+#include <algorithm>
+#include <vector>
 #include "ProfilerApp.h"
 
 void Mean3D( const Array<double> &Input, Array<double> &Output )
@@ -46,53 +48,80 @@ void Mean3D( const Array<double> &Input, Array<double> &Output )
 	PROFILE_STOP("Mean3D");
 }
 
+// Comparators of a sorting network that places the median of 27 values at position 13
+// (Batcher odd-even merge sort of 32 values with five padding values, pruned to the
+// comparators that affect the median)
+static std::vector<std::pair<int,int>> MedianNetwork27()
+{
+	std::vector<std::pair<int,int>> sort;
+	const int N = 32;
+	for (int p=1; p<N; p*=2){
+		for (int k=p; k>0; k/=2){
+			for (int j=k%p; j+k<N; j+=2*k){
+				for (int i=0; i<std::min(k,N-j-k); i++){
+					if ((i+j)/(2*p) == (i+j+k)/(2*p))
+						sort.push_back(std::pair<int,int>(i+j,i+j+k));
+				}
+			}
+		}
+	}
+	// the padding values (27-31) are larger than every input, so comparators involving
+	// them never exchange; keep the comparators that the median depends on
+	std::vector<bool> needed(N,false);
+	needed[13] = true;
+	std::vector<std::pair<int,int>> pruned;
+	for (auto c=sort.rbegin(); c!=sort.rend(); ++c){
+		if (c->second >= 27) continue;
+		if (needed[c->first] || needed[c->second]){
+			needed[c->first] = needed[c->second] = true;
+			pruned.push_back(*c);
+		}
+	}
+	return std::vector<std::pair<int,int>>(pruned.rbegin(),pruned.rend());
+}
+
 void Med3D( const Array<float> &Input, Array<float> &Output )
 {
 	PROFILE_START("Med3D");
-	// Perform a 3D Median filter on Input array with specified width
-	int i,j,k,ii,jj,kk;
-	int imin,jmin,kmin,imax,jmax,kmax;
-
-	float *List;
-	List=new float[27];
-
+	// Perform a 3D Median filter on Input array with a 3x3x3 window (hit recursively if needed)
+	// The sorting network is applied to a row of voxels at a time so that each
+	// compare-exchange is a branch free min/max over contiguous memory
 	int Nx = int(Input.size(0));
 	int Ny = int(Input.size(1));
 	int Nz = int(Input.size(2));
-
-	for (k=1; k<Nz-1; k++){
-		for (j=1; j<Ny-1; j++){
-			for (i=1; i<Nx-1; i++){
-
-				// Just use a 3x3x3 window (hit recursively if needed)
-				imin = i-1;
-				jmin = j-1;
-				kmin = k-1;
-				imax = i+2;
-				jmax = j+2;
-				kmax = k+2;
-
-				// Populate the list with values in the window
+	static const auto network = MedianNetwork27();
+	const int n = Nx-2;
+
+	#pragma omp parallel
+	{
+		std::vector<float> List(27*std::max(n,0));
+		#pragma omp for
+		for (int k=1; k<Nz-1; k++){
+			for (int j=1; j<Ny-1; j++){
+				// Populate the lists with values in the windows of the row
 				int Number=0;
-				for (kk=kmin; kk<kmax; kk++){
-					for (jj=jmin; jj<jmax; jj++){
-						for (ii=imin; ii<imax; ii++){
-							List[Number++] = Input(ii,jj,kk);
+				for (int kk=k-1; kk<k+2; kk++){
+					for (int jj=j-1; jj<j+2; jj++){
+						for (int ii=0; ii<3; ii++){
+							const float *src = &Input(ii,jj,kk);
+							float *dst = &List[n*Number++];
+							for (int i=0; i<n; i++) dst[i] = src[i];
 						}
 					}
 				}
-				// Sort the first 5 entries and return the median
-				for (ii=0; ii<14; ii++){
-					for (jj=ii+1; jj<27; jj++){
-						if (List[jj] < List[ii]){
-							float tmp = List[ii];
-							List[ii] = List[jj];
-							List[jj] = tmp;
-						}
+				for (const auto &c : network){
+					float *a = &List[n*c.first];
+					float *b = &List[n*c.second];
+					for (int i=0; i<n; i++){
+						float lo = std::min(a[i],b[i]);
+						float hi = std::max(a[i],b[i]);
+						a[i] = lo;
+						b[i] = hi;
 					}
 				}
 				// Return the median
-				Output(i,j,k) = List[13];
+				const float *median = &List[13*n];
+				for (int i=0; i<n; i++) Output(i+1,j,k) = median[i];
 			}
 		}
 	}
@@ -100,6 +129,19 @@ void Med3D( const Array<float> &Input, Array<float> &Output )
 }
 
 
+// Sum of the values in the window [i-d,i+d) (clamped to [0,N-1)) along one dimension
+static void BoxSum1D( double *data, int N, int stride, int d, double *prefix )
+{
+	prefix[0] = 0.0;
+	for (int i=0; i<N; i++) prefix[i+1] = prefix[i] + data[i*stride];
+	for (int i=1; i<N-1; i++){
+		int imin = std::max(0,i-d);
+		int imax = std::min(N-1,i+d);
+		data[i*stride] = prefix[imax] - prefix[imin];
+	}
+}
+
+
 int NLM3D( const Array<float> &Input, Array<float> &Mean, 
     const Array<float> &Distance, Array<float> &Output, const int d, const float h)
 {
@@ -111,72 +153,71 @@ int NLM3D( const Array<float> &Input, Array<float> &Mean,
 	// 		If Distance(i,j,k) > THRESHOLD_DIST then don't compute NLM
 
 	float THRESHOLD_DIST = float(d);
-	float weight, sum;
-	int i,j,k,ii,jj,kk;
-	int imin,jmin,kmin,imax,jmax,kmax;
 	int returnCount=0;
 
 	int Nx = int(Input.size(0));
 	int Ny = int(Input.size(1));
 	int Nz = int(Input.size(2));
 
-	// Compute the local means
-	for (k=1; k<Nz-1; k++){
-		for (j=1; j<Ny-1; j++){
-			for (i=1; i<Nx-1; i++){
-
-				imin = std::max(0,i-d);
-				jmin = std::max(0,j-d);
-				kmin = std::max(0,k-d);
-				imax = std::min(Nx-1,i+d);
-				jmax = std::min(Ny-1,j+d);
-				kmax = std::min(Nz-1,k+d);
-
-				// Populate the list with values in the window
-				sum = 0; weight=0;
-				for (kk=kmin; kk<kmax; kk++){
-					for (jj=jmin; jj<jmax; jj++){
-						for (ii=imin; ii<imax; ii++){
-							sum += Input(ii,jj,kk);
-							weight++;
-						}
-					}
+	// Compute the local means from separable running sums over the window
+	Array<double> Sum(Nx,Ny,Nz);
+	for (size_t n=0; n<Input.length(); n++) Sum(n) = Input(n);
+	#pragma omp parallel
+	{
+		std::vector<double> prefix(std::max(Nx,std::max(Ny,Nz))+1);
+		#pragma omp for
+		for (int k=0; k<Nz; k++){
+			for (int j=0; j<Ny; j++) BoxSum1D(&Sum(0,j,k),Nx,1,d,prefix.data());
+			for (int i=1; i<Nx-1; i++) BoxSum1D(&Sum(i,0,k),Ny,Nx,d,prefix.data());
+		}
+		#pragma omp for
+		for (int j=1; j<Ny-1; j++){
+			for (int i=1; i<Nx-1; i++) BoxSum1D(&Sum(i,j,0),Nz,Nx*Ny,d,prefix.data());
+		}
+		#pragma omp for
+		for (int k=1; k<Nz-1; k++){
+			int kmin = std::max(0,k-d), kmax = std::min(Nz-1,k+d);
+			for (int j=1; j<Ny-1; j++){
+				int jmin = std::max(0,j-d), jmax = std::min(Ny-1,j+d);
+				for (int i=1; i<Nx-1; i++){
+					int imin = std::max(0,i-d), imax = std::min(Nx-1,i+d);
+					double weight = double((imax-imin)*(jmax-jmin)*(kmax-kmin));
+					Mean(i,j,k) = float(Sum(i,j,k) / weight);
 				}
-
-				Mean(i,j,k) = sum / weight;
 			}
 		}
 	}
 
 	// Compute the non-local means
-	for (k=1; k<Nz-1; k++){
-		for (j=1; j<Ny-1; j++){
-			for (i=1; i<Nx-1; i++){
-
+	#pragma omp parallel for reduction(+:returnCount)
+	for (int k=1; k<Nz-1; k++){
+		for (int j=1; j<Ny-1; j++){
+			for (int i=1; i<Nx-1; i++){
 
 				if (fabs(Distance(i,j,k)) < THRESHOLD_DIST){
 					// compute the expensive non-local means
-					sum = 0; weight=0;
-
-					imin = std::max(0,i-d);
-					jmin = std::max(0,j-d);
-					kmin = std::max(0,k-d);
-					imax = std::min(Nx-1,i+d);
-					jmax = std::min(Ny-1,j+d);
-					kmax = std::min(Nz-1,k+d);
-
-					for (kk=kmin; kk<kmax; kk++){
-						for (jj=jmin; jj<jmax; jj++){
-							for (ii=imin; ii<imax; ii++){
-								float tmp = Mean(i,j,k) - Mean(ii,jj,kk);
-								sum += exp(-tmp*tmp*h)*Input(ii,jj,kk);
-								weight += exp(-tmp*tmp*h);
+					float sum = 0, weight = 0;
+					float mean = Mean(i,j,k);
+
+					int imin = std::max(0,i-d);
+					int jmin = std::max(0,j-d);
+					int kmin = std::max(0,k-d);
+					int imax = std::min(Nx-1,i+d);
+					int jmax = std::min(Ny-1,j+d);
+					int kmax = std::min(Nz-1,k+d);
+
+					for (int kk=kmin; kk<kmax; kk++){
+						for (int jj=jmin; jj<jmax; jj++){
+							for (int ii=imin; ii<imax; ii++){
+								float tmp = mean - Mean(ii,jj,kk);
+								float w = exp(-tmp*tmp*h);
+								sum += w*Input(ii,jj,kk);
+								weight += w;
 							}
 						}
 					}
 
 					returnCount++;
-					//Output(i,j,k) = Mean(i,j,k);
 					Output(i,j,k) = sum / weight;
 				}
 				else{
@@ -5,4 +5,24 @@
 
 double MorphOpen(DoubleArray &SignDist, signed char *id, std::shared_ptr<Domain> Dm, double VoidFraction, signed char ErodeLabel, signed char ReplaceLabel);
 double MorphDrain(DoubleArray &SignDist, signed char *id, std::shared_ptr<Domain> Dm, double VoidFraction);
+
+/*!
+ * Morphological opening for the whole radius schedule in one pass
+ * The opening is run down to a critical radius of 0.5 and Radius records the critical radius
+ * at which each cell was relabeled (0 if never), so the configuration for any radius R of the
+ * curve is the set Radius >= R.  The curve (void fraction, radius) is returned and written to
+ * morphopen.csv
+ */
+std::vector<std::pair<double,double>> MorphOpenCurve(DoubleArray &SignDist, signed char *id, std::shared_ptr<Domain> Dm,
+    signed char ErodeLabel, signed char ReplaceLabel, DoubleArray &Radius);
+
+/*!
+ * Morphological drainage for the whole radius schedule in one pass
+ * As MorphOpenCurve; Radius records the critical radius at which each cell holds the
+ * connected non-wetting phase (0 for the wetting phase), and the curve is written to
+ * morphdrain.csv.  Cells disconnected at a smaller radius are not recovered by the
+ * threshold, so the configurations are exact for monotone invasion.
+ */
+std::vector<std::pair<double,double>> MorphDrainCurve(DoubleArray &SignDist, signed char *id, std::shared_ptr<Domain> Dm, DoubleArray &Radius);
+
 double MorphGrow(DoubleArray &BoundaryDist, DoubleArray &Dist, Array<char> &id, std::shared_ptr<Domain> Dm, double TargetVol, double WallFactor);
@@ -3288,13 +3288,14 @@ inline void pmmc_ConstructLocalCube(DoubleArray &SignDist, DoubleArray &Phase, d
 	}
 }
 //--------------------------------------------------------------------------------------------------------
-inline void pmmc_MeshGradient(DoubleArray &f, DoubleArray &fx, DoubleArray &fy, DoubleArray &fz, int Nx, int Ny, int Nz)
+// Compute the gradient over the box [imin,imax)x[jmin,jmax)x[kmin,kmax)
+inline void pmmc_MeshGradient(DoubleArray &f, DoubleArray &fx, DoubleArray &fy, DoubleArray &fz,
+							int imin, int imax, int jmin, int jmax, int kmin, int kmax)
 {
 	int i,j,k;	
-	// Compute the Gradient everywhere except the halo region
-	for (k=1; k<Nz-1; k++){
-		for (j=1; j<Ny-1; j++){
-			for (i=1; i<Nx-1; i++){
+	for (k=kmin; k<kmax; k++){
+		for (j=jmin; j<jmax; j++){
+			for (i=imin; i<imax; i++){
 				// Compute all of the derivatives using finite differences
 				fx(i,j,k) = 0.5*(f(i+1,j,k) - f(i-1,j,k));
 				fy(i,j,k) = 0.5*(f(i,j+1,k) - f(i,j-1,k));
@@ -3303,19 +3304,24 @@ inline void pmmc_MeshGradient(DoubleArray &f, DoubleArray &fx, DoubleArray &fy,
 		}
 	}
 }
+inline void pmmc_MeshGradient(DoubleArray &f, DoubleArray &fx, DoubleArray &fy, DoubleArray &fz, int Nx, int Ny, int Nz)
+{
+	// Compute the Gradient everywhere except the halo region
+	pmmc_MeshGradient(f,fx,fy,fz,1,Nx-1,1,Ny-1,1,Nz-1);
+}
 //--------------------------------------------------------------------------------------------------------
+// Compute the curvature over the box [imin,imax)x[jmin,jmax)x[kmin,kmax)
 inline void pmmc_MeshCurvature(DoubleArray &f, DoubleArray &MeanCurvature, DoubleArray &GaussCurvature,
-							int Nx, int Ny, int Nz)
+							int imin, int imax, int jmin, int jmax, int kmin, int kmax)
 {
 	// Mesh spacing is taken to be one to simplify the calculation
 	int i,j,k;
 	double denominator;
 	double fxx,fyy,fzz,fxy,fxz,fyz,fx,fy,fz;
 
-	// Compute the curvature everywhere except the halo region
-	for (k=1; k<Nz-1; k++){
-		for (j=1; j<Ny-1; j++){
-			for (i=1; i<Nx-1; i++){
+	for (k=kmin; k<kmax; k++){
+		for (j=jmin; j<jmax; j++){
+			for (i=imin; i<imax; i++){
 				// Compute all of the derivatives using finite differences
 				fx = 0.5*(f(i+1,j,k) - f(i-1,j,k));
 				fy = 0.5*(f(i,j+1,k) - f(i,j-1,k));
@@ -3350,6 +3356,12 @@ inline void pmmc_MeshCurvature(DoubleArray &f, DoubleArray &MeanCurvature, Doubl
 		}
 	}
 }
+inline void pmmc_MeshCurvature(DoubleArray &f, DoubleArray &MeanCurvature, DoubleArray &GaussCurvature,
+							int Nx, int Ny, int Nz)
+{
+	// Compute the curvature everywhere except the halo region
+	pmmc_MeshCurvature(f,MeanCurvature,GaussCurvature,1,Nx-1,1,Ny-1,1,Nz-1);
+}
 //--------------------------------------------------------------------------------------------------------
 inline int pmmc_CubeListFromMesh(IntArray &cubeList, int ncubes, int Nx, int Ny, int Nz)
 {
@@ -21,6 +21,7 @@
 #include "common/Communication.h"
 #include "common/MPI_Helpers.h"
 #include "common/ScaLBL.h"
+#include "common/Restart.h"
 #include "models/ColorModel.h"
 
 #include "IO/MeshDatabase.h"
@@ -51,32 +52,45 @@ void DeleteArray( const TYPE *p )
 }
 
 
+// Copy the fields of a snapshot into the averages (from the analysis thread)
+static void copySnapshot( const runAnalysis::Snapshot& snapshot, TwoPhase& Averages )
+{
+    if ( snapshot.has_tplus )
+        Averages.Phase_tplus = snapshot.Phase_tplus;
+    if ( snapshot.has_tminus )
+        Averages.Phase_tminus = snapshot.Phase_tminus;
+    if ( snapshot.has_state ) {
+        Averages.Phase = snapshot.Phase;
+        Averages.Press = snapshot.Pressure;
+        Averages.Vel_x = snapshot.Vel_x;
+        Averages.Vel_y = snapshot.Vel_y;
+        Averages.Vel_z = snapshot.Vel_z;
+    }
+}
+static void copySnapshot( const runAnalysis::Snapshot& snapshot, SubPhase& Averages )
+{
+    if ( !snapshot.has_state )
+        return;
+    Averages.Pressure = snapshot.Pressure;
+    Averages.Rho_n = snapshot.Rho_n;
+    Averages.Rho_w = snapshot.Rho_w;
+    Averages.Vel_x = snapshot.Vel_x;
+    Averages.Vel_y = snapshot.Vel_y;
+    Averages.Vel_z = snapshot.Vel_z;
+}
+
+
 // Helper class to write the restart file from a seperate thread
 class WriteRestartWorkItem: public ThreadPool::WorkItemRet<void>
 {
 public:
-    WriteRestartWorkItem( const char* filename_, std::shared_ptr<double> cDen_, std::shared_ptr<double> cfq_, int N_ ):
-        filename(filename_), cfq(cfq_), cDen(cDen_), N(N_) {}
+    WriteRestartWorkItem( const char* filename_, std::shared_ptr<double> cDen_, std::shared_ptr<double> cfq_, int N_,
+        int timestep_, const std::string& layout_, bool direct_ ):
+        filename(filename_), cfq(cfq_), cDen(cDen_), N(N_), timestep(timestep_), layout(layout_), direct(direct_) {}
     virtual void run() {
         PROFILE_START("Save Checkpoint",1);
-        double value;
-        ofstream File(filename,ios::binary);
-        for (int n=0; n<N; n++){
-            // Write the two density values
-            value = cDen.get()[n];
-            File.write((char*) &value, sizeof(value));
-            value = cDen.get()[N+n];
-            File.write((char*) &value, sizeof(value));
-            
-        }
-        for (int n=0; n<N; n++){
-            // Write the distributions
-            for (int q=0; q<19; q++){
-                value = cfq.get()[q*N+n];
-                File.write((char*) &value, sizeof(value));
-            }
-        }
-        File.close();
+        // Write the two densities and the distributions as contiguous blocks
+        WriteRestartFile( filename, N, timestep, layout, { { cDen.get(), 2 }, { cfq.get(), 19 } }, direct );
         PROFILE_STOP("Save Checkpoint",1);
     };
 private:
@@ -86,6 +100,35 @@ private:
     // const DoubleArray& phase;
     //const DoubleArray& dist;
     const int N;
+    const int timestep;
+    const std::string layout;
+    const bool direct;
+};
+
+
+// Helper class to write the shared restart file (collective MPI-IO) from a seperate thread
+class WriteSharedRestartWorkItem: public ThreadPool::WorkItemRet<void>
+{
+public:
+    WriteSharedRestartWorkItem( const std::string& filename_, std::shared_ptr<double> cDen_, std::shared_ptr<double> cfq_, int N_,
+        int timestep_, const RankInfoStruct& rank_info_, const IntArray& Map_, int writers_, runAnalysis::commWrapper&& comm_ ):
+        filename(filename_), cfq(cfq_), cDen(cDen_), N(N_), timestep(timestep_), rank_info(rank_info_), Map(Map_),
+        writers(writers_), comm(std::move(comm_)) {}
+    virtual void run() {
+        PROFILE_START("Save Checkpoint",1);
+        WriteSharedRestartFile( filename, rank_info, Map, N, timestep, { { cDen.get(), 2 }, { cfq.get(), 19 } }, writers, comm.comm );
+        PROFILE_STOP("Save Checkpoint",1);
+    };
+private:
+    WriteSharedRestartWorkItem();
+    const std::string filename;
+    std::shared_ptr<double> cfq,cDen;
+    const int N;
+    const int timestep;
+    const RankInfoStruct& rank_info;
+    const IntArray& Map;
+    const int writers;
+    runAnalysis::commWrapper comm;
 };
 
 
@@ -277,9 +320,11 @@ public:
         	IO::writeData( timestep, visData, comm.comm );
 
         if (vis_db->getWithDefault<bool>( "save_8bit_raw", true )){
+        	bool compress = vis_db->getWithDefault<bool>( "compress_8bit_raw", false );
         	char CurrentIDFilename[40];
-        	sprintf(CurrentIDFilename,"id_t%d.raw",timestep);
-        	Averages.AggregateLabels(CurrentIDFilename);
+        	if (compress) sprintf(CurrentIDFilename,"id_t%d.zraw",timestep);
+        	else sprintf(CurrentIDFilename,"id_t%d.raw",timestep);
+        	Averages.AggregateLabels(CurrentIDFilename,compress);
         }
 
         PROFILE_STOP("Save Vis",1);
@@ -296,16 +341,17 @@ private:
 
 
 // Helper class to run the analysis from within a thread
-// Note: Averages will be modified after the constructor is called
+// Note: the simulation state is copied from the snapshot once the previous analysis is done
 class AnalysisWorkItem: public ThreadPool::WorkItemRet<void>
 {
 public:
     AnalysisWorkItem( AnalysisType type_, int timestep_, TwoPhase& Averages_, 
-            BlobIDstruct ids, BlobIDList id_list_, double beta_ ):
+            BlobIDstruct ids, BlobIDList id_list_, double beta_, std::shared_ptr<const runAnalysis::Snapshot> snapshot_ ):
                 type(type_), timestep(timestep_), Averages(Averages_), 
-                blob_ids(ids), id_list(id_list_), beta(beta_) { }
+                blob_ids(ids), id_list(id_list_), beta(beta_), snapshot(snapshot_) { }
     ~AnalysisWorkItem() { }
     virtual void run() {
+        copySnapshot(*snapshot,Averages);
         Averages.NumberComponents_NWP = blob_ids->first;
         Averages.Label_NWP = blob_ids->second;
         Averages.Label_NWP_map = *id_list;
@@ -340,6 +386,7 @@ private:
     BlobIDstruct blob_ids;
     BlobIDList id_list;
     double beta;
+    std::shared_ptr<const runAnalysis::Snapshot> snapshot;
 };
 
 
@@ -430,11 +477,13 @@ private:
 class BasicWorkItem: public ThreadPool::WorkItemRet<void>
 {
 public:
-	BasicWorkItem( AnalysisType type_, int timestep_, SubPhase& Averages_ ):
-                type(type_), timestep(timestep_), Averages(Averages_){ }
+	BasicWorkItem( AnalysisType type_, int timestep_, SubPhase& Averages_, std::shared_ptr<const runAnalysis::Snapshot> snapshot_ ):
+                type(type_), timestep(timestep_), Averages(Averages_), snapshot(snapshot_){ }
     ~BasicWorkItem() { }
     virtual void run() {
 
+        copySnapshot(*snapshot,Averages);
+
         if ( matches(type,AnalysisType::CopyPhaseIndicator) ) {
             // Averages.ColorToSignedDistance(beta,Averages.Phase,Averages.Phase_tplus);
         }
@@ -450,6 +499,7 @@ private:
     int timestep;
     SubPhase& Averages;
     double beta;
+    std::shared_ptr<const runAnalysis::Snapshot> snapshot;
 };
 
 class SubphaseWorkItem: public ThreadPool::WorkItemRet<void>
@@ -530,7 +580,9 @@ runAnalysis::runAnalysis(std::shared_ptr<Database> input_db, const RankInfoStruc
             d_rank_info( rank_info ),
             d_Map( Map ),
             d_fillData(Dm->Comm,Dm->rank_info,{Dm->Nx-2,Dm->Ny-2,Dm->Nz-2},{1,1,1},0,1),
-            d_ScaLBL_Comm( ScaLBL_Comm)
+            d_ScaLBL_Comm( ScaLBL_Comm),
+            d_snapshot_dropped( false ),
+            d_wait_time( 0 )
 {
 
 	auto db = input_db->getDatabase( "Analysis" );
@@ -566,6 +618,15 @@ runAnalysis::runAnalysis(std::shared_ptr<Database> input_db, const RankInfoStruc
 	
     auto restart_file = db->getScalar<std::string>( "restart_file" );
     d_restartFile = restart_file + "." + rankString;
+    d_restart_direct = db->getWithDefault<bool>( "restart_direct_io", false );
+    d_restart_shared = db->getWithDefault<bool>( "restart_shared", false );
+    d_restart_writers = db->getWithDefault<int>( "restart_writers", 0 );
+    d_restartSharedFile = restart_file + ".shared";
+
+    // Snapshot buffers handed to the analysis threads
+    int snapshot_buffers = db->getWithDefault<int>( "snapshot_buffers", 2 );
+    auto snapshot_policy = db->getWithDefault<std::string>( "snapshot_policy", "wait" );
+    d_snapshots = std::make_shared<SnapshotRing>( snapshot_buffers, snapshot_policy );
     
     
     d_rank = MPI_WORLD_RANK();
@@ -651,6 +712,10 @@ runAnalysis::~runAnalysis( )
 {
     // Finish processing analysis
     finish();
+    if ( d_rank == 0 && d_snapshots->taken() + d_snapshots->dropped() > 0 ) {
+        printf("Analysis: %i snapshots, %i dropped, solver waited %f s on the analysis\n",
+            d_snapshots->taken(), d_snapshots->dropped(), d_wait_time + d_snapshots->waitTime() );
+    }
     // Clear internal data
     MPI_Comm_free( &d_comm );
     for (int i=0; i<1024; i++) {
@@ -661,6 +726,7 @@ runAnalysis::~runAnalysis( )
 void runAnalysis::finish( )
 {
     PROFILE_START("finish");
+    double starttime = MPI_Wtime();
     // Wait for the work items to finish
     d_tpool.wait_pool_finished();
     // Clear the wait ids
@@ -671,10 +737,47 @@ void runAnalysis::finish( )
     d_wait_restart.reset();
     // Syncronize
     MPI_Barrier( d_comm );
+    d_wait_time += MPI_Wtime() - starttime;
     PROFILE_STOP("finish");
 }
 
 
+/******************************************************************
+ *  Get the next snapshot buffer                                   *
+ ******************************************************************/
+runAnalysis::SnapshotRing::SnapshotRing( int buffers, const std::string& policy ):
+    d_next( 0 ), d_policy( policy ), d_taken( 0 ), d_dropped( 0 ), d_wait_time( 0 )
+{
+    INSIST( buffers > 0, "snapshot_buffers must be positive" );
+    INSIST( d_policy == "wait" || d_policy == "drop", "snapshot_policy must be wait or drop" );
+    for (int i=0; i<buffers; i++)
+        d_buffers.push_back( std::make_shared<Snapshot>() );
+}
+std::shared_ptr<runAnalysis::Snapshot> runAnalysis::SnapshotRing::get( const ThreadPool& tpool, MPI_Comm comm )
+{
+    // The buffers are handed out in order, so the next one is the oldest
+    auto snapshot = d_buffers[d_next];
+    // The analysis is collective, so all ranks must agree to wait or drop
+    bool busy = sumReduce( comm, !snapshot->owner.finished() );
+    if ( busy && d_policy == "drop" ) {
+        d_dropped++;
+        return std::shared_ptr<Snapshot>();
+    }
+    if ( busy ) {
+        PROFILE_START("Wait for snapshot",1);
+        double starttime = MPI_Wtime();
+        tpool.wait( snapshot->owner );
+        d_wait_time += MPI_Wtime() - starttime;
+        PROFILE_STOP("Wait for snapshot",1);
+    }
+    snapshot->owner.reset();
+    snapshot->invalidate();
+    d_next = ( d_next + 1 ) % d_buffers.size();
+    d_taken++;
+    return snapshot;
+}
+
+
 /******************************************************************
  *  Set the thread affinities                                      *
  ******************************************************************/
@@ -837,23 +940,36 @@ void runAnalysis::run(int timestep, std::shared_ptr<Database> input_db, TwoPhase
         delete [] TmpDat;
     }
     */
+    // Take a snapshot buffer for the state copied during this analysis interval
+    bool copy_tplus = timestep%d_analysis_interval + 8 == d_analysis_interval;
+    bool copy_tminus = timestep%d_analysis_interval == 0;
+    bool copy_state = timestep%d_analysis_interval + 4 == d_analysis_interval;
+    if ( ( copy_tplus || copy_tminus || copy_state ) && !d_snapshot && !d_snapshot_dropped ) {
+        d_snapshot = getSnapshot();
+        d_snapshot_dropped = !d_snapshot;
+    }
+    bool dropped = timestep%d_analysis_interval == 0 && !d_snapshot;
     //if ( matches(type,AnalysisType::CopyPhaseIndicator) ) {
-    if ( timestep%d_analysis_interval + 8 == d_analysis_interval ) {
+    if ( copy_tplus && d_snapshot ) {
+      d_snapshot->Phase_tplus.resize(d_N[0],d_N[1],d_N[2]);
       if (d_regular)
-        d_ScaLBL_Comm->RegularLayout(d_Map,Phi,Averages.Phase_tplus);
+        d_ScaLBL_Comm->RegularLayout(d_Map,Phi,d_snapshot->Phase_tplus);
       else 
-    ScaLBL_CopyToHost(Averages.Phase_tplus.data(),Phi,N*sizeof(double));
+    ScaLBL_CopyToHost(d_snapshot->Phase_tplus.data(),Phi,N*sizeof(double));
+      d_snapshot->has_tplus = true;
         //memcpy(Averages.Phase_tplus.data(),phase->data(),N*sizeof(double));
     }
-    if ( timestep%d_analysis_interval == 0 ) {
+    if ( copy_tminus && d_snapshot ) {
+      d_snapshot->Phase_tminus.resize(d_N[0],d_N[1],d_N[2]);
       if (d_regular)
-        d_ScaLBL_Comm->RegularLayout(d_Map,Phi,Averages.Phase_tminus);
+        d_ScaLBL_Comm->RegularLayout(d_Map,Phi,d_snapshot->Phase_tminus);
       else 
-    ScaLBL_CopyToHost(Averages.Phase_tminus.data(),Phi,N*sizeof(double));
+    ScaLBL_CopyToHost(d_snapshot->Phase_tminus.data(),Phi,N*sizeof(double));
+      d_snapshot->has_tminus = true;
         //memcpy(Averages.Phase_tminus.data(),phase->data(),N*sizeof(double));
     }
     //if ( matches(type,AnalysisType::CopySimState) ) {
-    if ( timestep%d_analysis_interval + 4 == d_analysis_interval ) {
+    if ( copy_state && d_snapshot ) {
         // Copy the members of Averages to the cpu (phase was copied above)
         PROFILE_START("Copy-Pressure",1);
         ScaLBL_D3Q19_Pressure(fq,Pressure,d_Np);
@@ -863,16 +979,20 @@ void runAnalysis::run(int timestep, std::shared_ptr<Database> input_db, TwoPhase
         PROFILE_START("Copy-Wait",1);
         PROFILE_STOP("Copy-Wait",1);
         PROFILE_START("Copy-State",1);
+        auto& snapshot = *d_snapshot;
+        for ( auto array : { &snapshot.Phase, &snapshot.Pressure, &snapshot.Vel_x, &snapshot.Vel_y, &snapshot.Vel_z } )
+            array->resize(d_N[0],d_N[1],d_N[2]);
         //memcpy(Averages.Phase.data(),phase->data(),N*sizeof(double));
         if (d_regular)
-            d_ScaLBL_Comm->RegularLayout(d_Map,Phi,Averages.Phase);
+            d_ScaLBL_Comm->RegularLayout(d_Map,Phi,snapshot.Phase);
         else
-            ScaLBL_CopyToHost(Averages.Phase.data(),Phi,N*sizeof(double));
+            ScaLBL_CopyToHost(snapshot.Phase.data(),Phi,N*sizeof(double));
         // copy other variables
-        d_ScaLBL_Comm->RegularLayout(d_Map,Pressure,Averages.Press);
-        d_ScaLBL_Comm->RegularLayout(d_Map,&Velocity[0],Averages.Vel_x);
-        d_ScaLBL_Comm->RegularLayout(d_Map,&Velocity[d_Np],Averages.Vel_y);
-        d_ScaLBL_Comm->RegularLayout(d_Map,&Velocity[2*d_Np],Averages.Vel_z);
+        d_ScaLBL_Comm->RegularLayout(d_Map,Pressure,snapshot.Pressure);
+        d_ScaLBL_Comm->RegularLayout(d_Map,&Velocity[0],snapshot.Vel_x);
+        d_ScaLBL_Comm->RegularLayout(d_Map,&Velocity[d_Np],snapshot.Vel_y);
+        d_ScaLBL_Comm->RegularLayout(d_Map,&Velocity[2*d_Np],snapshot.Vel_z);
+        snapshot.has_state = true;
         PROFILE_STOP("Copy-State",1);
     }
     std::shared_ptr<double> cfq,cDen;
@@ -913,11 +1033,17 @@ void runAnalysis::run(int timestep, std::shared_ptr<Database> input_db, TwoPhase
     //if (timestep%d_restart_interval==0){
     // if ( matches(type,AnalysisType::ComputeAverages) ) {
     if ( timestep%d_analysis_interval == 0 ) {
-        auto work = new AnalysisWorkItem(type,timestep,Averages,d_last_index,d_last_id_map,d_beta);
-        work->add_dependency(d_wait_blobID);
-        work->add_dependency(d_wait_analysis);
-        work->add_dependency(d_wait_vis);     // Make sure we are done using analysis before modifying
-        d_wait_analysis = d_tpool.add_work(work);
+        if ( d_snapshot ) {
+            auto work = new AnalysisWorkItem(type,timestep,Averages,d_last_index,d_last_id_map,d_beta,d_snapshot);
+            work->add_dependency(d_wait_blobID);
+            work->add_dependency(d_wait_analysis);
+            work->add_dependency(d_wait_vis);     // Make sure we are done using analysis before modifying
+            d_wait_analysis = d_tpool.add_work(work);
+            d_snapshot->owner = d_wait_analysis;
+        }
+        // Start a new snapshot for the next analysis interval
+        d_snapshot.reset();
+        d_snapshot_dropped = false;
     }
 
     // Spawn a thread to write the restart file
@@ -931,14 +1057,19 @@ void runAnalysis::run(int timestep, std::shared_ptr<Database> input_db, TwoPhase
 	  //	OutStream.close();
     	}
     	// Write the restart file (using a seperate thread)
-        auto work = new WriteRestartWorkItem(d_restartFile.c_str(),cDen,cfq,d_Np);
+        ThreadPool::WorkItem *work;
+        if (d_restart_shared)
+            work = new WriteSharedRestartWorkItem(d_restartSharedFile,cDen,cfq,d_Np,timestep,d_rank_info,d_Map,d_restart_writers,getComm());
+        else
+            work = new WriteRestartWorkItem(d_restartFile.c_str(),cDen,cfq,d_Np,timestep,d_ScaLBL_Comm->Layout,d_restart_direct);
         work->add_dependency(d_wait_restart);
         d_wait_restart = d_tpool.add_work(work);
     }
 
     // Save the results for visualization
+    // A dropped snapshot also drops the vis output of this timestep
     //    if ( matches(type,AnalysisType::CreateRestart) ) {
-    if (timestep%d_restart_interval==0){
+    if (timestep%d_restart_interval==0 && !dropped){
         // Write the vis files
         auto work = new WriteVisWorkItem( timestep, d_meshData, Averages, d_fillData, getComm() );
         work->add_dependency(d_wait_blobID);
@@ -977,9 +1108,12 @@ void runAnalysis::basic(int timestep, std::shared_ptr<Database> input_db, SubPha
     PROFILE_START("Copy data to host",1);
 
     //if ( matches(type,AnalysisType::CopySimState) ) {
-    if ( timestep%d_analysis_interval == 0 ) {
-        finish(); // can't copy if threads are still working on data
-        // Copy the members of Averages to the cpu (phase was copied above)
+    // Copy the state into a free snapshot buffer (the analysis threads may still be working on Averages)
+    std::shared_ptr<Snapshot> snapshot;
+    if ( timestep%d_analysis_interval == 0 )
+        snapshot = getSnapshot();
+    bool dropped = timestep%d_analysis_interval == 0 && !snapshot;
+    if ( snapshot ) {
         PROFILE_START("Copy-Pressure",1);
         ScaLBL_D3Q19_Pressure(fq,Pressure,d_Np);
         //ScaLBL_D3Q19_Momentum(fq,Velocity,d_Np);
@@ -988,13 +1122,16 @@ void runAnalysis::basic(int timestep, std::shared_ptr<Database> input_db, SubPha
         PROFILE_START("Copy-Wait",1);
         PROFILE_STOP("Copy-Wait",1);
         PROFILE_START("Copy-State",1);
+        for ( auto array : { &snapshot->Pressure, &snapshot->Rho_n, &snapshot->Rho_w, &snapshot->Vel_x, &snapshot->Vel_y, &snapshot->Vel_z } )
+            array->resize(d_N[0],d_N[1],d_N[2]);
         // copy other variables
-        d_ScaLBL_Comm->RegularLayout(d_Map,Pressure,Averages.Pressure);
-        d_ScaLBL_Comm->RegularLayout(d_Map,&Den[0],Averages.Rho_n);
-        d_ScaLBL_Comm->RegularLayout(d_Map,&Den[d_Np],Averages.Rho_w);
-        d_ScaLBL_Comm->RegularLayout(d_Map,&Velocity[0],Averages.Vel_x);
-        d_ScaLBL_Comm->RegularLayout(d_Map,&Velocity[d_Np],Averages.Vel_y);
-        d_ScaLBL_Comm->RegularLayout(d_Map,&Velocity[2*d_Np],Averages.Vel_z);
+        d_ScaLBL_Comm->RegularLayout(d_Map,Pressure,snapshot->Pressure);
+        d_ScaLBL_Comm->RegularLayout(d_Map,&Den[0],snapshot->Rho_n);
+        d_ScaLBL_Comm->RegularLayout(d_Map,&Den[d_Np],snapshot->Rho_w);
+        d_ScaLBL_Comm->RegularLayout(d_Map,&Velocity[0],snapshot->Vel_x);
+        d_ScaLBL_Comm->RegularLayout(d_Map,&Velocity[d_Np],snapshot->Vel_y);
+        d_ScaLBL_Comm->RegularLayout(d_Map,&Velocity[2*d_Np],snapshot->Vel_z);
+        snapshot->has_state = true;
         PROFILE_STOP("Copy-State",1);
     }
     PROFILE_STOP("Copy data to host");
@@ -1002,15 +1139,17 @@ void runAnalysis::basic(int timestep, std::shared_ptr<Database> input_db, SubPha
     // Spawn threads to do the analysis work
     //if (timestep%d_restart_interval==0){
     // if ( matches(type,AnalysisType::ComputeAverages) ) {
-    if ( timestep%d_analysis_interval == 0 ) {
-        auto work = new BasicWorkItem(type,timestep,Averages);
+    if ( snapshot ) {
+        auto work = new BasicWorkItem(type,timestep,Averages,snapshot);
         work->add_dependency(d_wait_subphase);    // Make sure we are done using analysis before modifying
         work->add_dependency(d_wait_analysis);  
         work->add_dependency(d_wait_vis);
         d_wait_analysis = d_tpool.add_work(work);
+        snapshot->owner = d_wait_analysis;
     }
     
-    if ( timestep%d_subphase_analysis_interval == 0 ) {
+    // A dropped snapshot also drops the subphase analysis and vis output of this timestep
+    if ( timestep%d_subphase_analysis_interval == 0 && !dropped ) {
         auto work = new SubphaseWorkItem(type,timestep,Averages);
         work->add_dependency(d_wait_subphase);    // Make sure we are done using analysis before modifying
         work->add_dependency(d_wait_analysis);  
@@ -1037,12 +1176,16 @@ void runAnalysis::basic(int timestep, std::shared_ptr<Database> input_db, SubPha
     		OutStream.close();
     	}
     	// Write the restart file (using a seperate thread)
-    	auto work1 = new WriteRestartWorkItem(d_restartFile.c_str(),cDen,cfq,d_Np);
+    	ThreadPool::WorkItem *work1;
+    	if (d_restart_shared)
+    	    work1 = new WriteSharedRestartWorkItem(d_restartSharedFile,cDen,cfq,d_Np,timestep,d_rank_info,d_Map,d_restart_writers,getComm());
+    	else
+    	    work1 = new WriteRestartWorkItem(d_restartFile.c_str(),cDen,cfq,d_Np,timestep,d_ScaLBL_Comm->Layout,d_restart_direct);
     	work1->add_dependency(d_wait_restart);
     	d_wait_restart = d_tpool.add_work(work1);
     }
     
-    if (timestep%d_visualization_interval==0){
+    if (timestep%d_visualization_interval==0 && !dropped){
         // Write the vis files
          auto work = new IOWorkItem( timestep, input_db, d_meshData, Averages, d_fillData, getComm() );
         work->add_dependency(d_wait_analysis);
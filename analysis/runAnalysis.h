@@ -81,6 +81,41 @@ private:
 
 public:
 
+    //! Host copy of the simulation state handed from the solver to the analysis threads
+    struct Snapshot
+    {
+        DoubleArray Phase, Phase_tplus, Phase_tminus;
+        DoubleArray Pressure, Rho_n, Rho_w;
+        DoubleArray Vel_x, Vel_y, Vel_z;
+        // Fields copied since the buffer was taken (a reused buffer still holds an older timestep)
+        bool has_tplus = false, has_tminus = false, has_state = false;
+        ThreadPool::thread_id_t owner;      // work item that copies the snapshot into the averages
+        void invalidate() { has_tplus = has_tminus = has_state = false; }
+    };
+
+    //! Ring of snapshot buffers, each reused once the analysis of its last snapshot is done
+    class SnapshotRing
+    {
+      public:
+        SnapshotRing( int buffers, const std::string& policy );
+        /*!
+         *  \brief    Get the next snapshot buffer with its fields invalidated (collective)
+         *  \details  If the buffer is still in use the "wait" policy waits for its owner,
+         *      the "drop" policy returns NULL and counts the snapshot as dropped.
+         *      The decision is taken over all ranks of comm.
+         */
+        std::shared_ptr<Snapshot> get( const ThreadPool& tpool, MPI_Comm comm );
+        int taken() const { return d_taken; }
+        int dropped() const { return d_dropped; }
+        double waitTime() const { return d_wait_time; }   // time spent waiting on the owners
+      private:
+        std::vector<std::shared_ptr<Snapshot>> d_buffers;
+        size_t d_next;
+        std::string d_policy;   // "wait" or "drop" when the next buffer is still in use
+        int d_taken, d_dropped;
+        double d_wait_time;
+    };
+
     class commWrapper
     {
       public:
@@ -98,6 +133,12 @@ public:
     // Get a comm (not thread safe)
     commWrapper getComm( );
 
+private:
+
+    // Get the next snapshot buffer once its last owner is done (collective),
+    // returns NULL if the snapshot is dropped
+    std::shared_ptr<Snapshot> getSnapshot( ) { return d_snapshots->get( d_tpool, d_comm ); }
+
 private:
 
     int d_N[3];
@@ -116,11 +157,21 @@ private:
     std::vector<IO::MeshDataStruct> d_meshData;
     fillHalo<double> d_fillData;
     std::string d_restartFile;
+    bool d_restart_direct;      // write restart files with O_DIRECT
+    bool d_restart_shared;      // write a single restart file with collective MPI-IO
+    int d_restart_writers;      // number of MPI-IO aggregators for the shared restart file
+    std::string d_restartSharedFile;
     MPI_Comm d_comm;
     MPI_Comm d_comms[1024];
     volatile bool d_comm_used[1024];
     std::shared_ptr<ScaLBL_Communicator> d_ScaLBL_Comm;
 
+    // Ring of snapshot buffers
+    std::shared_ptr<SnapshotRing> d_snapshots;
+    std::shared_ptr<Snapshot> d_snapshot;   // snapshot being filled by run()
+    bool d_snapshot_dropped;
+    double d_wait_time;             // solver time spent waiting on the analysis in finish()
+
     // Ids of work items to use for dependencies
     ThreadPool::thread_id_t d_wait_blobID;
     ThreadPool::thread_id_t d_wait_analysis;
@@ -1,12 +1,12 @@
 # Configure the Profiler App for the current project
 # The 'CONFIGURE_TIMER' macro searches for the timer library if included,
-# or creates a dummy null timer if it is not used:
+# or uses the built-in profiler (common/Profiler.h) if it is not used:
 #    CONFIGURE_TIMER( DEFAULT_USE_TIMER NULL_TIMER_DIR )
 # This function assumes that USE_TIMER is set to indicate if the timer should be used
 # If USE_TIMER is set, TIMER_DIRECTORY specifies the install path for the timer
-# If USE_TIMER is not set we will create a summy timer that does nothing.
+# If USE_TIMER is not set we will create a ProfilerApp.h that includes the built-in profiler.
 # The input argument DEFAULT_USE_TIMER specifies if the timer library is included by default.
-# The input argument NULL_TIMER_DIR specifies the location to install the dummy timer.  
+# The input argument NULL_TIMER_DIR specifies the location to install the ProfilerApp.h header.  
 #    If it is an empty string, the default install path "${CMAKE_CURRENT_BINARY_DIR}/null_timer" is used.
 # This function will set the following variables and add the appropriate paths to the include list
 #    TIMER_INCLUDE  - Path to the timer headers
@@ -47,23 +47,11 @@ FUNCTION( CONFIGURE_TIMER DEFAULT_USE_TIMER NULL_TIMER_DIR )
         IF ( "${NULL_TIMER_DIR}" STREQUAL "" )
             SET( NULL_TIMER_DIR "${CMAKE_CURRENT_BINARY_DIR}/null_timer" )
         ENDIF()
-        FILE(WRITE  "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_START(...)       do {} while(0)\n" )
-        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_STOP(...)        do {} while(0)\n" )
-        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_START2(...)      do {} while(0)\n" )
-        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_STOP2(...)       do {} while(0)\n" )
-        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_SCOPED(...)      do {} while(0)\n" )
-        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_SYNCHRONIZE()    do {} while(0)\n" )
-        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_SAVE(...)        do {} while(0)\n" )
-        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_STORE_TRACE(X)   do {} while(0)\n" )
-        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_ENABLE(...)      do {} while(0)\n" )
-        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_DISABLE()        do {} while(0)\n" )
-        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_ENABLE_TRACE()   do {} while(0)\n" )
-        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_DISABLE_TRACE()  do {} while(0)\n" )
-        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_ENABLE_MEMORY()  do {} while(0)\n" )
-        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#define PROFILE_DISABLE_MEMORY() do {} while(0)\n" )
+        FILE(WRITE  "${NULL_TIMER_DIR}/ProfilerApp.h" "// Use the built-in profiler\n" )
+        FILE(APPEND "${NULL_TIMER_DIR}/ProfilerApp.h" "#include \"common/Profiler.h\"\n" )
         SET( TIMER_INCLUDE  "${NULL_TIMER_DIR}" )
         INCLUDE_DIRECTORIES( "${TIMER_INCLUDE}" )
-        MESSAGE( "Disabling timer utility" )
+        MESSAGE( "Using built-in profiler (common/Profiler.h)" )
     ENDIF()
     SET( TIMER_INCLUDE  "${TIMER_INCLUDE}"  PARENT_SCOPE )
     SET( TIMER_CXXFLAGS "${TIMER_CXXFLAGS}" PARENT_SCOPE )
@@ -38,6 +38,31 @@ MACRO( CONFIGURE_MIC )
 ENDMACRO()
 
 
+# Macro to configure OpenMP threading and vectorization of the CPU kernels
+MACRO( CONFIGURE_OPENMP )
+    CHECK_ENABLE_FLAG( USE_OPENMP 0 )
+    IF ( USE_OPENMP )
+        FIND_PACKAGE( OpenMP REQUIRED COMPONENTS CXX )
+        SET( CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${OpenMP_CXX_FLAGS}" )
+        SET( EXTERNAL_LIBS ${EXTERNAL_LIBS} ${OpenMP_CXX_LIBRARIES} )
+        ADD_DEFINITIONS( -DUSE_OPENMP )
+        MESSAGE( "Using OpenMP" )
+        MESSAGE( "  OpenMP_CXX_FLAGS = ${OpenMP_CXX_FLAGS}" )
+    ELSE()
+        # Honor the simd directives in the CPU kernels without the threaded runtime
+        CHECK_CXX_COMPILER_FLAG( -fopenmp-simd OPENMP_SIMD_FLAG )
+        IF ( OPENMP_SIMD_FLAG )
+            SET( CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -fopenmp-simd" )
+        ENDIF()
+    ENDIF()
+    # sqrt must not set errno for the collision kernels to vectorize
+    CHECK_CXX_COMPILER_FLAG( -fno-math-errno NO_MATH_ERRNO_FLAG )
+    IF ( NO_MATH_ERRNO_FLAG )
+        SET( CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -fno-math-errno" )
+    ENDIF()
+ENDMACRO()
+
+
 # Macro to find and configure the MPI libraries
 MACRO( CONFIGURE_MPI )
     # Determine if we want to use MPI
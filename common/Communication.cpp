@@ -76,6 +76,100 @@ RankInfoStruct::RankInfoStruct( int rank0, int nprocx, int nprocy, int nprocz )
 }
 
 
+/********************************************************
+*  Multi-field mesh halo exchange                       *
+********************************************************/
+MeshHaloExchange::MeshHaloExchange( MPI_Comm comm_, const RankInfoStruct& info_, int tag0 ):
+    comm(comm_), info(info_)
+{
+    for (int i=0; i<3; i++) {
+        for (int j=0; j<3; j++) {
+            for (int k=0; k<3; k++) {
+                tag[i][j][k] = tag0 + i + j*3 + k*9;
+                neighbor[i][j][k].rank = info.rank[i][j][k];
+            }
+        }
+    }
+}
+void MeshHaloExchange::setLists( int i, int j, int k, int sendCount, const int *sendList, int recvCount, const int *recvList )
+{
+    ASSERT(active.empty());
+    Neighbor& nb = neighbor[i+1][j+1][k+1];
+    nb.send_list = std::vector<int>(sendList,sendList+sendCount);
+    nb.recv_list = std::vector<int>(recvList,recvList+recvCount);
+}
+void MeshHaloExchange::start( const std::vector<DoubleArray*>& fields )
+{
+    ASSERT(active.empty());
+    active = fields;
+    const int N_fields = fields.size();
+    // Start the recieves (the neighbor (i,j,k) sends in the direction (-i,-j,-k))
+    for (int i=0; i<3; i++) {
+        for (int j=0; j<3; j++) {
+            for (int k=0; k<3; k++) {
+                Neighbor& nb = neighbor[i][j][k];
+                if ( nb.send_list.empty() && nb.recv_list.empty() )
+                    continue;
+                nb.recv_buf.resize(N_fields*nb.recv_list.size());
+                MPI_Irecv( nb.recv_buf.data(), nb.recv_buf.size(), MPI_DOUBLE, nb.rank,
+                    tag[2-i][2-j][2-k], comm, &nb.recv_req );
+            }
+        }
+    }
+    // Pack the fields and start the sends
+    for (int i=0; i<3; i++) {
+        for (int j=0; j<3; j++) {
+            for (int k=0; k<3; k++) {
+                Neighbor& nb = neighbor[i][j][k];
+                if ( nb.send_list.empty() && nb.recv_list.empty() )
+                    continue;
+                const int N = nb.send_list.size();
+                nb.send_buf.resize(N_fields*N);
+                for (int f=0; f<N_fields; f++)
+                    PackMeshData( nb.send_list.data(), N, &nb.send_buf[f*N], fields[f]->data() );
+                MPI_Isend( nb.send_buf.data(), nb.send_buf.size(), MPI_DOUBLE, nb.rank,
+                    tag[i][j][k], comm, &nb.send_req );
+            }
+        }
+    }
+}
+void MeshHaloExchange::wait( )
+{
+    const int N_fields = active.size();
+    // Recv the data and unpack
+    for (int i=0; i<3; i++) {
+        for (int j=0; j<3; j++) {
+            for (int k=0; k<3; k++) {
+                Neighbor& nb = neighbor[i][j][k];
+                if ( nb.send_list.empty() && nb.recv_list.empty() )
+                    continue;
+                MPI_Wait( &nb.recv_req, MPI_STATUS_IGNORE );
+                const int N = nb.recv_list.size();
+                for (int f=0; f<N_fields; f++)
+                    UnpackMeshData( nb.recv_list.data(), N, &nb.recv_buf[f*N], active[f]->data() );
+            }
+        }
+    }
+    // Wait until all sends have completed
+    for (int i=0; i<3; i++) {
+        for (int j=0; j<3; j++) {
+            for (int k=0; k<3; k++) {
+                Neighbor& nb = neighbor[i][j][k];
+                if ( nb.send_list.empty() && nb.recv_list.empty() )
+                    continue;
+                MPI_Wait( &nb.send_req, MPI_STATUS_IGNORE );
+            }
+        }
+    }
+    active.clear();
+}
+void MeshHaloExchange::fill( const std::vector<DoubleArray*>& fields )
+{
+    start( fields );
+    wait( );
+}
+
+
 /********************************************************
 *  Deprecated functions                                 *
 ********************************************************/
@@ -22,6 +22,7 @@
 #include "common/Array.h"
 
 #include <array>
+#include <vector>
 
 // ********** COMMUNICTION **************************************
 /*
@@ -119,6 +120,65 @@ private:
 };
 
 
+/*!
+ * @brief  Communicate the mesh halo of several fields
+ * @details  Exchange the halo values of any number of fields with one message per
+ *    neighbor.  The values exchanged with the face and edge neighbors are given by
+ *    lists of the local indices to send and recieve (see Domain::CommInit).  The
+ *    exchange may be started and completed separately to overlap it with work that
+ *    does not need the halos.
+ */
+class MeshHaloExchange
+{
+public:
+    /*!
+     * @brief  Default constructor
+     * @param[in] comm          Communicator
+     * @param[in] info          Rank and neighbor rank info
+     * @param[in] tag           Initial tag to use for the communication (we will require tag:tag+26)
+     */
+    MeshHaloExchange( MPI_Comm comm, const RankInfoStruct& info, int tag );
+
+    /*!
+     * @brief  Set the lists of the neighbor (i,j,k), i,j,k = -1,0,1
+     * @param[in] sendCount     Number of values to send
+     * @param[in] sendList      Local indices of the values to send
+     * @param[in] recvCount     Number of values to recieve
+     * @param[in] recvList      Local indices of the values to recieve
+     */
+    void setLists( int i, int j, int k, int sendCount, const int *sendList, int recvCount, const int *recvList );
+
+    /*!
+     * @brief  Start the communication
+     * @details  The fields may not be modified until wait() returns
+     * @param[in] fields        The fields on which we fill the halos
+     */
+    void start( const std::vector<DoubleArray*>& fields );
+
+    //! Wait for the communication to finish and fill the halos
+    void wait( );
+
+    //! Communicate the halos (start and wait)
+    void fill( const std::vector<DoubleArray*>& fields );
+
+private:
+    struct Neighbor {
+        int rank;
+        std::vector<int> send_list, recv_list;
+        std::vector<double> send_buf, recv_buf;
+        MPI_Request send_req, recv_req;
+    };
+    MPI_Comm comm;
+    RankInfoStruct info;
+    int tag[3][3][3];
+    Neighbor neighbor[3][3][3];
+    std::vector<DoubleArray*> active;
+    MeshHaloExchange();                                     // Private empty constructor
+    MeshHaloExchange(const MeshHaloExchange&);              // Private copy constructor
+    MeshHaloExchange& operator=(const MeshHaloExchange&);   // Private assignment operator
+};
+
+
 //***************************************************************************************
 inline void PackMeshData(int *list, int count, double *sendbuf, double *data){
 	// Fill in the phase ID values from neighboring processors
@@ -31,6 +31,8 @@
 #include "common/MPI_Helpers.h"
 #include "common/Communication.h"
 
+#include "zlib.h"
+
 // Inline function to read line without a return argument
 static inline void fgetl( char * str, int num, FILE * stream )
 {
@@ -38,6 +40,67 @@ static inline void fgetl( char * str, int num, FILE * stream )
     if ( 0 ) {char *temp = (char *)&ptr; temp++;}
 }
 
+
+// Clamp a global image coordinate to [start,size-1]
+static inline int64_t ImageClamp( int64_t x, int64_t start, int64_t size )
+{
+    if ( x < start )
+        x = start;
+    if ( !( x < size ) )
+        x = size - 1;
+    return x;
+}
+
+// Read the brick first:last (inclusive, x fastest) of a raw image with collective MPI-IO
+// readers sets the number of MPI-IO aggregators (cb_nodes hint), 0 for the MPI-IO default
+template<class TYPE>
+static std::vector<TYPE> ReadImageBrick( const std::string& filename, MPI_Datatype type, const int64_t global[3],
+    const int64_t first[3], const int64_t last[3], int readers, MPI_Comm comm )
+{
+    int sizes[3], subsizes[3], starts[3];
+    for ( int d = 0; d < 3; d++ ) {
+        sizes[2-d]    = global[d];
+        subsizes[2-d] = last[d] - first[d] + 1;
+        starts[2-d]   = first[d];
+    }
+    std::vector<TYPE> data( (size_t) subsizes[0] * subsizes[1] * subsizes[2] );
+    MPI_Datatype filetype;
+    MPI_Type_create_subarray( 3, sizes, subsizes, starts, MPI_ORDER_C, type, &filetype );
+    MPI_Type_commit( &filetype );
+    MPI_Info info;
+    MPI_Info_create( &info );
+    if ( readers > 0 )
+        MPI_Info_set( info, "cb_nodes", const_cast<char*>( std::to_string( readers ).c_str() ) );
+    MPI_File fid;
+    if ( MPI_File_open( comm, const_cast<char*>( filename.c_str() ), MPI_MODE_RDONLY, info, &fid ) != MPI_SUCCESS )
+        ERROR( "Domain.cpp: Error reading " + filename );
+    MPI_File_set_view( fid, 0, type, filetype, const_cast<char*>( "native" ), info );
+    MPI_Status status;
+    MPI_File_read_all( fid, data.data(), data.size(), type, &status );
+    int count = 0;
+    MPI_Get_count( &status, type, &count );
+    MPI_File_close( &fid );
+    MPI_Type_free( &filetype );
+    MPI_Info_free( &info );
+    if ( count != (int) data.size() )
+        ERROR( "Domain.cpp: Error reading " + filename + " (short read)" );
+    return data;
+}
+
+// Read a brick of an 8 or 16 bit segmented image as labels
+static std::vector<char> ReadImageBrick( const std::string& filename, const std::string& ReadType, const int64_t global[3],
+    const int64_t first[3], const int64_t last[3], int readers, MPI_Comm comm )
+{
+    if ( ReadType == "16bit" ) {
+        auto InputData = ReadImageBrick<short int>( filename, MPI_SHORT, global, first, last, readers, comm );
+        std::vector<char> data( InputData.size() );
+        for ( size_t n = 0; n < data.size(); n++ )
+            data[n] = char( InputData[n] );
+        return data;
+    }
+    return ReadImageBrick<char>( filename, MPI_CHAR, global, first, last, readers, comm );
+}
+
 /********************************************************
  * Constructors/Destructor                               *
  ********************************************************/
@@ -347,8 +410,11 @@ void Domain::Decomp( const std::string& Filename )
 	global_Ny = SIZE[1];
 	global_Nz = SIZE[2];
 	nprocs=nprocx*nprocy*nprocz;
-	char *SegData = NULL;
-	
+	int readers = 0;
+	if (database->keyExists( "ReadRanks" )){
+		readers = database->getScalar<int>( "ReadRanks" );
+	}
+
 	if (RANK==0){
 		printf("Input media: %s\n",Filename.c_str());
 		printf("Relabeling %lu values\n",ReadValues.size());
@@ -357,284 +423,167 @@ void Domain::Decomp( const std::string& Filename )
 			int newvalue=WriteValues[idx];
 			printf("oldvalue=%d, newvalue =%d \n",oldvalue,newvalue);
 		}
-
-		// Rank=0 reads the entire segmented data and distributes to worker processes
 		printf("Dimensions of segmented image: %ld x %ld x %ld \n",global_Nx,global_Ny,global_Nz);
-		int64_t SIZE = global_Nx*global_Ny*global_Nz;
-		SegData = new char[SIZE];
-		if (ReadType == "8bit"){
-			printf("Reading 8-bit input data \n");
-			FILE *SEGDAT = fopen(Filename.c_str(),"rb");
-			if (SEGDAT==NULL) ERROR("Domain.cpp: Error reading segmented data");
-			size_t ReadSeg;
-			ReadSeg=fread(SegData,1,SIZE,SEGDAT);
-			if (ReadSeg != size_t(SIZE)) printf("Domain.cpp: Error reading segmented data \n");
-			fclose(SEGDAT);
-		}
-		else if (ReadType == "16bit"){
-			printf("Reading 16-bit input data \n");
-			short int *InputData;
-			InputData = new short int[SIZE];
-			FILE *SEGDAT = fopen(Filename.c_str(),"rb");
-			if (SEGDAT==NULL) ERROR("Domain.cpp: Error reading segmented data");
-			size_t ReadSeg;
-			ReadSeg=fread(InputData,2,SIZE,SEGDAT);
-			if (ReadSeg != size_t(SIZE)) printf("Domain.cpp: Error reading segmented data \n");
-			fclose(SEGDAT);
-			for (int n=0; n<SIZE; n++){
-				SegData[n] = char(InputData[n]);
-			}
-		}
-		printf("Read segmented data from %s \n",Filename.c_str());
+		printf("Distributing subdomains across %i processors \n",nprocs);
+		printf("Process grid: %i x %i x %i \n",nprocx,nprocy,nprocz);
+		printf("Subdomain size: %i x %i x %i \n",nx,ny,nz);
+	}
 
-		// relabel the data
-		std::vector<long int> LabelCount(ReadValues.size(),0);
-		for (int k = 0; k<global_Nz; k++){
-			for (int j = 0; j<global_Ny; j++){
-				for (int i = 0; i<global_Nx; i++){
-					n = k*global_Nx*global_Ny+j*global_Nx+i;
-					//char locval = loc_id[n];
-					char locval = SegData[n];
-					for (size_t idx=0; idx<ReadValues.size(); idx++){
-						signed char oldvalue=ReadValues[idx];
-						signed char newvalue=WriteValues[idx];
-						if (locval == oldvalue){
-							SegData[n] = newvalue;
-							LabelCount[idx]++;
-							idx = ReadValues.size();
-						}
+	// number of sites to use for periodic boundary condition transition zone
+	int64_t z_transition_size = (nprocz*nz - (global_Nz - zStart))/2;
+	if (z_transition_size < 0) z_transition_size=0;
+	if (RANK==0) printf("Size of transition region: %ld \n", z_transition_size);
+
+	// Each rank reads the part of the image under its subdomain (including the halo)
+	int64_t global[3] = { global_Nx, global_Ny, global_Nz };
+	int64_t start[3] = { xStart, yStart, zStart };
+	int64_t offset[3] = { xStart + rank_info.ix*nx - 1, yStart + rank_info.jy*ny - 1, zStart + rank_info.kz*nz - 1 - z_transition_size };
+	int64_t first[3], last[3], owned_first[3], owned_last[3];
+	int local_size[3] = { nx, ny, nz };
+	for (int d=0; d<3; d++){
+		first[d] = ImageClamp(offset[d],start[d],global[d]);
+		last[d] = ImageClamp(offset[d]+local_size[d]+1,start[d],global[d]);
+		owned_first[d] = offset[d]+1;
+		owned_last[d] = offset[d]+local_size[d];
+	}
+	if (RANK==0){
+		if (ReadType == "8bit") printf("Reading 8-bit input data \n");
+		else printf("Reading 16-bit input data \n");
+	}
+	std::vector<char> SegData = ReadImageBrick(Filename, ReadType, global, first, last, readers, Comm);
+	// planes used by the mixed reflection pattern
+	bool reflection = !USE_CHECKER && (inlet_layers_z > 0 || outlet_layers_z > 0);
+	std::vector<char> InletPlane, OutletPlane;
+	if (reflection){
+		int64_t plane_first[3] = { first[0], first[1], zStart + nz*nprocz - 1 };
+		int64_t plane_last[3] = { last[0], last[1], zStart + nz*nprocz - 1 };
+		InletPlane = ReadImageBrick(Filename, ReadType, global, plane_first, plane_last, readers, Comm);
+		plane_first[2] = plane_last[2] = zStart;
+		OutletPlane = ReadImageBrick(Filename, ReadType, global, plane_first, plane_last, readers, Comm);
+	}
+	if (RANK==0) printf("Read segmented data from %s \n",Filename.c_str());
+
+	// relabel the data
+	int64_t bx = last[0]-first[0]+1;
+	int64_t by = last[1]-first[1]+1;
+	int64_t bz = last[2]-first[2]+1;
+	std::vector<long int> LabelCount(ReadValues.size(),0);
+	for (k=0; k<bz; k++){
+		for (j=0; j<by; j++){
+			for (i=0; i<bx; i++){
+				int64_t x = first[0]+i;
+				int64_t y = first[1]+j;
+				int64_t z = first[2]+k;
+				bool owned = x >= owned_first[0] && x <= owned_last[0] && y >= owned_first[1] && y <= owned_last[1]
+						&& z >= owned_first[2] && z <= owned_last[2];
+				n = k*bx*by+j*bx+i;
+				char locval = SegData[n];
+				for (size_t idx=0; idx<ReadValues.size(); idx++){
+					signed char oldvalue=ReadValues[idx];
+					signed char newvalue=WriteValues[idx];
+					if (locval == oldvalue){
+						SegData[n] = newvalue;
+						if (owned) LabelCount[idx]++;
+						idx = ReadValues.size();
 					}
 				}
 			}
 		}
+	}
+	for (size_t p=0; p<InletPlane.size(); p++){
 		for (size_t idx=0; idx<ReadValues.size(); idx++){
-			long int label=ReadValues[idx];
-			long int count=LabelCount[idx];
-			printf("Label=%ld, Count=%ld \n",label,count);
+			if (InletPlane[p] == (signed char) ReadValues[idx]){ InletPlane[p] = WriteValues[idx]; break; }
 		}
-		if (USE_CHECKER) {
-			if (inlet_layers_x > 0){
-				// use checkerboard pattern
-				printf("Checkerboard pattern at x inlet for %i layers \n",inlet_layers_x);
-				for (int k = 0; k<global_Nz; k++){
-					for (int j = 0; j<global_Ny; j++){
-						for (int i = xStart; i < xStart+inlet_layers_x; i++){
-							if ( (j/checkerSize + k/checkerSize)%2 == 0){
-								// void checkers
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = 2;
-							}
-							else{
-								// solid checkers
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = 0;
-							}
-						}
-					}
-				}
-			}
-
-			if (inlet_layers_y > 0){
-				printf("Checkerboard pattern at y inlet for %i layers \n",inlet_layers_y);
-				// use checkerboard pattern
-				for (int k = 0; k<global_Nz; k++){
-					for (int j = yStart; j < yStart+inlet_layers_y; j++){
-						for (int i = 0; i<global_Nx; i++){
-							if ( (i/checkerSize + k/checkerSize)%2 == 0){
-								// void checkers
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = 2;
-							}
-							else{
-								// solid checkers
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = 0;
-							}
-						}
-					}
-				}
-			}
-
-			if (inlet_layers_z > 0){
-				printf("Checkerboard pattern at z inlet for %i layers, saturated with phase label=%i \n",inlet_layers_z,inlet_layers_phase);
-				// use checkerboard pattern
-				for (int k = zStart; k < zStart+inlet_layers_z; k++){
-					for (int j = 0; j<global_Ny; j++){
-						for (int i = 0; i<global_Nx; i++){
-							if ( (i/checkerSize+j/checkerSize)%2 == 0){
-								// void checkers
-								//SegData[k*global_Nx*global_Ny+j*global_Nx+i] = 2;
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = inlet_layers_phase;
-							}
-							else{
-								// solid checkers
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = 0;
-							}
-						}
-					}
-				}
-			}
-
-			if (outlet_layers_x > 0){
-				// use checkerboard pattern
-				printf("Checkerboard pattern at x outlet for %i layers \n",outlet_layers_x);
-				for (int k = 0; k<global_Nz; k++){
-					for (int j = 0; j<global_Ny; j++){
-						for (int i = xStart + nx*nprocx - outlet_layers_x; i <  xStart + nx*nprocx; i++){
-							if ( (j/checkerSize + k/checkerSize)%2 == 0){
-								// void checkers
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = 2;
-							}
-							else{
-								// solid checkers
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = 0;
-							}
-						}
-					}
-				}
-			}
-
-			if (outlet_layers_y > 0){
-				printf("Checkerboard pattern at y outlet for %i layers \n",outlet_layers_y);
-				// use checkerboard pattern
-				for (int k = 0; k<global_Nz; k++){
-					for (int j = yStart + ny*nprocy - outlet_layers_y; j < yStart + ny*nprocy; j++){
-						for (int i = 0; i<global_Nx; i++){
-							if ( (i/checkerSize + k/checkerSize)%2 == 0){
-								// void checkers
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = 2;
-							}
-							else{
-								// solid checkers
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = 0;
-
-							}
-						}
-					}
-				}
-			}
-
-			if (outlet_layers_z > 0){
-				printf("Checkerboard pattern at z outlet for %i layers, saturated with phase label=%i \n",outlet_layers_z,outlet_layers_phase);
-				// use checkerboard pattern
-				for (int k = zStart + nz*nprocz - outlet_layers_z; k < zStart + nz*nprocz; k++){
-					for (int j = 0; j<global_Ny; j++){
-						for (int i = 0; i<global_Nx; i++){
-							if ( (i/checkerSize+j/checkerSize)%2 == 0){
-								// void checkers
-								//SegData[k*global_Nx*global_Ny+j*global_Nx+i] = 2;
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = outlet_layers_phase;
-							}
-							else{
-								// solid checkers
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = 0;
-							}
-						}
-					}
-				}
-			}
+		for (size_t idx=0; idx<ReadValues.size(); idx++){
+			if (OutletPlane[p] == (signed char) ReadValues[idx]){ OutletPlane[p] = WriteValues[idx]; break; }
 		}
-		else {
-			if (inlet_layers_z > 0){
-				printf("Mixed reflection pattern at z inlet for %i layers, saturated with phase label=%i \n",inlet_layers_z,inlet_layers_phase);
-				for (int k = zStart; k < zStart+inlet_layers_z; k++){
-					for (int j = 0; j<global_Ny; j++){
-						for (int i = 0; i<global_Nx; i++){
-							signed char local_id = SegData[k*global_Nx*global_Ny+j*global_Nx+i];
-							signed char reflection_id = SegData[(zStart + nz*nprocz - 1)*global_Nx*global_Ny+j*global_Nx+i];
-							if ( local_id < 1 && reflection_id > 0){
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = reflection_id;
-							}
-						}
-					}
+	}
+	// Each image cell is counted once, by the rank that owns it, so the totals cover only the part of
+	// the image under the process grid (the whole image when the subdomains span it)
+	if (RANK==0) printf("Label counts over the image cells owned by the subdomains: \n");
+	MPI_Allreduce(MPI_IN_PLACE,LabelCount.data(),LabelCount.size(),MPI_LONG,MPI_SUM,Comm);
+	for (size_t idx=0; idx<ReadValues.size(); idx++){
+		long int label=ReadValues[idx];
+		long int count=LabelCount[idx];
+		if (RANK==0) printf("Label=%ld, Count=%ld \n",label,count);
+	}
+	if (USE_CHECKER) {
+		if (RANK==0){
+			if (inlet_layers_x > 0) printf("Checkerboard pattern at x inlet for %i layers \n",inlet_layers_x);
+			if (inlet_layers_y > 0) printf("Checkerboard pattern at y inlet for %i layers \n",inlet_layers_y);
+			if (inlet_layers_z > 0) printf("Checkerboard pattern at z inlet for %i layers, saturated with phase label=%i \n",inlet_layers_z,inlet_layers_phase);
+			if (outlet_layers_x > 0) printf("Checkerboard pattern at x outlet for %i layers \n",outlet_layers_x);
+			if (outlet_layers_y > 0) printf("Checkerboard pattern at y outlet for %i layers \n",outlet_layers_y);
+			if (outlet_layers_z > 0) printf("Checkerboard pattern at z outlet for %i layers, saturated with phase label=%i \n",outlet_layers_z,outlet_layers_phase);
+		}
+		// use checkerboard pattern (void checkers get the phase label, solid checkers are 0)
+		for (k=0; k<bz; k++){
+			for (j=0; j<by; j++){
+				for (i=0; i<bx; i++){
+					int64_t x = first[0]+i;
+					int64_t y = first[1]+j;
+					int64_t z = first[2]+k;
+					char &value = SegData[k*bx*by+j*bx+i];
+					if (x >= xStart && x < xStart+inlet_layers_x)
+						value = ( (y/checkerSize + z/checkerSize)%2 == 0 ) ? 2 : 0;
+					if (y >= yStart && y < yStart+inlet_layers_y)
+						value = ( (x/checkerSize + z/checkerSize)%2 == 0 ) ? 2 : 0;
+					if (z >= zStart && z < zStart+inlet_layers_z)
+						value = ( (x/checkerSize + y/checkerSize)%2 == 0 ) ? inlet_layers_phase : 0;
+					if (x >= xStart + nx*nprocx - outlet_layers_x && x < xStart + nx*nprocx)
+						value = ( (y/checkerSize + z/checkerSize)%2 == 0 ) ? 2 : 0;
+					if (y >= yStart + ny*nprocy - outlet_layers_y && y < yStart + ny*nprocy)
+						value = ( (x/checkerSize + z/checkerSize)%2 == 0 ) ? 2 : 0;
+					if (z >= zStart + nz*nprocz - outlet_layers_z && z < zStart + nz*nprocz)
+						value = ( (x/checkerSize + y/checkerSize)%2 == 0 ) ? outlet_layers_phase : 0;
 				}
 			}
-			if (outlet_layers_z > 0){
-				printf("Mixed reflection pattern at z outlet for %i layers, saturated with phase label=%i \n",outlet_layers_z,outlet_layers_phase);
-				for (int k = zStart + nz*nprocz - outlet_layers_z; k < zStart + nz*nprocz; k++){
-					for (int j = 0; j<global_Ny; j++){
-						for (int i = 0; i<global_Nx; i++){
-							signed char local_id = SegData[k*global_Nx*global_Ny+j*global_Nx+i];
-							signed char reflection_id = SegData[zStart*global_Nx*global_Ny+j*global_Nx+i];
-							if ( local_id < 1 && reflection_id > 0){
-								SegData[k*global_Nx*global_Ny+j*global_Nx+i] = reflection_id;
-							}
-						}
+		}
+	}
+	else if (reflection) {
+		if (RANK==0){
+			if (inlet_layers_z > 0) printf("Mixed reflection pattern at z inlet for %i layers, saturated with phase label=%i \n",inlet_layers_z,inlet_layers_phase);
+			if (outlet_layers_z > 0) printf("Mixed reflection pattern at z outlet for %i layers, saturated with phase label=%i \n",outlet_layers_z,outlet_layers_phase);
+		}
+		// the outlet reflects the first layer after the inlet pattern has been applied to it
+		for (size_t p=0; p<OutletPlane.size(); p++){
+			if (inlet_layers_z > 0 && OutletPlane[p] < 1 && InletPlane[p] > 0) OutletPlane[p] = InletPlane[p];
+		}
+		for (k=0; k<bz; k++){
+			int64_t z = first[2]+k;
+			const std::vector<char> *source = NULL;
+			if (z >= zStart && z < zStart+inlet_layers_z) source = &InletPlane;
+			else if (z >= zStart + nz*nprocz - outlet_layers_z && z < zStart + nz*nprocz) source = &OutletPlane;
+			if (source == NULL) continue;
+			for (j=0; j<by; j++){
+				for (i=0; i<bx; i++){
+					signed char local_id = SegData[k*bx*by+j*bx+i];
+					signed char reflection_id = (*source)[j*bx+i];
+					if ( local_id < 1 && reflection_id > 0){
+						SegData[k*bx*by+j*bx+i] = reflection_id;
 					}
 				}
 			}
 		}
 	}
-	
-	// Get the rank info
-	int64_t N = (nx+2)*(ny+2)*(nz+2);
 
-	// number of sites to use for periodic boundary condition transition zone
-	int64_t z_transition_size = (nprocz*nz - (global_Nz - zStart))/2;
-	if (z_transition_size < 0) z_transition_size=0;
-
-	char LocalRankFilename[40];
-	char *loc_id;
-	loc_id = new char [(nx+2)*(ny+2)*(nz+2)];
-
-	// Set up the sub-domains
-	if (RANK==0){
-		printf("Distributing subdomains across %i processors \n",nprocs);
-		printf("Process grid: %i x %i x %i \n",nprocx,nprocy,nprocz);
-		printf("Subdomain size: %i x %i x %i \n",nx,ny,nz);
-		printf("Size of transition region: %ld \n", z_transition_size);
-
-		for (int kp=0; kp<nprocz; kp++){
-			for (int jp=0; jp<nprocy; jp++){
-				for (int ip=0; ip<nprocx; ip++){
-					// rank of the process that gets this subdomain
-					int rnk = kp*nprocx*nprocy + jp*nprocx + ip;
-					// Pack and send the subdomain for rnk
-					for (k=0;k<nz+2;k++){
-						for (j=0;j<ny+2;j++){
-							for (i=0;i<nx+2;i++){
-								int64_t x = xStart + ip*nx + i-1;
-								int64_t y = yStart + jp*ny + j-1;
-								// int64_t z = zStart + kp*nz + k-1;
-								int64_t z = zStart + kp*nz + k-1 - z_transition_size;
-								if (x<xStart) 	x=xStart;
-								if (!(x<global_Nx))	x=global_Nx-1;
-								if (y<yStart) 	y=yStart;
-								if (!(y<global_Ny))	y=global_Ny-1;
-								if (z<zStart) 	z=zStart;
-								if (!(z<global_Nz))	z=global_Nz-1;
-								int64_t nlocal = k*(nx+2)*(ny+2) + j*(nx+2) + i;
-								int64_t nglobal = z*global_Nx*global_Ny+y*global_Nx+x;
-								loc_id[nlocal] = SegData[nglobal];
-							}
-						}
-					}
-					if (rnk==0){
-						for (k=0;k<nz+2;k++){
-							for (j=0;j<ny+2;j++){
-								for (i=0;i<nx+2;i++){
-									int nlocal = k*(nx+2)*(ny+2) + j*(nx+2) + i;
-									id[nlocal] = loc_id[nlocal];
-								}
-							}
-						}
-					}
-					else{
-						//printf("Sending data to process %i \n", rnk);
-						MPI_Send(loc_id,N,MPI_CHAR,rnk,15,Comm);
-					}
-					// Write the data for this rank data 
-					sprintf(LocalRankFilename,"ID.%05i",rnk+rank_offset);
-					FILE *ID = fopen(LocalRankFilename,"wb");
-					fwrite(loc_id,1,(nx+2)*(ny+2)*(nz+2),ID);
-					fclose(ID);
-				}
+	// Copy the subdomain (the halo is clamped to the image)
+	for (k=0;k<nz+2;k++){
+		for (j=0;j<ny+2;j++){
+			for (i=0;i<nx+2;i++){
+				int64_t x = ImageClamp(offset[0]+i,start[0],global[0]) - first[0];
+				int64_t y = ImageClamp(offset[1]+j,start[1],global[1]) - first[1];
+				int64_t z = ImageClamp(offset[2]+k,start[2],global[2]) - first[2];
+				id[k*(nx+2)*(ny+2) + j*(nx+2) + i] = SegData[z*bx*by+y*bx+x];
 			}
 		}
-
-	}
-	else{
-		// Recieve the subdomain from rank = 0
-		//printf("Ready to recieve data %i at process %i \n", N,rank);
-		MPI_Recv(id,N,MPI_CHAR,0,15,Comm,MPI_STATUS_IGNORE);
 	}
-	//Comm.barrier();
+	// Write the data for this rank
+	char LocalRankFilename[40];
+	sprintf(LocalRankFilename,"ID.%05i",RANK+rank_offset);
+	FILE *ID = fopen(LocalRankFilename,"wb");
+	fwrite(id,1,(nx+2)*(ny+2)*(nz+2),ID);
+	fclose(ID);
 	MPI_Barrier(Comm);
 	// Compute the porosity
 	double sum;
@@ -693,7 +642,7 @@ void Domain::Decomp( const std::string& Filename )
 }
 
 
-void Domain::AggregateLabels( const std::string& filename ){
+void Domain::AggregateLabels( const std::string& filename, bool compress ){
 	
 	int nx = Nx;
 	int ny = Ny;
@@ -713,10 +662,8 @@ void Domain::AggregateLabels( const std::string& filename ){
 	int full_ny = npy*(ny-2);
 	int full_nz = npz*(nz-2);
 	int local_size = (nx-2)*(ny-2)*(nz-2);
-	unsigned long int full_size = long(full_nx)*long(full_ny)*long(full_nz);
 	
-	signed char *LocalID;
-	LocalID = new signed char [local_size];
+	std::vector<signed char> LocalID(local_size);
 		
 	//printf("aggregate labels: local size=%i, global size = %i",local_size, full_size);
 	// assign the ID for the local sub-region
@@ -729,58 +676,48 @@ void Domain::AggregateLabels( const std::string& filename ){
 			}
 		}
 	}
-	MPI_Barrier(Comm);
 
-	// populate the FullID 
-	if (rank() == 0){
-		signed char *FullID;
-		FullID = new signed char [full_size];
-		// first handle local ID for rank 0
-		for (int k=1; k<nz-1; k++){
-			for (int j=1; j<ny-1; j++){
-				for (int i=1; i<nx-1; i++){
-					int x = i-1;
-					int y = j-1;
-					int z = k-1;
-					int n_local = (k-1)*(nx-2)*(ny-2) + (j-1)*(nx-2) + i-1;
-					unsigned long int n_full = z*long(full_nx)*long(full_ny) + y*long(full_nx) + x;
-					FullID[n_full] = LocalID[n_local];
-				}
-			}
-		}
-		// next get the local ID from the other ranks
-		for (int rnk = 1; rnk<nprocs; rnk++){
-			ipz = rnk / (npx*npy);
-			ipy = (rnk - ipz*npx*npy) / npx;
-			ipx = (rnk - ipz*npx*npy - ipy*npx); 
-			//printf("ipx=%i ipy=%i ipz=%i\n", ipx, ipy, ipz);
-			int tag = 15+rnk;
-			MPI_Recv(LocalID,local_size,MPI_CHAR,rnk,tag,Comm,MPI_STATUS_IGNORE);
-			for (int k=1; k<nz-1; k++){
-				for (int j=1; j<ny-1; j++){
-					for (int i=1; i<nx-1; i++){
-						int x = i-1 + ipx*(nx-2);
-						int y = j-1 + ipy*(ny-2);
-						int z = k-1 + ipz*(nz-2);
-						int n_local = (k-1)*(nx-2)*(ny-2) + (j-1)*(nx-2) + i-1;
-						unsigned long int n_full = z*long(full_nx)*long(full_ny) + y*long(full_nx) + x;
-						FullID[n_full] = LocalID[n_local];
-					}
-				}
-			}
-		}
-		// write the output
-		FILE *OUTFILE = fopen(filename.c_str(),"wb");
-		fwrite(FullID,1,full_size,OUTFILE);
-		fclose(OUTFILE);
+	// each rank writes its sub-region directly into the shared file
+	MPI_File fid;
+	if (MPI_File_open(Comm,const_cast<char*>(filename.c_str()),MPI_MODE_CREATE|MPI_MODE_WRONLY,MPI_INFO_NULL,&fid) != MPI_SUCCESS)
+		ERROR("Domain.cpp: Error writing " + filename);
+	MPI_File_set_size(fid,0);
+	if (!compress){
+		// raw global image (x fastest)
+		int sizes[3] = { full_nz, full_ny, full_nx };
+		int subsizes[3] = { nz-2, ny-2, nx-2 };
+		int starts[3] = { ipz*(nz-2), ipy*(ny-2), ipx*(nx-2) };
+		MPI_Datatype filetype;
+		MPI_Type_create_subarray(3,sizes,subsizes,starts,MPI_ORDER_C,MPI_CHAR,&filetype);
+		MPI_Type_commit(&filetype);
+		MPI_File_set_view(fid,0,MPI_CHAR,filetype,const_cast<char*>("native"),MPI_INFO_NULL);
+		MPI_File_write_all(fid,LocalID.data(),local_size,MPI_CHAR,MPI_STATUS_IGNORE);
+		MPI_Type_free(&filetype);
 	}
-	else{
-		// send LocalID to rank=0
-		int tag = 15+ rank();
-		int dstrank = 0;
-		MPI_Send(LocalID,local_size,MPI_CHAR,dstrank,tag,Comm);
+	else {
+		// header, chunk table and one zlib chunk per rank (see Domain.h)
+		uLongf bytes = compressBound(local_size);
+		std::vector<Bytef> chunk(bytes);
+		if (compress2(chunk.data(),&bytes,(const Bytef*)LocalID.data(),local_size,Z_BEST_SPEED) != Z_OK)
+			ERROR("Domain.cpp: Error compressing labels");
+		uint64_t size = bytes, offset = 0;
+		MPI_Exscan(&size,&offset,1,MPI_UINT64_T,MPI_SUM,Comm);
+		if (rank() == 0) offset = 0;
+		offset += 64 + 16*nprocs;
+		uint64_t entry[2] = { offset, size };
+		std::vector<uint64_t> table(2*nprocs);
+		MPI_Gather(entry,2,MPI_UINT64_T,table.data(),2,MPI_UINT64_T,0,Comm);
+		if (rank() == 0){
+			int header[16] = { 0 };
+			memcpy(header,"LBPMZID",8);
+			int values[10] = { 1, full_nx, full_ny, full_nz, nx-2, ny-2, nz-2, npx, npy, npz };
+			memcpy(&header[2],values,sizeof(values));
+			MPI_File_write_at(fid,0,header,sizeof(header),MPI_BYTE,MPI_STATUS_IGNORE);
+			MPI_File_write_at(fid,sizeof(header),table.data(),16*nprocs,MPI_BYTE,MPI_STATUS_IGNORE);
+		}
+		MPI_File_write_at_all(fid,offset,chunk.data(),bytes,MPI_BYTE,MPI_STATUS_IGNORE);
 	}
-	MPI_Barrier(Comm);
+	MPI_File_close(&fid);
 
 }
 
@@ -1023,6 +960,26 @@ void Domain::CommInit()
 	for (int idx=0; idx<recvCount_yZ; idx++)    recvList_yZ[idx] -= (Ny-2)*Nx - (Nz-2)*Nx*Ny;
 	for (int idx=0; idx<recvCount_Yz; idx++)    recvList_Yz[idx] += (Ny-2)*Nx - (Nz-2)*Nx*Ny;
 	//......................................................................................
+	// Multi-field mesh halo exchange with the same lists
+	MeshHalo = std::shared_ptr<MeshHaloExchange>(new MeshHaloExchange(Comm,rank_info,32));
+	MeshHalo->setLists(-1,0,0,sendCount_x,sendList_x,recvCount_x,recvList_x);
+	MeshHalo->setLists(1,0,0,sendCount_X,sendList_X,recvCount_X,recvList_X);
+	MeshHalo->setLists(0,-1,0,sendCount_y,sendList_y,recvCount_y,recvList_y);
+	MeshHalo->setLists(0,1,0,sendCount_Y,sendList_Y,recvCount_Y,recvList_Y);
+	MeshHalo->setLists(0,0,-1,sendCount_z,sendList_z,recvCount_z,recvList_z);
+	MeshHalo->setLists(0,0,1,sendCount_Z,sendList_Z,recvCount_Z,recvList_Z);
+	MeshHalo->setLists(-1,-1,0,sendCount_xy,sendList_xy,recvCount_xy,recvList_xy);
+	MeshHalo->setLists(1,-1,0,sendCount_Xy,sendList_Xy,recvCount_Xy,recvList_Xy);
+	MeshHalo->setLists(-1,1,0,sendCount_xY,sendList_xY,recvCount_xY,recvList_xY);
+	MeshHalo->setLists(1,1,0,sendCount_XY,sendList_XY,recvCount_XY,recvList_XY);
+	MeshHalo->setLists(-1,0,-1,sendCount_xz,sendList_xz,recvCount_xz,recvList_xz);
+	MeshHalo->setLists(1,0,-1,sendCount_Xz,sendList_Xz,recvCount_Xz,recvList_Xz);
+	MeshHalo->setLists(-1,0,1,sendCount_xZ,sendList_xZ,recvCount_xZ,recvList_xZ);
+	MeshHalo->setLists(1,0,1,sendCount_XZ,sendList_XZ,recvCount_XZ,recvList_XZ);
+	MeshHalo->setLists(0,-1,-1,sendCount_yz,sendList_yz,recvCount_yz,recvList_yz);
+	MeshHalo->setLists(0,1,-1,sendCount_Yz,sendList_Yz,recvCount_Yz,recvList_Yz);
+	MeshHalo->setLists(0,-1,1,sendCount_yZ,sendList_yZ,recvCount_yZ,recvList_yZ);
+	MeshHalo->setLists(0,1,1,sendCount_YZ,sendList_YZ,recvCount_YZ,recvList_YZ);
 	// allocate recv buffers
 	recvBuf_x = new int [recvCount_x];
 	recvBuf_y = new int [recvCount_y];
@@ -1249,6 +1206,21 @@ void Domain::CommunicateMeshHalo(DoubleArray &Mesh)
 	UnpackMeshData(recvList_YZ, recvCount_YZ ,recvData_YZ, MeshData);
 }
 
+void Domain::CommunicateMeshHalo(const std::vector<DoubleArray*> &Mesh)
+{
+	MeshHalo->fill(Mesh);
+}
+
+void Domain::StartMeshHalo(const std::vector<DoubleArray*> &Mesh)
+{
+	MeshHalo->start(Mesh);
+}
+
+void Domain::WaitMeshHalo()
+{
+	MeshHalo->wait();
+}
+
 // TODO Ideally stuff below here should be moved somewhere else -- doesn't really belong here
 void WriteCheckpoint(const char *FILENAME, const double *cDen, const double *cfq, size_t Np)
 {
@@ -1316,11 +1288,10 @@ void Domain::ReadFromFile(const std::string& Filename,const std::string& Datatyp
     //       user needs to modify the input file accordingly before LBPM simulator read
     //       the input file.
 	//........................................................................................
-	int rank_offset = 0;
 	int RANK = rank();
-	int nprocs, nprocx, nprocy, nprocz, nx, ny, nz;
+	int nx, ny, nz;
 	int64_t global_Nx,global_Ny,global_Nz;
-	int64_t i,j,k,n;
+	int64_t i,j,k;
     //TODO These offset we may still need them
 	int64_t xStart,yStart,zStart;
 	xStart=yStart=zStart=0;
@@ -1330,7 +1301,6 @@ void Domain::ReadFromFile(const std::string& Filename,const std::string& Datatyp
     //      but user may have a user-specified size
 	auto size = database->getVector<int>( "n" );
 	auto SIZE = database->getVector<int>( "N" );
-	auto nproc = database->getVector<int>( "nproc" );
     //TODO currently the funcationality "offset" is disabled as the user-defined input data may have a different size from that of the input domain 
 	if (database->keyExists( "offset" )){
 		auto offset = database->getVector<int>( "offset" );
@@ -1342,113 +1312,49 @@ void Domain::ReadFromFile(const std::string& Filename,const std::string& Datatyp
 	nx = size[0];
 	ny = size[1];
 	nz = size[2];
-	nprocx = nproc[0];
-	nprocy = nproc[1];
-	nprocz = nproc[2];
 	global_Nx = SIZE[0];
 	global_Ny = SIZE[1];
 	global_Nz = SIZE[2];
-	nprocs=nprocx*nprocy*nprocz;
 
-	double *SegData = NULL;
+	int readers = 0;
+	if (database->keyExists( "ReadRanks" )){
+		readers = database->getScalar<int>( "ReadRanks" );
+	}
 	if (RANK==0){
 		printf("User-defined input file: %s (data type: %s)\n",Filename.c_str(),Datatype.c_str());
         printf("NOTE: currently only BC=0 or 5 supports user-defined input file!\n");
-		// Rank=0 reads the entire segmented data and distributes to worker processes
 		printf("Dimensions of the user-defined input file: %ld x %ld x %ld \n",global_Nx,global_Ny,global_Nz);
-		int64_t SIZE = global_Nx*global_Ny*global_Nz;
-
-		if (Datatype == "double"){
-			printf("Reading input data as double precision floating number\n");
-		    SegData = new double[SIZE];
-			FILE *SEGDAT = fopen(Filename.c_str(),"rb");
-			if (SEGDAT==NULL) ERROR("Domain.cpp: Error reading user-defined file!\n");
-			size_t ReadSeg;
-			ReadSeg=fread(SegData,8,SIZE,SEGDAT);
-			if (ReadSeg != size_t(SIZE)) printf("Domain.cpp: Error reading file: %s\n",Filename.c_str());
-			fclose(SEGDAT);
-		}
-        else{
-            ERROR("Error: User-defined input file only supports double-precision floating number!\n"); 
-        }
-		printf("Read file successfully from %s \n",Filename.c_str());
 	}
-	
-	// Get the rank info
-	int64_t N = (nx+2)*(ny+2)*(nz+2);
-
-	// number of sites to use for periodic boundary condition transition zone
-	//int64_t z_transition_size = (nprocz*nz - (global_Nz - zStart))/2;
-	//if (z_transition_size < 0) z_transition_size=0;
-	int64_t z_transition_size = 0;
-
-	//char LocalRankFilename[1000];//just for debug
-	double *loc_id;
-	loc_id = new double [(nx+2)*(ny+2)*(nz+2)];
+	if (Datatype != "double"){
+		ERROR("Error: User-defined input file only supports double-precision floating number!\n");
+	}
 
-	// Set up the sub-domains
-	if (RANK==0){
-        printf("Decomposing user-defined input file\n");
-		printf("Distributing subdomains across %i processors \n",nprocs);
-		printf("Process grid: %i x %i x %i \n",nprocx,nprocy,nprocz);
-		printf("Subdomain size: %i x %i x %i \n",nx,ny,nz);
-		printf("Size of transition region: %ld \n", z_transition_size);
+	// Each rank reads the part of the file under its subdomain (including the halo)
+	int64_t global[3] = { global_Nx, global_Ny, global_Nz };
+	int64_t start[3] = { xStart, yStart, zStart };
+	int64_t offset[3] = { xStart + rank_info.ix*nx - 1, yStart + rank_info.jy*ny - 1, zStart + rank_info.kz*nz - 1 };
+	int64_t first[3], last[3];
+	int local_size[3] = { nx, ny, nz };
+	for (int d=0; d<3; d++){
+		first[d] = ImageClamp(offset[d],start[d],global[d]);
+		last[d] = ImageClamp(offset[d]+local_size[d]+1,start[d],global[d]);
+	}
+	if (RANK==0) printf("Reading input data as double precision floating number\n");
+	std::vector<double> SegData = ReadImageBrick<double>(Filename, MPI_DOUBLE, global, first, last, readers, Comm);
+	if (RANK==0) printf("Read file successfully from %s \n",Filename.c_str());
 
-		for (int kp=0; kp<nprocz; kp++){
-			for (int jp=0; jp<nprocy; jp++){
-				for (int ip=0; ip<nprocx; ip++){
-					// rank of the process that gets this subdomain
-					int rnk = kp*nprocx*nprocy + jp*nprocx + ip;
-					// Pack and send the subdomain for rnk
-					for (k=0;k<nz+2;k++){
-						for (j=0;j<ny+2;j++){
-							for (i=0;i<nx+2;i++){
-								int64_t x = xStart + ip*nx + i-1;
-								int64_t y = yStart + jp*ny + j-1;
-								// int64_t z = zStart + kp*nz + k-1;
-								int64_t z = zStart + kp*nz + k-1 - z_transition_size;
-								if (x<xStart) 	x=xStart;
-								if (!(x<global_Nx))	x=global_Nx-1;
-								if (y<yStart) 	y=yStart;
-								if (!(y<global_Ny))	y=global_Ny-1;
-								if (z<zStart) 	z=zStart;
-								if (!(z<global_Nz))	z=global_Nz-1;
-								int64_t nlocal = k*(nx+2)*(ny+2) + j*(nx+2) + i;
-								int64_t nglobal = z*global_Nx*global_Ny+y*global_Nx+x;
-								loc_id[nlocal] = SegData[nglobal];
-							}
-						}
-					}
-					if (rnk==0){
-						for (k=0;k<nz+2;k++){
-							for (j=0;j<ny+2;j++){
-								for (i=0;i<nx+2;i++){
-									int nlocal = k*(nx+2)*(ny+2) + j*(nx+2) + i;
-									UserData[nlocal] = loc_id[nlocal];
-								}
-							}
-						}
-					}
-					else{
-						//printf("Sending data to process %i \n", rnk);
-						MPI_Send(loc_id,N,MPI_DOUBLE,rnk,15,Comm);
-					}
-					// Write the data for this rank data 
-                    // NOTE just for debug
-					//sprintf(LocalRankFilename,"%s.%05i",Filename.c_str(),rnk+rank_offset);
-					//FILE *ID = fopen(LocalRankFilename,"wb");
-					//fwrite(loc_id,8,(nx+2)*(ny+2)*(nz+2),ID);
-					//fclose(ID);
-				}
+	// Copy the subdomain (the halo is clamped to the file)
+	int64_t bx = last[0]-first[0]+1;
+	int64_t by = last[1]-first[1]+1;
+	for (k=0;k<nz+2;k++){
+		for (j=0;j<ny+2;j++){
+			for (i=0;i<nx+2;i++){
+				int64_t x = ImageClamp(offset[0]+i,start[0],global[0]) - first[0];
+				int64_t y = ImageClamp(offset[1]+j,start[1],global[1]) - first[1];
+				int64_t z = ImageClamp(offset[2]+k,start[2],global[2]) - first[2];
+				UserData[k*(nx+2)*(ny+2) + j*(nx+2) + i] = SegData[z*bx*by+y*bx+x];
 			}
 		}
-
-	}
-	else{
-		// Recieve the subdomain from rank = 0
-		//printf("Ready to recieve data %i at process %i \n", N,rank);
-		MPI_Recv(UserData,N,MPI_DOUBLE,0,15,Comm,MPI_STATUS_IGNORE);
 	}
-	//Comm.barrier();
 	MPI_Barrier(Comm);
 }
@@ -196,15 +196,28 @@ public: // Public variables (need to create accessors instead)
     void Decomp( const std::string& filename );
     void ReadFromFile(const std::string& Filename,const std::string& Datatype, double *UserData);
     void CommunicateMeshHalo(DoubleArray &Mesh);
+    //! Communicate the mesh halos of several fields with one message per neighbor
+    void CommunicateMeshHalo(const std::vector<DoubleArray*> &Mesh);
+    //! Start communicating the mesh halos of several fields (complete with WaitMeshHalo)
+    void StartMeshHalo(const std::vector<DoubleArray*> &Mesh);
+    void WaitMeshHalo();
     void CommInit(); 
     int PoreCount();
-    void AggregateLabels( const std::string& filename );
+    /*!
+     * Write the labels of the whole domain (without the halo) to one file with collective MPI-IO
+     * The raw file is the global 8 bit image. A compressed file starts with a 64 byte header
+     * ("LBPMZID", then int version, global size[3], subdomain size[3], process grid[3]),
+     * followed by a (uint64 offset, uint64 bytes) entry for each rank and a zlib chunk
+     * holding the subdomain of each rank
+     */
+    void AggregateLabels( const std::string& filename, bool compress = false );
 
 private:
 
     void PackID(int *list, int count, signed char *sendbuf, signed char *ID);
     void UnpackID(int *list, int count, signed char *recvbuf, signed char *ID);
     void CommHaloIDs();
+    std::shared_ptr<MeshHaloExchange> MeshHalo;
     
 	//......................................................................................
 	MPI_Request req1[18], req2[18];
@@ -227,6 +227,12 @@ inline std::vector<int> sumReduce( MPI_Comm comm, const std::vector<int>& x )
 	MPI_Allreduce(x.data(),y.data(),x.size(),MPI_INT,MPI_SUM,comm);
     return y;
 }
+inline std::vector<double> sumReduce( MPI_Comm comm, const std::vector<double>& x )
+{
+    auto y = x;
+	MPI_Allreduce(x.data(),y.data(),x.size(),MPI_DOUBLE,MPI_SUM,comm);
+    return y;
+}
 inline double maxReduce( MPI_Comm comm, double x )
 {
     double y = 0;
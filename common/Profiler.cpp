@@ -0,0 +1,232 @@
+#include "common/Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+
+namespace Utilities {
+
+
+// Accumulated time of a region over all threads
+struct ProfilerRecord {
+    double time = 0.0;
+    long long calls = 0;
+};
+
+// Maximum number of regions
+static const int profiler_max_regions = 1024;
+
+// Times of the regions of one thread, indexed by the region id.  Only the owning
+// thread writes; time and calls are atomic so that save/report can read them
+struct ProfilerThread {
+    struct Region {
+        double start = -1.0;
+        std::atomic<double> time{ 0.0 };
+        std::atomic<long long> calls{ 0 };
+    };
+    Region region[profiler_max_regions];
+};
+
+static std::atomic<int> profiler_level( 1 );
+static std::mutex profiler_mutex;
+static std::vector<std::string> profiler_names;
+static std::unordered_map<std::string,int> profiler_ids;
+static std::vector<std::unique_ptr<ProfilerThread>> profiler_threads;
+
+static inline double profilerTime()
+{
+    using namespace std::chrono;
+    return duration<double>( steady_clock::now().time_since_epoch() ).count();
+}
+
+// Regions of the current thread (kept after the thread exits so its times are reported)
+static ProfilerThread& profilerThread()
+{
+    thread_local ProfilerThread *thread = nullptr;
+    if ( thread == nullptr ) {
+        std::lock_guard<std::mutex> lock( profiler_mutex );
+        profiler_threads.emplace_back( new ProfilerThread );
+        thread = profiler_threads.back().get();
+    }
+    return *thread;
+}
+
+// Sum of the calls and time of each region over the threads (caller holds the lock)
+static std::map<std::string,ProfilerRecord> profilerRecords()
+{
+    std::map<std::string,ProfilerRecord> records;
+    for ( size_t id = 0; id < profiler_names.size(); id++ ) {
+        ProfilerRecord record;
+        for ( const auto& thread : profiler_threads ) {
+            record.time += thread->region[id].time.load( std::memory_order_relaxed );
+            record.calls += thread->region[id].calls.load( std::memory_order_relaxed );
+        }
+        if ( record.calls > 0 )
+            records[profiler_names[id]] = record;
+    }
+    return records;
+}
+
+
+int Profiler::id( const std::string& name )
+{
+    std::lock_guard<std::mutex> lock( profiler_mutex );
+    auto it = profiler_ids.find( name );
+    if ( it != profiler_ids.end() )
+        return it->second;
+    if ( (int) profiler_names.size() >= profiler_max_regions )
+        return -1;
+    int id = profiler_names.size();
+    profiler_names.push_back( name );
+    profiler_ids[name] = id;
+    return id;
+}
+
+
+void Profiler::start( int id, int level )
+{
+    if ( level > profiler_level || id < 0 )
+        return;
+    profilerThread().region[id].start = profilerTime();
+}
+
+
+void Profiler::stop( int id, int level )
+{
+    if ( level > profiler_level || id < 0 )
+        return;
+    double stop = profilerTime();
+    auto& region = profilerThread().region[id];
+    if ( region.start < 0.0 )
+        return;
+    region.time.store( region.time.load( std::memory_order_relaxed ) + stop - region.start,
+        std::memory_order_relaxed );
+    region.calls.store( region.calls.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+    region.start = -1.0;
+}
+
+
+void Profiler::enable( int level ) { profiler_level = level; }
+
+
+void Profiler::disable() { profiler_level = -1; }
+
+
+void Profiler::reset()
+{
+    std::lock_guard<std::mutex> lock( profiler_mutex );
+    for ( auto& thread : profiler_threads ) {
+        for ( auto& region : thread->region ) {
+            region.time.store( 0.0, std::memory_order_relaxed );
+            region.calls.store( 0, std::memory_order_relaxed );
+        }
+    }
+}
+
+
+void Profiler::save( const std::string& filename, bool global )
+{
+    int rank = 0, initialized = 0, finalized = 0;
+    MPI_Initialized( &initialized );
+    MPI_Finalized( &finalized );
+    if ( initialized && !finalized )
+        MPI_Comm_rank( MPI_COMM_WORLD, &rank );
+    if ( !global && rank != 0 )
+        return;
+    char name[256];
+    snprintf( name, sizeof( name ), "%s.%i.timer", filename.c_str(), rank );
+    FILE *fid = fopen( name, "w" );
+    if ( fid == NULL )
+        return;
+    std::lock_guard<std::mutex> lock( profiler_mutex );
+    fprintf( fid, "region,calls,time\n" );
+    for ( const auto& record : profilerRecords() )
+        fprintf( fid, "\"%s\",%lli,%e\n", record.first.c_str(), record.second.calls, record.second.time );
+    fclose( fid );
+}
+
+
+void Profiler::report( MPI_Comm comm, FILE *fid )
+{
+    int rank, nprocs;
+    MPI_Comm_rank( comm, &rank );
+    MPI_Comm_size( comm, &nprocs );
+    std::map<std::string,ProfilerRecord> records;
+    {
+        std::lock_guard<std::mutex> lock( profiler_mutex );
+        records = profilerRecords();
+    }
+    // Union of the region names of all ranks
+    std::vector<char> names;
+    for ( const auto& record : records )
+        names.insert( names.end(), record.first.c_str(), record.first.c_str() + record.first.size() + 1 );
+    int size = names.size();
+    std::vector<int> sizes( nprocs ), disp( nprocs + 1, 0 );
+    MPI_Allgather( &size, 1, MPI_INT, sizes.data(), 1, MPI_INT, comm );
+    for ( int p = 0; p < nprocs; p++ )
+        disp[p + 1] = disp[p] + sizes[p];
+    std::vector<char> all_names( std::max( disp[nprocs], 1 ) );
+    MPI_Allgatherv( names.data(), size, MPI_CHAR, all_names.data(), sizes.data(), disp.data(), MPI_CHAR, comm );
+    std::set<std::string> regions;
+    for ( int n = 0; n < disp[nprocs]; n += strlen( &all_names[n] ) + 1 )
+        regions.insert( std::string( &all_names[n] ) );
+    // Combine the times: max of (time,-time) and sum of (time,calls)
+    int N = regions.size();
+    std::vector<double> max( 2 * N ), sum( 2 * N ), max_global( 2 * N ), sum_global( 2 * N );
+    int i = 0;
+    for ( const auto& region : regions ) {
+        auto it        = records.find( region );
+        double time    = it == records.end() ? 0.0 : it->second.time;
+        double calls   = it == records.end() ? 0.0 : double( it->second.calls );
+        max[2 * i]     = time;
+        max[2 * i + 1] = -time;
+        sum[2 * i]     = time;
+        sum[2 * i + 1] = calls;
+        i++;
+    }
+    MPI_Reduce( max.data(), max_global.data(), 2 * N, MPI_DOUBLE, MPI_MAX, 0, comm );
+    MPI_Reduce( sum.data(), sum_global.data(), 2 * N, MPI_DOUBLE, MPI_SUM, 0, comm );
+    if ( rank != 0 )
+        return;
+    // Print the regions with the most expensive first
+    std::vector<std::pair<double,int>> order( N );
+    for ( i = 0; i < N; i++ )
+        order[i] = std::pair<double,int>( -max_global[2 * i], i );
+    std::sort( order.begin(), order.end() );
+    std::vector<std::string> region_names( regions.begin(), regions.end() );
+    fprintf( fid, "Profile over %i ranks (wall time in seconds):\n", nprocs );
+    fprintf( fid, "  %-32s %12s %12s %12s %12s %10s\n", "region", "calls/rank", "min", "mean", "max", "max/mean" );
+    for ( const auto& entry : order ) {
+        i           = entry.second;
+        double mean = sum_global[2 * i] / nprocs;
+        fprintf( fid, "  %-32s %12.1f %12.4f %12.4f %12.4f %10.2f\n", region_names[i].c_str(),
+            sum_global[2 * i + 1] / nprocs, -max_global[2 * i + 1], mean, max_global[2 * i],
+            mean > 0.0 ? max_global[2 * i] / mean : 1.0 );
+    }
+}
+
+void Profiler::reportRate( MPI_Comm comm, double MLUPS, FILE *fid )
+{
+    int rank, nprocs;
+    MPI_Comm_rank( comm, &rank );
+    MPI_Comm_size( comm, &nprocs );
+    double MLUPS_min, MLUPS_max;
+    MPI_Reduce( &MLUPS, &MLUPS_min, 1, MPI_DOUBLE, MPI_MIN, 0, comm );
+    MPI_Reduce( &MLUPS, &MLUPS_max, 1, MPI_DOUBLE, MPI_MAX, 0, comm );
+    if ( rank != 0 )
+        return;
+    fprintf( fid, "Lattice update rate (per core)= %f MLUPS \n", MLUPS );
+    fprintf( fid, "Lattice update rate (per core, min / max)= %f / %f MLUPS \n", MLUPS_min, MLUPS_max );
+    fprintf( fid, "Lattice update rate (total)= %f MLUPS \n", MLUPS * nprocs );
+}
+
+
+} // namespace Utilities
@@ -0,0 +1,170 @@
+#ifndef included_Profiler
+#define included_Profiler
+
+#include <atomic>
+#include <string>
+#include <stdio.h>
+
+#include "mpi.h"
+
+/*
+Built-in profiler
+  Records the wall time and number of calls of each named region on every rank.
+  It is used by the PROFILE_* macros when the external timer utility is not
+  enabled (USE_TIMER), so that every build reports where the time is spent.
+  Each region name is registered once and given an id; the macros resolve the
+  id once per call site, so timing a region only reads the clock and updates an
+  array of the calling thread.  The threads are combined when the times are
+  saved or reported.  Nested regions report inclusive times.
+*/
+
+namespace Utilities {
+
+
+//! Region id of a call site of the PROFILE_* macros (-2 until it is looked up)
+struct ProfilerSite {
+    std::atomic<int> id{ -2 };
+};
+
+
+class Profiler
+{
+public:
+    //! Get the id of a region (registering the name the first time)
+    static int id( const std::string& name );
+
+    /*!
+     * Get the id of a region for a call site of the macros
+     * @details  The id of a string literal is looked up once and stored in the site,
+     *    other names (which may change between calls) are looked up on every call
+     * @param site      Id storage of the call site
+     * @param name      Name of the region
+     * @param level     Unused (allows the macros to pass the arguments of start)
+     */
+    template<size_t N>
+    static int id( ProfilerSite& site, const char ( &name )[N], int level = 0 )
+    {
+        int id = site.id.load( std::memory_order_relaxed );
+        if ( id == -2 ) {
+            id = Profiler::id( std::string( name ) );
+            site.id.store( id, std::memory_order_relaxed );
+        }
+        return id;
+    }
+    static int id( ProfilerSite&, const std::string& name, int level = 0 ) { return id( name ); }
+
+    //! Get the level from the arguments of the macros
+    template<class NAME>
+    static int level( const NAME&, int level = 0 ) { return level; }
+
+    /*!
+     * Start a region
+     * @param id        Id of the region (see id())
+     * @param level     Level of the region; it is only timed if level <= the enabled level
+     */
+    static void start( int id, int level = 0 );
+
+    //! Stop a region started with the same id and level
+    static void stop( int id, int level = 0 );
+
+    //! Start a region by name (looks up the id on every call)
+    static void start( const std::string& name, int level = 0 ) { start( id( name ), level ); }
+
+    //! Stop a region by name (looks up the id on every call)
+    static void stop( const std::string& name, int level = 0 ) { stop( id( name ), level ); }
+
+    //! Time the regions with level <= level (1 by default)
+    static void enable( int level = 1 );
+
+    //! Stop timing all regions
+    static void disable();
+
+    //! Clear the recorded times
+    static void reset();
+
+    /*!
+     * Write the times of this rank to <filename>.<rank>.timer
+     * @param filename  Base name of the file
+     * @param global    Write the file on every rank (otherwise only rank 0 writes)
+     */
+    static void save( const std::string& filename, bool global = false );
+
+    /*!
+     * Print the time of each region (min/mean/max over the ranks) and the number of calls
+     * @details  This is a collective call over comm; rank 0 prints the table
+     * @param comm      Communicator of the ranks to combine
+     * @param fid       File to print to on rank 0
+     */
+    static void report( MPI_Comm comm, FILE *fid = stdout );
+
+    /*!
+     * Print the lattice update rate per core (with its min / max over the ranks) and in total
+     * @details  This is a collective call over comm; rank 0 prints the rates.
+     *    The spread of the per core rates shows the load imbalance.
+     * @param comm      Communicator of the ranks to combine
+     * @param MLUPS     Lattice update rate of this rank (millions of updates per second)
+     * @param fid       File to print to on rank 0
+     */
+    static void reportRate( MPI_Comm comm, double MLUPS, FILE *fid = stdout );
+};
+
+
+//! Time a region until the end of the current scope
+class ScopedTimer
+{
+public:
+    ScopedTimer( const std::string& name, int level = 0 ): ScopedTimer( Profiler::id( name ), level ) {}
+    ScopedTimer( int id, int level ): d_id( id ), d_level( level )
+    {
+        Profiler::start( d_id, d_level );
+    }
+    ~ScopedTimer() { Profiler::stop( d_id, d_level ); }
+    ScopedTimer( const ScopedTimer& ) = delete;
+    ScopedTimer& operator=( const ScopedTimer& ) = delete;
+
+private:
+    int d_id;
+    int d_level;
+};
+
+
+} // namespace Utilities
+
+
+#ifndef USE_TIMER
+    // The region id of a string literal is looked up once for each call site
+    #define PROFILE_START( ... )                                                            \
+        do {                                                                                \
+            static Utilities::ProfilerSite profile_site_;                                   \
+            Utilities::Profiler::start( Utilities::Profiler::id( profile_site_, __VA_ARGS__ ), \
+                Utilities::Profiler::level( __VA_ARGS__ ) );                                \
+        } while ( 0 )
+    #define PROFILE_STOP( ... )                                                             \
+        do {                                                                                \
+            static Utilities::ProfilerSite profile_site_;                                   \
+            Utilities::Profiler::stop( Utilities::Profiler::id( profile_site_, __VA_ARGS__ ),  \
+                Utilities::Profiler::level( __VA_ARGS__ ) );                                \
+        } while ( 0 )
+    #define PROFILE_START2( ... )       PROFILE_START( __VA_ARGS__ )
+    #define PROFILE_STOP2( ... )        PROFILE_STOP( __VA_ARGS__ )
+    #define PROFILE_SCOPED( VAR, ... )                                                      \
+        static Utilities::ProfilerSite VAR##_profile_site_;                                 \
+        Utilities::ScopedTimer VAR( Utilities::Profiler::id( VAR##_profile_site_, __VA_ARGS__ ), \
+            Utilities::Profiler::level( __VA_ARGS__ ) )
+    #define PROFILE_SAVE( ... )         Utilities::Profiler::save( __VA_ARGS__ )
+    #define PROFILE_ENABLE( ... )       Utilities::Profiler::enable( __VA_ARGS__ )
+    #define PROFILE_DISABLE()           Utilities::Profiler::disable()
+    #define PROFILE_SYNCHRONIZE()       do {} while(0)
+    #define PROFILE_STORE_TRACE(X)      do {} while(0)
+    #define PROFILE_ENABLE_TRACE()      do {} while(0)
+    #define PROFILE_DISABLE_TRACE()     do {} while(0)
+    #define PROFILE_ENABLE_MEMORY()     do {} while(0)
+    #define PROFILE_DISABLE_MEMORY()    do {} while(0)
+    #define PROFILE_REPORT( COMM )      Utilities::Profiler::report( COMM )
+#else
+    // The external timer writes its results with PROFILE_SAVE
+    #define PROFILE_REPORT( COMM )      do {} while(0)
+#endif
+
+
+#endif
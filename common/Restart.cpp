@@ -0,0 +1,332 @@
+#include "common/Restart.h"
+#include "common/Utilities.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <climits>
+
+
+static const char RestartMagic[8] = { 'L', 'B', 'P', 'M', 'R', 'S', 'T', '\0' };
+static const int RestartVersion = 1;
+static const int RestartMaxFields = 16;
+static const size_t RestartAlignment = 4096;     // header size and block alignment
+static const size_t RestartChunk = 1 << 22;      // bounce buffer for O_DIRECT writes
+
+struct RestartHeader {
+    char magic[8];
+    int version;
+    int Np;
+    int timestep;
+    int precision;                              // bytes per stored value
+    int nfields;
+    int components[RestartMaxFields];           // values per site in each field
+    char layout[32];                            // site ordering
+};
+
+
+static size_t alignUp( size_t bytes )
+{
+    return ( bytes + RestartAlignment - 1 ) / RestartAlignment * RestartAlignment;
+}
+
+
+// Write the full buffer (write may return after a partial write)
+static void writeAll( int fid, const char *data, size_t bytes, const std::string& filename )
+{
+    while ( bytes > 0 ) {
+        ssize_t N = ::write( fid, data, bytes );
+        if ( N < 0 ) {
+            if ( errno == EINTR )
+                continue;
+            ERROR( "Error writing restart file " + filename + ": " + strerror( errno ) );
+        }
+        data += N;
+        bytes -= N;
+    }
+}
+
+
+// Write a block followed by zeros up to the next aligned offset
+static void writeBlock( int fid, const char *data, size_t bytes, char *buffer, const std::string& filename )
+{
+    size_t padded = alignUp( bytes );
+    if ( buffer == NULL ) {
+        // buffered I/O: write straight from the array
+        writeAll( fid, data, bytes, filename );
+        if ( padded > bytes ) {
+            std::vector<char> zeros( padded - bytes, 0 );
+            writeAll( fid, zeros.data(), zeros.size(), filename );
+        }
+        return;
+    }
+    // O_DIRECT: the source must be aligned, so copy through the bounce buffer
+    for ( size_t offset = 0; offset < padded; offset += RestartChunk ) {
+        size_t length = std::min( RestartChunk, padded - offset );
+        size_t valid  = offset < bytes ? std::min( length, bytes - offset ) : 0;
+        memcpy( buffer, data + offset, valid );
+        memset( buffer + valid, 0, length - valid );
+        writeAll( fid, buffer, length, filename );
+    }
+}
+
+
+void WriteRestartFile( const std::string& filename, int Np, int timestep, const std::string& layout,
+    const RestartFieldsOut& fields, bool direct )
+{
+    INSIST( (int) fields.size() <= RestartMaxFields, "Too many fields for the restart header" );
+    std::vector<char> header( RestartAlignment, 0 );
+    auto head = reinterpret_cast<RestartHeader*>( header.data() );
+    memcpy( head->magic, RestartMagic, sizeof( RestartMagic ) );
+    head->version   = RestartVersion;
+    head->Np        = Np;
+    head->timestep  = timestep;
+    head->precision = sizeof( double );
+    head->nfields   = fields.size();
+    for ( size_t i = 0; i < fields.size(); i++ )
+        head->components[i] = fields[i].second;
+    strncpy( head->layout, layout.c_str(), sizeof( head->layout ) - 1 );
+
+    int fid      = -1;
+    char *buffer = NULL;
+#ifdef O_DIRECT
+    if ( direct ) {
+        fid = ::open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644 );
+        if ( fid >= 0 && posix_memalign( (void **) &buffer, RestartAlignment, RestartChunk ) != 0 )
+            ERROR( "Unable to allocate the restart buffer" );
+    }
+#endif
+    if ( fid < 0 ) {
+        // O_DIRECT is not available or the file system does not support it
+        fid = ::open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    }
+    if ( fid < 0 )
+        ERROR( "Unable to open restart file " + filename + ": " + strerror( errno ) );
+    writeBlock( fid, header.data(), header.size(), buffer, filename );
+    for ( size_t i = 0; i < fields.size(); i++ ) {
+        size_t bytes = sizeof( double ) * fields[i].second * (size_t) Np;
+        writeBlock( fid, reinterpret_cast<const char*>( fields[i].first ), bytes, buffer, filename );
+    }
+    ::close( fid );
+    free( buffer );
+}
+
+
+// Legacy format: each field written site by site with its components interleaved
+static void ReadLegacyRestartFile( FILE *fid, const std::string& filename, int Np, const RestartFieldsIn& fields )
+{
+    size_t bytes = 0;
+    for ( auto field : fields )
+        bytes += sizeof( double ) * field.second * (size_t) Np;
+    fseek( fid, 0, SEEK_END );
+    INSIST( (size_t) ftell( fid ) == bytes, "Restart file " + filename + " does not match the domain" );
+    fseek( fid, 0, SEEK_SET );
+    const int block = 65536;
+    std::vector<double> tmp;
+    for ( auto field : fields ) {
+        int Q = field.second;
+        tmp.resize( (size_t) Q * block );
+        for ( int start = 0; start < Np; start += block ) {
+            int count = std::min( block, Np - start );
+            size_t N  = fread( tmp.data(), sizeof( double ), (size_t) Q * count, fid );
+            INSIST( N == (size_t) Q * count, "Error reading restart file " + filename );
+            for ( int q = 0; q < Q; q++ ) {
+                for ( int n = 0; n < count; n++ )
+                    field.first[(size_t) q * Np + start + n] = tmp[(size_t) n * Q + q];
+            }
+        }
+    }
+}
+
+
+int ReadRestartFile( const std::string& filename, int Np, const std::string& layout,
+    const RestartFieldsIn& fields )
+{
+    FILE *fid = fopen( filename.c_str(), "rb" );
+    INSIST( fid, "Restart file does not exist: " + filename );
+    RestartHeader head;
+    memset( &head, 0, sizeof( head ) );
+    size_t N = fread( &head, 1, sizeof( head ), fid );
+    if ( N < sizeof( head ) || memcmp( head.magic, RestartMagic, sizeof( RestartMagic ) ) != 0 ) {
+        ReadLegacyRestartFile( fid, filename, Np, fields );
+        fclose( fid );
+        return -1;
+    }
+    head.layout[sizeof( head.layout ) - 1] = 0;
+    INSIST( head.version == RestartVersion, "Unknown restart file version in " + filename );
+    INSIST( head.precision == sizeof( double ), "Unsupported restart precision in " + filename );
+    INSIST( head.Np == Np && head.nfields == (int) fields.size(),
+        "Restart file " + filename + " does not match the domain" );
+    INSIST( layout == head.layout, "Restart file " + filename + " was written with layout " +
+        std::string( head.layout ) + " (current layout is " + layout + ")" );
+    size_t offset = RestartAlignment;
+    for ( size_t i = 0; i < fields.size(); i++ ) {
+        INSIST( head.components[i] == fields[i].second, "Restart file " + filename + " does not match the fields" );
+        size_t count = (size_t) fields[i].second * Np;
+        fseek( fid, offset, SEEK_SET );
+        N = fread( fields[i].first, sizeof( double ), count, fid );
+        INSIST( N == count, "Error reading restart file " + filename );
+        offset += alignUp( sizeof( double ) * count );
+    }
+    fclose( fid );
+    return head.timestep;
+}
+
+
+/******************************************************************
+ *  Shared restart files (collective MPI-IO)                       *
+ ******************************************************************/
+static const char SharedRestartMagic[8] = { 'L', 'B', 'P', 'M', 'S', 'R', 'S', '\0' };
+
+struct SharedRestartHeader {
+    char magic[8];
+    int version;
+    int N[3];                                   // global grid size (without the halo)
+    int timestep;
+    int precision;                              // bytes per stored value
+    int nfields;
+    int components[RestartMaxFields];           // values per site in each field
+};
+
+
+// Local part of the global [component][z][y][x] grid
+static MPI_Datatype SharedRestartType( const RankInfoStruct& rank_info, const int n[3], int Q )
+{
+    int sizes[4]    = { Q, n[2] * rank_info.nz, n[1] * rank_info.ny, n[0] * rank_info.nx };
+    int subsizes[4] = { Q, n[2], n[1], n[0] };
+    int starts[4]   = { 0, n[2] * rank_info.kz, n[1] * rank_info.jy, n[0] * rank_info.ix };
+    MPI_Datatype type;
+    MPI_Type_create_subarray( 4, sizes, subsizes, starts, MPI_ORDER_C, MPI_DOUBLE, &type );
+    MPI_Type_commit( &type );
+    return type;
+}
+
+
+static int SharedRestartComponents( const std::vector<int>& components )
+{
+    int Q = 0;
+    for ( auto q : components )
+        Q += q;
+    return Q;
+}
+
+
+void WriteSharedRestartFile( const std::string& filename, const RankInfoStruct& rank_info, const IntArray& Map,
+    int Np, int timestep, const RestartFieldsOut& fields, int writers, MPI_Comm comm )
+{
+    INSIST( (int) fields.size() <= RestartMaxFields, "Too many fields for the restart header" );
+    int n[3] = { (int) Map.size( 0 ) - 2, (int) Map.size( 1 ) - 2, (int) Map.size( 2 ) - 2 };
+    std::vector<int> components;
+    for ( auto field : fields )
+        components.push_back( field.second );
+    int Q = SharedRestartComponents( components );
+    size_t N = (size_t) n[0] * n[1] * n[2];
+    INSIST( Q * N < (size_t) INT_MAX, "Sub-domain is too large for a shared restart file" );
+
+    // Copy the sites to the local regular grid
+    std::vector<double> data( Q * N, 0.0 );
+    for ( int k = 0; k < n[2]; k++ ) {
+        for ( int j = 0; j < n[1]; j++ ) {
+            for ( int i = 0; i < n[0]; i++ ) {
+                int idx = Map( i + 1, j + 1, k + 1 );
+                if ( idx < 0 || idx >= Np )
+                    continue;
+                size_t m = ( (size_t) k * n[1] + j ) * n[0] + i;
+                int c    = 0;
+                for ( auto field : fields ) {
+                    for ( int q = 0; q < field.second; q++, c++ )
+                        data[c * N + m] = field.first[(size_t) q * Np + idx];
+                }
+            }
+        }
+    }
+
+    MPI_Info info;
+    MPI_Info_create( &info );
+    if ( writers > 0 )
+        MPI_Info_set( info, "cb_nodes", const_cast<char*>( std::to_string( writers ).c_str() ) );
+    MPI_File fid;
+    int err = MPI_File_open( comm, const_cast<char*>( filename.c_str() ), MPI_MODE_CREATE | MPI_MODE_WRONLY, info, &fid );
+    INSIST( err == MPI_SUCCESS, "Unable to open restart file " + filename );
+    MPI_File_set_size( fid, 0 );
+    if ( comm_rank( comm ) == 0 ) {
+        std::vector<char> header( RestartAlignment, 0 );
+        auto head = reinterpret_cast<SharedRestartHeader*>( header.data() );
+        memcpy( head->magic, SharedRestartMagic, sizeof( SharedRestartMagic ) );
+        head->version   = RestartVersion;
+        head->N[0]      = n[0] * rank_info.nx;
+        head->N[1]      = n[1] * rank_info.ny;
+        head->N[2]      = n[2] * rank_info.nz;
+        head->timestep  = timestep;
+        head->precision = sizeof( double );
+        head->nfields   = fields.size();
+        for ( size_t i = 0; i < components.size(); i++ )
+            head->components[i] = components[i];
+        MPI_File_write_at( fid, 0, header.data(), header.size(), MPI_CHAR, MPI_STATUS_IGNORE );
+    }
+    MPI_Datatype type = SharedRestartType( rank_info, n, Q );
+    MPI_File_set_view( fid, RestartAlignment, MPI_DOUBLE, type, const_cast<char*>( "native" ), info );
+    MPI_File_write_all( fid, data.data(), data.size(), MPI_DOUBLE, MPI_STATUS_IGNORE );
+    MPI_File_close( &fid );
+    MPI_Type_free( &type );
+    MPI_Info_free( &info );
+}
+
+
+int ReadSharedRestartFile( const std::string& filename, const RankInfoStruct& rank_info, const IntArray& Map,
+    int Np, const RestartFieldsIn& fields, MPI_Comm comm )
+{
+    int n[3] = { (int) Map.size( 0 ) - 2, (int) Map.size( 1 ) - 2, (int) Map.size( 2 ) - 2 };
+    MPI_File fid;
+    int err = MPI_File_open( comm, const_cast<char*>( filename.c_str() ), MPI_MODE_RDONLY, MPI_INFO_NULL, &fid );
+    INSIST( err == MPI_SUCCESS, "Restart file does not exist: " + filename );
+    SharedRestartHeader head;
+    memset( &head, 0, sizeof( head ) );
+    if ( comm_rank( comm ) == 0 )
+        MPI_File_read_at( fid, 0, &head, sizeof( head ), MPI_CHAR, MPI_STATUS_IGNORE );
+    MPI_Bcast( &head, sizeof( head ), MPI_CHAR, 0, comm );
+    INSIST( memcmp( head.magic, SharedRestartMagic, sizeof( SharedRestartMagic ) ) == 0,
+        filename + " is not a shared restart file" );
+    INSIST( head.version == RestartVersion, "Unknown restart file version in " + filename );
+    INSIST( head.precision == sizeof( double ), "Unsupported restart precision in " + filename );
+    INSIST( head.N[0] == n[0] * rank_info.nx && head.N[1] == n[1] * rank_info.ny && head.N[2] == n[2] * rank_info.nz,
+        "Restart file " + filename + " does not match the global domain" );
+    std::vector<int> components;
+    INSIST( head.nfields == (int) fields.size(), "Restart file " + filename + " does not match the fields" );
+    for ( size_t i = 0; i < fields.size(); i++ ) {
+        INSIST( head.components[i] == fields[i].second, "Restart file " + filename + " does not match the fields" );
+        components.push_back( fields[i].second );
+    }
+    int Q = SharedRestartComponents( components );
+    size_t N = (size_t) n[0] * n[1] * n[2];
+    INSIST( Q * N < (size_t) INT_MAX, "Sub-domain is too large for a shared restart file" );
+
+    std::vector<double> data( Q * N );
+    MPI_Datatype type = SharedRestartType( rank_info, n, Q );
+    MPI_File_set_view( fid, RestartAlignment, MPI_DOUBLE, type, const_cast<char*>( "native" ), MPI_INFO_NULL );
+    MPI_File_read_all( fid, data.data(), data.size(), MPI_DOUBLE, MPI_STATUS_IGNORE );
+    MPI_File_close( &fid );
+    MPI_Type_free( &type );
+
+    // Copy the local regular grid to the sites
+    for ( int k = 0; k < n[2]; k++ ) {
+        for ( int j = 0; j < n[1]; j++ ) {
+            for ( int i = 0; i < n[0]; i++ ) {
+                int idx = Map( i + 1, j + 1, k + 1 );
+                if ( idx < 0 || idx >= Np )
+                    continue;
+                size_t m = ( (size_t) k * n[1] + j ) * n[0] + i;
+                int c    = 0;
+                for ( auto field : fields ) {
+                    for ( int q = 0; q < field.second; q++, c++ )
+                        field.first[(size_t) q * Np + idx] = data[c * N + m];
+                }
+            }
+        }
+    }
+    return head.timestep;
+}
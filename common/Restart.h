@@ -0,0 +1,78 @@
+#ifndef RESTART_H
+#define RESTART_H
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "common/Array.h"
+#include "common/Communication.h"
+#include "common/MPI_Helpers.h"
+
+/*
+Block restart files
+  A 4096 byte header (format version, Np, site layout, precision, timestep and
+  the number of values per site of each field) is followed by each field as one
+  contiguous block of components*Np values in the order of the memory optimized
+  layout, e.g. Den (2*Np) followed by fq (19*Np). Blocks start on 4096 byte
+  boundaries so that they can be written with O_DIRECT.
+ */
+
+// (data, values per site) for each field, stored component major as on the device
+typedef std::vector<std::pair<const double*,int>> RestartFieldsOut;
+typedef std::vector<std::pair<double*,int>> RestartFieldsIn;
+
+/*!
+ * Write a block restart file
+ * @param filename   Name of the (per rank) restart file
+ * @param Np         Number of sites
+ * @param timestep   Timestep stored in the header
+ * @param layout     Site ordering of the fields (ScaLBL_Communicator::Layout)
+ * @param fields     Fields to write
+ * @param direct     Bypass the page cache with O_DIRECT (falls back to buffered I/O if unsupported)
+ */
+void WriteRestartFile( const std::string& filename, int Np, int timestep, const std::string& layout,
+    const RestartFieldsOut& fields, bool direct = false );
+
+/*!
+ * Read a restart file
+ * Files without a header are read in the legacy format, where each field is
+ * written site by site with its components interleaved (Den[n], Den[Np+n], ...)
+ * @return           Timestep from the header, or -1 for a legacy file
+ */
+int ReadRestartFile( const std::string& filename, int Np, const std::string& layout,
+    const RestartFieldsIn& fields );
+
+
+/*
+Shared restart files
+  A single file written with collective MPI-IO. After a 4096 byte header (global
+  grid size, values per site of each field and timestep) each component of each
+  field is stored as one global regular grid without the halo (solid nodes are
+  zero), so the file can be read on a different process decomposition of the
+  same domain.
+ */
+
+/*!
+ * Write a shared restart file (collective over comm)
+ * @param filename   Name of the restart file
+ * @param rank_info  Process decomposition
+ * @param Map        Site index of each local node (including the halo, -1 for solid)
+ * @param Np         Number of sites
+ * @param timestep   Timestep stored in the header
+ * @param fields     Fields to write
+ * @param writers    Number of aggregator ranks (MPI-IO cb_nodes hint), 0 for the MPI-IO default
+ * @param comm       Communicator
+ */
+void WriteSharedRestartFile( const std::string& filename, const RankInfoStruct& rank_info, const IntArray& Map,
+    int Np, int timestep, const RestartFieldsOut& fields, int writers, MPI_Comm comm );
+
+/*!
+ * Read a shared restart file (collective over comm)
+ * @return           Timestep from the header
+ */
+int ReadSharedRestartFile( const std::string& filename, const RankInfoStruct& rank_info, const IntArray& Map,
+    int Np, const RestartFieldsIn& fields, MPI_Comm comm );
+
+
+#endif
@@ -15,6 +15,10 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "common/ScaLBL.h"
+#include "ProfilerApp.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 ScaLBL_Communicator::ScaLBL_Communicator(std::shared_ptr <Domain> Dm){
 	//......................................................................................
@@ -95,6 +99,12 @@ ScaLBL_Communicator::ScaLBL_Communicator(std::shared_ptr <Domain> Dm){
 	nprocz = Dm->nprocz();
 	BoundaryCondition = Dm->BoundaryCondition;
 	//......................................................................................
+	// The inlet does not change, so its area and the communicator of the inlet ranks
+	// are set up once here rather than on every call of D3Q19_Flux_BC_z
+	double LocInletArea = (kproc == 0) ? double(sendCount_z) : 0.0;
+	MPI_Allreduce(&LocInletArea,&InletArea,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_SCALBL);
+	MPI_Comm_split(MPI_COMM_SCALBL,(kproc == 0) ? 0 : MPI_UNDEFINED,rank,&MPI_COMM_INLET);
+	//......................................................................................
 
 	ScaLBL_AllocateZeroCopy((void **) &sendbuf_x, 2*5*sendCount_x*sizeof(double));	// Allocate device memory
 	ScaLBL_AllocateZeroCopy((void **) &sendbuf_X, 2*5*sendCount_X*sizeof(double));	// Allocate device memory
@@ -319,14 +329,295 @@ ScaLBL_Communicator::ScaLBL_Communicator(std::shared_ptr <Domain> Dm){
 
 	CommunicationCount = SendCount+RecvCount;
 	//......................................................................................
-
+	AggregateEdges = false;
+	auto db = Dm->getDatabase();
+	if (db != NULL && db->keyExists( "AggregateEdges" )){
+		AggregateEdges = db->getScalar<bool>( "AggregateEdges" );
+	}
+	Layout = "lexicographic";
+	LayoutBrickSize = 8;
+	if (db != NULL && db->keyExists( "Layout" )){
+		Layout = db->getScalar<std::string>( "Layout" );
+	}
+	if (db != NULL && db->keyExists( "LayoutBrickSize" )){
+		LayoutBrickSize = db->getScalar<int>( "LayoutBrickSize" );
+	}
+	if (Layout != "lexicographic" && Layout != "morton" && Layout != "hilbert" && Layout != "brick"){
+		ERROR("ScaLBL_Communicator: unknown Layout " + Layout + " (use lexicographic, morton, hilbert or brick)");
+	}
+	if (LayoutBrickSize < 1){
+		ERROR("ScaLBL_Communicator: LayoutBrickSize must be positive");
+	}
+	transitCount_xy = transitCount_xY = transitCount_xz = transitCount_xZ = 0;
+	transitCount_Xy = transitCount_XY = transitCount_Xz = transitCount_XZ = 0;
+	transitCount_yz = transitCount_yZ = transitCount_Yz = transitCount_YZ = 0;
+	if (AggregateEdges){
+		// Edges travel along x (or y) first; get the size of the data passing through this process
+		int sendcounts[4], recvcounts[4];
+		sendcounts[0]=sendCount_xy; sendcounts[1]=sendCount_xY; sendcounts[2]=sendCount_xz; sendcounts[3]=sendCount_xZ;
+		MPI_Sendrecv(sendcounts,4,MPI_INT,rank_x,2,recvcounts,4,MPI_INT,rank_X,2,MPI_COMM_SCALBL,MPI_STATUS_IGNORE);
+		transitCount_xy=recvcounts[0]; transitCount_xY=recvcounts[1]; transitCount_xz=recvcounts[2]; transitCount_xZ=recvcounts[3];
+		sendcounts[0]=sendCount_Xy; sendcounts[1]=sendCount_XY; sendcounts[2]=sendCount_Xz; sendcounts[3]=sendCount_XZ;
+		MPI_Sendrecv(sendcounts,4,MPI_INT,rank_X,3,recvcounts,4,MPI_INT,rank_x,3,MPI_COMM_SCALBL,MPI_STATUS_IGNORE);
+		transitCount_Xy=recvcounts[0]; transitCount_XY=recvcounts[1]; transitCount_Xz=recvcounts[2]; transitCount_XZ=recvcounts[3];
+		sendcounts[0]=sendCount_yz; sendcounts[1]=sendCount_yZ;
+		MPI_Sendrecv(sendcounts,2,MPI_INT,rank_y,4,recvcounts,2,MPI_INT,rank_Y,4,MPI_COMM_SCALBL,MPI_STATUS_IGNORE);
+		transitCount_yz=recvcounts[0]; transitCount_yZ=recvcounts[1];
+		sendcounts[0]=sendCount_Yz; sendcounts[1]=sendCount_YZ;
+		MPI_Sendrecv(sendcounts,2,MPI_INT,rank_Y,5,recvcounts,2,MPI_INT,rank_y,5,MPI_COMM_SCALBL,MPI_STATUS_IGNORE);
+		transitCount_Yz=recvcounts[0]; transitCount_YZ=recvcounts[1];
+	}
+	ScaLBL_AllocateZeroCopy((void **) &transitbuf_xy, transitCount_xy*sizeof(double));
+	ScaLBL_AllocateZeroCopy((void **) &transitbuf_xY, transitCount_xY*sizeof(double));
+	ScaLBL_AllocateZeroCopy((void **) &transitbuf_xz, transitCount_xz*sizeof(double));
+	ScaLBL_AllocateZeroCopy((void **) &transitbuf_xZ, transitCount_xZ*sizeof(double));
+	ScaLBL_AllocateZeroCopy((void **) &transitbuf_Xy, transitCount_Xy*sizeof(double));
+	ScaLBL_AllocateZeroCopy((void **) &transitbuf_XY, transitCount_XY*sizeof(double));
+	ScaLBL_AllocateZeroCopy((void **) &transitbuf_Xz, transitCount_Xz*sizeof(double));
+	ScaLBL_AllocateZeroCopy((void **) &transitbuf_XZ, transitCount_XZ*sizeof(double));
+	ScaLBL_AllocateZeroCopy((void **) &transitbuf_yz, transitCount_yz*sizeof(double));
+	ScaLBL_AllocateZeroCopy((void **) &transitbuf_yZ, transitCount_yZ*sizeof(double));
+	ScaLBL_AllocateZeroCopy((void **) &transitbuf_Yz, transitCount_Yz*sizeof(double));
+	ScaLBL_AllocateZeroCopy((void **) &transitbuf_YZ, transitCount_YZ*sizeof(double));
+	//......................................................................................
+	// Buffers, counts and neighbors never change, so set up the requests once
+	// (each exchange uses 18 tags starting from the one given)
+	InitExchange(req_D3Q19AA,32,5,true);
+	InitExchange(req_D3Q19AA_Single,64,5,true,MPI_FLOAT);
+	InitExchange(req_BiD3Q7AA,96,2,false);
+	InitExchange(req_TriD3Q7AA,128,3,false);
+	InitExchange(req_Halo,160,1,true);
+	RecvDone = 0;
+	// recieve buffers in the order of the recieve requests
+	recvbuf[0]=recvbuf_X; recvCount[0]=recvCount_X; dvcRecvList[0]=dvcRecvList_X; dvcRecvDist[0]=dvcRecvDist_X;
+	recvbuf[1]=recvbuf_x; recvCount[1]=recvCount_x; dvcRecvList[1]=dvcRecvList_x; dvcRecvDist[1]=dvcRecvDist_x;
+	recvbuf[2]=recvbuf_Y; recvCount[2]=recvCount_Y; dvcRecvList[2]=dvcRecvList_Y; dvcRecvDist[2]=dvcRecvDist_Y;
+	recvbuf[3]=recvbuf_y; recvCount[3]=recvCount_y; dvcRecvList[3]=dvcRecvList_y; dvcRecvDist[3]=dvcRecvDist_y;
+	recvbuf[4]=recvbuf_Z; recvCount[4]=recvCount_Z; dvcRecvList[4]=dvcRecvList_Z; dvcRecvDist[4]=dvcRecvDist_Z;
+	recvbuf[5]=recvbuf_z; recvCount[5]=recvCount_z; dvcRecvList[5]=dvcRecvList_z; dvcRecvDist[5]=dvcRecvDist_z;
+	recvbuf[6]=recvbuf_XY; recvCount[6]=recvCount_XY; dvcRecvList[6]=dvcRecvList_XY; dvcRecvDist[6]=dvcRecvDist_XY;
+	recvbuf[7]=recvbuf_xy; recvCount[7]=recvCount_xy; dvcRecvList[7]=dvcRecvList_xy; dvcRecvDist[7]=dvcRecvDist_xy;
+	recvbuf[8]=recvbuf_xY; recvCount[8]=recvCount_xY; dvcRecvList[8]=dvcRecvList_xY; dvcRecvDist[8]=dvcRecvDist_xY;
+	recvbuf[9]=recvbuf_Xy; recvCount[9]=recvCount_Xy; dvcRecvList[9]=dvcRecvList_Xy; dvcRecvDist[9]=dvcRecvDist_Xy;
+	recvbuf[10]=recvbuf_XZ; recvCount[10]=recvCount_XZ; dvcRecvList[10]=dvcRecvList_XZ; dvcRecvDist[10]=dvcRecvDist_XZ;
+	recvbuf[11]=recvbuf_xz; recvCount[11]=recvCount_xz; dvcRecvList[11]=dvcRecvList_xz; dvcRecvDist[11]=dvcRecvDist_xz;
+	recvbuf[12]=recvbuf_xZ; recvCount[12]=recvCount_xZ; dvcRecvList[12]=dvcRecvList_xZ; dvcRecvDist[12]=dvcRecvDist_xZ;
+	recvbuf[13]=recvbuf_Xz; recvCount[13]=recvCount_Xz; dvcRecvList[13]=dvcRecvList_Xz; dvcRecvDist[13]=dvcRecvDist_Xz;
+	recvbuf[14]=recvbuf_YZ; recvCount[14]=recvCount_YZ; dvcRecvList[14]=dvcRecvList_YZ; dvcRecvDist[14]=dvcRecvDist_YZ;
+	recvbuf[15]=recvbuf_yz; recvCount[15]=recvCount_yz; dvcRecvList[15]=dvcRecvList_yz; dvcRecvDist[15]=dvcRecvDist_yz;
+	recvbuf[16]=recvbuf_yZ; recvCount[16]=recvCount_yZ; dvcRecvList[16]=dvcRecvList_yZ; dvcRecvDist[16]=dvcRecvDist_yZ;
+	recvbuf[17]=recvbuf_Yz; recvCount[17]=recvCount_Yz; dvcRecvList[17]=dvcRecvList_Yz; dvcRecvDist[17]=dvcRecvDist_Yz;
+	//......................................................................................
 }
 
 
 ScaLBL_Communicator::~ScaLBL_Communicator(){
 	// destrutor does nothing (bad idea)
 	// -- note that there needs to be a way to free memory allocated on the device!!!
+	int finalized;
+	MPI_Finalized(&finalized);
+	if (!finalized){
+		MPI_Request *requests[5] = { req_D3Q19AA, req_D3Q19AA_Single, req_BiD3Q7AA, req_TriD3Q7AA, req_Halo };
+		for (int r=0; r<5; r++){
+			for (int idx=0; idx<36; idx++){
+				if (requests[r][idx] != MPI_REQUEST_NULL) MPI_Request_free(&requests[r][idx]);
+			}
+		}
+		for (size_t t=0; t<AggregateTypes.size(); t++) MPI_Type_free(&AggregateTypes[t]);
+		if (MPI_COMM_INLET != MPI_COMM_NULL) MPI_Comm_free(&MPI_COMM_INLET);
+	}
+}
+
+// Describe several separate buffers as one message (addresses are relative to MPI_BOTTOM)
+static MPI_Datatype CreateAggregateType(int count, double **buffers, int *lengths, MPI_Datatype datatype, std::vector<MPI_Datatype> &types)
+{
+	MPI_Aint displacements[5];
+	MPI_Datatype blocktypes[5];
+	for (int b=0; b<count; b++){
+		MPI_Get_address(buffers[b],&displacements[b]);
+		blocktypes[b] = datatype;
+	}
+	MPI_Datatype type;
+	MPI_Type_create_struct(count,lengths,displacements,blocktypes,&type);
+	MPI_Type_commit(&type);
+	types.push_back(type);
+	return type;
+}
+
+void ScaLBL_Communicator::InitExchange(MPI_Request *req, int tag, int face, bool edges, MPI_Datatype datatype){
+	// face is the number of values sent for each site on a face
+	// each direction uses its own tag (tag:tag+17); the recieve req[18+i] matches the send req[i]
+	// of the neighbor, so messages between ranks that neighbor in several directions cannot mix
+	// single precision (MPI_FLOAT) messages use the first half of each buffer
+	for (int idx=0; idx<36; idx++) req[idx] = MPI_REQUEST_NULL;
+	if (edges && AggregateEdges){
+		// Three stages: x faces carry the x edges, y faces pass them on together with the y edges,
+		// z faces deliver everything that remains. Recieving stage n completes the data for stage n+1
+		double *buffers[5];
+		int lengths[5];
+		MPI_Datatype type;
+		//...x faces.........................................................................
+		buffers[0]=sendbuf_x; buffers[1]=sendbuf_xy; buffers[2]=sendbuf_xY; buffers[3]=sendbuf_xz; buffers[4]=sendbuf_xZ;
+		lengths[0]=face*sendCount_x; lengths[1]=sendCount_xy; lengths[2]=sendCount_xY; lengths[3]=sendCount_xz; lengths[4]=sendCount_xZ;
+		type = CreateAggregateType(5,buffers,lengths,datatype,AggregateTypes);
+		MPI_Send_init(MPI_BOTTOM,1,type,rank_x,tag+0,MPI_COMM_SCALBL,&req[0]);
+		buffers[0]=recvbuf_X; buffers[1]=transitbuf_xy; buffers[2]=transitbuf_xY; buffers[3]=transitbuf_xz; buffers[4]=transitbuf_xZ;
+		lengths[0]=face*recvCount_X; lengths[1]=transitCount_xy; lengths[2]=transitCount_xY; lengths[3]=transitCount_xz; lengths[4]=transitCount_xZ;
+		type = CreateAggregateType(5,buffers,lengths,datatype,AggregateTypes);
+		MPI_Recv_init(MPI_BOTTOM,1,type,rank_X,tag+0,MPI_COMM_SCALBL,&req[18]);
+		buffers[0]=sendbuf_X; buffers[1]=sendbuf_Xy; buffers[2]=sendbuf_XY; buffers[3]=sendbuf_Xz; buffers[4]=sendbuf_XZ;
+		lengths[0]=face*sendCount_X; lengths[1]=sendCount_Xy; lengths[2]=sendCount_XY; lengths[3]=sendCount_Xz; lengths[4]=sendCount_XZ;
+		type = CreateAggregateType(5,buffers,lengths,datatype,AggregateTypes);
+		MPI_Send_init(MPI_BOTTOM,1,type,rank_X,tag+1,MPI_COMM_SCALBL,&req[1]);
+		buffers[0]=recvbuf_x; buffers[1]=transitbuf_Xy; buffers[2]=transitbuf_XY; buffers[3]=transitbuf_Xz; buffers[4]=transitbuf_XZ;
+		lengths[0]=face*recvCount_x; lengths[1]=transitCount_Xy; lengths[2]=transitCount_XY; lengths[3]=transitCount_Xz; lengths[4]=transitCount_XZ;
+		type = CreateAggregateType(5,buffers,lengths,datatype,AggregateTypes);
+		MPI_Recv_init(MPI_BOTTOM,1,type,rank_x,tag+1,MPI_COMM_SCALBL,&req[19]);
+		//...y faces.........................................................................
+		buffers[0]=sendbuf_y; buffers[1]=sendbuf_yz; buffers[2]=sendbuf_yZ; buffers[3]=transitbuf_xy; buffers[4]=transitbuf_Xy;
+		lengths[0]=face*sendCount_y; lengths[1]=sendCount_yz; lengths[2]=sendCount_yZ; lengths[3]=transitCount_xy; lengths[4]=transitCount_Xy;
+		type = CreateAggregateType(5,buffers,lengths,datatype,AggregateTypes);
+		MPI_Send_init(MPI_BOTTOM,1,type,rank_y,tag+2,MPI_COMM_SCALBL,&req[2]);
+		buffers[0]=recvbuf_Y; buffers[1]=transitbuf_yz; buffers[2]=transitbuf_yZ; buffers[3]=recvbuf_XY; buffers[4]=recvbuf_xY;
+		lengths[0]=face*recvCount_Y; lengths[1]=transitCount_yz; lengths[2]=transitCount_yZ; lengths[3]=recvCount_XY; lengths[4]=recvCount_xY;
+		type = CreateAggregateType(5,buffers,lengths,datatype,AggregateTypes);
+		MPI_Recv_init(MPI_BOTTOM,1,type,rank_Y,tag+2,MPI_COMM_SCALBL,&req[20]);
+		buffers[0]=sendbuf_Y; buffers[1]=sendbuf_Yz; buffers[2]=sendbuf_YZ; buffers[3]=transitbuf_xY; buffers[4]=transitbuf_XY;
+		lengths[0]=face*sendCount_Y; lengths[1]=sendCount_Yz; lengths[2]=sendCount_YZ; lengths[3]=transitCount_xY; lengths[4]=transitCount_XY;
+		type = CreateAggregateType(5,buffers,lengths,datatype,AggregateTypes);
+		MPI_Send_init(MPI_BOTTOM,1,type,rank_Y,tag+3,MPI_COMM_SCALBL,&req[3]);
+		buffers[0]=recvbuf_y; buffers[1]=transitbuf_Yz; buffers[2]=transitbuf_YZ; buffers[3]=recvbuf_Xy; buffers[4]=recvbuf_xy;
+		lengths[0]=face*recvCount_y; lengths[1]=transitCount_Yz; lengths[2]=transitCount_YZ; lengths[3]=recvCount_Xy; lengths[4]=recvCount_xy;
+		type = CreateAggregateType(5,buffers,lengths,datatype,AggregateTypes);
+		MPI_Recv_init(MPI_BOTTOM,1,type,rank_y,tag+3,MPI_COMM_SCALBL,&req[21]);
+		//...z faces.........................................................................
+		buffers[0]=sendbuf_z; buffers[1]=transitbuf_xz; buffers[2]=transitbuf_Xz; buffers[3]=transitbuf_yz; buffers[4]=transitbuf_Yz;
+		lengths[0]=face*sendCount_z; lengths[1]=transitCount_xz; lengths[2]=transitCount_Xz; lengths[3]=transitCount_yz; lengths[4]=transitCount_Yz;
+		type = CreateAggregateType(5,buffers,lengths,datatype,AggregateTypes);
+		MPI_Send_init(MPI_BOTTOM,1,type,rank_z,tag+4,MPI_COMM_SCALBL,&req[4]);
+		buffers[0]=recvbuf_Z; buffers[1]=recvbuf_XZ; buffers[2]=recvbuf_xZ; buffers[3]=recvbuf_YZ; buffers[4]=recvbuf_yZ;
+		lengths[0]=face*recvCount_Z; lengths[1]=recvCount_XZ; lengths[2]=recvCount_xZ; lengths[3]=recvCount_YZ; lengths[4]=recvCount_yZ;
+		type = CreateAggregateType(5,buffers,lengths,datatype,AggregateTypes);
+		MPI_Recv_init(MPI_BOTTOM,1,type,rank_Z,tag+4,MPI_COMM_SCALBL,&req[22]);
+		buffers[0]=sendbuf_Z; buffers[1]=transitbuf_xZ; buffers[2]=transitbuf_XZ; buffers[3]=transitbuf_yZ; buffers[4]=transitbuf_YZ;
+		lengths[0]=face*sendCount_Z; lengths[1]=transitCount_xZ; lengths[2]=transitCount_XZ; lengths[3]=transitCount_yZ; lengths[4]=transitCount_YZ;
+		type = CreateAggregateType(5,buffers,lengths,datatype,AggregateTypes);
+		MPI_Send_init(MPI_BOTTOM,1,type,rank_Z,tag+5,MPI_COMM_SCALBL,&req[5]);
+		buffers[0]=recvbuf_z; buffers[1]=recvbuf_Xz; buffers[2]=recvbuf_xz; buffers[3]=recvbuf_Yz; buffers[4]=recvbuf_yz;
+		lengths[0]=face*recvCount_z; lengths[1]=recvCount_Xz; lengths[2]=recvCount_xz; lengths[3]=recvCount_Yz; lengths[4]=recvCount_yz;
+		type = CreateAggregateType(5,buffers,lengths,datatype,AggregateTypes);
+		MPI_Recv_init(MPI_BOTTOM,1,type,rank_z,tag+5,MPI_COMM_SCALBL,&req[23]);
+		return;
+	}
+	MPI_Send_init(sendbuf_x, face*sendCount_x,datatype,rank_x,tag+0,MPI_COMM_SCALBL,&req[0]);
+	MPI_Recv_init(recvbuf_X, face*recvCount_X,datatype,rank_X,tag+0,MPI_COMM_SCALBL,&req[18]);
+	MPI_Send_init(sendbuf_X, face*sendCount_X,datatype,rank_X,tag+1,MPI_COMM_SCALBL,&req[1]);
+	MPI_Recv_init(recvbuf_x, face*recvCount_x,datatype,rank_x,tag+1,MPI_COMM_SCALBL,&req[19]);
+	MPI_Send_init(sendbuf_y, face*sendCount_y,datatype,rank_y,tag+2,MPI_COMM_SCALBL,&req[2]);
+	MPI_Recv_init(recvbuf_Y, face*recvCount_Y,datatype,rank_Y,tag+2,MPI_COMM_SCALBL,&req[20]);
+	MPI_Send_init(sendbuf_Y, face*sendCount_Y,datatype,rank_Y,tag+3,MPI_COMM_SCALBL,&req[3]);
+	MPI_Recv_init(recvbuf_y, face*recvCount_y,datatype,rank_y,tag+3,MPI_COMM_SCALBL,&req[21]);
+	MPI_Send_init(sendbuf_z, face*sendCount_z,datatype,rank_z,tag+4,MPI_COMM_SCALBL,&req[4]);
+	MPI_Recv_init(recvbuf_Z, face*recvCount_Z,datatype,rank_Z,tag+4,MPI_COMM_SCALBL,&req[22]);
+	MPI_Send_init(sendbuf_Z, face*sendCount_Z,datatype,rank_Z,tag+5,MPI_COMM_SCALBL,&req[5]);
+	MPI_Recv_init(recvbuf_z, face*recvCount_z,datatype,rank_z,tag+5,MPI_COMM_SCALBL,&req[23]);
+	if (edges){
+		MPI_Send_init(sendbuf_xy, sendCount_xy,datatype,rank_xy,tag+6,MPI_COMM_SCALBL,&req[6]);
+		MPI_Recv_init(recvbuf_XY, recvCount_XY,datatype,rank_XY,tag+6,MPI_COMM_SCALBL,&req[24]);
+		MPI_Send_init(sendbuf_XY, sendCount_XY,datatype,rank_XY,tag+7,MPI_COMM_SCALBL,&req[7]);
+		MPI_Recv_init(recvbuf_xy, recvCount_xy,datatype,rank_xy,tag+7,MPI_COMM_SCALBL,&req[25]);
+		MPI_Send_init(sendbuf_Xy, sendCount_Xy,datatype,rank_Xy,tag+8,MPI_COMM_SCALBL,&req[8]);
+		MPI_Recv_init(recvbuf_xY, recvCount_xY,datatype,rank_xY,tag+8,MPI_COMM_SCALBL,&req[26]);
+		MPI_Send_init(sendbuf_xY, sendCount_xY,datatype,rank_xY,tag+9,MPI_COMM_SCALBL,&req[9]);
+		MPI_Recv_init(recvbuf_Xy, recvCount_Xy,datatype,rank_Xy,tag+9,MPI_COMM_SCALBL,&req[27]);
+		MPI_Send_init(sendbuf_xz, sendCount_xz,datatype,rank_xz,tag+10,MPI_COMM_SCALBL,&req[10]);
+		MPI_Recv_init(recvbuf_XZ, recvCount_XZ,datatype,rank_XZ,tag+10,MPI_COMM_SCALBL,&req[28]);
+		MPI_Send_init(sendbuf_XZ, sendCount_XZ,datatype,rank_XZ,tag+11,MPI_COMM_SCALBL,&req[11]);
+		MPI_Recv_init(recvbuf_xz, recvCount_xz,datatype,rank_xz,tag+11,MPI_COMM_SCALBL,&req[29]);
+		MPI_Send_init(sendbuf_Xz, sendCount_Xz,datatype,rank_Xz,tag+12,MPI_COMM_SCALBL,&req[12]);
+		MPI_Recv_init(recvbuf_xZ, recvCount_xZ,datatype,rank_xZ,tag+12,MPI_COMM_SCALBL,&req[30]);
+		MPI_Send_init(sendbuf_xZ, sendCount_xZ,datatype,rank_xZ,tag+13,MPI_COMM_SCALBL,&req[13]);
+		MPI_Recv_init(recvbuf_Xz, recvCount_Xz,datatype,rank_Xz,tag+13,MPI_COMM_SCALBL,&req[31]);
+		MPI_Send_init(sendbuf_yz, sendCount_yz,datatype,rank_yz,tag+14,MPI_COMM_SCALBL,&req[14]);
+		MPI_Recv_init(recvbuf_YZ, recvCount_YZ,datatype,rank_YZ,tag+14,MPI_COMM_SCALBL,&req[32]);
+		MPI_Send_init(sendbuf_YZ, sendCount_YZ,datatype,rank_YZ,tag+15,MPI_COMM_SCALBL,&req[15]);
+		MPI_Recv_init(recvbuf_yz, recvCount_yz,datatype,rank_yz,tag+15,MPI_COMM_SCALBL,&req[33]);
+		MPI_Send_init(sendbuf_Yz, sendCount_Yz,datatype,rank_Yz,tag+16,MPI_COMM_SCALBL,&req[16]);
+		MPI_Recv_init(recvbuf_yZ, recvCount_yZ,datatype,rank_yZ,tag+16,MPI_COMM_SCALBL,&req[34]);
+		MPI_Send_init(sendbuf_yZ, sendCount_yZ,datatype,rank_yZ,tag+17,MPI_COMM_SCALBL,&req[17]);
+		MPI_Recv_init(recvbuf_Yz, recvCount_Yz,datatype,rank_Yz,tag+17,MPI_COMM_SCALBL,&req[35]);
+	}
+}
+
+void ScaLBL_Communicator::StartRecv(MPI_Request *req, bool edges){
+	// post the recieves before packing so that messages can land while the sends are prepared
+	RecvDone = 0;
+	if (edges && !AggregateEdges) MPI_Startall(12,&req[24]);
+	MPI_Startall(6,&req[18]);
 }
+
+void ScaLBL_Communicator::StartSend(MPI_Request *req, int idx, bool edges){
+	// send buffer idx must be packed before calling
+	// aggregated y and z messages carry forwarded edges and are started by WaitNext
+	if (edges && AggregateEdges && idx > 1) return;
+	ScaLBL_DeviceBarrier();
+	MPI_Start(&req[idx]);
+}
+
+int ScaLBL_Communicator::WaitNext(MPI_Request *req, bool edges, int *ready){
+	// wait for any recieve; returns the number of recieve buffers (indexed as req[18+idx]) that are complete
+	// returns 0 once every recieve has completed and the sends have finished
+	int count = (edges && !AggregateEdges) ? 18 : 6;
+	int idx;
+	PROFILE_START("MPI wait",1);
+	MPI_Waitany(count,&req[18],&idx,MPI_STATUS_IGNORE);
+	if (idx == MPI_UNDEFINED){
+		MPI_Waitall(count,req,stat1);
+		PROFILE_STOP("MPI wait",1);
+		return 0;
+	}
+	PROFILE_STOP("MPI wait",1);
+	ready[0] = idx;
+	if (!(edges && AggregateEdges)) return 1;
+	// forward the edges once the previous stage has arrived
+	RecvDone |= 1 << idx;
+	if (idx < 2 && (RecvDone & 3) == 3){
+		MPI_Startall(2,&req[2]);
+	}
+	if (idx < 4 && (RecvDone & 15) == 15){
+		MPI_Startall(2,&req[4]);
+	}
+	// edges delivered with each aggregated message
+	static const int edge[6][4] = { {0}, {0}, {6,8}, {9,7}, {10,12,14,16}, {13,11,17,15} };
+	static const int edge_count[6] = { 0, 0, 2, 2, 4, 4 };
+	for (int e=0; e<edge_count[idx]; e++) ready[e+1] = edge[idx][e];
+	return edge_count[idx]+1;
+}
+
+void ScaLBL_Communicator::WaitExchange(MPI_Request *req, bool edges){
+	if (edges && AggregateEdges){
+		int ready[5];
+		while (WaitNext(req,edges,ready) > 0);
+	}
+	else {
+		// every request is waited on at once (WaitNext times the waits of aggregated exchanges)
+		int count = edges ? 18 : 6;
+		PROFILE_START("MPI wait",1);
+		MPI_Waitall(count,req,stat1);
+		MPI_Waitall(count,&req[18],stat2);
+		PROFILE_STOP("MPI wait",1);
+	}
+}
+
+bool ScaLBL_Communicator::BoundaryRecv(int idx){
+	// z messages that are replaced by the boundary condition (indexed as req[18+idx])
+	if (BoundaryCondition > 0){
+		if (kproc == nprocz-1 && (idx == 4 || idx == 10 || idx == 12 || idx == 14 || idx == 16)) return true;
+		if (kproc == 0 && (idx == 5 || idx == 11 || idx == 13 || idx == 15 || idx == 17)) return true;
+	}
+	return false;
+}
+
 int ScaLBL_Communicator::LastExterior(){
 	return next;
 }
@@ -368,6 +659,70 @@ void ScaLBL_Communicator::D3Q19_MapRecv(int Cqx, int Cqy, int Cqz, int *list,  i
 	delete [] ReturnDist;
 }
 
+// Interleave the low 21 bits of i, j and k (Morton / Z-order)
+static uint64_t MortonKey(uint64_t i, uint64_t j, uint64_t k){
+	uint64_t key = 0;
+	for (int b=0; b<21; b++){
+		key |= ((i >> b) & 1) << (3*b);
+		key |= ((j >> b) & 1) << (3*b+1);
+		key |= ((k >> b) & 1) << (3*b+2);
+	}
+	return key;
+}
+
+// Position along a 3D Hilbert curve with 2^bits points per side (Skilling, AIP Conf. Proc. 707, 2004)
+static uint64_t HilbertKey(uint64_t i, uint64_t j, uint64_t k, int bits){
+	uint64_t X[3] = { i, j, k };
+	uint64_t M = uint64_t(1) << (bits-1);
+	uint64_t P,Q,t;
+	// inverse undo
+	for (Q=M; Q>1; Q>>=1){
+		P = Q-1;
+		for (int d=0; d<3; d++){
+			if (X[d] & Q) X[0] ^= P;
+			else {
+				t = (X[0] ^ X[d]) & P;
+				X[0] ^= t;
+				X[d] ^= t;
+			}
+		}
+	}
+	// Gray encode
+	for (int d=1; d<3; d++) X[d] ^= X[d-1];
+	t = 0;
+	for (Q=M; Q>1; Q>>=1){
+		if (X[2] & Q) t ^= Q-1;
+	}
+	for (int d=0; d<3; d++) X[d] ^= t;
+	// transposed form to a single index (most significant bits first)
+	uint64_t key = 0;
+	for (int b=bits-1; b>=0; b--){
+		for (int d=0; d<3; d++) key = (key << 1) | ((X[d] >> b) & 1);
+	}
+	return key;
+}
+
+uint64_t ScaLBL_Communicator::LayoutKey(int i, int j, int k){
+	// sort key used to order the sites within the exterior and interior index sets
+	if (Layout == "morton"){
+		return MortonKey(i,j,k);
+	}
+	else if (Layout == "hilbert"){
+		int bits = 1;
+		while ((1 << bits) < std::max(Nx,std::max(Ny,Nz))) bits++;
+		return HilbertKey(i,j,k,bits);
+	}
+	else if (Layout == "brick"){
+		// lexicographic order of bricks, lexicographic order within each brick
+		int B = LayoutBrickSize;
+		uint64_t nbx = (Nx+B-1)/B;
+		uint64_t nby = (Ny+B-1)/B;
+		uint64_t brick = (uint64_t(k/B)*nby + j/B)*nbx + i/B;
+		return brick*B*B*B + ((k%B)*B + j%B)*B + i%B;
+	}
+	return (uint64_t(k)*Ny + j)*Nx + i;
+}
+
 int ScaLBL_Communicator::MemoryOptimizedLayoutAA(IntArray &Map, int *neighborList, signed char *id, int Np){
 	/*
 	 * Generate a memory optimized layout
@@ -397,6 +752,8 @@ int ScaLBL_Communicator::MemoryOptimizedLayoutAA(IntArray &Map, int *neighborLis
 
 	// ********* Exterior **********
 	// Step 1/2: Index the outer walls of the grid only
+	// sites are collected in lexicographic order and sorted if another Layout is selected
+	std::vector<std::pair<uint64_t,int>> sites;
 	idx=0;	next=0;
 	for (k=1; k<Nz-1; k++){
 		for (j=1; j<Ny-1; j++){
@@ -407,16 +764,14 @@ int ScaLBL_Communicator::MemoryOptimizedLayoutAA(IntArray &Map, int *neighborLis
 				n = k*Nx*Ny+j*Nx+i;
 				if (id[n] > 0){
 					// Counts for the six faces
-					if (i==1)       Map(n)=idx++;
-					else if (j==1)  Map(n)=idx++;
-					else if (k==1)  Map(n)=idx++;
-					else if (i==Nx-2)  Map(n)=idx++;
-					else if (j==Ny-2)  Map(n)=idx++;
-					else if (k==Nz-2)  Map(n)=idx++;
+					if (i==1 || j==1 || k==1 || i==Nx-2 || j==Ny-2 || k==Nz-2)
+						sites.push_back(std::make_pair(LayoutKey(i,j,k),n));
 				}
 			}
 		}
 	}
+	if (Layout != "lexicographic") std::stable_sort(sites.begin(),sites.end());
+	for (size_t p=0; p<sites.size(); p++) Map(sites[p].second)=idx++;
 	next=idx;
 	
 	//printf("Interior... \n");
@@ -426,18 +781,20 @@ int ScaLBL_Communicator::MemoryOptimizedLayoutAA(IntArray &Map, int *neighborLis
 	first_interior=(next/16 + 1)*16;
 	idx = first_interior;
 	// Step 2/2: Next loop over the domain interior in block-cyclic fashion
+	sites.clear();
 	for (k=2; k<Nz-2; k++){
 		for (j=2; j<Ny-2; j++){
 			for (i=2; i<Nx-2; i++){
 				// Local index (regular layout)
 				n = k*Nx*Ny + j*Nx + i;
 				if (id[n] > 0 ){
-					Map(n) = idx++;
-					//neighborList[idx++] = n; // index of self in regular layout
+					sites.push_back(std::make_pair(LayoutKey(i,j,k),n));
 				}
 			}
 		}
 	}
+	if (Layout != "lexicographic") std::stable_sort(sites.begin(),sites.end());
+	for (size_t p=0; p<sites.size(); p++) Map(sites[p].second)=idx++;
 	last_interior=idx;
 	
 	Np = (last_interior/16 + 1)*16;
@@ -865,7 +1222,126 @@ int ScaLBL_Communicator::MemoryOptimizedLayoutAA(IntArray &Map, int *neighborLis
 	return(Np);
 }
 
+int ScaLBL_Communicator::CompressNeighborList(const int *neighborList, int Np, short *offset, int *base){
+	/*
+	 * Compress the neighbor list generated by MemoryOptimizedLayoutAA to 16 bits per entry
+	 *   offset(q*Np+idx) = 2*(neighbor - idx - base(block,q,s)) + s for links to fluid sites
+	 *   base(block,q,s) = base[(block*18+q)*2+s] for blocks of 2^ScaLBL_NEIGHBOR_BLOCK_SHIFT sites
+	 *      s=0: median offset in the block, s=1: median of the offsets that do not fit around the first
+	 *      (links between the exterior and interior sets are far apart in memory)
+	 *   bounce-back links are stored as ScaLBL_NEIGHBOR_BOUNCEBACK
+	 *   blocks with an offset that does not fit in 15 bits around either base are marked
+	 *   ScaLBL_NEIGHBOR_FULL (read the full list)
+	 * base must hold 36*(Np/blocksize+1) values
+	 * returns the number of blocks that read the full list
+	 */
+	const long int range = 16383;
+	int blocksize = 1 << ScaLBL_NEIGHBOR_BLOCK_SHIFT;
+	int nblocks = Np/blocksize + 1;
+	int full = 0;
+	std::vector<int> offsets, others;
+	for (int block=0; block<nblocks; block++){
+		int start = block*blocksize;
+		int finish = std::min(start+blocksize,Np);
+		bool fits = true;
+		for (int q=0; q<18; q++){
+			offsets.clear();
+			for (int idx=start; idx<finish; idx++){
+				if ((idx < next) || (idx >= first_interior && idx < last_interior)){
+					int value = neighborList[q*Np+idx];
+					if (value/Np == q+1 && value != idx + ((q^1)+1)*Np) offsets.push_back(value%Np - idx);
+				}
+			}
+			int b0 = 0;
+			int b1 = 0;
+			if (offsets.size() > 0){
+				std::nth_element(offsets.begin(),offsets.begin()+offsets.size()/2,offsets.end());
+				b0 = offsets[offsets.size()/2];
+				others.clear();
+				for (size_t m=0; m<offsets.size(); m++){
+					if (std::abs((long int)offsets[m] - b0) > range) others.push_back(offsets[m]);
+				}
+				if (others.size() > 0){
+					std::nth_element(others.begin(),others.begin()+others.size()/2,others.end());
+					b1 = others[others.size()/2];
+				}
+			}
+			base[(block*18+q)*2] = b0;
+			base[(block*18+q)*2+1] = b1;
+			for (int idx=start; idx<finish; idx++){
+				offset[q*Np+idx] = ScaLBL_NEIGHBOR_BOUNCEBACK;
+				if ((idx < next) || (idx >= first_interior && idx < last_interior)){
+					int value = neighborList[q*Np+idx];
+					long int d0 = (long int)(value%Np) - idx - b0;
+					long int d1 = (long int)(value%Np) - idx - b1;
+					if (value == idx + ((q^1)+1)*Np){
+						offset[q*Np+idx] = ScaLBL_NEIGHBOR_BOUNCEBACK;
+					}
+					else if (value/Np == q+1 && std::abs(d0) <= range){
+						offset[q*Np+idx] = short(2*d0);
+					}
+					else if (value/Np == q+1 && std::abs(d1) <= range){
+						offset[q*Np+idx] = short(2*d1+1);
+					}
+					else {
+						fits = false;
+					}
+				}
+			}
+		}
+		if (!fits){
+			for (int q=0; q<36; q++) base[block*36+q] = ScaLBL_NEIGHBOR_FULL;
+			full++;
+		}
+	}
+	return full;
+}
+
+// Packing for either storage type (single precision messages use the first half of each buffer)
+static inline void D3Q19_Pack(int q, int *list, int start, int count, double *sendbuf, double *dist, int N){
+	ScaLBL_D3Q19_Pack(q,list,start,count,sendbuf,dist,N);
+}
+static inline void D3Q19_Pack(int q, int *list, int start, int count, double *sendbuf, float *dist, int N){
+	ScaLBL_D3Q19_Pack_Single(q,list,start,count,(float *)sendbuf,dist,N);
+}
+static inline void D3Q19_PackFace(int q1, int q2, int q3, int q4, int q5, int *list, int count, double *sendbuf, double *dist, int N){
+	ScaLBL_D3Q19_PackFace(q1,q2,q3,q4,q5,list,count,sendbuf,dist,N);
+}
+static inline void D3Q19_PackFace(int q1, int q2, int q3, int q4, int q5, int *list, int count, double *sendbuf, float *dist, int N){
+	ScaLBL_D3Q19_PackFace_Single(q1,q2,q3,q4,q5,list,count,(float *)sendbuf,dist,N);
+}
+static inline void D3Q19_Unpack(int q, int *list, int start, int count, double *recvbuf, double *dist, int N){
+	ScaLBL_D3Q19_Unpack(q,list,start,count,recvbuf,dist,N);
+}
+static inline void D3Q19_Unpack(int q, int *list, int start, int count, double *recvbuf, float *dist, int N){
+	ScaLBL_D3Q19_Unpack_Single(q,list,start,count,(float *)recvbuf,dist,N);
+}
+static inline void D3Q19_UnpackFace(const int *q, int *list, int count, double *recvbuf, double *dist, int N){
+	ScaLBL_D3Q19_UnpackFace(q[0],q[1],q[2],q[3],q[4],list,count,recvbuf,dist,N);
+}
+static inline void D3Q19_UnpackFace(const int *q, int *list, int count, double *recvbuf, float *dist, int N){
+	ScaLBL_D3Q19_UnpackFace_Single(q[0],q[1],q[2],q[3],q[4],list,count,(float *)recvbuf,dist,N);
+}
+
 void ScaLBL_Communicator::SendD3Q19AA(double *dist){
+	SendD3Q19(dist,req_D3Q19AA);
+}
+
+void ScaLBL_Communicator::SendD3Q19AA(float *dist){
+	SendD3Q19(dist,req_D3Q19AA_Single);
+}
+
+void ScaLBL_Communicator::RecvD3Q19AA(double *dist){
+	RecvD3Q19(dist,req_D3Q19AA);
+}
+
+void ScaLBL_Communicator::RecvD3Q19AA(float *dist){
+	RecvD3Q19(dist,req_D3Q19AA_Single);
+}
+
+template<class TYPE>
+void ScaLBL_Communicator::SendD3Q19(TYPE *dist, MPI_Request *req){
+	PROFILE_SCOPED(timer,"Pack and send",1);
 
 	// NOTE: the center distribution f0 must NOT be at the start of feven, provide offset to start of f2
 	if (Lock==true){
@@ -874,249 +1350,105 @@ void ScaLBL_Communicator::SendD3Q19AA(double *dist){
 	else{
 		Lock=true;
 	}
-	// assign tag of 19 to D3Q19 communication
-	sendtag = recvtag = 19;
+	StartRecv(req,true);
 	ScaLBL_DeviceBarrier();
-	// Pack the distributions
-	//...Packing for x face(2,8,10,12,14)................................
-	ScaLBL_D3Q19_Pack(2,dvcSendList_x,0,sendCount_x,sendbuf_x,dist,N);
-	ScaLBL_D3Q19_Pack(8,dvcSendList_x,sendCount_x,sendCount_x,sendbuf_x,dist,N);
-	ScaLBL_D3Q19_Pack(10,dvcSendList_x,2*sendCount_x,sendCount_x,sendbuf_x,dist,N);
-	ScaLBL_D3Q19_Pack(12,dvcSendList_x,3*sendCount_x,sendCount_x,sendbuf_x,dist,N);
-	ScaLBL_D3Q19_Pack(14,dvcSendList_x,4*sendCount_x,sendCount_x,sendbuf_x,dist,N);
-	
-	MPI_Isend(sendbuf_x, 5*sendCount_x,MPI_DOUBLE,rank_x,sendtag,MPI_COMM_SCALBL,&req1[0]);
-	MPI_Irecv(recvbuf_X, 5*recvCount_X,MPI_DOUBLE,rank_X,recvtag,MPI_COMM_SCALBL,&req2[0]);
-	//...Packing for X face(1,7,9,11,13)................................
-	ScaLBL_D3Q19_Pack(1,dvcSendList_X,0,sendCount_X,sendbuf_X,dist,N);
-	ScaLBL_D3Q19_Pack(7,dvcSendList_X,sendCount_X,sendCount_X,sendbuf_X,dist,N);
-	ScaLBL_D3Q19_Pack(9,dvcSendList_X,2*sendCount_X,sendCount_X,sendbuf_X,dist,N);
-	ScaLBL_D3Q19_Pack(11,dvcSendList_X,3*sendCount_X,sendCount_X,sendbuf_X,dist,N);
-	ScaLBL_D3Q19_Pack(13,dvcSendList_X,4*sendCount_X,sendCount_X,sendbuf_X,dist,N);
-	
-	MPI_Isend(sendbuf_X, 5*sendCount_X,MPI_DOUBLE,rank_X,sendtag,MPI_COMM_SCALBL,&req1[1]);
-	MPI_Irecv(recvbuf_x, 5*recvCount_x,MPI_DOUBLE,rank_x,recvtag,MPI_COMM_SCALBL,&req2[1]);
-	//...Packing for y face(4,8,9,16,18).................................
-	ScaLBL_D3Q19_Pack(4,dvcSendList_y,0,sendCount_y,sendbuf_y,dist,N);
-	ScaLBL_D3Q19_Pack(8,dvcSendList_y,sendCount_y,sendCount_y,sendbuf_y,dist,N);
-	ScaLBL_D3Q19_Pack(9,dvcSendList_y,2*sendCount_y,sendCount_y,sendbuf_y,dist,N);
-	ScaLBL_D3Q19_Pack(16,dvcSendList_y,3*sendCount_y,sendCount_y,sendbuf_y,dist,N);
-	ScaLBL_D3Q19_Pack(18,dvcSendList_y,4*sendCount_y,sendCount_y,sendbuf_y,dist,N);
-	
-	MPI_Isend(sendbuf_y, 5*sendCount_y,MPI_DOUBLE,rank_y,sendtag,MPI_COMM_SCALBL,&req1[2]);
-	MPI_Irecv(recvbuf_Y, 5*recvCount_Y,MPI_DOUBLE,rank_Y,recvtag,MPI_COMM_SCALBL,&req2[2]);
-	//...Packing for Y face(3,7,10,15,17).................................
-	ScaLBL_D3Q19_Pack(3,dvcSendList_Y,0,sendCount_Y,sendbuf_Y,dist,N);
-	ScaLBL_D3Q19_Pack(7,dvcSendList_Y,sendCount_Y,sendCount_Y,sendbuf_Y,dist,N);
-	ScaLBL_D3Q19_Pack(10,dvcSendList_Y,2*sendCount_Y,sendCount_Y,sendbuf_Y,dist,N);
-	ScaLBL_D3Q19_Pack(15,dvcSendList_Y,3*sendCount_Y,sendCount_Y,sendbuf_Y,dist,N);
-	ScaLBL_D3Q19_Pack(17,dvcSendList_Y,4*sendCount_Y,sendCount_Y,sendbuf_Y,dist,N);
-	
-	MPI_Isend(sendbuf_Y, 5*sendCount_Y,MPI_DOUBLE,rank_Y,sendtag,MPI_COMM_SCALBL,&req1[3]);
-	MPI_Irecv(recvbuf_y, 5*recvCount_y,MPI_DOUBLE,rank_y,recvtag,MPI_COMM_SCALBL,&req2[3]);
-	//...Packing for z face(6,12,13,16,17)................................
-	ScaLBL_D3Q19_Pack(6,dvcSendList_z,0,sendCount_z,sendbuf_z,dist,N);
-	ScaLBL_D3Q19_Pack(12,dvcSendList_z,sendCount_z,sendCount_z,sendbuf_z,dist,N);
-	ScaLBL_D3Q19_Pack(13,dvcSendList_z,2*sendCount_z,sendCount_z,sendbuf_z,dist,N);
-	ScaLBL_D3Q19_Pack(16,dvcSendList_z,3*sendCount_z,sendCount_z,sendbuf_z,dist,N);
-	ScaLBL_D3Q19_Pack(17,dvcSendList_z,4*sendCount_z,sendCount_z,sendbuf_z,dist,N);
-	
-	MPI_Isend(sendbuf_z, 5*sendCount_z,MPI_DOUBLE,rank_z,sendtag,MPI_COMM_SCALBL,&req1[4]);
-	MPI_Irecv(recvbuf_Z, 5*recvCount_Z,MPI_DOUBLE,rank_Z,recvtag,MPI_COMM_SCALBL,&req2[4]);
-	
-	//...Packing for Z face(5,11,14,15,18)................................
-	ScaLBL_D3Q19_Pack(5,dvcSendList_Z,0,sendCount_Z,sendbuf_Z,dist,N);
-	ScaLBL_D3Q19_Pack(11,dvcSendList_Z,sendCount_Z,sendCount_Z,sendbuf_Z,dist,N);
-	ScaLBL_D3Q19_Pack(14,dvcSendList_Z,2*sendCount_Z,sendCount_Z,sendbuf_Z,dist,N);
-	ScaLBL_D3Q19_Pack(15,dvcSendList_Z,3*sendCount_Z,sendCount_Z,sendbuf_Z,dist,N);
-	ScaLBL_D3Q19_Pack(18,dvcSendList_Z,4*sendCount_Z,sendCount_Z,sendbuf_Z,dist,N);
-	
-	MPI_Isend(sendbuf_Z, 5*sendCount_Z,MPI_DOUBLE,rank_Z,sendtag,MPI_COMM_SCALBL,&req1[5]);
-	MPI_Irecv(recvbuf_z, 5*recvCount_z,MPI_DOUBLE,rank_z,recvtag,MPI_COMM_SCALBL,&req2[5]);
-	
+	// Pack the distributions and start each message as soon as its buffer is ready
+	// edges are packed first since aggregated face messages carry them
 	//...Pack the xy edge (8)................................
-	ScaLBL_D3Q19_Pack(8,dvcSendList_xy,0,sendCount_xy,sendbuf_xy,dist,N);
-	MPI_Isend(sendbuf_xy, sendCount_xy,MPI_DOUBLE,rank_xy,sendtag,MPI_COMM_SCALBL,&req1[6]);
-	MPI_Irecv(recvbuf_XY, recvCount_XY,MPI_DOUBLE,rank_XY,recvtag,MPI_COMM_SCALBL,&req2[6]);
+	D3Q19_Pack(8,dvcSendList_xy,0,sendCount_xy,sendbuf_xy,dist,N);
+	StartSend(req,6,true);
+	//...Pack the XY edge (7)................................
+	D3Q19_Pack(7,dvcSendList_XY,0,sendCount_XY,sendbuf_XY,dist,N);
+	StartSend(req,7,true);
 	//...Pack the Xy edge (9)................................
-	ScaLBL_D3Q19_Pack(9,dvcSendList_Xy,0,sendCount_Xy,sendbuf_Xy,dist,N);
-	MPI_Isend(sendbuf_Xy, sendCount_Xy,MPI_DOUBLE,rank_Xy,sendtag,MPI_COMM_SCALBL,&req1[8]);
-	MPI_Irecv(recvbuf_xY, recvCount_xY,MPI_DOUBLE,rank_xY,recvtag,MPI_COMM_SCALBL,&req2[8]);
+	D3Q19_Pack(9,dvcSendList_Xy,0,sendCount_Xy,sendbuf_Xy,dist,N);
+	StartSend(req,8,true);
 	//...Pack the xY edge (10)................................
-	ScaLBL_D3Q19_Pack(10,dvcSendList_xY,0,sendCount_xY,sendbuf_xY,dist,N);
-	MPI_Isend(sendbuf_xY, sendCount_xY,MPI_DOUBLE,rank_xY,sendtag,MPI_COMM_SCALBL,&req1[9]);
-	MPI_Irecv(recvbuf_Xy, recvCount_Xy,MPI_DOUBLE,rank_Xy,recvtag,MPI_COMM_SCALBL,&req2[9]);
-	//...Pack the XY edge (7)................................
-	ScaLBL_D3Q19_Pack(7,dvcSendList_XY,0,sendCount_XY,sendbuf_XY,dist,N);
-	MPI_Isend(sendbuf_XY, sendCount_XY,MPI_DOUBLE,rank_XY,sendtag,MPI_COMM_SCALBL,&req1[7]);
-	MPI_Irecv(recvbuf_xy, recvCount_xy,MPI_DOUBLE,rank_xy,recvtag,MPI_COMM_SCALBL,&req2[7]);
+	D3Q19_Pack(10,dvcSendList_xY,0,sendCount_xY,sendbuf_xY,dist,N);
+	StartSend(req,9,true);
 	//...Pack the xz edge (12)................................
-	ScaLBL_D3Q19_Pack(12,dvcSendList_xz,0,sendCount_xz,sendbuf_xz,dist,N);
-	MPI_Isend(sendbuf_xz, sendCount_xz,MPI_DOUBLE,rank_xz,sendtag,MPI_COMM_SCALBL,&req1[10]);
-	MPI_Irecv(recvbuf_XZ, recvCount_XZ,MPI_DOUBLE,rank_XZ,recvtag,MPI_COMM_SCALBL,&req2[10]);
-	//...Pack the xZ edge (14)................................
-	ScaLBL_D3Q19_Pack(14,dvcSendList_xZ,0,sendCount_xZ,sendbuf_xZ,dist,N);
-	MPI_Isend(sendbuf_xZ, sendCount_xZ,MPI_DOUBLE,rank_xZ,sendtag,MPI_COMM_SCALBL,&req1[13]);
-	MPI_Irecv(recvbuf_Xz, recvCount_Xz,MPI_DOUBLE,rank_Xz,recvtag,MPI_COMM_SCALBL,&req2[13]);
-	//...Pack the Xz edge (13)................................
-	ScaLBL_D3Q19_Pack(13,dvcSendList_Xz,0,sendCount_Xz,sendbuf_Xz,dist,N);
-	MPI_Isend(sendbuf_Xz, sendCount_Xz,MPI_DOUBLE,rank_Xz,sendtag,MPI_COMM_SCALBL,&req1[12]);
-	MPI_Irecv(recvbuf_xZ, recvCount_xZ,MPI_DOUBLE,rank_xZ,recvtag,MPI_COMM_SCALBL,&req2[12]);
+	D3Q19_Pack(12,dvcSendList_xz,0,sendCount_xz,sendbuf_xz,dist,N);
+	StartSend(req,10,true);
 	//...Pack the XZ edge (11)................................
-	ScaLBL_D3Q19_Pack(11,dvcSendList_XZ,0,sendCount_XZ,sendbuf_XZ,dist,N);
-	MPI_Isend(sendbuf_XZ, sendCount_XZ,MPI_DOUBLE,rank_XZ,sendtag,MPI_COMM_SCALBL,&req1[11]);
-	MPI_Irecv(recvbuf_xz, recvCount_xz,MPI_DOUBLE,rank_xz,recvtag,MPI_COMM_SCALBL,&req2[11]);
+	D3Q19_Pack(11,dvcSendList_XZ,0,sendCount_XZ,sendbuf_XZ,dist,N);
+	StartSend(req,11,true);
+	//...Pack the Xz edge (13)................................
+	D3Q19_Pack(13,dvcSendList_Xz,0,sendCount_Xz,sendbuf_Xz,dist,N);
+	StartSend(req,12,true);
+	//...Pack the xZ edge (14)................................
+	D3Q19_Pack(14,dvcSendList_xZ,0,sendCount_xZ,sendbuf_xZ,dist,N);
+	StartSend(req,13,true);
 	//...Pack the yz edge (16)................................
-	ScaLBL_D3Q19_Pack(16,dvcSendList_yz,0,sendCount_yz,sendbuf_yz,dist,N);
-	MPI_Isend(sendbuf_yz, sendCount_yz,MPI_DOUBLE,rank_yz,sendtag,MPI_COMM_SCALBL,&req1[14]);
-	MPI_Irecv(recvbuf_YZ, recvCount_YZ,MPI_DOUBLE,rank_YZ,recvtag,MPI_COMM_SCALBL,&req2[14]);
-	//...Pack the yZ edge (18)................................
-	ScaLBL_D3Q19_Pack(18,dvcSendList_yZ,0,sendCount_yZ,sendbuf_yZ,dist,N);
-	MPI_Isend(sendbuf_yZ, sendCount_yZ,MPI_DOUBLE,rank_yZ,sendtag,MPI_COMM_SCALBL,&req1[17]);
-	MPI_Irecv(recvbuf_Yz, recvCount_Yz,MPI_DOUBLE,rank_Yz,recvtag,MPI_COMM_SCALBL,&req2[17]);
-	//...Pack the Yz edge (17)................................
-	ScaLBL_D3Q19_Pack(17,dvcSendList_Yz,0,sendCount_Yz,sendbuf_Yz,dist,N);
-	MPI_Isend(sendbuf_Yz, sendCount_Yz,MPI_DOUBLE,rank_Yz,sendtag,MPI_COMM_SCALBL,&req1[16]);
-	MPI_Irecv(recvbuf_yZ, recvCount_yZ,MPI_DOUBLE,rank_yZ,recvtag,MPI_COMM_SCALBL,&req2[16]);
+	D3Q19_Pack(16,dvcSendList_yz,0,sendCount_yz,sendbuf_yz,dist,N);
+	StartSend(req,14,true);
 	//...Pack the YZ edge (15)................................
-	ScaLBL_D3Q19_Pack(15,dvcSendList_YZ,0,sendCount_YZ,sendbuf_YZ,dist,N);
-	MPI_Isend(sendbuf_YZ, sendCount_YZ,MPI_DOUBLE,rank_YZ,sendtag,MPI_COMM_SCALBL,&req1[15]);
-	MPI_Irecv(recvbuf_yz, recvCount_yz,MPI_DOUBLE,rank_yz,recvtag,MPI_COMM_SCALBL,&req2[15]);
+	D3Q19_Pack(15,dvcSendList_YZ,0,sendCount_YZ,sendbuf_YZ,dist,N);
+	StartSend(req,15,true);
+	//...Pack the Yz edge (17)................................
+	D3Q19_Pack(17,dvcSendList_Yz,0,sendCount_Yz,sendbuf_Yz,dist,N);
+	StartSend(req,16,true);
+	//...Pack the yZ edge (18)................................
+	D3Q19_Pack(18,dvcSendList_yZ,0,sendCount_yZ,sendbuf_yZ,dist,N);
+	StartSend(req,17,true);
+	//...Packing for x face(2,8,10,12,14)................................
+	D3Q19_PackFace(2,8,10,12,14,dvcSendList_x,sendCount_x,sendbuf_x,dist,N);
+	StartSend(req,0,true);
+	//...Packing for X face(1,7,9,11,13)................................
+	D3Q19_PackFace(1,7,9,11,13,dvcSendList_X,sendCount_X,sendbuf_X,dist,N);
+	StartSend(req,1,true);
+	//...Packing for y face(4,8,9,16,18).................................
+	D3Q19_PackFace(4,8,9,16,18,dvcSendList_y,sendCount_y,sendbuf_y,dist,N);
+	StartSend(req,2,true);
+	//...Packing for Y face(3,7,10,15,17).................................
+	D3Q19_PackFace(3,7,10,15,17,dvcSendList_Y,sendCount_Y,sendbuf_Y,dist,N);
+	StartSend(req,3,true);
+	//...Packing for z face(6,12,13,16,17)................................
+	D3Q19_PackFace(6,12,13,16,17,dvcSendList_z,sendCount_z,sendbuf_z,dist,N);
+	StartSend(req,4,true);
+	//...Packing for Z face(5,11,14,15,18)................................
+	D3Q19_PackFace(5,11,14,15,18,dvcSendList_Z,sendCount_Z,sendbuf_Z,dist,N);
+	StartSend(req,5,true);
 	//...................................................................................
 
 }
 
-void ScaLBL_Communicator::RecvD3Q19AA(double *dist){
+template<class TYPE>
+void ScaLBL_Communicator::RecvD3Q19(TYPE *dist, MPI_Request *req){
+	PROFILE_SCOPED(timer,"Wait and unpack",1);
 
 	// NOTE: the center distribution f0 must NOT be at the start of feven, provide offset to start of f2
-	//...................................................................................
-	// Wait for completion of D3Q19 communication
-	MPI_Waitall(18,req1,stat1);
-	MPI_Waitall(18,req2,stat2);
-	ScaLBL_DeviceBarrier();
-
 	//...................................................................................
 	// NOTE: AA Routine writes to opposite 
-	// Unpack the distributions on the device
-	//...................................................................................
-	//...Unpacking for x face(2,8,10,12,14)................................
-	ScaLBL_D3Q19_Unpack(2,dvcRecvDist_x,0,recvCount_x,recvbuf_x,dist,N);
-	ScaLBL_D3Q19_Unpack(8,dvcRecvDist_x,recvCount_x,recvCount_x,recvbuf_x,dist,N);
-	ScaLBL_D3Q19_Unpack(10,dvcRecvDist_x,2*recvCount_x,recvCount_x,recvbuf_x,dist,N);
-	ScaLBL_D3Q19_Unpack(12,dvcRecvDist_x,3*recvCount_x,recvCount_x,recvbuf_x,dist,N);
-	ScaLBL_D3Q19_Unpack(14,dvcRecvDist_x,4*recvCount_x,recvCount_x,recvbuf_x,dist,N);
-	//...................................................................................
-	//...Packing for X face(1,7,9,11,13)................................
-	ScaLBL_D3Q19_Unpack(1,dvcRecvDist_X,0,recvCount_X,recvbuf_X,dist,N);
-	ScaLBL_D3Q19_Unpack(7,dvcRecvDist_X,recvCount_X,recvCount_X,recvbuf_X,dist,N);
-	ScaLBL_D3Q19_Unpack(9,dvcRecvDist_X,2*recvCount_X,recvCount_X,recvbuf_X,dist,N);
-	ScaLBL_D3Q19_Unpack(11,dvcRecvDist_X,3*recvCount_X,recvCount_X,recvbuf_X,dist,N);
-	ScaLBL_D3Q19_Unpack(13,dvcRecvDist_X,4*recvCount_X,recvCount_X,recvbuf_X,dist,N);
-	//...................................................................................
-	//...Packing for y face(4,8,9,16,18).................................
-	ScaLBL_D3Q19_Unpack(4,dvcRecvDist_y,0,recvCount_y,recvbuf_y,dist,N);
-	ScaLBL_D3Q19_Unpack(8,dvcRecvDist_y,recvCount_y,recvCount_y,recvbuf_y,dist,N);
-	ScaLBL_D3Q19_Unpack(9,dvcRecvDist_y,2*recvCount_y,recvCount_y,recvbuf_y,dist,N);
-	ScaLBL_D3Q19_Unpack(16,dvcRecvDist_y,3*recvCount_y,recvCount_y,recvbuf_y,dist,N);
-	ScaLBL_D3Q19_Unpack(18,dvcRecvDist_y,4*recvCount_y,recvCount_y,recvbuf_y,dist,N);
-	//...................................................................................
-	//...Packing for Y face(3,7,10,15,17).................................
-	ScaLBL_D3Q19_Unpack(3,dvcRecvDist_Y,0,recvCount_Y,recvbuf_Y,dist,N);
-	ScaLBL_D3Q19_Unpack(7,dvcRecvDist_Y,recvCount_Y,recvCount_Y,recvbuf_Y,dist,N);
-	ScaLBL_D3Q19_Unpack(10,dvcRecvDist_Y,2*recvCount_Y,recvCount_Y,recvbuf_Y,dist,N);
-	ScaLBL_D3Q19_Unpack(15,dvcRecvDist_Y,3*recvCount_Y,recvCount_Y,recvbuf_Y,dist,N);
-	ScaLBL_D3Q19_Unpack(17,dvcRecvDist_Y,4*recvCount_Y,recvCount_Y,recvbuf_Y,dist,N);
+	// Unpack the distributions on the device as each message arrives
 	//...................................................................................
-	//...Pack the xy edge (8)................................
-	ScaLBL_D3Q19_Unpack(8,dvcRecvDist_xy,0,recvCount_xy,recvbuf_xy,dist,N);
-	//...Pack the Xy edge (9)................................
-	ScaLBL_D3Q19_Unpack(9,dvcRecvDist_Xy,0,recvCount_Xy,recvbuf_Xy,dist,N);
-	//...Pack the xY edge (10)................................
-	ScaLBL_D3Q19_Unpack(10,dvcRecvDist_xY,0,recvCount_xY,recvbuf_xY,dist,N);
-	//...Pack the XY edge (7)................................
-	ScaLBL_D3Q19_Unpack(7,dvcRecvDist_XY,0,recvCount_XY,recvbuf_XY,dist,N);
-
-	if (BoundaryCondition > 0){
-		if (kproc != 0){
-			//...Packing for z face(6,12,13,16,17)................................
-			ScaLBL_D3Q19_Unpack(6,dvcRecvDist_z,0,recvCount_z,recvbuf_z,dist,N);
-			ScaLBL_D3Q19_Unpack(12,dvcRecvDist_z,recvCount_z,recvCount_z,recvbuf_z,dist,N);
-			ScaLBL_D3Q19_Unpack(13,dvcRecvDist_z,2*recvCount_z,recvCount_z,recvbuf_z,dist,N);
-			ScaLBL_D3Q19_Unpack(16,dvcRecvDist_z,3*recvCount_z,recvCount_z,recvbuf_z,dist,N);
-			ScaLBL_D3Q19_Unpack(17,dvcRecvDist_z,4*recvCount_z,recvCount_z,recvbuf_z,dist,N);
-			//...Pack the xz edge (12)................................
-			ScaLBL_D3Q19_Unpack(12,dvcRecvDist_xz,0,recvCount_xz,recvbuf_xz,dist,N);
-			//...Pack the Xz edge (13)................................
-			ScaLBL_D3Q19_Unpack(13,dvcRecvDist_Xz,0,recvCount_Xz,recvbuf_Xz,dist,N);
-			//...Pack the yz edge (16)................................
-			ScaLBL_D3Q19_Unpack(16,dvcRecvDist_yz,0,recvCount_yz,recvbuf_yz,dist,N);
-			//...Pack the Yz edge (17)................................
-			ScaLBL_D3Q19_Unpack(17,dvcRecvDist_Yz,0,recvCount_Yz,recvbuf_Yz,dist,N);
-			//..................................................................................
-		}
-		if (kproc != nprocz-1){
-			//...Packing for Z face(5,11,14,15,18)................................
-			ScaLBL_D3Q19_Unpack(5,dvcRecvDist_Z,0,recvCount_Z,recvbuf_Z,dist,N);
-			ScaLBL_D3Q19_Unpack(11,dvcRecvDist_Z,recvCount_Z,recvCount_Z,recvbuf_Z,dist,N);
-			ScaLBL_D3Q19_Unpack(14,dvcRecvDist_Z,2*recvCount_Z,recvCount_Z,recvbuf_Z,dist,N);
-			ScaLBL_D3Q19_Unpack(15,dvcRecvDist_Z,3*recvCount_Z,recvCount_Z,recvbuf_Z,dist,N);
-			ScaLBL_D3Q19_Unpack(18,dvcRecvDist_Z,4*recvCount_Z,recvCount_Z,recvbuf_Z,dist,N);
-			//...Pack the xZ edge (14)................................
-			ScaLBL_D3Q19_Unpack(14,dvcRecvDist_xZ,0,recvCount_xZ,recvbuf_xZ,dist,N);
-			//...Pack the XZ edge (11)................................
-			ScaLBL_D3Q19_Unpack(11,dvcRecvDist_XZ,0,recvCount_XZ,recvbuf_XZ,dist,N);
-			//...Pack the yZ edge (18)................................
-			ScaLBL_D3Q19_Unpack(18,dvcRecvDist_yZ,0,recvCount_yZ,recvbuf_yZ,dist,N);
-			//...Pack the YZ edge (15)................................
-			ScaLBL_D3Q19_Unpack(15,dvcRecvDist_YZ,0,recvCount_YZ,recvbuf_YZ,dist,N);
-			//..................................................................................
+	// distributions held by recieve buffer idx: X, x, Y, y, Z, z faces (5 each), then the edges
+	static const int face_q[6][5] = { {1,7,9,11,13}, {2,8,10,12,14}, {3,7,10,15,17},
+			{4,8,9,16,18}, {5,11,14,15,18}, {6,12,13,16,17} };
+	static const int edge_q[12] = { 7, 8, 10, 9, 11, 12, 14, 13, 15, 16, 18, 17 };
+	int n,idx,nready,ready[5];
+	while ((nready = WaitNext(req,true,ready)) > 0){
+		for (n=0; n<nready; n++){
+			idx = ready[n];
+			if (BoundaryRecv(idx)) continue;
+			if (idx < 6)
+				D3Q19_UnpackFace(face_q[idx],dvcRecvDist[idx],recvCount[idx],recvbuf[idx],dist,N);
+			else
+				D3Q19_Unpack(edge_q[idx-6],dvcRecvDist[idx],0,recvCount[idx],recvbuf[idx],dist,N);
 		}
 	}
-	else {
-		//...Packing for z face(6,12,13,16,17)................................
-		ScaLBL_D3Q19_Unpack(6,dvcRecvDist_z,0,recvCount_z,recvbuf_z,dist,N);
-		ScaLBL_D3Q19_Unpack(12,dvcRecvDist_z,recvCount_z,recvCount_z,recvbuf_z,dist,N);
-		ScaLBL_D3Q19_Unpack(13,dvcRecvDist_z,2*recvCount_z,recvCount_z,recvbuf_z,dist,N);
-		ScaLBL_D3Q19_Unpack(16,dvcRecvDist_z,3*recvCount_z,recvCount_z,recvbuf_z,dist,N);
-		ScaLBL_D3Q19_Unpack(17,dvcRecvDist_z,4*recvCount_z,recvCount_z,recvbuf_z,dist,N);
-		//...Packing for Z face(5,11,14,15,18)................................
-		ScaLBL_D3Q19_Unpack(5,dvcRecvDist_Z,0,recvCount_Z,recvbuf_Z,dist,N);
-		ScaLBL_D3Q19_Unpack(11,dvcRecvDist_Z,recvCount_Z,recvCount_Z,recvbuf_Z,dist,N);
-		ScaLBL_D3Q19_Unpack(14,dvcRecvDist_Z,2*recvCount_Z,recvCount_Z,recvbuf_Z,dist,N);
-		ScaLBL_D3Q19_Unpack(15,dvcRecvDist_Z,3*recvCount_Z,recvCount_Z,recvbuf_Z,dist,N);
-		ScaLBL_D3Q19_Unpack(18,dvcRecvDist_Z,4*recvCount_Z,recvCount_Z,recvbuf_Z,dist,N);
-		//..................................................................................
-		//...Pack the xz edge (12)................................
-		ScaLBL_D3Q19_Unpack(12,dvcRecvDist_xz,0,recvCount_xz,recvbuf_xz,dist,N);
-		//...Pack the xZ edge (14)................................
-		ScaLBL_D3Q19_Unpack(14,dvcRecvDist_xZ,0,recvCount_xZ,recvbuf_xZ,dist,N);
-		//...Pack the Xz edge (13)................................
-		ScaLBL_D3Q19_Unpack(13,dvcRecvDist_Xz,0,recvCount_Xz,recvbuf_Xz,dist,N);
-		//...Pack the XZ edge (11)................................
-		ScaLBL_D3Q19_Unpack(11,dvcRecvDist_XZ,0,recvCount_XZ,recvbuf_XZ,dist,N);
-		//...Pack the yz edge (16)................................
-		ScaLBL_D3Q19_Unpack(16,dvcRecvDist_yz,0,recvCount_yz,recvbuf_yz,dist,N);
-		//...Pack the yZ edge (18)................................
-		ScaLBL_D3Q19_Unpack(18,dvcRecvDist_yZ,0,recvCount_yZ,recvbuf_yZ,dist,N);
-		//...Pack the Yz edge (17)................................
-		ScaLBL_D3Q19_Unpack(17,dvcRecvDist_Yz,0,recvCount_Yz,recvbuf_Yz,dist,N);
-		//...Pack the YZ edge (15)................................
-		ScaLBL_D3Q19_Unpack(15,dvcRecvDist_YZ,0,recvCount_YZ,recvbuf_YZ,dist,N);
-	}
-
+	ScaLBL_DeviceBarrier();
 	//...................................................................................
 	Lock=false; // unlock the communicator after communications complete
 	//...................................................................................
-
 }
 
 void ScaLBL_Communicator::RecvGrad(double *phi, double *grad){
+	PROFILE_SCOPED(timer,"Wait and unpack",1);
 
 	// Recieves halo and incorporates into D3Q19 based stencil gradient computation
 	//...................................................................................
 	// Wait for completion of D3Q19 communication
-	MPI_Waitall(18,req1,stat1);
-	MPI_Waitall(18,req2,stat2);
+	WaitExchange(req_Halo,true);
 	ScaLBL_DeviceBarrier();
 
 	//...................................................................................
@@ -1194,6 +1526,7 @@ void ScaLBL_Communicator::RecvGrad(double *phi, double *grad){
 }
 
 void ScaLBL_Communicator::BiSendD3Q7AA(double *Aq, double *Bq){
+	PROFILE_SCOPED(timer,"Pack and send",1);
 
 	// NOTE: the center distribution f0 must NOT be at the start of feven, provide offset to start of f2
 	if (Lock==true){
@@ -1202,107 +1535,47 @@ void ScaLBL_Communicator::BiSendD3Q7AA(double *Aq, double *Bq){
 	else{
 		Lock=true;
 	}
-	// assign tag of 19 to D3Q19 communication
-	sendtag = recvtag = 14;
+	StartRecv(req_BiD3Q7AA,false);
 	ScaLBL_DeviceBarrier();
-	// Pack the distributions
+	// Pack the distributions and start each message as soon as its buffer is ready
 	//...Packing for x face(2,8,10,12,14)................................
-	ScaLBL_D3Q19_Pack(2,dvcSendList_x,0,sendCount_x,sendbuf_x,Aq,N);
-	ScaLBL_D3Q19_Pack(2,dvcSendList_x,sendCount_x,sendCount_x,sendbuf_x,Bq,N);
-
-	MPI_Isend(sendbuf_x, 2*sendCount_x,MPI_DOUBLE,rank_x,sendtag,MPI_COMM_SCALBL,&req1[0]);
-	MPI_Irecv(recvbuf_X, 2*recvCount_X,MPI_DOUBLE,rank_X,recvtag,MPI_COMM_SCALBL,&req2[0]);
-	
+	ScaLBL_D3Q7_BiPack(2,dvcSendList_x,sendCount_x,sendbuf_x,Aq,Bq,N);
+	StartSend(req_BiD3Q7AA,0,false);
 	//...Packing for X face(1,7,9,11,13)................................
-	ScaLBL_D3Q19_Pack(1,dvcSendList_X,0,sendCount_X,sendbuf_X,Aq,N);
-	ScaLBL_D3Q19_Pack(1,dvcSendList_X,sendCount_X,sendCount_X,sendbuf_X,Bq,N);
-	
-	MPI_Isend(sendbuf_X, 2*sendCount_X,MPI_DOUBLE,rank_X,sendtag,MPI_COMM_SCALBL,&req1[1]);
-	MPI_Irecv(recvbuf_x, 2*recvCount_x,MPI_DOUBLE,rank_x,recvtag,MPI_COMM_SCALBL,&req2[1]);
-
-	//...Packing for y face(4,8,9,16,18).................................
-	ScaLBL_D3Q19_Pack(4,dvcSendList_y,0,sendCount_y,sendbuf_y,Aq,N);
-	ScaLBL_D3Q19_Pack(4,dvcSendList_y,sendCount_y,sendCount_y,sendbuf_y,Bq,N);
-
-	MPI_Isend(sendbuf_y, 2*sendCount_y,MPI_DOUBLE,rank_y,sendtag,MPI_COMM_SCALBL,&req1[2]);
-	MPI_Irecv(recvbuf_Y, 2*recvCount_Y,MPI_DOUBLE,rank_Y,recvtag,MPI_COMM_SCALBL,&req2[2]);
-	
-	//...Packing for Y face(3,7,10,15,17).................................
-	ScaLBL_D3Q19_Pack(3,dvcSendList_Y,0,sendCount_Y,sendbuf_Y,Aq,N);
-	ScaLBL_D3Q19_Pack(3,dvcSendList_Y,sendCount_Y,sendCount_Y,sendbuf_Y,Bq,N);
-
-	MPI_Isend(sendbuf_Y, 2*sendCount_Y,MPI_DOUBLE,rank_Y,sendtag,MPI_COMM_SCALBL,&req1[3]);
-	MPI_Irecv(recvbuf_y, 2*recvCount_y,MPI_DOUBLE,rank_y,recvtag,MPI_COMM_SCALBL,&req2[3]);
-	
+	ScaLBL_D3Q7_BiPack(1,dvcSendList_X,sendCount_X,sendbuf_X,Aq,Bq,N);
+	StartSend(req_BiD3Q7AA,1,false);
+	//...Packing for y face(4,8,9,16,18)................................
+	ScaLBL_D3Q7_BiPack(4,dvcSendList_y,sendCount_y,sendbuf_y,Aq,Bq,N);
+	StartSend(req_BiD3Q7AA,2,false);
+	//...Packing for Y face(3,7,10,15,17)................................
+	ScaLBL_D3Q7_BiPack(3,dvcSendList_Y,sendCount_Y,sendbuf_Y,Aq,Bq,N);
+	StartSend(req_BiD3Q7AA,3,false);
 	//...Packing for z face(6,12,13,16,17)................................
-	ScaLBL_D3Q19_Pack(6,dvcSendList_z,0,sendCount_z,sendbuf_z,Aq,N);
-	ScaLBL_D3Q19_Pack(6,dvcSendList_z,sendCount_z,sendCount_z,sendbuf_z,Bq,N);
-	
-	MPI_Isend(sendbuf_z, 2*sendCount_z,MPI_DOUBLE,rank_z,sendtag,MPI_COMM_SCALBL,&req1[4]);
-	MPI_Irecv(recvbuf_Z, 2*recvCount_Z,MPI_DOUBLE,rank_Z,recvtag,MPI_COMM_SCALBL,&req2[4]);
-	
+	ScaLBL_D3Q7_BiPack(6,dvcSendList_z,sendCount_z,sendbuf_z,Aq,Bq,N);
+	StartSend(req_BiD3Q7AA,4,false);
 	//...Packing for Z face(5,11,14,15,18)................................
-	ScaLBL_D3Q19_Pack(5,dvcSendList_Z,0,sendCount_Z,sendbuf_Z,Aq,N);
-	ScaLBL_D3Q19_Pack(5,dvcSendList_Z,sendCount_Z,sendCount_Z,sendbuf_Z,Bq,N);
-
+	ScaLBL_D3Q7_BiPack(5,dvcSendList_Z,sendCount_Z,sendbuf_Z,Aq,Bq,N);
+	StartSend(req_BiD3Q7AA,5,false);
 	//...................................................................................
-	// Send all the distributions
-	MPI_Isend(sendbuf_Z, 2*sendCount_Z,MPI_DOUBLE,rank_Z,sendtag,MPI_COMM_SCALBL,&req1[5]);
-	MPI_Irecv(recvbuf_z, 2*recvCount_z,MPI_DOUBLE,rank_z,recvtag,MPI_COMM_SCALBL,&req2[5]);
 
 }
 
-
 void ScaLBL_Communicator::BiRecvD3Q7AA(double *Aq, double *Bq){
+	PROFILE_SCOPED(timer,"Wait and unpack",1);
 
 	// NOTE: the center distribution f0 must NOT be at the start of feven, provide offset to start of f2
-	//...................................................................................
-	// Wait for completion of D3Q19 communication
-	MPI_Waitall(6,req1,stat1);
-	MPI_Waitall(6,req2,stat2);
-	ScaLBL_DeviceBarrier();
-
 	//...................................................................................
 	// NOTE: AA Routine writes to opposite
-	// Unpack the distributions on the device
-	//...................................................................................
-	//...Unpacking for x face(2,8,10,12,14)................................
-	ScaLBL_D3Q7_Unpack(2,dvcRecvDist_x,0,recvCount_x,recvbuf_x,Aq,N);
-	ScaLBL_D3Q7_Unpack(2,dvcRecvDist_x,recvCount_x,recvCount_x,recvbuf_x,Bq,N);
-	//...................................................................................
-	//...Packing for X face(1,7,9,11,13)................................
-	ScaLBL_D3Q7_Unpack(1,dvcRecvDist_X,0,recvCount_X,recvbuf_X,Aq,N);
-	ScaLBL_D3Q7_Unpack(1,dvcRecvDist_X,recvCount_X,recvCount_X,recvbuf_X,Bq,N);
-	//...................................................................................
-	//...Packing for y face(4,8,9,16,18).................................
-	ScaLBL_D3Q7_Unpack(4,dvcRecvDist_y,0,recvCount_y,recvbuf_y,Aq,N);
-	ScaLBL_D3Q7_Unpack(4,dvcRecvDist_y,recvCount_y,recvCount_y,recvbuf_y,Bq,N);
+	// Unpack the distributions on the device as each message arrives
 	//...................................................................................
-	//...Packing for Y face(3,7,10,15,17).................................
-	ScaLBL_D3Q7_Unpack(3,dvcRecvDist_Y,0,recvCount_Y,recvbuf_Y,Aq,N);
-	ScaLBL_D3Q7_Unpack(3,dvcRecvDist_Y,recvCount_Y,recvCount_Y,recvbuf_Y,Bq,N);
-	//...................................................................................
-
-	if (BoundaryCondition > 0){
-		if (kproc != 0){
-			//...Packing for z face(6,12,13,16,17)................................
-			ScaLBL_D3Q7_Unpack(6,dvcRecvDist_z,0,recvCount_z,recvbuf_z,Aq,N);
-			ScaLBL_D3Q7_Unpack(6,dvcRecvDist_z,recvCount_z,recvCount_z,recvbuf_z,Bq,N);
-		}
-		if (kproc != nprocz-1){
-			//...Packing for Z face(5,11,14,15,18)................................
-			ScaLBL_D3Q7_Unpack(5,dvcRecvDist_Z,0,recvCount_Z,recvbuf_Z,Aq,N);
-			ScaLBL_D3Q7_Unpack(5,dvcRecvDist_Z,recvCount_Z,recvCount_Z,recvbuf_Z,Bq,N);
-		}
-	}
-	else {
-		//...Packing for z face(6,12,13,16,17)................................
-		ScaLBL_D3Q7_Unpack(6,dvcRecvDist_z,0,recvCount_z,recvbuf_z,Aq,N);
-		ScaLBL_D3Q7_Unpack(6,dvcRecvDist_z,recvCount_z,recvCount_z,recvbuf_z,Bq,N);
-		//...Packing for Z face(5,11,14,15,18)................................
-		ScaLBL_D3Q7_Unpack(5,dvcRecvDist_Z,0,recvCount_Z,recvbuf_Z,Aq,N);
-		ScaLBL_D3Q7_Unpack(5,dvcRecvDist_Z,recvCount_Z,recvCount_Z,recvbuf_Z,Bq,N);
+	int idx,ready[5];
+	while (WaitNext(req_BiD3Q7AA,false,ready) > 0){
+		idx = ready[0];
+		if (BoundaryRecv(idx)) continue;
+		// recieve buffer idx holds distribution q = idx+1 (X face(1), x face(2), ... z face(6))
+		ScaLBL_D3Q7_BiUnpack(idx+1,dvcRecvDist[idx],recvCount[idx],recvbuf[idx],Aq,Bq,N);
 	}
+	ScaLBL_DeviceBarrier();
 /*	if (BoundaryCondition == 5){
 		if (kproc == 0){
 			ScaLBL_D3Q7_Reflection_BC_z(dvcSendList_z, Aq, sendCount_z, N);
@@ -1321,6 +1594,7 @@ void ScaLBL_Communicator::BiRecvD3Q7AA(double *Aq, double *Bq){
 }
 
 void ScaLBL_Communicator::TriSendD3Q7AA(double *Aq, double *Bq, double *Cq){
+	PROFILE_SCOPED(timer,"Pack and send",1);
 
 	// NOTE: the center distribution f0 must NOT be at the start of feven, provide offset to start of f2
 	if (Lock==true){
@@ -1329,112 +1603,47 @@ void ScaLBL_Communicator::TriSendD3Q7AA(double *Aq, double *Bq, double *Cq){
 	else{
 		Lock=true;
 	}
-	// assign tag of 19 to D3Q19 communication
-	sendtag = recvtag = 15;
+	StartRecv(req_TriD3Q7AA,false);
 	ScaLBL_DeviceBarrier();
-	// Pack the distributions
+	// Pack the distributions and start each message as soon as its buffer is ready
 	//...Packing for x face(2,8,10,12,14)................................
-	ScaLBL_D3Q19_Pack(2,dvcSendList_x,0,sendCount_x,sendbuf_x,Aq,N);
-	ScaLBL_D3Q19_Pack(2,dvcSendList_x,sendCount_x,sendCount_x,sendbuf_x,Bq,N);
-	ScaLBL_D3Q19_Pack(2,dvcSendList_x,2*sendCount_x,sendCount_x,sendbuf_x,Cq,N);
+	ScaLBL_D3Q7_TriPack(2,dvcSendList_x,sendCount_x,sendbuf_x,Aq,Bq,Cq,N);
+	StartSend(req_TriD3Q7AA,0,false);
 	//...Packing for X face(1,7,9,11,13)................................
-	ScaLBL_D3Q19_Pack(1,dvcSendList_X,0,sendCount_X,sendbuf_X,Aq,N);
-	ScaLBL_D3Q19_Pack(1,dvcSendList_X,sendCount_X,sendCount_X,sendbuf_X,Bq,N);
-	ScaLBL_D3Q19_Pack(1,dvcSendList_X,2*sendCount_X,sendCount_X,sendbuf_X,Cq,N);
-	//...Packing for y face(4,8,9,16,18).................................
-	ScaLBL_D3Q19_Pack(4,dvcSendList_y,0,sendCount_y,sendbuf_y,Aq,N);
-	ScaLBL_D3Q19_Pack(4,dvcSendList_y,sendCount_y,sendCount_y,sendbuf_y,Bq,N);
-	ScaLBL_D3Q19_Pack(4,dvcSendList_y,2*sendCount_y,sendCount_y,sendbuf_y,Cq,N);
-	//...Packing for Y face(3,7,10,15,17).................................
-	ScaLBL_D3Q19_Pack(3,dvcSendList_Y,0,sendCount_Y,sendbuf_Y,Aq,N);
-	ScaLBL_D3Q19_Pack(3,dvcSendList_Y,sendCount_Y,sendCount_Y,sendbuf_Y,Bq,N);
-	ScaLBL_D3Q19_Pack(3,dvcSendList_Y,2*sendCount_Y,sendCount_Y,sendbuf_Y,Cq,N);
+	ScaLBL_D3Q7_TriPack(1,dvcSendList_X,sendCount_X,sendbuf_X,Aq,Bq,Cq,N);
+	StartSend(req_TriD3Q7AA,1,false);
+	//...Packing for y face(4,8,9,16,18)................................
+	ScaLBL_D3Q7_TriPack(4,dvcSendList_y,sendCount_y,sendbuf_y,Aq,Bq,Cq,N);
+	StartSend(req_TriD3Q7AA,2,false);
+	//...Packing for Y face(3,7,10,15,17)................................
+	ScaLBL_D3Q7_TriPack(3,dvcSendList_Y,sendCount_Y,sendbuf_Y,Aq,Bq,Cq,N);
+	StartSend(req_TriD3Q7AA,3,false);
 	//...Packing for z face(6,12,13,16,17)................................
-	ScaLBL_D3Q19_Pack(6,dvcSendList_z,0,sendCount_z,sendbuf_z,Aq,N);
-	ScaLBL_D3Q19_Pack(6,dvcSendList_z,sendCount_z,sendCount_z,sendbuf_z,Bq,N);
-	ScaLBL_D3Q19_Pack(6,dvcSendList_z,2*sendCount_z,sendCount_z,sendbuf_z,Cq,N);
+	ScaLBL_D3Q7_TriPack(6,dvcSendList_z,sendCount_z,sendbuf_z,Aq,Bq,Cq,N);
+	StartSend(req_TriD3Q7AA,4,false);
 	//...Packing for Z face(5,11,14,15,18)................................
-	ScaLBL_D3Q19_Pack(5,dvcSendList_Z,0,sendCount_Z,sendbuf_Z,Aq,N);
-	ScaLBL_D3Q19_Pack(5,dvcSendList_Z,sendCount_Z,sendCount_Z,sendbuf_Z,Bq,N);
-	ScaLBL_D3Q19_Pack(5,dvcSendList_Z,2*sendCount_Z,sendCount_Z,sendbuf_Z,Cq,N);
-
+	ScaLBL_D3Q7_TriPack(5,dvcSendList_Z,sendCount_Z,sendbuf_Z,Aq,Bq,Cq,N);
+	StartSend(req_TriD3Q7AA,5,false);
 	//...................................................................................
-	// Send all the distributions
-	MPI_Isend(sendbuf_x, 3*sendCount_x,MPI_DOUBLE,rank_x,sendtag,MPI_COMM_SCALBL,&req1[0]);
-	MPI_Irecv(recvbuf_X, 3*recvCount_X,MPI_DOUBLE,rank_X,recvtag,MPI_COMM_SCALBL,&req2[0]);
-	MPI_Isend(sendbuf_X, 3*sendCount_X,MPI_DOUBLE,rank_X,sendtag,MPI_COMM_SCALBL,&req1[1]);
-	MPI_Irecv(recvbuf_x, 3*recvCount_x,MPI_DOUBLE,rank_x,recvtag,MPI_COMM_SCALBL,&req2[1]);
-	MPI_Isend(sendbuf_y, 3*sendCount_y,MPI_DOUBLE,rank_y,sendtag,MPI_COMM_SCALBL,&req1[2]);
-	MPI_Irecv(recvbuf_Y, 3*recvCount_Y,MPI_DOUBLE,rank_Y,recvtag,MPI_COMM_SCALBL,&req2[2]);
-	MPI_Isend(sendbuf_Y, 3*sendCount_Y,MPI_DOUBLE,rank_Y,sendtag,MPI_COMM_SCALBL,&req1[3]);
-	MPI_Irecv(recvbuf_y, 3*recvCount_y,MPI_DOUBLE,rank_y,recvtag,MPI_COMM_SCALBL,&req2[3]);
-	MPI_Isend(sendbuf_z, 3*sendCount_z,MPI_DOUBLE,rank_z,sendtag,MPI_COMM_SCALBL,&req1[4]);
-	MPI_Irecv(recvbuf_Z, 3*recvCount_Z,MPI_DOUBLE,rank_Z,recvtag,MPI_COMM_SCALBL,&req2[4]);
-	MPI_Isend(sendbuf_Z, 3*sendCount_Z,MPI_DOUBLE,rank_Z,sendtag,MPI_COMM_SCALBL,&req1[5]);
-	MPI_Irecv(recvbuf_z, 3*recvCount_z,MPI_DOUBLE,rank_z,recvtag,MPI_COMM_SCALBL,&req2[5]);
 
 }
 
-
 void ScaLBL_Communicator::TriRecvD3Q7AA(double *Aq, double *Bq, double *Cq){
+	PROFILE_SCOPED(timer,"Wait and unpack",1);
 
 	// NOTE: the center distribution f0 must NOT be at the start of feven, provide offset to start of f2
-	//...................................................................................
-	// Wait for completion of D3Q19 communication
-	MPI_Waitall(6,req1,stat1);
-	MPI_Waitall(6,req2,stat2);
-	ScaLBL_DeviceBarrier();
-
 	//...................................................................................
 	// NOTE: AA Routine writes to opposite
-	// Unpack the distributions on the device
-	//...................................................................................
-	//...Unpacking for x face(2,8,10,12,14)................................
-	ScaLBL_D3Q7_Unpack(2,dvcRecvDist_x,0,recvCount_x,recvbuf_x,Aq,N);
-	ScaLBL_D3Q7_Unpack(2,dvcRecvDist_x,recvCount_x,recvCount_x,recvbuf_x,Bq,N);
-	ScaLBL_D3Q7_Unpack(2,dvcRecvDist_x,2*recvCount_x,recvCount_x,recvbuf_x,Cq,N);
-	//...................................................................................
-	//...Packing for X face(1,7,9,11,13)................................
-	ScaLBL_D3Q7_Unpack(1,dvcRecvDist_X,0,recvCount_X,recvbuf_X,Aq,N);
-	ScaLBL_D3Q7_Unpack(1,dvcRecvDist_X,recvCount_X,recvCount_X,recvbuf_X,Bq,N);
-	ScaLBL_D3Q7_Unpack(1,dvcRecvDist_X,2*recvCount_X,recvCount_X,recvbuf_X,Cq,N);
-	//...................................................................................
-	//...Packing for y face(4,8,9,16,18).................................
-	ScaLBL_D3Q7_Unpack(4,dvcRecvDist_y,0,recvCount_y,recvbuf_y,Aq,N);
-	ScaLBL_D3Q7_Unpack(4,dvcRecvDist_y,recvCount_y,recvCount_y,recvbuf_y,Bq,N);
-	ScaLBL_D3Q7_Unpack(4,dvcRecvDist_y,2*recvCount_y,recvCount_y,recvbuf_y,Cq,N);
-	//...................................................................................
-	//...Packing for Y face(3,7,10,15,17).................................
-	ScaLBL_D3Q7_Unpack(3,dvcRecvDist_Y,0,recvCount_Y,recvbuf_Y,Aq,N);
-	ScaLBL_D3Q7_Unpack(3,dvcRecvDist_Y,recvCount_Y,recvCount_Y,recvbuf_Y,Bq,N);
-	ScaLBL_D3Q7_Unpack(3,dvcRecvDist_Y,2*recvCount_Y,recvCount_Y,recvbuf_Y,Cq,N);
+	// Unpack the distributions on the device as each message arrives
 	//...................................................................................
-	
-	if (BoundaryCondition > 0){
-		if (kproc != 0){
-			//...Packing for z face(6,12,13,16,17)................................
-			ScaLBL_D3Q7_Unpack(6,dvcRecvDist_z,0,recvCount_z,recvbuf_z,Aq,N);
-			ScaLBL_D3Q7_Unpack(6,dvcRecvDist_z,recvCount_z,recvCount_z,recvbuf_z,Bq,N);
-			ScaLBL_D3Q7_Unpack(6,dvcRecvDist_z,2*recvCount_z,recvCount_z,recvbuf_z,Cq,N);
-		}
-		if (kproc != nprocz-1){
-			//...Packing for Z face(5,11,14,15,18)................................
-			ScaLBL_D3Q7_Unpack(5,dvcRecvDist_Z,0,recvCount_Z,recvbuf_Z,Aq,N);
-			ScaLBL_D3Q7_Unpack(5,dvcRecvDist_Z,recvCount_Z,recvCount_Z,recvbuf_Z,Bq,N);
-			ScaLBL_D3Q7_Unpack(5,dvcRecvDist_Z,2*recvCount_Z,recvCount_Z,recvbuf_Z,Cq,N);
-		}
+	int idx,ready[5];
+	while (WaitNext(req_TriD3Q7AA,false,ready) > 0){
+		idx = ready[0];
+		if (BoundaryRecv(idx)) continue;
+		// recieve buffer idx holds distribution q = idx+1 (X face(1), x face(2), ... z face(6))
+		ScaLBL_D3Q7_TriUnpack(idx+1,dvcRecvDist[idx],recvCount[idx],recvbuf[idx],Aq,Bq,Cq,N);
 	}
-	else {
-		//...Packing for z face(6,12,13,16,17)................................
-		ScaLBL_D3Q7_Unpack(6,dvcRecvDist_z,0,recvCount_z,recvbuf_z,Aq,N);
-		ScaLBL_D3Q7_Unpack(6,dvcRecvDist_z,recvCount_z,recvCount_z,recvbuf_z,Bq,N);
-		ScaLBL_D3Q7_Unpack(6,dvcRecvDist_z,2*recvCount_z,recvCount_z,recvbuf_z,Cq,N);
-		//...Packing for Z face(5,11,14,15,18)................................
-		ScaLBL_D3Q7_Unpack(5,dvcRecvDist_Z,0,recvCount_Z,recvbuf_Z,Aq,N);
-		ScaLBL_D3Q7_Unpack(5,dvcRecvDist_Z,recvCount_Z,recvCount_Z,recvbuf_Z,Bq,N);
-		ScaLBL_D3Q7_Unpack(5,dvcRecvDist_Z,2*recvCount_Z,recvCount_Z,recvbuf_Z,Cq,N);
-	}
-	
+	ScaLBL_DeviceBarrier();
 	//...................................................................................
 	Lock=false; // unlock the communicator after communications complete
 	//...................................................................................
@@ -1443,6 +1652,7 @@ void ScaLBL_Communicator::TriRecvD3Q7AA(double *Aq, double *Bq, double *Cq){
 
 
 void ScaLBL_Communicator::SendHalo(double *data){
+	PROFILE_SCOPED(timer,"Pack and send",1);
 	//...................................................................................
 	if (Lock==true){
 		ERROR("ScaLBL Error (SendHalo): ScaLBL_Communicator is locked -- did you forget to match Send/Recv calls?");
@@ -1450,117 +1660,65 @@ void ScaLBL_Communicator::SendHalo(double *data){
 	else{
 		Lock=true;
 	}
+	StartRecv(req_Halo,true);
 	ScaLBL_DeviceBarrier();
 	//...................................................................................
-	sendtag = recvtag = 1;
+	// Send / Recv all the phase indcator field values
+	// edges are packed first since aggregated face messages carry them
 	//...................................................................................
-	ScaLBL_Scalar_Pack(dvcSendList_x, sendCount_x,sendbuf_x, data, N);
-	ScaLBL_Scalar_Pack(dvcSendList_y, sendCount_y,sendbuf_y, data, N);
-	ScaLBL_Scalar_Pack(dvcSendList_z, sendCount_z,sendbuf_z, data, N);
-	ScaLBL_Scalar_Pack(dvcSendList_X, sendCount_X,sendbuf_X, data, N);
-	ScaLBL_Scalar_Pack(dvcSendList_Y, sendCount_Y,sendbuf_Y, data, N);
-	ScaLBL_Scalar_Pack(dvcSendList_Z, sendCount_Z,sendbuf_Z, data, N);
 	ScaLBL_Scalar_Pack(dvcSendList_xy, sendCount_xy,sendbuf_xy, data, N);
-	ScaLBL_Scalar_Pack(dvcSendList_xY, sendCount_xY,sendbuf_xY, data, N);
-	ScaLBL_Scalar_Pack(dvcSendList_Xy, sendCount_Xy,sendbuf_Xy, data, N);
+	StartSend(req_Halo,6,true);
 	ScaLBL_Scalar_Pack(dvcSendList_XY, sendCount_XY,sendbuf_XY, data, N);
+	StartSend(req_Halo,7,true);
+	ScaLBL_Scalar_Pack(dvcSendList_Xy, sendCount_Xy,sendbuf_Xy, data, N);
+	StartSend(req_Halo,8,true);
+	ScaLBL_Scalar_Pack(dvcSendList_xY, sendCount_xY,sendbuf_xY, data, N);
+	StartSend(req_Halo,9,true);
 	ScaLBL_Scalar_Pack(dvcSendList_xz, sendCount_xz,sendbuf_xz, data, N);
-	ScaLBL_Scalar_Pack(dvcSendList_xZ, sendCount_xZ,sendbuf_xZ, data, N);
-	ScaLBL_Scalar_Pack(dvcSendList_Xz, sendCount_Xz,sendbuf_Xz, data, N);
+	StartSend(req_Halo,10,true);
 	ScaLBL_Scalar_Pack(dvcSendList_XZ, sendCount_XZ,sendbuf_XZ, data, N);
+	StartSend(req_Halo,11,true);
+	ScaLBL_Scalar_Pack(dvcSendList_Xz, sendCount_Xz,sendbuf_Xz, data, N);
+	StartSend(req_Halo,12,true);
+	ScaLBL_Scalar_Pack(dvcSendList_xZ, sendCount_xZ,sendbuf_xZ, data, N);
+	StartSend(req_Halo,13,true);
 	ScaLBL_Scalar_Pack(dvcSendList_yz, sendCount_yz,sendbuf_yz, data, N);
-	ScaLBL_Scalar_Pack(dvcSendList_yZ, sendCount_yZ,sendbuf_yZ, data, N);
-	ScaLBL_Scalar_Pack(dvcSendList_Yz, sendCount_Yz,sendbuf_Yz, data, N);
+	StartSend(req_Halo,14,true);
 	ScaLBL_Scalar_Pack(dvcSendList_YZ, sendCount_YZ,sendbuf_YZ, data, N);
-	//...................................................................................
-	// Send / Recv all the phase indcator field values
+	StartSend(req_Halo,15,true);
+	ScaLBL_Scalar_Pack(dvcSendList_Yz, sendCount_Yz,sendbuf_Yz, data, N);
+	StartSend(req_Halo,16,true);
+	ScaLBL_Scalar_Pack(dvcSendList_yZ, sendCount_yZ,sendbuf_yZ, data, N);
+	StartSend(req_Halo,17,true);
+	ScaLBL_Scalar_Pack(dvcSendList_x, sendCount_x,sendbuf_x, data, N);
+	StartSend(req_Halo,0,true);
+	ScaLBL_Scalar_Pack(dvcSendList_X, sendCount_X,sendbuf_X, data, N);
+	StartSend(req_Halo,1,true);
+	ScaLBL_Scalar_Pack(dvcSendList_y, sendCount_y,sendbuf_y, data, N);
+	StartSend(req_Halo,2,true);
+	ScaLBL_Scalar_Pack(dvcSendList_Y, sendCount_Y,sendbuf_Y, data, N);
+	StartSend(req_Halo,3,true);
+	ScaLBL_Scalar_Pack(dvcSendList_z, sendCount_z,sendbuf_z, data, N);
+	StartSend(req_Halo,4,true);
+	ScaLBL_Scalar_Pack(dvcSendList_Z, sendCount_Z,sendbuf_Z, data, N);
+	StartSend(req_Halo,5,true);
 	//...................................................................................
 
-	MPI_Isend(sendbuf_x, sendCount_x,MPI_DOUBLE,rank_x,sendtag,MPI_COMM_SCALBL,&req1[0]);
-	MPI_Irecv(recvbuf_X, recvCount_X,MPI_DOUBLE,rank_X,recvtag,MPI_COMM_SCALBL,&req2[0]);
-	MPI_Isend(sendbuf_X, sendCount_X,MPI_DOUBLE,rank_X,sendtag,MPI_COMM_SCALBL,&req1[1]);
-	MPI_Irecv(recvbuf_x, recvCount_x,MPI_DOUBLE,rank_x,recvtag,MPI_COMM_SCALBL,&req2[1]);
-	MPI_Isend(sendbuf_y, sendCount_y,MPI_DOUBLE,rank_y,sendtag,MPI_COMM_SCALBL,&req1[2]);
-	MPI_Irecv(recvbuf_Y, recvCount_Y,MPI_DOUBLE,rank_Y,recvtag,MPI_COMM_SCALBL,&req2[2]);
-	MPI_Isend(sendbuf_Y, sendCount_Y,MPI_DOUBLE,rank_Y,sendtag,MPI_COMM_SCALBL,&req1[3]);
-	MPI_Irecv(recvbuf_y, recvCount_y,MPI_DOUBLE,rank_y,recvtag,MPI_COMM_SCALBL,&req2[3]);
-	MPI_Isend(sendbuf_z, sendCount_z,MPI_DOUBLE,rank_z,sendtag,MPI_COMM_SCALBL,&req1[4]);
-	MPI_Irecv(recvbuf_Z, recvCount_Z,MPI_DOUBLE,rank_Z,recvtag,MPI_COMM_SCALBL,&req2[4]);
-	MPI_Isend(sendbuf_Z, sendCount_Z,MPI_DOUBLE,rank_Z,sendtag,MPI_COMM_SCALBL,&req1[5]);
-	MPI_Irecv(recvbuf_z, recvCount_z,MPI_DOUBLE,rank_z,recvtag,MPI_COMM_SCALBL,&req2[5]);
-	MPI_Isend(sendbuf_xy, sendCount_xy,MPI_DOUBLE,rank_xy,sendtag,MPI_COMM_SCALBL,&req1[6]);
-	MPI_Irecv(recvbuf_XY, recvCount_XY,MPI_DOUBLE,rank_XY,recvtag,MPI_COMM_SCALBL,&req2[6]);
-	MPI_Isend(sendbuf_XY, sendCount_XY,MPI_DOUBLE,rank_XY,sendtag,MPI_COMM_SCALBL,&req1[7]);
-	MPI_Irecv(recvbuf_xy, recvCount_xy,MPI_DOUBLE,rank_xy,recvtag,MPI_COMM_SCALBL,&req2[7]);
-	MPI_Isend(sendbuf_Xy, sendCount_Xy,MPI_DOUBLE,rank_Xy,sendtag,MPI_COMM_SCALBL,&req1[8]);
-	MPI_Irecv(recvbuf_xY, recvCount_xY,MPI_DOUBLE,rank_xY,recvtag,MPI_COMM_SCALBL,&req2[8]);
-	MPI_Isend(sendbuf_xY, sendCount_xY,MPI_DOUBLE,rank_xY,sendtag,MPI_COMM_SCALBL,&req1[9]);
-	MPI_Irecv(recvbuf_Xy, recvCount_Xy,MPI_DOUBLE,rank_Xy,recvtag,MPI_COMM_SCALBL,&req2[9]);
-	MPI_Isend(sendbuf_xz, sendCount_xz,MPI_DOUBLE,rank_xz,sendtag,MPI_COMM_SCALBL,&req1[10]);
-	MPI_Irecv(recvbuf_XZ, recvCount_XZ,MPI_DOUBLE,rank_XZ,recvtag,MPI_COMM_SCALBL,&req2[10]);
-	MPI_Isend(sendbuf_XZ, sendCount_XZ,MPI_DOUBLE,rank_XZ,sendtag,MPI_COMM_SCALBL,&req1[11]);
-	MPI_Irecv(recvbuf_xz, recvCount_xz,MPI_DOUBLE,rank_xz,recvtag,MPI_COMM_SCALBL,&req2[11]);
-	MPI_Isend(sendbuf_Xz, sendCount_Xz,MPI_DOUBLE,rank_Xz,sendtag,MPI_COMM_SCALBL,&req1[12]);
-	MPI_Irecv(recvbuf_xZ, recvCount_xZ,MPI_DOUBLE,rank_xZ,recvtag,MPI_COMM_SCALBL,&req2[12]);
-	MPI_Isend(sendbuf_xZ, sendCount_xZ,MPI_DOUBLE,rank_xZ,sendtag,MPI_COMM_SCALBL,&req1[13]);
-	MPI_Irecv(recvbuf_Xz, recvCount_Xz,MPI_DOUBLE,rank_Xz,recvtag,MPI_COMM_SCALBL,&req2[13]);
-	MPI_Isend(sendbuf_yz, sendCount_yz,MPI_DOUBLE,rank_yz,sendtag,MPI_COMM_SCALBL,&req1[14]);
-	MPI_Irecv(recvbuf_YZ, recvCount_YZ,MPI_DOUBLE,rank_YZ,recvtag,MPI_COMM_SCALBL,&req2[14]);
-	MPI_Isend(sendbuf_YZ, sendCount_YZ,MPI_DOUBLE,rank_YZ,sendtag,MPI_COMM_SCALBL,&req1[15]);
-	MPI_Irecv(recvbuf_yz, recvCount_yz,MPI_DOUBLE,rank_yz,recvtag,MPI_COMM_SCALBL,&req2[15]);
-	MPI_Isend(sendbuf_Yz, sendCount_Yz,MPI_DOUBLE,rank_Yz,sendtag,MPI_COMM_SCALBL,&req1[16]);
-	MPI_Irecv(recvbuf_yZ, recvCount_yZ,MPI_DOUBLE,rank_yZ,recvtag,MPI_COMM_SCALBL,&req2[16]);
-	MPI_Isend(sendbuf_yZ, sendCount_yZ,MPI_DOUBLE,rank_yZ,sendtag,MPI_COMM_SCALBL,&req1[17]);
-	MPI_Irecv(recvbuf_Yz, recvCount_Yz,MPI_DOUBLE,rank_Yz,recvtag,MPI_COMM_SCALBL,&req2[17]);
-	//...................................................................................
 }
 void ScaLBL_Communicator::RecvHalo(double *data){
+	PROFILE_SCOPED(timer,"Wait and unpack",1);
 
 	//...................................................................................
-	MPI_Waitall(18,req1,stat1);
-	MPI_Waitall(18,req2,stat2);
-	ScaLBL_DeviceBarrier();
-	//...................................................................................
+	// Unpack each message as it arrives
 	//...................................................................................
-	ScaLBL_Scalar_Unpack(dvcRecvList_x, recvCount_x,recvbuf_x, data, N);
-	ScaLBL_Scalar_Unpack(dvcRecvList_y, recvCount_y,recvbuf_y, data, N);
-	ScaLBL_Scalar_Unpack(dvcRecvList_X, recvCount_X,recvbuf_X, data, N);
-	ScaLBL_Scalar_Unpack(dvcRecvList_Y, recvCount_Y,recvbuf_Y, data, N);
-	ScaLBL_Scalar_Unpack(dvcRecvList_xy, recvCount_xy,recvbuf_xy, data, N);
-	ScaLBL_Scalar_Unpack(dvcRecvList_xY, recvCount_xY,recvbuf_xY, data, N);
-	ScaLBL_Scalar_Unpack(dvcRecvList_Xy, recvCount_Xy,recvbuf_Xy, data, N);
-	ScaLBL_Scalar_Unpack(dvcRecvList_XY, recvCount_XY,recvbuf_XY, data, N);
-	
-	if (BoundaryCondition > 0){
-		if (kproc != 0){
-			//...Packing for z face(6,12,13,16,17)................................
-			ScaLBL_Scalar_Unpack(dvcRecvList_z, recvCount_z,recvbuf_z, data, N);
-			ScaLBL_Scalar_Unpack(dvcRecvList_xz, recvCount_xz,recvbuf_xz, data, N);
-			ScaLBL_Scalar_Unpack(dvcRecvList_Xz, recvCount_Xz,recvbuf_Xz, data, N);
-			ScaLBL_Scalar_Unpack(dvcRecvList_yz, recvCount_yz,recvbuf_yz, data, N);
-			ScaLBL_Scalar_Unpack(dvcRecvList_Yz, recvCount_Yz,recvbuf_Yz, data, N);
-		}
-		if (kproc != nprocz-1){
-			//...Packing for Z face(5,11,14,15,18)................................
-			ScaLBL_Scalar_Unpack(dvcRecvList_Z, recvCount_Z,recvbuf_Z, data, N);
-			ScaLBL_Scalar_Unpack(dvcRecvList_xZ, recvCount_xZ,recvbuf_xZ, data, N);
-			ScaLBL_Scalar_Unpack(dvcRecvList_XZ, recvCount_XZ,recvbuf_XZ, data, N);
-			ScaLBL_Scalar_Unpack(dvcRecvList_yZ, recvCount_yZ,recvbuf_yZ, data, N);
-			ScaLBL_Scalar_Unpack(dvcRecvList_YZ, recvCount_YZ,recvbuf_YZ, data, N);
+	int n,nready,ready[5];
+	while ((nready = WaitNext(req_Halo,true,ready)) > 0){
+		for (n=0; n<nready; n++){
+			if (BoundaryRecv(ready[n])) continue;
+			ScaLBL_Scalar_Unpack(dvcRecvList[ready[n]], recvCount[ready[n]],recvbuf[ready[n]], data, N);
 		}
 	}
-	else {
-		ScaLBL_Scalar_Unpack(dvcRecvList_z, recvCount_z,recvbuf_z, data, N);
-		ScaLBL_Scalar_Unpack(dvcRecvList_xz, recvCount_xz,recvbuf_xz, data, N);
-		ScaLBL_Scalar_Unpack(dvcRecvList_Xz, recvCount_Xz,recvbuf_Xz, data, N);
-		ScaLBL_Scalar_Unpack(dvcRecvList_yz, recvCount_yz,recvbuf_yz, data, N);
-		ScaLBL_Scalar_Unpack(dvcRecvList_Yz, recvCount_Yz,recvbuf_Yz, data, N);
-		ScaLBL_Scalar_Unpack(dvcRecvList_Z, recvCount_Z,recvbuf_Z, data, N);
-		ScaLBL_Scalar_Unpack(dvcRecvList_xZ, recvCount_xZ,recvbuf_xZ, data, N);
-		ScaLBL_Scalar_Unpack(dvcRecvList_XZ, recvCount_XZ,recvbuf_XZ, data, N);
-		ScaLBL_Scalar_Unpack(dvcRecvList_yZ, recvCount_yZ,recvbuf_yZ, data, N);
-		ScaLBL_Scalar_Unpack(dvcRecvList_YZ, recvCount_YZ,recvbuf_YZ, data, N);
-	}
+	ScaLBL_DeviceBarrier();
 	//...................................................................................
 	Lock=false; // unlock the communicator after communications complete
 	//...................................................................................
@@ -1604,6 +1762,7 @@ void ScaLBL_Communicator::RegularLayout(IntArray map, const double *data, Double
 }
 
 void ScaLBL_Communicator::Color_BC_z(int *Map, double *Phi, double *Den, double vA, double vB){
+	PROFILE_SCOPED(timer,"Boundary conditions",1);
 	if (kproc == 0) {
 		if (BoundaryCondition == 5){
 			//ScaLBL_CopySlice_z(Phi,Nx,Ny,Nz,1,0);
@@ -1617,6 +1776,7 @@ void ScaLBL_Communicator::Color_BC_z(int *Map, double *Phi, double *Den, double
 }
 
 void ScaLBL_Communicator::Color_BC_Z(int *Map, double *Phi, double *Den, double vA, double vB){
+	PROFILE_SCOPED(timer,"Boundary conditions",1);
 	if (kproc == nprocz-1){
 		if (BoundaryCondition == 5){
 			//ScaLBL_CopySlice_z(Phi,Nx,Ny,Nz,Nz-2,Nz-1);
@@ -1630,6 +1790,7 @@ void ScaLBL_Communicator::Color_BC_Z(int *Map, double *Phi, double *Den, double
 }
 
 void ScaLBL_Communicator::D3Q19_Pressure_BC_z(int *neighborList, double *fq, double din, int time){
+	PROFILE_SCOPED(timer,"Boundary conditions",1);
     //ScaLBL_D3Q19_Pressure_BC_z(int *LIST,fq,din,Nx,Ny,Nz);
 	if (kproc == 0) {
 		if (time%2==0){
@@ -1642,6 +1803,7 @@ void ScaLBL_Communicator::D3Q19_Pressure_BC_z(int *neighborList, double *fq, dou
 }
 
 void ScaLBL_Communicator::D3Q19_Pressure_BC_Z(int *neighborList, double *fq, double dout, int time){
+	PROFILE_SCOPED(timer,"Boundary conditions",1);
     //ScaLBL_D3Q19_Pressure_BC_Z(int *LIST,fq,dout,Nx,Ny,Nz);
 	if (kproc == nprocz-1){
 		if (time%2==0){
@@ -1654,53 +1816,38 @@ void ScaLBL_Communicator::D3Q19_Pressure_BC_Z(int *neighborList, double *fq, dou
 }
 
 double ScaLBL_Communicator::D3Q19_Flux_BC_z(int *neighborList, double *fq, double flux, int time){
-	double sum, locsum, din;
-	double LocInletArea, InletArea;
-	
 	// Note that flux = rho_0 * Q
-	
-	// Compute the inlet area
-	if (kproc == 0) 
-		LocInletArea = double(sendCount_z);
-	else LocInletArea = 0.f;
-	
-	MPI_Allreduce(&LocInletArea,&InletArea,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_SCALBL);
-	//printf("Inlet area = %f \n", InletArea);
+	// Only the inlet ranks take part in the reduction, so the other ranks return without
+	// communicating and the returned inlet pressure is only set on the inlet (kproc == 0)
+	if (kproc != 0) return 0.0;
+	PROFILE_SCOPED(timer,"Boundary conditions",1);
+	double sum, locsum, din;
 
 	// Set the flux BC
-	locsum = 0.f;
 	if (time%2==0){
-		if (kproc == 0) 
-			locsum = ScaLBL_D3Q19_AAeven_Flux_BC_z(dvcSendList_z, fq, flux, InletArea, sendCount_z, N);
-		
-		MPI_Allreduce(&locsum,&sum,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_SCALBL);
+		locsum = ScaLBL_D3Q19_AAeven_Flux_BC_z(dvcSendList_z, fq, flux, InletArea, sendCount_z, N);
+		MPI_Allreduce(&locsum,&sum,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_INLET);
 		din = flux/InletArea + sum;
-		//if (rank==0) printf("computed din (even) =%f \n",din);
-		if (kproc == 0)
-			ScaLBL_D3Q19_AAeven_Pressure_BC_z(dvcSendList_z, fq, din, sendCount_z, N);
+		ScaLBL_D3Q19_AAeven_Pressure_BC_z(dvcSendList_z, fq, din, sendCount_z, N);
 	}
 	else{
-		if (kproc == 0) 
-			locsum = ScaLBL_D3Q19_AAodd_Flux_BC_z(neighborList, dvcSendList_z, fq, flux, InletArea, sendCount_z, N);
-
-		MPI_Allreduce(&locsum,&sum,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_SCALBL);
+		locsum = ScaLBL_D3Q19_AAodd_Flux_BC_z(neighborList, dvcSendList_z, fq, flux, InletArea, sendCount_z, N);
+		MPI_Allreduce(&locsum,&sum,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_INLET);
 		din = flux/InletArea + sum;
-		
-		//if (rank==0) printf("computed din (odd)=%f \n",din);
-		if (kproc == 0) 
-			ScaLBL_D3Q19_AAodd_Pressure_BC_z(neighborList, dvcSendList_z, fq, din, sendCount_z, N);
+		ScaLBL_D3Q19_AAodd_Pressure_BC_z(neighborList, dvcSendList_z, fq, din, sendCount_z, N);
 	}
-	//printf("Inlet pressure = %f \n", din);
 	return din;
 }
 
 void ScaLBL_Communicator::D3Q19_Reflection_BC_z(double *fq){
+	PROFILE_SCOPED(timer,"Boundary conditions",1);
 	if (kproc == 0)
 		ScaLBL_D3Q19_Reflection_BC_z(dvcSendList_z, fq, sendCount_z, N);
 	
 }
 
 void ScaLBL_Communicator::D3Q19_Reflection_BC_Z(double *fq){
+	PROFILE_SCOPED(timer,"Boundary conditions",1);
 	if (kproc == nprocz-1)
 		ScaLBL_D3Q19_Reflection_BC_Z(dvcSendList_Z, fq, sendCount_Z, N);
 }
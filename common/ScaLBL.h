@@ -25,8 +25,17 @@
  */
 #ifndef ScalLBL_H
 #define ScalLBL_H
+#include <stdint.h>
+#include <string>
 #include "common/Domain.h"
 
+// Compressed neighbor list: 16 bit offsets relative to the site, with two bases for each direction
+// and block of 2^ScaLBL_NEIGHBOR_BLOCK_SHIFT sites (selected by the low bit of the offset);
+// bounce-back links use a reserved offset and blocks that do not fit are marked to read the full list
+#define ScaLBL_NEIGHBOR_BOUNCEBACK -32768
+#define ScaLBL_NEIGHBOR_FULL -2147483647
+#define ScaLBL_NEIGHBOR_BLOCK_SHIFT 8
+
 extern "C" int ScaLBL_SetDevice(int rank);
 
 extern "C" void ScaLBL_AllocateDeviceMemory(void** address, size_t size);
@@ -47,8 +56,28 @@ extern "C" void ScaLBL_D3Q19_Pack(int q, int *list, int start, int count, double
 
 extern "C" void ScaLBL_D3Q19_Unpack(int q, int *list, int start, int count, double *recvbuf, double *dist, int N);
 
+extern "C" void ScaLBL_D3Q19_PackFace(int q1, int q2, int q3, int q4, int q5, int *list, int count, double *sendbuf, double *dist, int N);
+
+extern "C" void ScaLBL_D3Q19_UnpackFace(int q1, int q2, int q3, int q4, int q5, int *list, int count, double *recvbuf, double *dist, int N);
+
+extern "C" void ScaLBL_D3Q19_Pack_Single(int q, int *list, int start, int count, float *sendbuf, float *dist, int N);
+
+extern "C" void ScaLBL_D3Q19_Unpack_Single(int q, int *list, int start, int count, float *recvbuf, float *dist, int N);
+
+extern "C" void ScaLBL_D3Q19_PackFace_Single(int q1, int q2, int q3, int q4, int q5, int *list, int count, float *sendbuf, float *dist, int N);
+
+extern "C" void ScaLBL_D3Q19_UnpackFace_Single(int q1, int q2, int q3, int q4, int q5, int *list, int count, float *recvbuf, float *dist, int N);
+
 extern "C" void ScaLBL_D3Q7_Unpack(int q, int *list,  int start, int count, double *recvbuf, double *dist, int N);
 
+extern "C" void ScaLBL_D3Q7_BiPack(int q, int *list, int count, double *sendbuf, double *Aq, double *Bq, int N);
+
+extern "C" void ScaLBL_D3Q7_TriPack(int q, int *list, int count, double *sendbuf, double *Aq, double *Bq, double *Cq, int N);
+
+extern "C" void ScaLBL_D3Q7_BiUnpack(int q, int *list, int count, double *recvbuf, double *Aq, double *Bq, int N);
+
+extern "C" void ScaLBL_D3Q7_TriUnpack(int q, int *list, int count, double *recvbuf, double *Aq, double *Bq, double *Cq, int N);
+
 extern "C" void ScaLBL_Scalar_Pack(int *list, int count, double *sendbuf, double *Data, int N);
 
 extern "C" void ScaLBL_Scalar_Unpack(int *list, int count, double *recvbuf, double *Data, int N);
@@ -67,6 +96,13 @@ extern "C" void ScaLBL_D3Q19_Momentum(double *dist, double *vel, int Np);
 
 extern "C" void ScaLBL_D3Q19_Pressure(double *dist, double *press, int Np);
 
+// Single precision storage: distributions hold the deviation from the rest state (rho=1, u=0)
+extern "C" void ScaLBL_D3Q19_Init_Single(float *dist, int Np);
+
+extern "C" void ScaLBL_D3Q19_Momentum_Single(float *dist, double *vel, int Np);
+
+extern "C" void ScaLBL_D3Q19_Pressure_Single(float *dist, double *press, int Np);
+
 // BGK MODEL
 extern "C" void ScaLBL_D3Q19_AAeven_BGK(double *dist, int start, int finish, int Np, double rlx, double Fx, double Fy, double Fz);
 
@@ -209,6 +245,17 @@ extern "C" void ScaLBL_D3Q19_AAeven_MRT(double *dist, int start, int finish, int
 extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *d_neighborList, double *dist, int start, int finish, int Np,
 		double rlx_setA, double rlx_setB, double Fx, double Fy, double Fz);
 
+// MRT collision with single precision storage (see ScaLBL_D3Q19_Init_Single), computed in double
+extern "C" void ScaLBL_D3Q19_AAeven_MRT_Single(float *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
+		double Fy, double Fz);
+
+extern "C" void ScaLBL_D3Q19_AAodd_MRT_Single(int *d_neighborList, float *dist, int start, int finish, int Np,
+		double rlx_setA, double rlx_setB, double Fx, double Fy, double Fz);
+
+// Odd step reading the compressed neighbor list built by ScaLBL_Communicator::CompressNeighborList
+// (halves the memory of the neighbor list; the decode makes it slower than ScaLBL_D3Q19_AAodd_MRT on CPU)
+extern "C" void ScaLBL_D3Q19_AAodd_MRT_Compressed(int *neighborList, short *neighborOffset, int *neighborBase, double *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx, double Fy, double Fz);
+
 // COLOR MODEL
 
 extern "C" void ScaLBL_D3Q19_AAeven_Color(int *Map, double *dist, double *Aq, double *Bq, double *Den, double *Phi,
@@ -293,6 +340,9 @@ public:
 	
 	int next;
 	int first_interior,last_interior;
+	bool AggregateEdges;	// route the 12 edge messages through the face neighbors (6 messages per exchange)
+	std::string Layout;	// order of the sites in MemoryOptimizedLayoutAA: lexicographic, morton, hilbert or brick
+	int LayoutBrickSize;	// edge length of the bricks for the brick layout
 	//......................................................................................
 	//  Set up for D319 distributions
 	// 		- determines how much memory is allocated
@@ -312,8 +362,11 @@ public:
 	int LastInterior();
 	
 	int MemoryOptimizedLayoutAA(IntArray &Map, int *neighborList, signed char *id, int Np);
+	int CompressNeighborList(const int *neighborList, int Np, short *offset, int *base);
 	void SendD3Q19AA(double *dist);
 	void RecvD3Q19AA(double *dist);
+	void SendD3Q19AA(float *dist);
+	void RecvD3Q19AA(float *dist);
 //	void BiSendD3Q7(double *A_even, double *A_odd, double *B_even, double *B_odd);
 //	void BiRecvD3Q7(double *A_even, double *A_odd, double *B_even, double *B_odd);
 	void BiSendD3Q7AA(double *Aq, double *Bq);
@@ -353,13 +406,34 @@ private:
 
 	int iproc,jproc,kproc;
 	int nprocx,nprocy,nprocz;
-	int sendtag,recvtag;
+	// Ranks with kproc == 0 (the z inlet) and the global inlet area, set once for D3Q19_Flux_BC_z
+	MPI_Comm MPI_COMM_INLET;
+	double InletArea;
 	// Give the object it's own MPI communicator
 	RankInfoStruct rank_info;
 	MPI_Group Group;	// Group of processors associated with this domain
-	MPI_Request req1[18],req2[18];
 	MPI_Status stat1[18],stat2[18];
 	//......................................................................................
+	// Persistent requests for each exchange pattern (sends in 0-17, recieves in 18-35)
+	// Face messages are 0-5; edge messages 6-17 are unused when edges are aggregated
+	//......................................................................................
+	MPI_Request req_D3Q19AA[36], req_D3Q19AA_Single[36], req_BiD3Q7AA[36], req_TriD3Q7AA[36], req_Halo[36];
+	std::vector<MPI_Datatype> AggregateTypes;
+	void InitExchange(MPI_Request *req, int tag, int face, bool edges, MPI_Datatype datatype=MPI_DOUBLE);
+	void StartRecv(MPI_Request *req, bool edges);
+	void StartSend(MPI_Request *req, int idx, bool edges);
+	int WaitNext(MPI_Request *req, bool edges, int *ready);
+	void WaitExchange(MPI_Request *req, bool edges);
+	bool BoundaryRecv(int idx);
+	template<class TYPE> void SendD3Q19(TYPE *dist, MPI_Request *req);
+	template<class TYPE> void RecvD3Q19(TYPE *dist, MPI_Request *req);
+	uint64_t LayoutKey(int i, int j, int k);
+	int RecvDone;	// bit mask of the aggregated messages that have arrived
+	// Recieve buffers in request order (req[18+idx]) so messages can be unpacked as they arrive
+	double *recvbuf[18];
+	int recvCount[18];
+	int *dvcRecvList[18], *dvcRecvDist[18];
+	//......................................................................................
 	// MPI ranks for all 18 neighbors
 	//......................................................................................
 	// These variables are all private to prevent external things from modifying them!!
@@ -380,6 +454,14 @@ private:
 	int recvCount_xy, recvCount_yz, recvCount_xz, recvCount_Xy, recvCount_Yz, recvCount_xZ;
 	int recvCount_xY, recvCount_yZ, recvCount_Xz, recvCount_XY, recvCount_YZ, recvCount_XZ;
 	//......................................................................................
+	// Edge data forwarded by this process when edges are aggregated (named by the edge it belongs to)
+	int transitCount_xy, transitCount_xY, transitCount_xz, transitCount_xZ;
+	int transitCount_Xy, transitCount_XY, transitCount_Xz, transitCount_XZ;
+	int transitCount_yz, transitCount_yZ, transitCount_Yz, transitCount_YZ;
+	double *transitbuf_xy, *transitbuf_xY, *transitbuf_xz, *transitbuf_xZ;
+	double *transitbuf_Xy, *transitbuf_XY, *transitbuf_Xz, *transitbuf_XZ;
+	double *transitbuf_yz, *transitbuf_yZ, *transitbuf_Yz, *transitbuf_YZ;
+	//......................................................................................
 	// Send buffers that reside on the compute device
 	int *dvcSendList_x, *dvcSendList_y, *dvcSendList_z, *dvcSendList_X, *dvcSendList_Y, *dvcSendList_Z;
 	int *dvcSendList_xy, *dvcSendList_yz, *dvcSendList_xz, *dvcSendList_Xy, *dvcSendList_Yz, *dvcSendList_xZ;
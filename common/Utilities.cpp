@@ -57,8 +57,10 @@ void Utilities::startup( int argc, char **argv )
 {
     NULL_USE( argc );
     NULL_USE( argv );
+#ifndef USE_OPENMP
     // Disable OpenMP
     Utilities::setenv( "OMP_NUM_THREADS", "1" );
+#endif
     Utilities::setenv( "MKL_NUM_THREADS", "1" );
     // Start MPI
 #ifdef USE_MPI
@@ -15,6 +15,7 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <math.h>
+#include "SIMD.h"
 
 #define STOKES
 
@@ -1267,7 +1268,7 @@ extern "C" void ScaLBL_SetSlice_z(double *Phi, double value, int Nx, int Ny, int
 //extern "C" void ScaLBL_D3Q19_AAeven_Color(double *dist, double *Aq, double *Bq, double *Den, double *Velocity,
 //		double *ColorGrad, double rhoA, double rhoB, double tauA, double tauB, double alpha, double beta,
 //		double Fx, double Fy, double Fz, int start, int finish, int Np){
-extern "C" void ScaLBL_D3Q19_AAeven_Color(int *Map, double *dist, double *Aq, double *Bq, double *Den, double *Phi,
+extern "C" ScaLBL_SIMD_DISPATCH void ScaLBL_D3Q19_AAeven_Color(int *Map, double *dist, double *Aq, double *Bq, double *Den, double *Phi,
 		double *Vel, double rhoA, double rhoB, double tauA, double tauB, double alpha, double beta,
 		double Fx, double Fy, double Fz, int strideY, int strideZ, int start, int finish, int Np){
 
@@ -1298,6 +1299,7 @@ extern "C" void ScaLBL_D3Q19_AAeven_Color(int *Map, double *dist, double *Aq, do
 	const double mrt_V12=0.04166666666666666;
 
 
+	#pragma omp parallel for simd private(ijk,nn,fq,rho,jx,jy,jz,m1,m2,m4,m6,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m3,m5,m7,nA,nB,a1,b1,a2,b2,nAB,delta,C,nx,ny,nz,ux,uy,uz,phi,tau,rho0,rlx_setA,rlx_setB)
 	for (int n=start; n<finish; n++){
 		
 		// read the component number densities
@@ -1850,7 +1852,7 @@ extern "C" void ScaLBL_D3Q19_AAeven_Color(int *Map, double *dist, double *Aq, do
 //extern "C" void ScaLBL_D3Q19_AAodd_Color(int *neighborList, double *dist, double *Aq, double *Bq, double *Den, double *Velocity,
 //		double *ColorGrad, double rhoA, double rhoB, double tauA, double tauB, double alpha, double beta,
 //		double Fx, double Fy, double Fz, int start, int finish, int Np){
-extern "C" void ScaLBL_D3Q19_AAodd_Color(int *neighborList, int *Map, double *dist, double *Aq, double *Bq, double *Den, 
+extern "C" ScaLBL_SIMD_DISPATCH void ScaLBL_D3Q19_AAodd_Color(int *neighborList, int *Map, double *dist, double *Aq, double *Bq, double *Den, 
 		double *Phi, double *Vel, double rhoA, double rhoB, double tauA, double tauB, double alpha, double beta,
 		double Fx, double Fy, double Fz, int strideY, int strideZ, int start, int finish, int Np){
 	
@@ -1884,6 +1886,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_Color(int *neighborList, int *Map, double *di
 	const double mrt_V11=0.01388888888888889;
 	const double mrt_V12=0.04166666666666666;
 
+	#pragma omp parallel for simd private(nn,ijk,nread,nr1,nr2,nr3,nr4,nr5,nr6,nr7,nr8,nr9,nr10,nr11,nr12,nr13,nr14,fq,rho,jx,jy,jz,m1,m2,m4,m6,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m3,m5,m7,nA,nB,a1,b1,a2,b2,nAB,delta,C,nx,ny,nz,ux,uy,uz,phi,tau,rho0,rlx_setA,rlx_setB)
 	for (int n=start; n<finish; n++){
 	
 		// read the component number densities
@@ -2511,6 +2514,7 @@ extern "C" void ScaLBL_D3Q7_AAodd_PhaseField(int *neighborList, int *Map, double
 	int idx,n,nread;
 	double fq,nA,nB;
 
+	#pragma omp parallel for private(idx,nread,fq,nA,nB)
 	for (int n=start; n<finish; n++){
 		
 		//..........Compute the number density for component A............
@@ -2597,6 +2601,7 @@ extern "C" void ScaLBL_D3Q7_AAeven_PhaseField(int *Map, double *Aq, double *Bq,
 			int start, int finish, int Np){
 	int idx,n,nread;
 	double fq,nA,nB;
+	#pragma omp parallel for private(idx,nread,fq,nA,nB)
 	for (int n=start; n<finish; n++){
 		
 		// compute number density for component A
@@ -2674,6 +2679,7 @@ extern "C" void ScaLBL_D3Q19_Gradient(int *Map, double *phi, double *ColorGrad,
 	double f10,f11,f12,f13,f14,f15,f16,f17,f18;
 	double nx,ny,nz;
 
+	#pragma omp parallel for private(n,N,i,j,k,nn,f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,f18,nx,ny,nz)
 	for (idx=0; idx<Np; idx++){
 
 		// Get the 1D index based on regular data layout
@@ -2791,6 +2797,7 @@ extern "C" void ScaLBL_PhaseField_Init(int *Map, double *Phi, double *Den, doubl
 	int idx,n;
 	double phi,nA,nB;
 
+	#pragma omp parallel for private(n,phi,nA,nB)
 	for (idx=start; idx<finish; idx++){
 
 		n = Map[idx];
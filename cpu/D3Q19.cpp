@@ -15,6 +15,20 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <stdio.h>
+#include <type_traits>
+#include "SIMD.h"
+#include "common/ScaLBL.h"
+
+// Kernel bodies shared by the double and single precision entry points are inlined into each clone
+#if defined(__GNUC__)
+#define ScaLBL_KERNEL_INLINE inline __attribute__((always_inline))
+#else
+#define ScaLBL_KERNEL_INLINE inline
+#endif
+
+// Single precision storage (the *_Single entry points) holds the deviation of each distribution from
+// the rest state (rho=1, u=0) so that the small non-equilibrium part keeps the float mantissa;
+// moments are computed in double and rho, m1, m2 are shifted by their rest values (1, -11, 3)
 
 extern "C" void ScaLBL_D3Q19_Pack(int q, int *list, int start, int count, double *sendbuf, double *dist, int N){
 	//....................................................................................
@@ -28,6 +42,22 @@ extern "C" void ScaLBL_D3Q19_Pack(int q, int *list, int start, int count, double
 	}
 }
 
+extern "C" void ScaLBL_D3Q19_PackFace(int q1, int q2, int q3, int q4, int q5, int *list, int count, double *sendbuf, double *dist, int N){
+	//....................................................................................
+	// Pack the five distributions that cross a face in a single pass over the list
+	// sendbuf holds count values for q1, followed by q2, ... q5
+	//....................................................................................
+	int idx,n;
+	for (idx=0; idx<count; idx++){
+		n = list[idx];
+		sendbuf[idx] = dist[q1*N+n];
+		sendbuf[count+idx] = dist[q2*N+n];
+		sendbuf[2*count+idx] = dist[q3*N+n];
+		sendbuf[3*count+idx] = dist[q4*N+n];
+		sendbuf[4*count+idx] = dist[q5*N+n];
+	}
+}
+
 extern "C" void ScaLBL_D3Q19_Unpack(int q, int *list,  int start, int count,
 		double *recvbuf, double *dist, int N){
 	//....................................................................................
@@ -47,9 +77,74 @@ extern "C" void ScaLBL_D3Q19_Unpack(int q, int *list,  int start, int count,
 	}
 }
 
+extern "C" void ScaLBL_D3Q19_UnpackFace(int q1, int q2, int q3, int q4, int q5, int *list, int count, double *recvbuf, double *dist, int N){
+	//....................................................................................
+	// Unpack the five distributions that cross a face in a single pass over the list
+	// recvbuf and list hold count values for q1, followed by q2, ... q5 (see ScaLBL_D3Q19_PackFace)
+	//....................................................................................
+	int idx,n;
+	for (idx=0; idx<count; idx++){
+		n = list[idx];
+		if (!(n<0)) dist[q1*N+n] = recvbuf[idx];
+		n = list[count+idx];
+		if (!(n<0)) dist[q2*N+n] = recvbuf[count+idx];
+		n = list[2*count+idx];
+		if (!(n<0)) dist[q3*N+n] = recvbuf[2*count+idx];
+		n = list[3*count+idx];
+		if (!(n<0)) dist[q4*N+n] = recvbuf[3*count+idx];
+		n = list[4*count+idx];
+		if (!(n<0)) dist[q5*N+n] = recvbuf[4*count+idx];
+	}
+}
+
+extern "C" void ScaLBL_D3Q19_Pack_Single(int q, int *list, int start, int count, float *sendbuf, float *dist, int N){
+	int idx,n;
+	for (idx=0; idx<count; idx++){
+		n = list[idx];
+		sendbuf[start+idx] = dist[q*N+n];
+	}
+}
+
+extern "C" void ScaLBL_D3Q19_PackFace_Single(int q1, int q2, int q3, int q4, int q5, int *list, int count, float *sendbuf, float *dist, int N){
+	int idx,n;
+	for (idx=0; idx<count; idx++){
+		n = list[idx];
+		sendbuf[idx] = dist[q1*N+n];
+		sendbuf[count+idx] = dist[q2*N+n];
+		sendbuf[2*count+idx] = dist[q3*N+n];
+		sendbuf[3*count+idx] = dist[q4*N+n];
+		sendbuf[4*count+idx] = dist[q5*N+n];
+	}
+}
+
+extern "C" void ScaLBL_D3Q19_Unpack_Single(int q, int *list,  int start, int count, float *recvbuf, float *dist, int N){
+	int n,idx;
+	for (idx=0; idx<count; idx++){
+		n = list[start+idx];
+		if (!(n<0)) dist[q*N+n] = recvbuf[start+idx];
+	}
+}
+
+extern "C" void ScaLBL_D3Q19_UnpackFace_Single(int q1, int q2, int q3, int q4, int q5, int *list, int count, float *recvbuf, float *dist, int N){
+	int idx,n;
+	for (idx=0; idx<count; idx++){
+		n = list[idx];
+		if (!(n<0)) dist[q1*N+n] = recvbuf[idx];
+		n = list[count+idx];
+		if (!(n<0)) dist[q2*N+n] = recvbuf[count+idx];
+		n = list[2*count+idx];
+		if (!(n<0)) dist[q3*N+n] = recvbuf[2*count+idx];
+		n = list[3*count+idx];
+		if (!(n<0)) dist[q4*N+n] = recvbuf[3*count+idx];
+		n = list[4*count+idx];
+		if (!(n<0)) dist[q5*N+n] = recvbuf[4*count+idx];
+	}
+}
+
 extern "C" void ScaLBL_D3Q19_AA_Init(double *f_even, double *f_odd, int Np)
 {
 	int n;
+	#pragma omp parallel for
 	for (n=0; n<Np; n++){
 		f_even[n] = 0.3333333333333333;
 		f_odd[n] = 0.055555555555555555;		//double(100*n)+1.f;
@@ -77,6 +172,7 @@ extern "C" void ScaLBL_D3Q19_AA_Init(double *f_even, double *f_odd, int Np)
 extern "C" void ScaLBL_D3Q19_Init(double *dist, int Np)
 {
 	int n;
+	#pragma omp parallel for
 	for (n=0; n<Np; n++){
 		dist[n] = 0.3333333333333333;
 		dist[Np+n] = 0.055555555555555555;		//double(100*n)+1.f;
@@ -100,6 +196,13 @@ extern "C" void ScaLBL_D3Q19_Init(double *dist, int Np)
 	}
 }
 
+extern "C" void ScaLBL_D3Q19_Init_Single(float *dist, int Np)
+{
+	// rest state (stored as the deviation from the weights)
+	#pragma omp parallel for
+	for (int n=0; n<19*Np; n++) dist[n] = 0.f;
+}
+
 //*************************************************************************
 extern "C" void ScaLBL_D3Q19_Swap(char *ID, double *disteven, double *distodd, int Nx, int Ny, int Nz)
 {
@@ -845,7 +948,8 @@ extern "C" void ScaLBL_D3Q19_Velocity_BC_Z(double *disteven, double *distodd, do
 	}
 }
 
-extern "C" void ScaLBL_D3Q19_Momentum(double *dist, double *vel, int Np)
+template<class TYPE>
+static void ScaLBL_D3Q19_Momentum_Kernel(const TYPE *dist, double *vel, int Np)
 {
 	int n;
 	int N =Np;
@@ -854,6 +958,7 @@ extern "C" void ScaLBL_D3Q19_Momentum(double *dist, double *vel, int Np)
 	double f10,f11,f12,f13,f14,f15,f16,f17,f18;
 	double vx,vy,vz;
 
+	#pragma omp parallel for private(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,f18,vx,vy,vz)
 	for (n=0; n<N; n++){
 		//........................................................................
 		// Registers to store the distributions
@@ -889,8 +994,21 @@ extern "C" void ScaLBL_D3Q19_Momentum(double *dist, double *vel, int Np)
 	}
 }
 
-extern "C" void ScaLBL_D3Q19_Pressure(double *dist, double *Pressure, int N)
+extern "C" void ScaLBL_D3Q19_Momentum(double *dist, double *vel, int Np)
+{
+	ScaLBL_D3Q19_Momentum_Kernel<double>(dist, vel, Np);
+}
+
+extern "C" void ScaLBL_D3Q19_Momentum_Single(float *dist, double *vel, int Np)
 {
+	// the rest state carries no momentum, so the deviations give the momentum directly
+	ScaLBL_D3Q19_Momentum_Kernel<float>(dist, vel, Np);
+}
+
+template<class TYPE>
+static void ScaLBL_D3Q19_Pressure_Kernel(const TYPE *dist, double *Pressure, int N)
+{
+	#pragma omp parallel for
 	for (int n=0; n<N; n++){
 		//........................................................................
 		// Registers to store the distributions
@@ -916,12 +1034,25 @@ extern "C" void ScaLBL_D3Q19_Pressure(double *dist, double *Pressure, int N)
 		double f15 = dist[15*N+n];
 		double f17 = dist[17*N+n];
 		//.................Compute the velocity...................................
-		Pressure[n] = 0.3333333333333333*(f0+f2+f1+f4+f3+f6+f5+f8+f7+f10+
-				f9+f12+f11+f14+f13+f16+f15+f18+f17);
+		double rho = f0+f2+f1+f4+f3+f6+f5+f8+f7+f10+
+				f9+f12+f11+f14+f13+f16+f15+f18+f17;
+		if (std::is_same<TYPE,float>::value) rho += 1.0;
+		Pressure[n] = 0.3333333333333333*rho;
 	}
 }
 
-extern "C" void ScaLBL_D3Q19_AAeven_MRT(double *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
+extern "C" void ScaLBL_D3Q19_Pressure(double *dist, double *Pressure, int N)
+{
+	ScaLBL_D3Q19_Pressure_Kernel<double>(dist, Pressure, N);
+}
+
+extern "C" void ScaLBL_D3Q19_Pressure_Single(float *dist, double *Pressure, int N)
+{
+	ScaLBL_D3Q19_Pressure_Kernel<float>(dist, Pressure, N);
+}
+
+template<class TYPE>
+static ScaLBL_KERNEL_INLINE void ScaLBL_D3Q19_AAeven_MRT_Kernel(TYPE *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
 		double Fy, double Fz)
 {
 	// conserved momemnts
@@ -942,6 +1073,7 @@ extern "C" void ScaLBL_D3Q19_AAeven_MRT(double *dist, int start, int finish, int
 	constexpr double mrt_V11=0.01388888888888889;
 	constexpr double mrt_V12=0.04166666666666666;
 
+	#pragma omp parallel for simd private(rho,jx,jy,jz,m1,m2,m4,m6,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18)
 	for (int n=start; n<finish; n++){
 		// q=0
 		double fq = dist[n];
@@ -1220,6 +1352,12 @@ extern "C" void ScaLBL_D3Q19_AAeven_MRT(double *dist, int start, int finish, int
 		//		(read from opposite array due to previous swap operation)
 		//........................................................................
 
+		if (std::is_same<TYPE,float>::value){
+			// restore the rest state removed from single precision storage
+			rho += 1.0;
+			m1 -= 11.0;
+			m2 += 3.0;
+		}
 		//..............incorporate external force................................................
 		//..............carry out relaxation process...............................................
 		m1 = m1 + rlx_setA*((19*(jx*jx+jy*jy+jz*jz)/rho - 11*rho) - m1);
@@ -1238,6 +1376,11 @@ extern "C" void ScaLBL_D3Q19_AAeven_MRT(double *dist, int start, int finish, int
 		m17 = m17 + rlx_setB*( - m17);
 		m18 = m18 + rlx_setB*( - m18);
 		//.......................................................................................................
+		if (std::is_same<TYPE,float>::value){
+			rho -= 1.0;
+			m1 += 11.0;
+			m2 -= 3.0;
+		}
 		//.................inverse transformation......................................................
 
 		// q=0
@@ -1350,7 +1493,51 @@ extern "C" void ScaLBL_D3Q19_AAeven_MRT(double *dist, int start, int finish, int
 	}
 }
 
-extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
+extern "C" ScaLBL_SIMD_DISPATCH void ScaLBL_D3Q19_AAeven_MRT(double *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
+		double Fy, double Fz)
+{
+	ScaLBL_D3Q19_AAeven_MRT_Kernel<double>(dist, start, finish, Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+}
+
+extern "C" ScaLBL_SIMD_DISPATCH void ScaLBL_D3Q19_AAeven_MRT_Single(float *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
+		double Fy, double Fz)
+{
+	ScaLBL_D3Q19_AAeven_MRT_Kernel<float>(dist, start, finish, Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+}
+
+// Neighbor fetch for the odd step: entry q of the neighbor list for site n
+struct ScaLBL_D3Q19_NeighborList {
+	const int *list;
+	int Np;
+	inline int operator()(int n, int q) const { return list[q*Np+n]; }
+};
+
+// Neighbor fetch from the compressed neighbor list (see ScaLBL_Communicator::CompressNeighborList)
+// returns the same value as the full list; blockBase holds the two bases for each direction in the block of n,
+// selected by the low bit of the offset (blocks marked ScaLBL_NEIGHBOR_FULL are not decoded)
+struct ScaLBL_D3Q19_NeighborOffset {
+	const short *offset;
+	int Np;
+	int base[18];	// even base of each direction, with the direction and the offset bias folded in
+	int step[18];	// odd base minus even base
+	ScaLBL_D3Q19_NeighborOffset(const short *neighborOffset, const int *blockBase, int N): offset(neighborOffset), Np(N) {
+		for (int q=0; q<18; q++){
+			base[q] = blockBase[2*q] + (q+1)*Np - 32768;
+			step[q] = blockBase[2*q+1] - blockBase[2*q];
+		}
+	}
+	inline int operator()(int n, int q) const {
+		// (written on 32 bit values with the bases held locally so that the calling loop vectorizes;
+		//  the shift by 2^16 keeps the compiler from narrowing the arithmetic to 16 bit lanes)
+		int d = offset[q*Np+n] + 65536;
+		int next = n + base[q] + (-(d & 1) & step[q]) + (d >> 1);
+		int bounce = -(d == ScaLBL_NEIGHBOR_BOUNCEBACK + 65536);
+		return next + (bounce & (n + ((q^1)+1)*Np - next));
+	}
+};
+
+template<class TYPE, class NEIGHBOR>
+static ScaLBL_KERNEL_INLINE void ScaLBL_D3Q19_AAodd_MRT_Kernel(const NEIGHBOR& neighbor, TYPE *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
 		double Fy, double Fz)
 {
 	// conserved momemnts
@@ -1372,6 +1559,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 
 
 	int nread;
+	#pragma omp simd private(rho,jx,jy,jz,m1,m2,m4,m6,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,nread)
 	for (int n=start; n<finish; n++){
 		// q=0
 		double fq = dist[n];
@@ -1380,7 +1568,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m2  = 12.0*fq;
 
 		// q=1
-		nread = neighborList[n]; // neighbor 2 ( > 10Np => odd part of dist)
+		nread = neighbor(n,0); // neighbor 2 ( > 10Np => odd part of dist)
 		fq = dist[nread]; // reading the f1 data into register fq
 		//fp = dist[10*Np+n];
 		rho += fq;
@@ -1392,7 +1580,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m10 = -4.0*fq;
 
 		// f2 = dist[10*Np+n];
-		nread = neighborList[n+Np]; // neighbor 1 ( < 10Np => even part of dist)
+		nread = neighbor(n,1); // neighbor 1 ( < 10Np => even part of dist)
 		fq = dist[nread];  // reading the f2 data into register fq
 		//fq = dist[Np+n];
 		rho += fq;
@@ -1404,7 +1592,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m10 -= 4.0*(fq);
 
 		// q=3
-		nread = neighborList[n+2*Np]; // neighbor 4
+		nread = neighbor(n,2); // neighbor 4
 		fq = dist[nread];
 		//fq = dist[11*Np+n];
 		rho += fq;
@@ -1418,7 +1606,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m12 = -2.0*fq;
 
 		// q = 4
-		nread = neighborList[n+3*Np]; // neighbor 3
+		nread = neighbor(n,3); // neighbor 3
 		fq = dist[nread];
 		//fq = dist[2*Np+n];
 		rho+= fq;
@@ -1432,7 +1620,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m12 -= 2.0*fq;
 
 		// q=5
-		nread = neighborList[n+4*Np];
+		nread = neighbor(n,4);
 		fq = dist[nread];
 		//fq = dist[12*Np+n];
 		rho += fq;
@@ -1447,7 +1635,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 
 
 		// q = 6
-		nread = neighborList[n+5*Np];
+		nread = neighbor(n,5);
 		fq = dist[nread];
 		//fq = dist[3*Np+n];
 		rho+= fq;
@@ -1461,7 +1649,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m12 += 2.0*fq;
 
 		// q=7
-		nread = neighborList[n+6*Np];
+		nread = neighbor(n,6);
 		fq = dist[nread];
 		//fq = dist[13*Np+n];
 		rho += fq;
@@ -1480,7 +1668,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m17 = -fq;
 
 		// q = 8
-		nread = neighborList[n+7*Np];
+		nread = neighbor(n,7);
 		fq = dist[nread];
 		//fq = dist[4*Np+n];
 		rho += fq;
@@ -1499,7 +1687,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m17 += fq;
 
 		// q=9
-		nread = neighborList[n+8*Np];
+		nread = neighbor(n,8);
 		fq = dist[nread];
 		//fq = dist[14*Np+n];
 		rho += fq;
@@ -1518,7 +1706,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m17 += fq;
 
 		// q = 10
-		nread = neighborList[n+9*Np];
+		nread = neighbor(n,9);
 		fq = dist[nread];
 		//fq = dist[5*Np+n];
 		rho += fq;
@@ -1537,7 +1725,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m17 -= fq;
 
 		// q=11
-		nread = neighborList[n+10*Np];
+		nread = neighbor(n,10);
 		fq = dist[nread];
 		//fq = dist[15*Np+n];
 		rho += fq;
@@ -1556,7 +1744,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m18 = fq;
 
 		// q=12
-		nread = neighborList[n+11*Np];
+		nread = neighbor(n,11);
 		fq = dist[nread];
 		//fq = dist[6*Np+n];
 		rho += fq;
@@ -1575,7 +1763,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m18 -= fq;
 
 		// q=13
-		nread = neighborList[n+12*Np];
+		nread = neighbor(n,12);
 		fq = dist[nread];
 		//fq = dist[16*Np+n];
 		rho += fq;
@@ -1594,7 +1782,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m18 -= fq;
 
 		// q=14
-		nread = neighborList[n+13*Np];
+		nread = neighbor(n,13);
 		fq = dist[nread];
 		//fq = dist[7*Np+n];
 		rho += fq;
@@ -1613,7 +1801,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m18 += fq;
 
 		// q=15
-		nread = neighborList[n+14*Np];
+		nread = neighbor(n,14);
 		fq = dist[nread];
 		//fq = dist[17*Np+n];
 		rho += fq;
@@ -1630,7 +1818,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m18 -= fq;
 
 		// q=16
-		nread = neighborList[n+15*Np];
+		nread = neighbor(n,15);
 		fq = dist[nread];
 		//fq = dist[8*Np+n];
 		rho += fq;
@@ -1648,7 +1836,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 
 		// q=17
 		//fq = dist[18*Np+n];
-		nread = neighborList[n+16*Np];
+		nread = neighbor(n,16);
 		fq = dist[nread];
 		rho += fq;
 		m1 += 8.0*fq;
@@ -1664,7 +1852,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m18 += fq;
 
 		// q=18
-		nread = neighborList[n+17*Np];
+		nread = neighbor(n,17);
 		fq = dist[nread];
 		//fq = dist[9*Np+n];
 		rho += fq;
@@ -1680,6 +1868,12 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m17 -= fq;
 		m18 -= fq;
 
+		if (std::is_same<TYPE,float>::value){
+			// restore the rest state removed from single precision storage
+			rho += 1.0;
+			m1 -= 11.0;
+			m2 += 3.0;
+		}
 		//..............incorporate external force................................................
 		//..............carry out relaxation process...............................................
 		m1 = m1 + rlx_setA*((19*(jx*jx+jy*jy+jz*jz)/rho - 11*rho) - m1);
@@ -1698,6 +1892,11 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		m17 = m17 + rlx_setB*( - m17);
 		m18 = m18 + rlx_setB*( - m18);
 		//.......................................................................................................
+		if (std::is_same<TYPE,float>::value){
+			rho -= 1.0;
+			m1 += 11.0;
+			m2 -= 3.0;
+		}
 		//.................inverse transformation......................................................
 
 		// q=0
@@ -1706,59 +1905,59 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 
 		// q = 1
 		fq = mrt_V1*rho-mrt_V4*m1-mrt_V5*m2+0.1*(jx-m4)+mrt_V6*(m9-m10)+0.16666666*Fx;
-		nread = neighborList[n+Np];
+		nread = neighbor(n,1);
 		dist[nread] = fq;
 
 		// q=2
 		fq = mrt_V1*rho-mrt_V4*m1-mrt_V5*m2+0.1*(m4-jx)+mrt_V6*(m9-m10) -  0.16666666*Fx;
-		nread = neighborList[n];
+		nread = neighbor(n,0);
 		dist[nread] = fq;
 
 		// q = 3
 		fq = mrt_V1*rho-mrt_V4*m1-mrt_V5*m2+0.1*(jy-m6)+mrt_V7*(m10-m9)+mrt_V8*(m11-m12) + 0.16666666*Fy;
-		nread = neighborList[n+3*Np];
+		nread = neighbor(n,3);
 		dist[nread] = fq;
 
 		// q = 4
 		fq = mrt_V1*rho-mrt_V4*m1-mrt_V5*m2+0.1*(m6-jy)+mrt_V7*(m10-m9)+mrt_V8*(m11-m12) - 0.16666666*Fy;
-		nread = neighborList[n+2*Np];
+		nread = neighbor(n,2);
 		dist[nread] = fq;
 
 		// q = 5
 		fq = mrt_V1*rho-mrt_V4*m1-mrt_V5*m2+0.1*(jz-m8)+mrt_V7*(m10-m9)+mrt_V8*(m12-m11) + 0.16666666*Fz;
-		nread = neighborList[n+5*Np];
+		nread = neighbor(n,5);
 		dist[nread] = fq;
 
 		// q = 6
 		fq = mrt_V1*rho-mrt_V4*m1-mrt_V5*m2+0.1*(m8-jz)+mrt_V7*(m10-m9)+mrt_V8*(m12-m11) - 0.16666666*Fz;
-		nread = neighborList[n+4*Np];
+		nread = neighbor(n,4);
 		dist[nread] = fq;
 
 		// q = 7
 		fq = mrt_V1*rho+mrt_V9*m1+mrt_V10*m2+0.1*(jx+jy)+0.025*(m4+m6)
                                                 								+mrt_V7*m9+mrt_V11*m10+mrt_V8*m11
                                                 								+mrt_V12*m12+0.25*m13+0.125*(m16-m17) + 0.08333333333*(Fx+Fy);
-		nread = neighborList[n+7*Np];
+		nread = neighbor(n,7);
 		dist[nread] = fq;
 
 		// q = 8
 		fq = mrt_V1*rho+mrt_V9*m1+mrt_V10*m2-0.1*(jx+jy)-0.025*(m4+m6) +mrt_V7*m9+mrt_V11*m10+mrt_V8*m11
 				+mrt_V12*m12+0.25*m13+0.125*(m17-m16) - 0.08333333333*(Fx+Fy);
-		nread = neighborList[n+6*Np];
+		nread = neighbor(n,6);
 		dist[nread] = fq;
 
 		// q = 9
 		fq = mrt_V1*rho+mrt_V9*m1+mrt_V10*m2+0.1*(jx-jy)+0.025*(m4-m6)
                                                 								+mrt_V7*m9+mrt_V11*m10+mrt_V8*m11
                                                 								+mrt_V12*m12-0.25*m13+0.125*(m16+m17) + 0.08333333333*(Fx-Fy);
-		nread = neighborList[n+9*Np];
+		nread = neighbor(n,9);
 		dist[nread] = fq;
 
 		// q = 10
 		fq = mrt_V1*rho+mrt_V9*m1+mrt_V10*m2+0.1*(jy-jx)+0.025*(m6-m4)
                                                 								+mrt_V7*m9+mrt_V11*m10+mrt_V8*m11
                                                 								+mrt_V12*m12-0.25*m13-0.125*(m16+m17)- 0.08333333333*(Fx-Fy);
-		nread = neighborList[n+8*Np];
+		nread = neighbor(n,8);
 		dist[nread] = fq;
 
 		// q = 11
@@ -1766,14 +1965,14 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 				+mrt_V10*m2+0.1*(jx+jz)+0.025*(m4+m8)
 				+mrt_V7*m9+mrt_V11*m10-mrt_V8*m11
 				-mrt_V12*m12+0.25*m15+0.125*(m18-m16) + 0.08333333333*(Fx+Fz);
-		nread = neighborList[n+11*Np];
+		nread = neighbor(n,11);
 		dist[nread] = fq;
 
 		// q = 12
 		fq = mrt_V1*rho+mrt_V9*m1+mrt_V10*m2-0.1*(jx+jz)-0.025*(m4+m8)
                                         								+mrt_V7*m9+mrt_V11*m10-mrt_V8*m11
                                         								-mrt_V12*m12+0.25*m15+0.125*(m16-m18) - 0.08333333333*(Fx+Fz);
-		nread = neighborList[n+10*Np];
+		nread = neighbor(n,10);
 		dist[nread]= fq;
 
 		// q = 13
@@ -1781,7 +1980,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 				+mrt_V10*m2+0.1*(jx-jz)+0.025*(m4-m8)
 				+mrt_V7*m9+mrt_V11*m10-mrt_V8*m11
 				-mrt_V12*m12-0.25*m15-0.125*(m16+m18) + 0.08333333333*(Fx-Fz);
-		nread = neighborList[n+13*Np];
+		nread = neighbor(n,13);
 		dist[nread] = fq;
 
 		// q= 14
@@ -1789,7 +1988,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 				+mrt_V10*m2+0.1*(jz-jx)+0.025*(m8-m4)
 				+mrt_V7*m9+mrt_V11*m10-mrt_V8*m11
 				-mrt_V12*m12-0.25*m15+0.125*(m16+m18) - 0.08333333333*(Fx-Fz);
-		nread = neighborList[n+12*Np];
+		nread = neighbor(n,12);
 		dist[nread] = fq;
 
 
@@ -1797,14 +1996,14 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		fq = mrt_V1*rho+mrt_V9*m1
 				+mrt_V10*m2+0.1*(jy+jz)+0.025*(m6+m8)
 				-mrt_V6*m9-mrt_V7*m10+0.25*m14+0.125*(m17-m18) + 0.08333333333*(Fy+Fz);
-		nread = neighborList[n+15*Np];
+		nread = neighbor(n,15);
 		dist[nread] = fq;
 
 		// q = 16
 		fq =  mrt_V1*rho+mrt_V9*m1
 				+mrt_V10*m2-0.1*(jy+jz)-0.025*(m6+m8)
 				-mrt_V6*m9-mrt_V7*m10+0.25*m14+0.125*(m18-m17)- 0.08333333333*(Fy+Fz);
-		nread = neighborList[n+14*Np];
+		nread = neighbor(n,14);
 		dist[nread] = fq;
 
 
@@ -1812,19 +2011,67 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int star
 		fq = mrt_V1*rho+mrt_V9*m1
 				+mrt_V10*m2+0.1*(jy-jz)+0.025*(m6-m8)
 				-mrt_V6*m9-mrt_V7*m10-0.25*m14+0.125*(m17+m18) + 0.08333333333*(Fy-Fz);
-		nread = neighborList[n+17*Np];
+		nread = neighbor(n,17);
 		dist[nread] = fq;
 
 		// q = 18
 		fq = mrt_V1*rho+mrt_V9*m1
 				+mrt_V10*m2+0.1*(jz-jy)+0.025*(m8-m6)
 				-mrt_V6*m9-mrt_V7*m10-0.25*m14-0.125*(m17+m18) - 0.08333333333*(Fy-Fz);
-		nread = neighborList[n+16*Np];
+		nread = neighbor(n,16);
 		dist[nread] = fq;
 
 	}
 }
 
+template<class TYPE>
+static ScaLBL_KERNEL_INLINE void ScaLBL_D3Q19_AAodd_MRT_List(int *neighborList, TYPE *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
+		double Fy, double Fz)
+{
+	// threads take blocks of 2^ScaLBL_NEIGHBOR_BLOCK_SHIFT sites, each block is one vectorized loop
+	const ScaLBL_D3Q19_NeighborList neighbor = { neighborList, Np };
+	const int blocksize = 1 << ScaLBL_NEIGHBOR_BLOCK_SHIFT;
+	#pragma omp parallel for
+	for (int n=start; n<finish; n+=blocksize){
+		int end = (n+blocksize < finish) ? n+blocksize : finish;
+		ScaLBL_D3Q19_AAodd_MRT_Kernel<TYPE>(neighbor, dist, n, end, Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+	}
+}
+
+extern "C" ScaLBL_SIMD_DISPATCH void ScaLBL_D3Q19_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
+		double Fy, double Fz)
+{
+	ScaLBL_D3Q19_AAodd_MRT_List<double>(neighborList, dist, start, finish, Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+}
+
+extern "C" ScaLBL_SIMD_DISPATCH void ScaLBL_D3Q19_AAodd_MRT_Single(int *neighborList, float *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
+		double Fy, double Fz)
+{
+	ScaLBL_D3Q19_AAodd_MRT_List<float>(neighborList, dist, start, finish, Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+}
+
+extern "C" ScaLBL_SIMD_DISPATCH void ScaLBL_D3Q19_AAodd_MRT_Compressed(int *neighborList, short *neighborOffset, int *neighborBase, double *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
+		double Fy, double Fz)
+{
+	// Each block is processed from the 16 bit offsets with the bases of the block held locally,
+	// or from the full list if the block is marked ScaLBL_NEIGHBOR_FULL (both inline the same kernel,
+	// so the parallel region and the SIMD dispatch are entered once for all blocks)
+	const ScaLBL_D3Q19_NeighborList list = { neighborList, Np };
+	const int blocksize = 1 << ScaLBL_NEIGHBOR_BLOCK_SHIFT;
+	int first = start >> ScaLBL_NEIGHBOR_BLOCK_SHIFT;
+	int last = (finish + blocksize - 1) >> ScaLBL_NEIGHBOR_BLOCK_SHIFT;
+	#pragma omp parallel for
+	for (int block=first; block<last; block++){
+		int n = (block*blocksize > start) ? block*blocksize : start;
+		int end = ((block+1)*blocksize < finish) ? (block+1)*blocksize : finish;
+		const int *blockBase = &neighborBase[block*36];
+		if (blockBase[0] == ScaLBL_NEIGHBOR_FULL)
+			ScaLBL_D3Q19_AAodd_MRT_Kernel<double>(list, dist, n, end, Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+		else
+			ScaLBL_D3Q19_AAodd_MRT_Kernel<double>(ScaLBL_D3Q19_NeighborOffset(neighborOffset, blockBase, Np), dist, n, end, Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+	}
+}
+
 extern "C" void ScaLBL_D3Q19_AAeven_Compact(char * ID, double *dist,  int Np)
 {
 
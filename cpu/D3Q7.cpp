@@ -59,6 +59,60 @@ extern "C" void ScaLBL_D3Q7_Unpack(int q, int *list,  int start, int count,
 }
 
 
+extern "C" void ScaLBL_D3Q7_BiPack(int q, int *list, int count, double *sendbuf, double *Aq, double *Bq, int N){
+	//....................................................................................
+	// Pack distribution q from two components in a single pass over the list
+	//....................................................................................
+	int idx,n;
+	for (idx=0; idx<count; idx++){
+		n = list[idx];
+		sendbuf[idx] = Aq[q*N+n];
+		sendbuf[count+idx] = Bq[q*N+n];
+	}
+}
+
+extern "C" void ScaLBL_D3Q7_TriPack(int q, int *list, int count, double *sendbuf, double *Aq, double *Bq, double *Cq, int N){
+	//....................................................................................
+	// Pack distribution q from three components in a single pass over the list
+	//....................................................................................
+	int idx,n;
+	for (idx=0; idx<count; idx++){
+		n = list[idx];
+		sendbuf[idx] = Aq[q*N+n];
+		sendbuf[count+idx] = Bq[q*N+n];
+		sendbuf[2*count+idx] = Cq[q*N+n];
+	}
+}
+
+extern "C" void ScaLBL_D3Q7_BiUnpack(int q, int *list, int count, double *recvbuf, double *Aq, double *Bq, int N){
+	//....................................................................................
+	// Unpack distribution q for two components in a single pass over the list
+	//....................................................................................
+	int n,idx;
+	for (idx=0; idx<count; idx++){
+		n = list[idx];
+		if (!(n<0)){
+			Aq[q*N+n] = recvbuf[idx];
+			Bq[q*N+n] = recvbuf[count+idx];
+		}
+	}
+}
+
+extern "C" void ScaLBL_D3Q7_TriUnpack(int q, int *list, int count, double *recvbuf, double *Aq, double *Bq, double *Cq, int N){
+	//....................................................................................
+	// Unpack distribution q for three components in a single pass over the list
+	//....................................................................................
+	int n,idx;
+	for (idx=0; idx<count; idx++){
+		n = list[idx];
+		if (!(n<0)){
+			Aq[q*N+n] = recvbuf[idx];
+			Bq[q*N+n] = recvbuf[count+idx];
+			Cq[q*N+n] = recvbuf[2*count+idx];
+		}
+	}
+}
+
 extern "C" void ScaLBL_PackDenD3Q7(int *list, int count, double *sendbuf, int number, double *Data, int N){
 	//....................................................................................
 	// Pack distribution into the send buffer for the listed lattice sites
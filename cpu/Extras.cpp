@@ -36,11 +36,25 @@ extern "C" void ScaLBL_AllocateZeroCopy(void** address, size_t size){
 extern "C" void ScaLBL_AllocateDeviceMemory(void** address, size_t size){
 	//cudaMalloc(address,size);
 	(*address) = _mm_malloc(size,64);
-	memset(*address,0,size);
 	
 	if (*address==NULL){
 		printf("Memory allocation failed! \n");
+		return;
+	}
+#ifdef USE_OPENMP
+	// zero the pages from all threads so that first touch spreads the memory
+	// across the NUMA nodes instead of placing it all near the master thread
+	char *data = (char *)(*address);
+	long int nblocks = (size + 4095)/4096;
+	#pragma omp parallel for schedule(static)
+	for (long int b=0; b<nblocks; b++){
+		size_t offset = b*4096;
+		size_t length = (offset+4096 < size) ? 4096 : size-offset;
+		memset(&data[offset],0,length);
 	}
+#else
+	memset(*address,0,size);
+#endif
 }
 
 extern "C" void ScaLBL_FreeDeviceMemory(void* pointer){
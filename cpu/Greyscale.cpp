@@ -32,6 +32,7 @@ extern "C" void ScaLBL_D3Q19_AAeven_Greyscale(double *dist, int start, int finis
     double mu_eff = (1.0/rlx_eff-0.5)/3.0;//kinematic viscosity
     double Fx, Fy, Fz;//The total body force including Brinkman force and user-specified (Gx,Gy,Gz)
 
+	#pragma omp parallel for private(rho,vx,vy,vz,v_mag,ux,uy,uz,u_mag,pressure,f0,f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,f18,GeoFun,porosity,perm,c0,c1,Fx,Fy,Fz)
 	for (int n=start; n<finish; n++){
 		// q=0
 		f0 = dist[n];
@@ -279,6 +280,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_Greyscale(int *neighborList, double *dist, in
     double Fx, Fy, Fz;//The total body force including Brinkman force and user-specified (Gx,Gy,Gz)
 
 	int nread;
+	#pragma omp parallel for private(rho,vx,vy,vz,v_mag,ux,uy,uz,u_mag,pressure,f0,f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,f18,nr1,nr2,nr3,nr4,nr5,nr6,nr7,nr8,nr9,nr10,nr11,nr12,nr13,nr14,nr15,nr16,nr17,nr18,GeoFun,porosity,perm,c0,c1,Fx,Fy,Fz,nread)
 	for (int n=start; n<finish; n++){
 		
 		// q=0
@@ -600,6 +602,7 @@ extern "C" void ScaLBL_D3Q19_AAeven_Greyscale_IMRT(double *dist, int start, int
 	const double mrt_V11=0.01388888888888889;
 	const double mrt_V12=0.04166666666666666;
 
+	#pragma omp parallel for private(vx,vy,vz,v_mag,ux,uy,uz,u_mag,pressure,jx,jy,jz,m1,m2,m4,m6,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,fq,GeoFun,porosity,perm,c0,c1,Fx,Fy,Fz)
 	for (int n=start; n<finish; n++){
 
 		//........................................................................
@@ -1089,6 +1092,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_Greyscale_IMRT(int *neighborList, double *dis
 	const double mrt_V11=0.01388888888888889;
 	const double mrt_V12=0.04166666666666666;
 
+	#pragma omp parallel for private(nread,vx,vy,vz,v_mag,ux,uy,uz,u_mag,pressure,jx,jy,jz,m1,m2,m4,m6,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,fq,GeoFun,porosity,perm,c0,c1,Fx,Fy,Fz)
 	for (int n=start; n<finish; n++){
 
 		//........................................................................
@@ -1618,6 +1622,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_Greyscale_MRT(int *neighborList, double *dist
 	const double mrt_V11=0.01388888888888889;
 	const double mrt_V12=0.04166666666666666;
 
+	#pragma omp parallel for private(nread,nr1,nr2,nr3,nr4,nr5,nr6,nr7,nr8,nr9,nr10,nr11,nr12,nr13,nr14,vx,vy,vz,v_mag,ux,uy,uz,u_mag,pressure,rho,jx,jy,jz,m1,m2,m4,m6,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,fq,GeoFun,porosity,perm,c0,c1,Fx,Fy,Fz)
 	for (int n=start; n<finish; n++){
         //........................................................................
         //					READ THE DISTRIBUTIONS
@@ -2167,6 +2172,7 @@ extern "C" void ScaLBL_D3Q19_AAeven_Greyscale_MRT(double *dist, int start, int f
 	const double mrt_V12=0.04166666666666666;
 
 
+	#pragma omp parallel for private(vx,vy,vz,v_mag,ux,uy,uz,u_mag,pressure,rho,jx,jy,jz,m1,m2,m4,m6,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,fq,GeoFun,porosity,perm,c0,c1,Fx,Fy,Fz)
 	for (int n=start; n<finish; n++){
         //........................................................................
         //					READ THE DISTRIBUTIONS
@@ -2617,6 +2623,7 @@ extern "C" void ScaLBL_D3Q19_AAeven_Greyscale_MRT(double *dist, int start, int f
 extern "C" void ScaLBL_D3Q19_GreyIMRT_Init(double *dist, int Np, double Den)
 {
 	int n;
+	#pragma omp parallel for
 	for (n=0; n<Np; n++){
 		dist[n] = Den - 0.6666666666666667;
 		dist[Np+n] = 0.055555555555555555;		//double(100*n)+1.f;
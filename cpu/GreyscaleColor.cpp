@@ -45,6 +45,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_GreyscaleColor(int *neighborList, int *Map, d
 	const double mrt_V11=0.01388888888888889;
 	const double mrt_V12=0.04166666666666666;
 
+	#pragma omp parallel for private(nn,ijk,nread,nr1,nr2,nr3,nr4,nr5,nr6,nr7,nr8,nr9,nr10,nr11,nr12,nr13,nr14,fq,rho,jx,jy,jz,vx,vy,vz,v_mag,ux,uy,uz,u_mag,m1,m2,m4,m6,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m3,m5,m7,nA,nB,a1,b1,a2,b2,nAB,delta,C,nx,ny,nz,phi,tau,rho0,rlx_setA,rlx_setB,porosity,perm,c0,c1,tau_eff,mu_eff,nx_gs,ny_gs,nz_gs,Fx,Fy,Fz)
 	for (n=start; n<finish; n++){
 		// read the component number densities
 		nA = Den[n];
@@ -750,6 +751,7 @@ extern "C" void ScaLBL_D3Q19_AAeven_GreyscaleColor(int *Map, double *dist, doubl
 	const double mrt_V11=0.01388888888888889;
 	const double mrt_V12=0.04166666666666666;
 
+	#pragma omp parallel for private(ijk,nn,fq,rho,jx,jy,jz,vx,vy,vz,v_mag,ux,uy,uz,u_mag,m1,m2,m4,m6,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m3,m5,m7,nA,nB,a1,b1,a2,b2,nAB,delta,C,nx,ny,nz,phi,tau,rho0,rlx_setA,rlx_setB,porosity,perm,c0,c1,tau_eff,mu_eff,nx_gs,ny_gs,nz_gs,Fx,Fy,Fz)
 	for (n=start; n<finish; n++){
 
 		// read the component number densities
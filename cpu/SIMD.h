@@ -0,0 +1,30 @@
+/*
+  Copyright 2013--2018 James E. McClure, Virginia Polytechnic & State University
+  Copyright Equnior ASA
+
+  This file is part of the Open Porous Media project (OPM).
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef ScaLBL_SIMD_H
+#define ScaLBL_SIMD_H
+
+// Clone the collision kernels for AVX-512 and AVX2; the version matching the CPU is selected at load time
+#if defined(__x86_64__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define ScaLBL_SIMD_DISPATCH __attribute__((target_clones("avx512f","avx2","default")))
+#endif
+#endif
+#ifndef ScaLBL_SIMD_DISPATCH
+#define ScaLBL_SIMD_DISPATCH
+#endif
+
+#endif
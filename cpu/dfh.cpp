@@ -57,6 +57,7 @@ extern "C" void ScaLBL_Gradient_Unpack(double weight, double Cqx, double Cqy, do
 
 extern "C" void ScaLBL_DFH_Init(double *Phi, double *Den, double *Aq, double *Bq, int start, int finish, int Np)
 {
+	#pragma omp parallel for
 	for (int idx=start; idx<finish; idx++){
 	    double phi,nA,nB;
 		phi = Phi[idx];
@@ -119,6 +120,7 @@ extern "C" void ScaLBL_D3Q19_AAeven_DFH(int *neighborList, double *dist, double
 	const double mrt_V12=0.04166666666666666;
 
 
+	#pragma omp parallel for private(fq,rho,jx,jy,jz,m1,m2,m4,m6,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,nA,nB,a1,b1,a2,b2,nAB,delta,C,nx,ny,nz,ux,uy,uz,phi,tau,rho0,rlx_setA,rlx_setB,force_x,force_y,force_z)
 	for (int n=start; n<finish; n++){
 		
 		// read the component number densities
@@ -645,6 +647,7 @@ extern "C" void ScaLBL_D3Q19_AAodd_DFH(int *neighborList, double *dist, double *
 	const double mrt_V11=0.01388888888888889;
 	const double mrt_V12=0.04166666666666666;
 
+	#pragma omp parallel for private(nread,nr1,nr2,nr3,nr4,nr5,nr6,nr7,nr8,nr9,nr10,nr11,nr12,nr13,nr14,fq,rho,jx,jy,jz,m1,m2,m4,m6,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,nA,nB,a1,b1,a2,b2,nAB,delta,C,nx,ny,nz,ux,uy,uz,phi,tau,rho0,rlx_setA,rlx_setB,force_x,force_y,force_z)
 	for (int n=start; n<finish; n++){
 		
 		// read the component number densities
@@ -1213,6 +1216,7 @@ extern "C" void ScaLBL_D3Q7_AAodd_DFH(int *neighborList, double *Aq, double *Bq,
 			double *Den, double *Phi, int start, int finish, int Np)
 {
 
+	#pragma omp parallel for
 	for (int n=start; n<finish; n++){
 		int nread;
 		double fq,nA,nB;
@@ -1300,6 +1304,7 @@ extern "C" void ScaLBL_D3Q7_AAodd_DFH(int *neighborList, double *Aq, double *Bq,
 extern "C" void ScaLBL_D3Q7_AAeven_DFH(double *Aq, double *Bq, double *Den, double *Phi, 
 			int start, int finish, int Np)
 {
+	#pragma omp parallel for
 	for (int n=start; n<finish; n++){
 		double fq,nA,nB;
 		// compute number density for component A
@@ -1381,6 +1386,7 @@ extern "C" void ScaLBL_D3Q19_Gradient_DFH(int *neighborList, double *Phi, double
 	// non-conserved moments
 	// additional variables needed for computations
 
+	#pragma omp parallel for private(nn,m1,m2,m4,m6,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m3,m5,m7,nx,ny,nz)
 	for (n=start; n<finish; n++){
 		nn = neighborList[n+Np]%Np;
 		m1 = Phi[nn];
@@ -15,7 +15,9 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <stdio.h>
+#include <type_traits>
 #include <cooperative_groups.h>
+#include "common/ScaLBL.h"
 
 #define NBLOCKS 1024
 #define NTHREADS 256
@@ -158,6 +160,22 @@ __global__ void dvc_ScaLBL_D3Q19_Pack(int q, int *list, int start, int count, do
 
 }
 
+__global__ void dvc_ScaLBL_D3Q19_PackFace(int q1, int q2, int q3, int q4, int q5, int *list, int count, double *sendbuf, double *dist, int N){
+	//....................................................................................
+	// Pack the five distributions that cross a face in a single pass over the list
+	//....................................................................................
+	int idx,n;
+	idx = blockIdx.x*blockDim.x + threadIdx.x;
+	if (idx<count){
+		n = list[idx];
+		sendbuf[idx] = dist[q1*N+n];
+		sendbuf[count+idx] = dist[q2*N+n];
+		sendbuf[2*count+idx] = dist[q3*N+n];
+		sendbuf[3*count+idx] = dist[q4*N+n];
+		sendbuf[4*count+idx] = dist[q5*N+n];
+	}
+}
+
 __global__ void dvc_ScaLBL_D3Q19_Unpack(int q,  int *list,  int start, int count,
 		double *recvbuf, double *dist, int N){
 	//....................................................................................
@@ -178,6 +196,85 @@ __global__ void dvc_ScaLBL_D3Q19_Unpack(int q,  int *list,  int start, int count
 	}
 }
 
+__global__ void dvc_ScaLBL_D3Q19_UnpackFace(int q1, int q2, int q3, int q4, int q5, int *list, int count, double *recvbuf, double *dist, int N){
+	//....................................................................................
+	// Unpack the five distributions that cross a face in a single pass over the list
+	//....................................................................................
+	int idx,n;
+	idx = blockIdx.x*blockDim.x + threadIdx.x;
+	if (idx<count){
+		n = list[idx];
+		if (!(n<0)) dist[q1*N+n] = recvbuf[idx];
+		n = list[count+idx];
+		if (!(n<0)) dist[q2*N+n] = recvbuf[count+idx];
+		n = list[2*count+idx];
+		if (!(n<0)) dist[q3*N+n] = recvbuf[2*count+idx];
+		n = list[3*count+idx];
+		if (!(n<0)) dist[q4*N+n] = recvbuf[3*count+idx];
+		n = list[4*count+idx];
+		if (!(n<0)) dist[q5*N+n] = recvbuf[4*count+idx];
+	}
+}
+
+__global__ void dvc_ScaLBL_D3Q19_Pack_Single(int q, int *list, int start, int count, float *sendbuf, float *dist, int N){
+	int idx,n;
+	idx = blockIdx.x*blockDim.x + threadIdx.x;
+	if (idx<count){
+		n = list[idx];
+		sendbuf[start+idx] = dist[q*N+n];
+	}
+}
+
+__global__ void dvc_ScaLBL_D3Q19_PackFace_Single(int q1, int q2, int q3, int q4, int q5, int *list, int count, float *sendbuf, float *dist, int N){
+	int idx,n;
+	idx = blockIdx.x*blockDim.x + threadIdx.x;
+	if (idx<count){
+		n = list[idx];
+		sendbuf[idx] = dist[q1*N+n];
+		sendbuf[count+idx] = dist[q2*N+n];
+		sendbuf[2*count+idx] = dist[q3*N+n];
+		sendbuf[3*count+idx] = dist[q4*N+n];
+		sendbuf[4*count+idx] = dist[q5*N+n];
+	}
+}
+
+__global__ void dvc_ScaLBL_D3Q19_Unpack_Single(int q,  int *list,  int start, int count, float *recvbuf, float *dist, int N){
+	int n,idx;
+	idx = blockIdx.x*blockDim.x + threadIdx.x;
+	if (idx<count){
+		n = list[start+idx];
+		if (!(n<0)) dist[q*N+n] = recvbuf[start+idx];
+	}
+}
+
+__global__ void dvc_ScaLBL_D3Q19_UnpackFace_Single(int q1, int q2, int q3, int q4, int q5, int *list, int count, float *recvbuf, float *dist, int N){
+	int idx,n;
+	idx = blockIdx.x*blockDim.x + threadIdx.x;
+	if (idx<count){
+		n = list[idx];
+		if (!(n<0)) dist[q1*N+n] = recvbuf[idx];
+		n = list[count+idx];
+		if (!(n<0)) dist[q2*N+n] = recvbuf[count+idx];
+		n = list[2*count+idx];
+		if (!(n<0)) dist[q3*N+n] = recvbuf[2*count+idx];
+		n = list[3*count+idx];
+		if (!(n<0)) dist[q4*N+n] = recvbuf[3*count+idx];
+		n = list[4*count+idx];
+		if (!(n<0)) dist[q5*N+n] = recvbuf[4*count+idx];
+	}
+}
+
+__global__ void dvc_ScaLBL_D3Q19_Init_Single(float *dist, int Np)
+{
+	// rest state (stored as the deviation from the weights)
+	int n;
+	int S = 19*Np/NBLOCKS/NTHREADS + 1;
+	for (int s=0; s<S; s++){
+		n = S*blockIdx.x*blockDim.x + s*blockDim.x + threadIdx.x;
+		if (n<19*Np) dist[n] = 0.f;
+	}
+}
+
 __global__ void dvc_ScaLBL_D3Q19_Init(char *ID, double *f_even, double *f_odd, int Nx, int Ny, int Nz)
 {
 	int n,N;
@@ -445,8 +542,31 @@ dvc_ScaLBL_AAodd_Compact(char * ID, int *d_neighborList, double *dist, int Np) {
 }
 
 
+// Neighbor fetch for the odd step: entry q of the neighbor list for site n
+struct dvc_ScaLBL_D3Q19_NeighborList {
+	int *list;
+	int Np;
+	__device__ inline int operator()(int n, int q) const { return list[q*Np+n]; }
+};
+
+// Neighbor fetch from the compressed neighbor list (see ScaLBL_Communicator::CompressNeighborList)
+// the low bit of the offset selects one of the two bases for the block and direction
+struct dvc_ScaLBL_D3Q19_NeighborOffset {
+	int *list;
+	short *offset;
+	int *base;
+	int Np;
+	__device__ inline int operator()(int n, int q) const {
+		int d = offset[q*Np+n];
+		int b = base[((n >> ScaLBL_NEIGHBOR_BLOCK_SHIFT)*18+q)*2 + (d & 1)];
+		if (base[(n >> ScaLBL_NEIGHBOR_BLOCK_SHIFT)*36] == ScaLBL_NEIGHBOR_FULL) return list[q*Np+n];
+		return (d == ScaLBL_NEIGHBOR_BOUNCEBACK) ? n + ((q^1)+1)*Np : n + b + (d >> 1) + (q+1)*Np;
+	}
+};
+
+template<class TYPE, class NEIGHBOR>
 __global__ void 
-dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx, double Fy, double Fz) {
+dvc_ScaLBL_AAodd_MRT(NEIGHBOR neighbor, TYPE *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx, double Fy, double Fz) {
 
 	int n;
 	double fq;
@@ -469,7 +589,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m2  = 12.0*fq;
 
 			// q=1
-			nread = neighborList[n]; // neighbor 2 ( > 10Np => odd part of dist)
+			nread = neighbor(n,0); // neighbor 2 ( > 10Np => odd part of dist)
 			fq = dist[nread]; // reading the f1 data into register fq
 			//fp = dist[10*Np+n];
 			rho += fq;
@@ -481,7 +601,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m10 = -4.0*fq;
 
 			// f2 = dist[10*Np+n];
-			nread = neighborList[n+Np]; // neighbor 1 ( < 10Np => even part of dist)
+			nread = neighbor(n,1); // neighbor 1 ( < 10Np => even part of dist)
 			fq = dist[nread];  // reading the f2 data into register fq
 			//fq = dist[Np+n];
 			rho += fq;
@@ -493,7 +613,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m10 -= 4.0*(fq);
 
 			// q=3
-			nread = neighborList[n+2*Np]; // neighbor 4
+			nread = neighbor(n,2); // neighbor 4
 			fq = dist[nread];
 			//fq = dist[11*Np+n];
 			rho += fq;
@@ -507,7 +627,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m12 = -2.0*fq;
 
 			// q = 4
-			nread = neighborList[n+3*Np]; // neighbor 3
+			nread = neighbor(n,3); // neighbor 3
 			fq = dist[nread];
 			//fq = dist[2*Np+n];
 			rho+= fq;
@@ -521,7 +641,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m12 -= 2.0*fq;
 
 			// q=5
-			nread = neighborList[n+4*Np];
+			nread = neighbor(n,4);
 			fq = dist[nread];
 			//fq = dist[12*Np+n];
 			rho += fq;
@@ -536,7 +656,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 
 
 			// q = 6
-			nread = neighborList[n+5*Np];
+			nread = neighbor(n,5);
 			fq = dist[nread];
 			//fq = dist[3*Np+n];
 			rho+= fq;
@@ -550,7 +670,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m12 += 2.0*fq;
 
 			// q=7
-			nread = neighborList[n+6*Np];
+			nread = neighbor(n,6);
 			fq = dist[nread];
 			//fq = dist[13*Np+n];
 			rho += fq;
@@ -569,7 +689,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m17 = -fq;
 
 			// q = 8
-			nread = neighborList[n+7*Np];
+			nread = neighbor(n,7);
 			fq = dist[nread];
 			//fq = dist[4*Np+n];
 			rho += fq;
@@ -588,7 +708,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m17 += fq;
 
 			// q=9
-			nread = neighborList[n+8*Np];
+			nread = neighbor(n,8);
 			fq = dist[nread];
 			//fq = dist[14*Np+n];
 			rho += fq;
@@ -607,7 +727,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m17 += fq;
 
 			// q = 10
-			nread = neighborList[n+9*Np];
+			nread = neighbor(n,9);
 			fq = dist[nread];
 			//fq = dist[5*Np+n];
 			rho += fq;
@@ -626,7 +746,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m17 -= fq;
 
 			// q=11
-			nread = neighborList[n+10*Np];
+			nread = neighbor(n,10);
 			fq = dist[nread];
 			//fq = dist[15*Np+n];
 			rho += fq;
@@ -645,7 +765,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m18 = fq;
 
 			// q=12
-			nread = neighborList[n+11*Np];
+			nread = neighbor(n,11);
 			fq = dist[nread];
 			//fq = dist[6*Np+n];
 			rho += fq;
@@ -664,7 +784,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m18 -= fq;
 
 			// q=13
-			nread = neighborList[n+12*Np];
+			nread = neighbor(n,12);
 			fq = dist[nread];
 			//fq = dist[16*Np+n];
 			rho += fq;
@@ -683,7 +803,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m18 -= fq;
 
 			// q=14
-			nread = neighborList[n+13*Np];
+			nread = neighbor(n,13);
 			fq = dist[nread];
 			//fq = dist[7*Np+n];
 			rho += fq;
@@ -702,7 +822,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m18 += fq;
 
 			// q=15
-			nread = neighborList[n+14*Np];
+			nread = neighbor(n,14);
 			fq = dist[nread];
 			//fq = dist[17*Np+n];
 			rho += fq;
@@ -719,7 +839,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m18 -= fq;
 
 			// q=16
-			nread = neighborList[n+15*Np];
+			nread = neighbor(n,15);
 			fq = dist[nread];
 			//fq = dist[8*Np+n];
 			rho += fq;
@@ -737,7 +857,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 
 			// q=17
 			//fq = dist[18*Np+n];
-			nread = neighborList[n+16*Np];
+			nread = neighbor(n,16);
 			fq = dist[nread];
 			rho += fq;
 			m1 += 8.0*fq;
@@ -753,7 +873,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m18 += fq;
 
 			// q=18
-			nread = neighborList[n+17*Np];
+			nread = neighbor(n,17);
 			fq = dist[nread];
 			//fq = dist[9*Np+n];
 			rho += fq;
@@ -769,6 +889,12 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m17 -= fq;
 			m18 -= fq;
 
+			if (std::is_same<TYPE,float>::value){
+				// restore the rest state removed from single precision storage (see ScaLBL.h)
+				rho += 1.0;
+				m1 -= 11.0;
+				m2 += 3.0;
+			}
 			//..............incorporate external force................................................
 			//..............carry out relaxation process...............................................
 			m1 = m1 + rlx_setA*((19*(jx*jx+jy*jy+jz*jz)/rho - 11*rho) - m1);
@@ -787,6 +913,11 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			m17 = m17 + rlx_setB*( - m17);
 			m18 = m18 + rlx_setB*( - m18);
 			//.......................................................................................................
+			if (std::is_same<TYPE,float>::value){
+				rho -= 1.0;
+				m1 += 11.0;
+				m2 -= 3.0;
+			}
 			//.................inverse transformation......................................................
 
 			// q=0
@@ -795,57 +926,57 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 
 			// q = 1
 			fq = mrt_V1*rho-mrt_V4*m1-mrt_V5*m2+0.1*(jx-m4)+mrt_V6*(m9-m10)+0.16666666*Fx;
-			nread = neighborList[n+Np];
+			nread = neighbor(n,1);
 			dist[nread] = fq;
 
 			// q=2
 			fq = mrt_V1*rho-mrt_V4*m1-mrt_V5*m2+0.1*(m4-jx)+mrt_V6*(m9-m10) -  0.16666666*Fx;
-			nread = neighborList[n];
+			nread = neighbor(n,0);
 			dist[nread] = fq;
 
 			// q = 3
 			fq = mrt_V1*rho-mrt_V4*m1-mrt_V5*m2+0.1*(jy-m6)+mrt_V7*(m10-m9)+mrt_V8*(m11-m12) + 0.16666666*Fy;
-			nread = neighborList[n+3*Np];
+			nread = neighbor(n,3);
 			dist[nread] = fq;
 
 			// q = 4
 			fq = mrt_V1*rho-mrt_V4*m1-mrt_V5*m2+0.1*(m6-jy)+mrt_V7*(m10-m9)+mrt_V8*(m11-m12) - 0.16666666*Fy;
-			nread = neighborList[n+2*Np];
+			nread = neighbor(n,2);
 			dist[nread] = fq;
 
 			// q = 5
 			fq = mrt_V1*rho-mrt_V4*m1-mrt_V5*m2+0.1*(jz-m8)+mrt_V7*(m10-m9)+mrt_V8*(m12-m11) + 0.16666666*Fz;
-			nread = neighborList[n+5*Np];
+			nread = neighbor(n,5);
 			dist[nread] = fq;
 
 			// q = 6
 			fq = mrt_V1*rho-mrt_V4*m1-mrt_V5*m2+0.1*(m8-jz)+mrt_V7*(m10-m9)+mrt_V8*(m12-m11) - 0.16666666*Fz;
-			nread = neighborList[n+4*Np];
+			nread = neighbor(n,4);
 			dist[nread] = fq;
 
 			// q = 7
 			fq = mrt_V1*rho+mrt_V9*m1+mrt_V10*m2+0.1*(jx+jy)+0.025*(m4+m6)+mrt_V7*m9+mrt_V11*m10+
 					mrt_V8*m11+mrt_V12*m12+0.25*m13+0.125*(m16-m17) + 0.08333333333*(Fx+Fy);
 			
-			nread = neighborList[n+7*Np];
+			nread = neighbor(n,7);
 			dist[nread] = fq;
 
 			// q = 8
 			fq = mrt_V1*rho+mrt_V9*m1+mrt_V10*m2-0.1*(jx+jy)-0.025*(m4+m6) +mrt_V7*m9+mrt_V11*m10+mrt_V8*m11
 					+mrt_V12*m12+0.25*m13+0.125*(m17-m16) - 0.08333333333*(Fx+Fy);
-			nread = neighborList[n+6*Np];
+			nread = neighbor(n,6);
 			dist[nread] = fq;
 
 			// q = 9
 			fq = mrt_V1*rho+mrt_V9*m1+mrt_V10*m2+0.1*(jx-jy)+0.025*(m4-m6)+mrt_V7*m9+mrt_V11*m10+
 					mrt_V8*m11+mrt_V12*m12-0.25*m13+0.125*(m16+m17) + 0.08333333333*(Fx-Fy);
-			nread = neighborList[n+9*Np];
+			nread = neighbor(n,9);
 			dist[nread] = fq;
 
 			// q = 10
 			fq = mrt_V1*rho+mrt_V9*m1+mrt_V10*m2+0.1*(jy-jx)+0.025*(m6-m4)+mrt_V7*m9+mrt_V11*m10+
 					mrt_V8*m11+mrt_V12*m12-0.25*m13-0.125*(m16+m17)- 0.08333333333*(Fx-Fy);
-			nread = neighborList[n+8*Np];
+			nread = neighbor(n,8);
 			dist[nread] = fq;
 
 			// q = 11
@@ -853,13 +984,13 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 					+mrt_V10*m2+0.1*(jx+jz)+0.025*(m4+m8)
 					+mrt_V7*m9+mrt_V11*m10-mrt_V8*m11
 					-mrt_V12*m12+0.25*m15+0.125*(m18-m16) + 0.08333333333*(Fx+Fz);
-			nread = neighborList[n+11*Np];
+			nread = neighbor(n,11);
 			dist[nread] = fq;
 
 			// q = 12
 			fq = mrt_V1*rho+mrt_V9*m1+mrt_V10*m2-0.1*(jx+jz)-0.025*(m4+m8)+
 					mrt_V7*m9+mrt_V11*m10-mrt_V8*m11-mrt_V12*m12+0.25*m15+0.125*(m16-m18) - 0.08333333333*(Fx+Fz);
-			nread = neighborList[n+10*Np];
+			nread = neighbor(n,10);
 			dist[nread]= fq;
 
 			// q = 13
@@ -867,7 +998,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 					+mrt_V10*m2+0.1*(jx-jz)+0.025*(m4-m8)
 					+mrt_V7*m9+mrt_V11*m10-mrt_V8*m11
 					-mrt_V12*m12-0.25*m15-0.125*(m16+m18) + 0.08333333333*(Fx-Fz);
-			nread = neighborList[n+13*Np];
+			nread = neighbor(n,13);
 			dist[nread] = fq;
 
 			// q= 14
@@ -875,7 +1006,7 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 					+mrt_V10*m2+0.1*(jz-jx)+0.025*(m8-m4)
 					+mrt_V7*m9+mrt_V11*m10-mrt_V8*m11
 					-mrt_V12*m12-0.25*m15+0.125*(m16+m18) - 0.08333333333*(Fx-Fz);
-			nread = neighborList[n+12*Np];
+			nread = neighbor(n,12);
 			dist[nread] = fq;
 
 
@@ -883,14 +1014,14 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			fq = mrt_V1*rho+mrt_V9*m1
 					+mrt_V10*m2+0.1*(jy+jz)+0.025*(m6+m8)
 					-mrt_V6*m9-mrt_V7*m10+0.25*m14+0.125*(m17-m18) + 0.08333333333*(Fy+Fz);
-			nread = neighborList[n+15*Np];
+			nread = neighbor(n,15);
 			dist[nread] = fq;
 
 			// q = 16
 			fq =  mrt_V1*rho+mrt_V9*m1
 					+mrt_V10*m2-0.1*(jy+jz)-0.025*(m6+m8)
 					-mrt_V6*m9-mrt_V7*m10+0.25*m14+0.125*(m18-m17)- 0.08333333333*(Fy+Fz);
-			nread = neighborList[n+14*Np];
+			nread = neighbor(n,14);
 			dist[nread] = fq;
 
 
@@ -898,24 +1029,24 @@ dvc_ScaLBL_AAodd_MRT(int *neighborList, double *dist, int start, int finish, int
 			fq = mrt_V1*rho+mrt_V9*m1
 					+mrt_V10*m2+0.1*(jy-jz)+0.025*(m6-m8)
 					-mrt_V6*m9-mrt_V7*m10-0.25*m14+0.125*(m17+m18) + 0.08333333333*(Fy-Fz);
-			nread = neighborList[n+17*Np];
+			nread = neighbor(n,17);
 			dist[nread] = fq;
 
 			// q = 18
 			fq = mrt_V1*rho+mrt_V9*m1
 					+mrt_V10*m2+0.1*(jz-jy)+0.025*(m8-m6)
 					-mrt_V6*m9-mrt_V7*m10-0.25*m14-0.125*(m17+m18) - 0.08333333333*(Fy-Fz);
-			nread = neighborList[n+16*Np];
+			nread = neighbor(n,16);
 			dist[nread] = fq;
 
 		}
 	}
 }
 
-
 //__launch_bounds__(512,1)
+template<class TYPE>
 __global__ void 
-dvc_ScaLBL_AAeven_MRT(double *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx, double Fy, double Fz) {
+dvc_ScaLBL_AAeven_MRT(TYPE *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx, double Fy, double Fz) {
 
 	int n;
 	double fq;
@@ -1205,6 +1336,12 @@ dvc_ScaLBL_AAeven_MRT(double *dist, int start, int finish, int Np, double rlx_se
 			//		(read from opposite array due to previous swap operation)
 			//........................................................................
 
+			if (std::is_same<TYPE,float>::value){
+				// restore the rest state removed from single precision storage (see ScaLBL.h)
+				rho += 1.0;
+				m1 -= 11.0;
+				m2 += 3.0;
+			}
 			//..............incorporate external force................................................
 			//..............carry out relaxation process...............................................
 			m1 = m1 + rlx_setA*((19*(jx*jx+jy*jy+jz*jz)/rho - 11*rho) - m1);
@@ -1223,6 +1360,11 @@ dvc_ScaLBL_AAeven_MRT(double *dist, int start, int finish, int Np, double rlx_se
 			m17 = m17 + rlx_setB*( - m17);
 			m18 = m18 + rlx_setB*( - m18);
 			//.......................................................................................................
+			if (std::is_same<TYPE,float>::value){
+				rho -= 1.0;
+				m1 += 11.0;
+				m2 -= 3.0;
+			}
 			//.................inverse transformation......................................................
 
 			// q=0
@@ -1546,7 +1688,8 @@ __global__  void dvc_ScaLBL_D3Q19_Swap(char *ID, double *disteven, double *disto
 }
 
 
-__global__  void dvc_ScaLBL_D3Q19_Momentum(double *dist, double *vel, int N)
+template<class TYPE>
+__global__  void dvc_ScaLBL_D3Q19_Momentum(const TYPE *dist, double *vel, int N)
 {
 	int n;
 	// distributions
@@ -1593,7 +1736,8 @@ __global__  void dvc_ScaLBL_D3Q19_Momentum(double *dist, double *vel, int N)
 	}
 }
 
-__global__  void dvc_ScaLBL_D3Q19_Pressure(const double *dist, double *Pressure, int N)
+template<class TYPE>
+__global__  void dvc_ScaLBL_D3Q19_Pressure(const TYPE *dist, double *Pressure, int N)
 {
 	int n;
 	// distributions
@@ -1631,8 +1775,10 @@ __global__  void dvc_ScaLBL_D3Q19_Pressure(const double *dist, double *Pressure,
 			f15 = dist[15*N+n];
 			f17 = dist[17*N+n];
 			//.................Compute the velocity...................................
-			Pressure[n] = 0.3333333333333333*(f0+f2+f1+f4+f3+f6+f5+f8+f7+f10+
-					f9+f12+f11+f14+f13+f16+f15+f18+f17);
+			double rho = f0+f2+f1+f4+f3+f6+f5+f8+f7+f10+
+					f9+f12+f11+f14+f13+f16+f15+f18+f17;
+			if (std::is_same<TYPE,float>::value) rho += 1.0;
+			Pressure[n] = 0.3333333333333333*rho;
 		}
 	}
 }
@@ -2358,10 +2504,40 @@ extern "C" void ScaLBL_D3Q19_Pack(int q, int *list, int start, int count, double
 	dvc_ScaLBL_D3Q19_Pack <<<GRID,512 >>>(q, list, start, count, sendbuf, dist, N);
 }
 
+extern "C" void ScaLBL_D3Q19_PackFace(int q1, int q2, int q3, int q4, int q5, int *list, int count, double *sendbuf, double *dist, int N){
+	int GRID = count / 512 + 1;
+	dvc_ScaLBL_D3Q19_PackFace <<<GRID,512 >>>(q1, q2, q3, q4, q5, list, count, sendbuf, dist, N);
+}
+
 extern "C" void ScaLBL_D3Q19_Unpack(int q, int *list,  int start, int count, double *recvbuf, double *dist, int N){
 	int GRID = count / 512 + 1;
 	dvc_ScaLBL_D3Q19_Unpack <<<GRID,512 >>>(q, list, start, count, recvbuf, dist, N);
 }
+
+extern "C" void ScaLBL_D3Q19_UnpackFace(int q1, int q2, int q3, int q4, int q5, int *list, int count, double *recvbuf, double *dist, int N){
+	int GRID = count / 512 + 1;
+	dvc_ScaLBL_D3Q19_UnpackFace <<<GRID,512 >>>(q1, q2, q3, q4, q5, list, count, recvbuf, dist, N);
+}
+
+extern "C" void ScaLBL_D3Q19_Pack_Single(int q, int *list, int start, int count, float *sendbuf, float *dist, int N){
+	int GRID = count / 512 + 1;
+	dvc_ScaLBL_D3Q19_Pack_Single <<<GRID,512 >>>(q, list, start, count, sendbuf, dist, N);
+}
+
+extern "C" void ScaLBL_D3Q19_PackFace_Single(int q1, int q2, int q3, int q4, int q5, int *list, int count, float *sendbuf, float *dist, int N){
+	int GRID = count / 512 + 1;
+	dvc_ScaLBL_D3Q19_PackFace_Single <<<GRID,512 >>>(q1, q2, q3, q4, q5, list, count, sendbuf, dist, N);
+}
+
+extern "C" void ScaLBL_D3Q19_Unpack_Single(int q, int *list,  int start, int count, float *recvbuf, float *dist, int N){
+	int GRID = count / 512 + 1;
+	dvc_ScaLBL_D3Q19_Unpack_Single <<<GRID,512 >>>(q, list, start, count, recvbuf, dist, N);
+}
+
+extern "C" void ScaLBL_D3Q19_UnpackFace_Single(int q1, int q2, int q3, int q4, int q5, int *list, int count, float *recvbuf, float *dist, int N){
+	int GRID = count / 512 + 1;
+	dvc_ScaLBL_D3Q19_UnpackFace_Single <<<GRID,512 >>>(q1, q2, q3, q4, q5, list, count, recvbuf, dist, N);
+}
 //*************************************************************************
 
 extern "C" void ScaLBL_D3Q19_AA_Init(double *f_even, double *f_odd, int Np){
@@ -2381,6 +2557,14 @@ extern "C" void ScaLBL_D3Q19_Init(double *dist, int Np){
 }
 
 
+extern "C" void ScaLBL_D3Q19_Init_Single(float *dist, int Np){
+	dvc_ScaLBL_D3Q19_Init_Single<<<NBLOCKS,NTHREADS >>>(dist, Np);
+	cudaError_t err = cudaGetLastError();
+	if (cudaSuccess != err){
+		printf("CUDA error in ScaLBL_D3Q19_Init_Single: %s \n",cudaGetErrorString(err));
+	}
+}
+
 extern "C" void ScaLBL_D3Q19_Swap(char *ID, double *disteven, double *distodd, int Nx, int Ny, int Nz){
 	dvc_ScaLBL_D3Q19_Swap<<<NBLOCKS,NTHREADS >>>(ID, disteven, distodd, Nx, Ny, Nz);
 	cudaError_t err = cudaGetLastError();
@@ -2438,6 +2622,18 @@ extern "C" void ScaLBL_D3Q19_Pressure(double *fq, double *Pressure, int Np){
 	dvc_ScaLBL_D3Q19_Pressure<<< NBLOCKS,NTHREADS >>>(fq, Pressure, Np);
 }
 
+extern "C" void ScaLBL_D3Q19_Momentum_Single(float *dist, double *vel, int Np){
+	dvc_ScaLBL_D3Q19_Momentum<<<NBLOCKS,NTHREADS >>>(dist, vel, Np);
+	cudaError_t err = cudaGetLastError();
+	if (cudaSuccess != err){
+		printf("CUDA error in ScaLBL_D3Q19_Momentum_Single: %s \n",cudaGetErrorString(err));
+	}
+}
+
+extern "C" void ScaLBL_D3Q19_Pressure_Single(float *fq, double *Pressure, int Np){
+	dvc_ScaLBL_D3Q19_Pressure<<< NBLOCKS,NTHREADS >>>(fq, Pressure, Np);
+}
+
 extern "C" void ScaLBL_D3Q19_Velocity_BC_z(double *disteven, double *distodd, double uz,int Nx, int Ny, int Nz){
 	int GRID = Nx*Ny / 512 + 1;
 	dvc_D3Q19_Velocity_BC_z<<<GRID,512>>>(disteven,distodd, uz, Nx, Ny, Nz);
@@ -2699,7 +2895,7 @@ extern "C" void ScaLBL_D3Q19_AAeven_MRT(double *dist, int start, int finish, int
 extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborlist, double *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
        double Fy, double Fz){
        
-       dvc_ScaLBL_AAodd_MRT<<<NBLOCKS,NTHREADS >>>(neighborlist,dist,start,finish,Np,rlx_setA,rlx_setB,Fx,Fy,Fz);
+       dvc_ScaLBL_AAodd_MRT<<<NBLOCKS,NTHREADS >>>(dvc_ScaLBL_D3Q19_NeighborList{neighborlist,Np},dist,start,finish,Np,rlx_setA,rlx_setB,Fx,Fy,Fz);
 
        cudaError_t err = cudaGetLastError();
 	if (cudaSuccess != err){
@@ -2707,3 +2903,31 @@ extern "C" void ScaLBL_D3Q19_AAodd_MRT(int *neighborlist, double *dist, int star
 	}
 }
 
+extern "C" void ScaLBL_D3Q19_AAeven_MRT_Single(float *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
+       double Fy, double Fz){
+	dvc_ScaLBL_AAeven_MRT<<<NBLOCKS,NTHREADS >>>(dist,start,finish,Np,rlx_setA,rlx_setB,Fx,Fy,Fz);
+	cudaError_t err = cudaGetLastError();
+	if (cudaSuccess != err){
+		printf("CUDA error in ScaLBL_D3Q19_AAeven_MRT_Single: %s \n",cudaGetErrorString(err));
+	}
+}
+
+extern "C" void ScaLBL_D3Q19_AAodd_MRT_Single(int *neighborlist, float *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx,
+       double Fy, double Fz){
+	dvc_ScaLBL_AAodd_MRT<<<NBLOCKS,NTHREADS >>>(dvc_ScaLBL_D3Q19_NeighborList{neighborlist,Np},dist,start,finish,Np,rlx_setA,rlx_setB,Fx,Fy,Fz);
+	cudaError_t err = cudaGetLastError();
+	if (cudaSuccess != err){
+		printf("CUDA error in ScaLBL_D3Q19_AAodd_MRT_Single: %s \n",cudaGetErrorString(err));
+	}
+}
+
+extern "C" void ScaLBL_D3Q19_AAodd_MRT_Compressed(int *neighborList, short *neighborOffset, int *neighborBase, double *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx, double Fy, double Fz){
+
+	dvc_ScaLBL_AAodd_MRT<<<NBLOCKS,NTHREADS >>>(dvc_ScaLBL_D3Q19_NeighborOffset{neighborList,neighborOffset,neighborBase,Np},dist,start,finish,Np,rlx_setA,rlx_setB,Fx,Fy,Fz);
+
+	cudaError_t err = cudaGetLastError();
+	if (cudaSuccess != err){
+		printf("CUDA error in ScaLBL_D3Q19_AAodd_MRT_Compressed: %s \n",cudaGetErrorString(err));
+	}
+}
+
@@ -96,6 +96,52 @@ __global__ void dvc_ScaLBL_D3Q7_Unpack(int q,  int *list,  int start, int count,
 	}
 }
 
+__global__ void dvc_ScaLBL_D3Q7_BiPack(int q, int *list, int count, double *sendbuf, double *Aq, double *Bq, int N){
+	int idx,n;
+	idx = blockIdx.x*blockDim.x + threadIdx.x;
+	if (idx<count){
+		n = list[idx];
+		sendbuf[idx] = Aq[q*N+n];
+		sendbuf[count+idx] = Bq[q*N+n];
+	}
+}
+
+__global__ void dvc_ScaLBL_D3Q7_TriPack(int q, int *list, int count, double *sendbuf, double *Aq, double *Bq, double *Cq, int N){
+	int idx,n;
+	idx = blockIdx.x*blockDim.x + threadIdx.x;
+	if (idx<count){
+		n = list[idx];
+		sendbuf[idx] = Aq[q*N+n];
+		sendbuf[count+idx] = Bq[q*N+n];
+		sendbuf[2*count+idx] = Cq[q*N+n];
+	}
+}
+
+__global__ void dvc_ScaLBL_D3Q7_BiUnpack(int q, int *list, int count, double *recvbuf, double *Aq, double *Bq, int N){
+	int n,idx;
+	idx = blockIdx.x*blockDim.x + threadIdx.x;
+	if (idx<count){
+		n = list[idx];
+		if (!(n<0)){
+			Aq[q*N+n] = recvbuf[idx];
+			Bq[q*N+n] = recvbuf[count+idx];
+		}
+	}
+}
+
+__global__ void dvc_ScaLBL_D3Q7_TriUnpack(int q, int *list, int count, double *recvbuf, double *Aq, double *Bq, double *Cq, int N){
+	int n,idx;
+	idx = blockIdx.x*blockDim.x + threadIdx.x;
+	if (idx<count){
+		n = list[idx];
+		if (!(n<0)){
+			Aq[q*N+n] = recvbuf[idx];
+			Bq[q*N+n] = recvbuf[count+idx];
+			Cq[q*N+n] = recvbuf[2*count+idx];
+		}
+	}
+}
+
 __global__  void dvc_ScaLBL_D3Q7_Reflection_BC_z(int *list, double *dist, int count, int Np){
 	int idx, n;
 	idx = blockIdx.x*blockDim.x + threadIdx.x;
@@ -266,6 +312,26 @@ extern "C" void ScaLBL_D3Q7_Unpack(int q, int *list,  int start, int count, doub
 	dvc_ScaLBL_D3Q7_Unpack <<<GRID,512 >>>(q, list, start, count, recvbuf, dist, N);
 }
 
+extern "C" void ScaLBL_D3Q7_BiPack(int q, int *list, int count, double *sendbuf, double *Aq, double *Bq, int N){
+	int GRID = count / 512 + 1;
+	dvc_ScaLBL_D3Q7_BiPack <<<GRID,512 >>>(q, list, count, sendbuf, Aq, Bq, N);
+}
+
+extern "C" void ScaLBL_D3Q7_TriPack(int q, int *list, int count, double *sendbuf, double *Aq, double *Bq, double *Cq, int N){
+	int GRID = count / 512 + 1;
+	dvc_ScaLBL_D3Q7_TriPack <<<GRID,512 >>>(q, list, count, sendbuf, Aq, Bq, Cq, N);
+}
+
+extern "C" void ScaLBL_D3Q7_BiUnpack(int q, int *list, int count, double *recvbuf, double *Aq, double *Bq, int N){
+	int GRID = count / 512 + 1;
+	dvc_ScaLBL_D3Q7_BiUnpack <<<GRID,512 >>>(q, list, count, recvbuf, Aq, Bq, N);
+}
+
+extern "C" void ScaLBL_D3Q7_TriUnpack(int q, int *list, int count, double *recvbuf, double *Aq, double *Bq, double *Cq, int N){
+	int GRID = count / 512 + 1;
+	dvc_ScaLBL_D3Q7_TriUnpack <<<GRID,512 >>>(q, list, count, recvbuf, Aq, Bq, Cq, N);
+}
+
 extern "C" void ScaLBL_Scalar_Pack(int *list, int count, double *sendbuf, double *Data, int N){
 	int GRID = count / 512 + 1;
 	dvc_ScaLBL_Scalar_Pack <<<GRID,512 >>>(list, count, sendbuf, Data, N);
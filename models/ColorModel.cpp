@@ -18,9 +18,11 @@
 color lattice boltzmann model
  */
 #include "models/ColorModel.h"
+#include "common/Profiler.h"
 #include "analysis/distance.h"
 #include "analysis/morphology.h"
 #include "common/Communication.h"
+#include "common/Restart.h"
 #include "common/ReadMicroCT.h"
 #include <stdlib.h>
 #include <time.h>
@@ -438,23 +440,19 @@ void ScaLBL_ColorModel::Initialize(){
 		ScaLBL_CopyToHost(TmpMap, dvcMap, Np*sizeof(int));
         ScaLBL_CopyToHost(cPhi, Phi, N*sizeof(double));
     	
-		ifstream File(LocalRestartFile,ios::binary);
-		int idx;
-		double value,va,vb;
-		for (int n=0; n<Np; n++){
-			File.read((char*) &va, sizeof(va));
-			File.read((char*) &vb, sizeof(vb));
-			cDen[n]    = va;
-			cDen[Np+n] = vb;
+		int restart_step;
+		if (analysis_db->getWithDefault<bool>( "restart_shared", false )){
+			// single file in global order (may come from a different decomposition)
+			auto restart_file = analysis_db->getWithDefault<std::string>( "restart_file", "Restart" ) + ".shared";
+			restart_step = ReadSharedRestartFile(restart_file, Dm->rank_info, Map, Np, { { cDen, 2 }, { cDist, 19 } }, comm);
 		}
-		for (int n=0; n<Np; n++){
-			// Read the distributions
-			for (int q=0; q<19; q++){
-				File.read((char*) &value, sizeof(value));
-				cDist[q*Np+n] = value;
-			}
+		else {
+			// block restart file (legacy interleaved files are also accepted)
+			restart_step = ReadRestartFile(LocalRestartFile, Np, ScaLBL_Comm->Layout, { { cDen, 2 }, { cDist, 19 } });
 		}
-		File.close();
+		if (rank==0 && restart_step >= 0) printf("   restart file written at timestep %i \n",restart_step);
+		int idx;
+		double value,va,vb;
 		
 		for (int n=0; n<ScaLBL_Comm->LastExterior(); n++){
 			va = cDen[n];
@@ -503,7 +501,6 @@ void ScaLBL_ColorModel::Initialize(){
 }
 
 void ScaLBL_ColorModel::Run(){
-	int nprocs=nprocx*nprocy*nprocz;
 	const RankInfoStruct rank_info(rank,nprocx,nprocy,nprocz);
 	
 	int IMAGE_INDEX = 0;
@@ -720,8 +717,7 @@ void ScaLBL_ColorModel::Run(){
 		}
 		ScaLBL_D3Q19_AAodd_Color(NeighborList, dvcMap, fq, Aq, Bq, Den, Phi, Velocity, rhoA, rhoB, tauA, tauB,
 				alpha, beta, Fx, Fy, Fz, Nx, Nx*Ny, 0, ScaLBL_Comm->LastExterior(), Np);
-		ScaLBL_DeviceBarrier(); 
-		MPI_Barrier(ScaLBL_Comm->MPI_COMM_SCALBL);
+		ScaLBL_DeviceBarrier();
 
 		// *************EVEN TIMESTEP*************
 		timestep++;
@@ -760,8 +756,7 @@ void ScaLBL_ColorModel::Run(){
 		}
 		ScaLBL_D3Q19_AAeven_Color(dvcMap, fq, Aq, Bq, Den, Phi, Velocity, rhoA, rhoB, tauA, tauB,
 				alpha, beta, Fx, Fy, Fz, Nx, Nx*Ny, 0, ScaLBL_Comm->LastExterior(), Np);
-		ScaLBL_DeviceBarrier(); 
-		MPI_Barrier(ScaLBL_Comm->MPI_COMM_SCALBL);
+		ScaLBL_DeviceBarrier();
 		//************************************************************************
 		PROFILE_STOP("Update");
 
@@ -1005,7 +1000,6 @@ void ScaLBL_ColorModel::Run(){
 			}
 			morph_timesteps += analysis_interval;
 		}
-		MPI_Barrier(ScaLBL_Comm->MPI_COMM_SCALBL);
 	}
 	analysis.finish();
 	PROFILE_STOP("Loop");
@@ -1022,10 +1016,9 @@ void ScaLBL_ColorModel::Run(){
 
 	if (rank==0) printf("********************************************************\n");
 	if (rank==0) printf("CPU time = %f \n", cputime);
-	if (rank==0) printf("Lattice update rate (per core)= %f MLUPS \n", MLUPS);
-	MLUPS *= nprocs;
-	if (rank==0) printf("Lattice update rate (total)= %f MLUPS \n", MLUPS);
+	Utilities::Profiler::reportRate(comm,MLUPS);
 	if (rank==0) printf("********************************************************\n");
+	PROFILE_REPORT(comm);
 
 	// ************************************************************************
 }
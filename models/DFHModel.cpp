@@ -2,6 +2,8 @@
 color lattice boltzmann model
  */
 #include "models/DFHModel.h"
+#include "common/Profiler.h"
+#include "common/Restart.h"
 
 ScaLBL_DFHModel::ScaLBL_DFHModel(int RANK, int NP, MPI_Comm COMM):
 rank(RANK), nprocs(NP), Restart(0),timestep(0),timestepMax(0),tauA(0),tauB(0),rhoA(0),rhoB(0),alpha(0),beta(0),
@@ -449,19 +451,21 @@ void ScaLBL_DFHModel::Initialize(){
 		MPI_Bcast(&timestep,1,MPI_INT,0,comm);
 		// Read in the restart file to CPU buffers
 		double *cPhi = new double[Np];
+		double *cDen = new double[2*Np];
 		double *cDist = new double[19*Np];
-		ifstream File(LocalRestartFile,ios::binary);
-		double value;
+		// densities and distributions as written by runAnalysis
+		if (analysis_db->getWithDefault<bool>( "restart_shared", false )){
+			auto restart_file = analysis_db->getWithDefault<std::string>( "restart_file", "Restart" ) + ".shared";
+			ReadSharedRestartFile(restart_file, Dm->rank_info, Map, Np, { { cDen, 2 }, { cDist, 19 } }, comm);
+		}
+		else
+			ReadRestartFile(LocalRestartFile, Np, ScaLBL_Comm->Layout, { { cDen, 2 }, { cDist, 19 } });
 		for (int n=0; n<Np; n++){
-			File.read((char*) &value, sizeof(value));
-			cPhi[n] = value;
-			// Read the distributions
-			for (int q=0; q<19; q++){
-				File.read((char*) &value, sizeof(value));
-				cDist[q*Np+n] = value;
-			}
+			double va = cDen[n];
+			double vb = cDen[Np+n];
+			cPhi[n] = (va-vb)/(va+vb);
 		}
-		File.close();
+		delete [] cDen;
 		// Copy the restart data to the GPU
 		ScaLBL_CopyToDevice(fq,cDist,19*Np*sizeof(double));
 		ScaLBL_CopyToDevice(Phi,cPhi,Np*sizeof(double));
@@ -478,7 +482,6 @@ void ScaLBL_DFHModel::Initialize(){
 }
 
 void ScaLBL_DFHModel::Run(){
-	int nprocs=nprocx*nprocy*nprocz;
 	const RankInfoStruct rank_info(rank,nprocx,nprocy,nprocz);
 
 	if (rank==0) printf("********************************************************\n");
@@ -532,7 +535,7 @@ void ScaLBL_DFHModel::Run(){
 		}
 		ScaLBL_D3Q19_AAodd_DFH(NeighborList, fq, Aq, Bq, Den, Phi, Gradient, SolidPotential, rhoA, rhoB, tauA, tauB,
 				alpha, beta, Fx, Fy, Fz, 0, ScaLBL_Comm->LastExterior(), Np);
-		ScaLBL_DeviceBarrier(); MPI_Barrier(comm);
+		ScaLBL_DeviceBarrier();
 
 		// *************EVEN TIMESTEP*************
 		timestep++;
@@ -568,9 +571,8 @@ void ScaLBL_DFHModel::Run(){
 		}
 		ScaLBL_D3Q19_AAeven_DFH(NeighborList, fq, Aq, Bq, Den, Phi, Gradient, SolidPotential, rhoA, rhoB, tauA, tauB,
 				alpha, beta, Fx, Fy, Fz,  0, ScaLBL_Comm->LastExterior(), Np);
-		ScaLBL_DeviceBarrier(); MPI_Barrier(comm);
+		ScaLBL_DeviceBarrier();
 		//************************************************************************
-		MPI_Barrier(comm);
 		PROFILE_STOP("Update");
 
 		// Run the analysis
@@ -590,10 +592,9 @@ void ScaLBL_DFHModel::Run(){
 	double MLUPS = double(Np)/cputime/1000000;
 	if (rank==0) printf("********************************************************\n");
 	if (rank==0) printf("CPU time = %f \n", cputime);
-	if (rank==0) printf("Lattice update rate (per core)= %f MLUPS \n", MLUPS);
-	MLUPS *= nprocs;
-	if (rank==0) printf("Lattice update rate (total)= %f MLUPS \n", MLUPS);
+	Utilities::Profiler::reportRate(comm,MLUPS);
 	if (rank==0) printf("********************************************************\n");
+	PROFILE_REPORT(comm);
 
 	// ************************************************************************
 }
@@ -2,9 +2,11 @@
 Two-fluid greyscale color lattice boltzmann model
  */
 #include "models/GreyscaleColorModel.h"
+#include "common/Profiler.h"
 #include "analysis/distance.h"
 #include "analysis/morphology.h"
 #include "common/Communication.h"
+#include "common/Restart.h"
 #include "common/ReadMicroCT.h"
 #include <stdlib.h>
 #include <time.h>
@@ -690,23 +692,11 @@ void ScaLBL_GreyscaleColorModel::Initialize(){
 		ScaLBL_CopyToHost(TmpMap, dvcMap, Np*sizeof(int));
         ScaLBL_CopyToHost(cPhi, Phi, N*sizeof(double));
     	
-		ifstream File(LocalRestartFile,ios::binary);
+		// block restart file (legacy interleaved files are also accepted)
+		int restart_step = ReadRestartFile(LocalRestartFile, Np, ScaLBL_Comm->Layout, { { cDen, 2 }, { cDist, 19 } });
+		if (rank==0 && restart_step >= 0) printf("   restart file written at timestep %i \n",restart_step);
 		int idx;
 		double value,va,vb;
-		for (int n=0; n<Np; n++){
-			File.read((char*) &va, sizeof(va));
-			File.read((char*) &vb, sizeof(vb));
-			cDen[n]    = va;
-			cDen[Np+n] = vb;
-		}
-		for (int n=0; n<Np; n++){
-			// Read the distributions
-			for (int q=0; q<19; q++){
-				File.read((char*) &value, sizeof(value));
-				cDist[q*Np+n] = value;
-			}
-		}
-		File.close();
 		
 		for (int n=0; n<ScaLBL_Comm->LastExterior(); n++){
 			va = cDen[n];
@@ -755,7 +745,6 @@ void ScaLBL_GreyscaleColorModel::Initialize(){
 }
 
 void ScaLBL_GreyscaleColorModel::Run(){
-	int nprocs=nprocx*nprocy*nprocz;
 	const RankInfoStruct rank_info(rank,nprocx,nprocy,nprocz);
 	
 	int IMAGE_INDEX = 0;
@@ -957,8 +946,7 @@ void ScaLBL_GreyscaleColorModel::Run(){
         //ScaLBL_D3Q19_AAodd_GreyscaleColor(NeighborList, dvcMap, fq, Aq, Bq, Den, Phi,GreySolidPhi,Porosity_dvc,Permeability_dvc,Velocity,
         //        rhoA, rhoB, tauA, tauB,tauA_eff, tauB_eff,
         //        alpha, beta, Fx, Fy, Fz, Nx, Nx*Ny, 0, ScaLBL_Comm->LastExterior(), Np);
-		ScaLBL_DeviceBarrier(); 
-		MPI_Barrier(ScaLBL_Comm->MPI_COMM_SCALBL);
+		ScaLBL_DeviceBarrier();
 
 		// *************EVEN TIMESTEP*************
 		timestep++;
@@ -1010,8 +998,7 @@ void ScaLBL_GreyscaleColorModel::Run(){
         //ScaLBL_D3Q19_AAeven_GreyscaleColor(dvcMap, fq, Aq, Bq, Den, Phi,GreySolidPhi,Porosity_dvc,Permeability_dvc,Velocity,
         //        rhoA, rhoB, tauA, tauB,tauA_eff, tauB_eff,
         //        alpha, beta, Fx, Fy, Fz, Nx, Nx*Ny, 0, ScaLBL_Comm->LastExterior(), Np);
-		ScaLBL_DeviceBarrier(); 
-		MPI_Barrier(ScaLBL_Comm->MPI_COMM_SCALBL);
+		ScaLBL_DeviceBarrier();
 		//************************************************************************
 		PROFILE_STOP("Update");
 
@@ -1249,7 +1236,6 @@ void ScaLBL_GreyscaleColorModel::Run(){
 			}
 			morph_timesteps += analysis_interval;
 		}
-		MPI_Barrier(ScaLBL_Comm->MPI_COMM_SCALBL);
 	}
 	//analysis.finish();
 	PROFILE_STOP("Loop");
@@ -1266,10 +1252,9 @@ void ScaLBL_GreyscaleColorModel::Run(){
 
 	if (rank==0) printf("********************************************************\n");
 	if (rank==0) printf("CPU time = %f \n", cputime);
-	if (rank==0) printf("Lattice update rate (per core)= %f MLUPS \n", MLUPS);
-	MLUPS *= nprocs;
-	if (rank==0) printf("Lattice update rate (total)= %f MLUPS \n", MLUPS);
+	Utilities::Profiler::reportRate(comm,MLUPS);
 	if (rank==0) printf("********************************************************\n");
+	PROFILE_REPORT(comm);
 
 	// ************************************************************************
 }
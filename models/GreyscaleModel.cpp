@@ -17,6 +17,7 @@
   Greyscale lattice boltzmann model
  */
 #include "models/GreyscaleModel.h"
+#include "common/Profiler.h"
 #include "analysis/distance.h"
 #include "analysis/morphology.h"
 #include <stdlib.h>
@@ -471,7 +472,6 @@ void ScaLBL_GreyscaleModel::Initialize(){
 }
 
 void ScaLBL_GreyscaleModel::Run(){
-	int nprocs=nprocx*nprocy*nprocz;
 	const RankInfoStruct rank_info(rank,nprocx,nprocy,nprocz);
 	
 	int analysis_interval = 1000; 	// number of timesteps in between in situ analysis 
@@ -514,6 +514,7 @@ void ScaLBL_GreyscaleModel::Run(){
 	double flow_rate_previous = 0.0;
 	while (timestep < timestepMax && error > tolerance) {
 		//************************************************************************/
+		PROFILE_START("Update");
 		// *************ODD TIMESTEP*************//
 		timestep++;
 		ScaLBL_Comm->SendD3Q19AA(fq); //READ FROM NORMAL
@@ -552,7 +553,7 @@ void ScaLBL_GreyscaleModel::Run(){
 		            ScaLBL_D3Q19_AAodd_Greyscale_IMRT(NeighborList, fq, 0, ScaLBL_Comm->LastExterior(), Np, rlx, rlx_eff, Fx, Fy, Fz,Porosity,Permeability,Velocity,Den,Pressure_dvc);
                     break;
         }
-		ScaLBL_DeviceBarrier(); MPI_Barrier(comm);
+		ScaLBL_DeviceBarrier();
 
 		// *************EVEN TIMESTEP*************//
 		timestep++;
@@ -592,7 +593,8 @@ void ScaLBL_GreyscaleModel::Run(){
 		            ScaLBL_D3Q19_AAeven_Greyscale_IMRT(fq, 0, ScaLBL_Comm->LastExterior(), Np, rlx, rlx_eff, Fx, Fy, Fz,Porosity,Permeability,Velocity,Den,Pressure_dvc);
                     break;
         }
-        ScaLBL_DeviceBarrier(); MPI_Barrier(comm);
+        ScaLBL_DeviceBarrier();
+		PROFILE_STOP("Update");
 		//************************************************************************/
 		
 		if (timestep%analysis_interval==0){
@@ -691,14 +693,11 @@ void ScaLBL_GreyscaleModel::Run(){
 			Morphology.ComputeScalar(SignDist,0.f);
 			//Morphology.PrintAll();
 			double mu = (tau-0.5)/3.f;
-			double Vs = Morphology.V();
-			double As = Morphology.A();
-			double Hs = Morphology.H();
-			double Xs = Morphology.X();
-			Vs = sumReduce( Dm->Comm, Vs);
-			As = sumReduce( Dm->Comm, As);
-			Hs = sumReduce( Dm->Comm, Hs);
-			Xs = sumReduce( Dm->Comm, Xs);
+			// global measures were reduced by ComputeScalar
+			double Vs = Morphology.Vi_global;
+			double As = Morphology.Ai_global;
+			double Hs = Morphology.Ji_global;
+			double Xs = Morphology.Xi_global;
 
 			double h = Dm->voxel_length;
 			//double absperm = h*h*mu*Mask->Porosity()*flow_rate / force_mag;
@@ -765,10 +764,9 @@ void ScaLBL_GreyscaleModel::Run(){
 
 	if (rank==0) printf("********************************************************\n");
 	if (rank==0) printf("CPU time = %f \n", cputime);
-	if (rank==0) printf("Lattice update rate (per core)= %f MLUPS \n", MLUPS);
-	MLUPS *= nprocs;
-	if (rank==0) printf("Lattice update rate (total)= %f MLUPS \n", MLUPS);
+	Utilities::Profiler::reportRate(comm,MLUPS);
 	if (rank==0) printf("********************************************************\n");
+	PROFILE_REPORT(comm);
 
 	// ************************************************************************
 }
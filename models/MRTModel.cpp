@@ -18,11 +18,13 @@
  * Multi-relaxation time LBM Model
  */
 #include "models/MRTModel.h"
+#include "common/Profiler.h"
 #include "analysis/distance.h"
 #include "common/ReadMicroCT.h"
 
 ScaLBL_MRTModel::ScaLBL_MRTModel(int RANK, int NP, MPI_Comm COMM):
-rank(RANK), nprocs(NP), Restart(0),timestep(0),timestepMax(0),tau(0),
+rank(RANK), nprocs(NP), Restart(0),CompressNeighbors(0),SinglePrecision(0),timestep(0),timestepMax(0),tau(0),
+NeighborOffset(NULL),NeighborBase(NULL),
 Fx(0),Fy(0),Fz(0),flux(0),din(0),dout(0),mu(0),
 Nx(0),Ny(0),Nz(0),N(0),Np(0),nprocx(0),nprocy(0),nprocz(0),BoundaryCondition(0),Lx(0),Ly(0),Lz(0),comm(COMM)
 {
@@ -34,7 +36,10 @@ ScaLBL_MRTModel::~ScaLBL_MRTModel(){
 
 void ScaLBL_MRTModel::ReadParams(string filename){
 	// read the input database 
-	db = std::make_shared<Database>( filename );
+	ReadParams( std::make_shared<Database>( filename ) );
+}
+void ScaLBL_MRTModel::ReadParams(std::shared_ptr<Database> db0){
+	db = db0;
 	domain_db = db->getDatabase( "Domain" );
 	mrt_db = db->getDatabase( "MRT" );
 	
@@ -71,11 +76,23 @@ void ScaLBL_MRTModel::ReadParams(string filename){
 	if (mrt_db->keyExists( "flux" )){
 		flux = mrt_db->getScalar<double>( "flux" );
 	}	
+	if (mrt_db->keyExists( "CompressNeighborList" )){
+		CompressNeighbors = mrt_db->getScalar<bool>( "CompressNeighborList" );
+	}
+	if (mrt_db->keyExists( "Precision" )){
+		auto precision = mrt_db->getScalar<std::string>( "Precision" );
+		if (precision == "single") SinglePrecision = true;
+		else if (precision != "double") ERROR("Error: MRT Precision must be double or single \n");
+	}
 	
 	// Read domain parameters
 	if (domain_db->keyExists( "BC" )){
 		BoundaryCondition = domain_db->getScalar<int>( "BC" );
 	}
+	if (SinglePrecision && (BoundaryCondition != 0 || CompressNeighbors)){
+		// the boundary conditions and the compressed odd step only exist for double storage
+		ERROR("Error: MRT Precision = single requires BC = 0 and no CompressNeighborList \n");
+	}
 
 	mu=(tau-0.5)/3.0;
 }
@@ -198,7 +215,14 @@ void ScaLBL_MRTModel::Create(){
 	int neighborSize=18*(Np*sizeof(int));
 	//...........................................................................
 	ScaLBL_AllocateDeviceMemory((void **) &NeighborList, neighborSize);
-	ScaLBL_AllocateDeviceMemory((void **) &fq, 19*dist_mem_size);  
+	if (SinglePrecision){
+		ScaLBL_AllocateDeviceMemory((void **) &fq_single, 19*Np*sizeof(float));
+		fq = NULL;
+	}
+	else {
+		ScaLBL_AllocateDeviceMemory((void **) &fq, 19*dist_mem_size);
+		fq_single = NULL;
+	}
 	ScaLBL_AllocateDeviceMemory((void **) &Pressure, sizeof(double)*Np);
 	ScaLBL_AllocateDeviceMemory((void **) &Velocity, 3*sizeof(double)*Np);
 	//...........................................................................
@@ -206,6 +230,21 @@ void ScaLBL_MRTModel::Create(){
 	if (rank==0)    printf ("Setting up device map and neighbor list \n");
 	// copy the neighbor list 
 	ScaLBL_CopyToDevice(NeighborList, neighborList, neighborSize);
+	if (CompressNeighbors){
+		// the full list is kept for the boundary conditions and for blocks that do not compress
+		int baseSize = 36*(Np/(1 << ScaLBL_NEIGHBOR_BLOCK_SHIFT) + 1);
+		short *neighborOffset = new short[18*Np];
+		int *neighborBase = new int[baseSize];
+		int full = ScaLBL_Comm->CompressNeighborList(neighborList,Np,neighborOffset,neighborBase);
+		ScaLBL_AllocateDeviceMemory((void **) &NeighborOffset, 18*Np*sizeof(short));
+		ScaLBL_AllocateDeviceMemory((void **) &NeighborBase, baseSize*sizeof(int));
+		ScaLBL_CopyToDevice(NeighborOffset, neighborOffset, 18*Np*sizeof(short));
+		ScaLBL_CopyToDevice(NeighborBase, neighborBase, baseSize*sizeof(int));
+		full = sumReduce( comm, full );
+		if (rank==0)    printf ("Compressed neighbor list: %i blocks use the full list \n",full);
+		delete [] neighborOffset;
+		delete [] neighborBase;
+	}
 	MPI_Barrier(comm);
 	
 }        
@@ -215,10 +254,57 @@ void ScaLBL_MRTModel::Initialize(){
 	 * This function initializes model
 	 */
     if (rank==0)    printf ("Initializing distributions \n");
-    ScaLBL_D3Q19_Init(fq, Np);
+    if (SinglePrecision) ScaLBL_D3Q19_Init_Single(fq_single, Np);
+    else ScaLBL_D3Q19_Init(fq, Np);
 }
 
-void ScaLBL_MRTModel::Run(){
+// MRT kernels for each storage type of the distributions (see ScaLBL_D3Q19_Init_Single);
+// the compressed neighbor list is only read with double storage (checked in ReadParams)
+static inline void ScaLBL_MRT_AAodd(int *neighborList, short *neighborOffset, int *neighborBase, double *dist, int start, int finish, int Np,
+		double rlx_setA, double rlx_setB, double Fx, double Fy, double Fz){
+	if (neighborOffset)
+		ScaLBL_D3Q19_AAodd_MRT_Compressed(neighborList, neighborOffset, neighborBase, dist, start, finish, Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+	else
+		ScaLBL_D3Q19_AAodd_MRT(neighborList, dist, start, finish, Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+}
+static inline void ScaLBL_MRT_AAodd(int *neighborList, short *neighborOffset, int *neighborBase, float *dist, int start, int finish, int Np,
+		double rlx_setA, double rlx_setB, double Fx, double Fy, double Fz){
+	ScaLBL_D3Q19_AAodd_MRT_Single(neighborList, dist, start, finish, Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+}
+static inline void ScaLBL_MRT_AAeven(double *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx, double Fy, double Fz){
+	ScaLBL_D3Q19_AAeven_MRT(dist, start, finish, Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+}
+static inline void ScaLBL_MRT_AAeven(float *dist, int start, int finish, int Np, double rlx_setA, double rlx_setB, double Fx, double Fy, double Fz){
+	ScaLBL_D3Q19_AAeven_MRT_Single(dist, start, finish, Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+}
+static inline void ScaLBL_MRT_Momentum(double *dist, double *vel, int Np){
+	ScaLBL_D3Q19_Momentum(dist, vel, Np);
+}
+static inline void ScaLBL_MRT_Momentum(float *dist, double *vel, int Np){
+	ScaLBL_D3Q19_Momentum_Single(dist, vel, Np);
+}
+
+void ScaLBL_MRTModel::SetBoundaryConditions(double *dist){
+	if (BoundaryCondition == 3){
+		ScaLBL_Comm->D3Q19_Pressure_BC_z(NeighborList, dist, din, timestep);
+		ScaLBL_Comm->D3Q19_Pressure_BC_Z(NeighborList, dist, dout, timestep);
+	}
+	else if (BoundaryCondition == 4){
+		din = ScaLBL_Comm->D3Q19_Flux_BC_z(NeighborList, dist, flux, timestep);
+		ScaLBL_Comm->D3Q19_Pressure_BC_Z(NeighborList, dist, dout, timestep);
+	}
+	else if (BoundaryCondition == 5){
+		ScaLBL_Comm->D3Q19_Reflection_BC_z(dist);
+		ScaLBL_Comm->D3Q19_Reflection_BC_Z(dist);
+	}
+}
+
+void ScaLBL_MRTModel::SetBoundaryConditions(float *dist){
+	// the boundary conditions only exist for double storage (BC = 0 is checked in ReadParams)
+}
+
+template<class TYPE>
+void ScaLBL_MRTModel::Run(TYPE *dist){
 	double rlx_setA=1.0/tau;
 	double rlx_setB = 8.f*(2.f-rlx_setA)/(8.f-rlx_setA);
 	
@@ -248,50 +334,31 @@ void ScaLBL_MRTModel::Run(){
 	timestep=0;
 	double error = 1.0;
 	double flow_rate_previous = 0.0;
+	PROFILE_START("Loop");
 	while (timestep < timestepMax && error > tolerance) {
 		//************************************************************************/
+		PROFILE_START("Update");
 		timestep++;
-		ScaLBL_Comm->SendD3Q19AA(fq); //READ FROM NORMAL
-		ScaLBL_D3Q19_AAodd_MRT(NeighborList, fq,  ScaLBL_Comm->FirstInterior(), ScaLBL_Comm->LastInterior(), Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
-		ScaLBL_Comm->RecvD3Q19AA(fq); //WRITE INTO OPPOSITE
+		ScaLBL_Comm->SendD3Q19AA(dist); //READ FROM NORMAL
+		ScaLBL_MRT_AAodd(NeighborList, NeighborOffset, NeighborBase, dist, ScaLBL_Comm->FirstInterior(), ScaLBL_Comm->LastInterior(), Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+		ScaLBL_Comm->RecvD3Q19AA(dist); //WRITE INTO OPPOSITE
 		// Set boundary conditions
-		if (BoundaryCondition == 3){
-			ScaLBL_Comm->D3Q19_Pressure_BC_z(NeighborList, fq, din, timestep);
-			ScaLBL_Comm->D3Q19_Pressure_BC_Z(NeighborList, fq, dout, timestep);
-		}
-		else if (BoundaryCondition == 4){
-			din = ScaLBL_Comm->D3Q19_Flux_BC_z(NeighborList, fq, flux, timestep);
-			ScaLBL_Comm->D3Q19_Pressure_BC_Z(NeighborList, fq, dout, timestep);
-		}
-		else if (BoundaryCondition == 5){
-			ScaLBL_Comm->D3Q19_Reflection_BC_z(fq);
-			ScaLBL_Comm->D3Q19_Reflection_BC_Z(fq);
-		}
-		ScaLBL_D3Q19_AAodd_MRT(NeighborList, fq, 0, ScaLBL_Comm->LastExterior(), Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
-		ScaLBL_DeviceBarrier(); MPI_Barrier(comm);
+		SetBoundaryConditions(dist);
+		ScaLBL_MRT_AAodd(NeighborList, NeighborOffset, NeighborBase, dist, 0, ScaLBL_Comm->LastExterior(), Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+		ScaLBL_DeviceBarrier();
 		timestep++;
-		ScaLBL_Comm->SendD3Q19AA(fq); //READ FORM NORMAL
-		ScaLBL_D3Q19_AAeven_MRT(fq, ScaLBL_Comm->FirstInterior(), ScaLBL_Comm->LastInterior(), Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
-		ScaLBL_Comm->RecvD3Q19AA(fq); //WRITE INTO OPPOSITE
+		ScaLBL_Comm->SendD3Q19AA(dist); //READ FORM NORMAL
+		ScaLBL_MRT_AAeven(dist, ScaLBL_Comm->FirstInterior(), ScaLBL_Comm->LastInterior(), Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+		ScaLBL_Comm->RecvD3Q19AA(dist); //WRITE INTO OPPOSITE
 		// Set boundary conditions
-		if (BoundaryCondition == 3){
-			ScaLBL_Comm->D3Q19_Pressure_BC_z(NeighborList, fq, din, timestep);
-			ScaLBL_Comm->D3Q19_Pressure_BC_Z(NeighborList, fq, dout, timestep);
-		}
-		else if (BoundaryCondition == 4){
-			din = ScaLBL_Comm->D3Q19_Flux_BC_z(NeighborList, fq, flux, timestep);
-			ScaLBL_Comm->D3Q19_Pressure_BC_Z(NeighborList, fq, dout, timestep);
-		}
-		else if (BoundaryCondition == 5){
-			ScaLBL_Comm->D3Q19_Reflection_BC_z(fq);
-			ScaLBL_Comm->D3Q19_Reflection_BC_Z(fq);
-		}
-		ScaLBL_D3Q19_AAeven_MRT(fq, 0, ScaLBL_Comm->LastExterior(), Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
-		ScaLBL_DeviceBarrier(); MPI_Barrier(comm);
+		SetBoundaryConditions(dist);
+		ScaLBL_MRT_AAeven(dist, 0, ScaLBL_Comm->LastExterior(), Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+		ScaLBL_DeviceBarrier();
+		PROFILE_STOP("Update");
 		//************************************************************************/
 		
 		if (timestep%1000==0){
-			ScaLBL_D3Q19_Momentum(fq,Velocity, Np);
+			ScaLBL_MRT_Momentum(dist, Velocity, Np);
 			ScaLBL_DeviceBarrier(); MPI_Barrier(comm);
 			ScaLBL_Comm->RegularLayout(Map,&Velocity[0],Velocity_x);
 			ScaLBL_Comm->RegularLayout(Map,&Velocity[Np],Velocity_y);
@@ -343,14 +410,11 @@ void ScaLBL_MRTModel::Run(){
 			Morphology.ComputeScalar(Distance,0.f);
 			//Morphology.PrintAll();
 			double mu = (tau-0.5)/3.f;
-			double Vs = Morphology.V();
-			double As = Morphology.A();
-			double Hs = Morphology.H();
-			double Xs = Morphology.X();
-			Vs=sumReduce( Dm->Comm, Vs);
-			As=sumReduce( Dm->Comm, As);
-			Hs=sumReduce( Dm->Comm, Hs);
-			Xs=sumReduce( Dm->Comm, Xs);
+			// global measures were reduced by ComputeScalar
+			double Vs = Morphology.Vi_global;
+			double As = Morphology.Ai_global;
+			double Hs = Morphology.Ji_global;
+			double Xs = Morphology.Xi_global;
 			double h = Dm->voxel_length;
 			double absperm = h*h*mu*Mask->Porosity()*flow_rate / force_mag;
 			if (rank==0) {
@@ -362,6 +426,7 @@ void ScaLBL_MRTModel::Run(){
 			}
 		}
 	}
+	PROFILE_STOP("Loop");
 	//************************************************************************/
 	stoptime = MPI_Wtime();
 	if (rank==0) printf("-------------------------------------------------------------------\n");
@@ -372,13 +437,17 @@ void ScaLBL_MRTModel::Run(){
 
 	if (rank==0) printf("********************************************************\n");
 	if (rank==0) printf("CPU time = %f \n", cputime);
-	if (rank==0) printf("Lattice update rate (per core)= %f MLUPS \n", MLUPS);
-	MLUPS *= nprocs;
-	if (rank==0) printf("Lattice update rate (total)= %f MLUPS \n", MLUPS);
+	Utilities::Profiler::reportRate(comm,MLUPS);
 	if (rank==0) printf("********************************************************\n");
+	PROFILE_REPORT(comm);
 
 }
 
+void ScaLBL_MRTModel::Run(){
+	if (SinglePrecision) Run(fq_single);
+	else Run(fq);
+}
+
 void ScaLBL_MRTModel::VelocityField(){
 
 /*	Minkowski Morphology(Mask);
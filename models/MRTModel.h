@@ -47,6 +47,8 @@ public:
 	void VelocityField();
 	
 	bool Restart,pBC;
+	bool CompressNeighbors;	// odd steps read the 16 bit neighbor list (saves memory, not a speedup)
+	bool SinglePrecision;	// distributions stored in fq_single (Precision = "single")
 	int timestep,timestepMax;
 	int BoundaryCondition;
 	double tau,mu;
@@ -70,7 +72,11 @@ public:
     IntArray Map;
     DoubleArray Distance;
     int *NeighborList;
+    // compressed neighbor list (see ScaLBL_Communicator::CompressNeighborList)
+    short *NeighborOffset;
+    int *NeighborBase;
     double *fq;
+    float *fq_single;	// deviation from the rest state (see ScaLBL_D3Q19_Init_Single)
     double *Velocity;
     double *Pressure;
     
@@ -89,4 +95,8 @@ private:
    
     //int rank,nprocs;
     void LoadParams(std::shared_ptr<Database> db0);    	
+    // time loop for the storage type of the distributions (fq or fq_single)
+    template<class TYPE> void Run(TYPE *dist);
+    void SetBoundaryConditions(double *dist);
+    void SetBoundaryConditions(float *dist);
 };
@@ -0,0 +1,143 @@
+//*************************************************************************
+// Test of Domain::AggregateLabels
+// Labels on a 3D process grid are written as the raw global image and as
+// compressed chunks; both files are read back in serial and compared with
+// the labels computed from the global coordinates
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "zlib.h"
+#include "common/Domain.h"
+#include "common/MPI_Helpers.h"
+
+std::shared_ptr<Database> loadInputs( int nprocs )
+{
+    int nproc[3] = { 1, 1, 1 };
+    for (int p=0; (1<<(p+1))<=nprocs; p++) nproc[p%3] *= 2;
+    auto db = std::make_shared<Database>();
+    db->putScalar<int>( "BC", 0 );
+    db->putVector<int>( "nproc", { nproc[0], nproc[1], nproc[2] } );
+    db->putVector<int>( "n", { 10, 12, 14 } );
+    db->putVector<double>( "L", { 1, 1, 1 } );
+    return db;
+}
+
+signed char Label(int x, int y, int z){
+	return (x*x + 3*y + 7*z*z)%5 == 0 ? 0 : 1 + (x+y+z)%3;
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestAggregateLabels	\n");
+			printf("********************************************************\n");
+		}
+		auto db = loadInputs( nprocs );
+		Domain Dm(db,comm);
+		int nx = Dm.Nx-2;
+		int ny = Dm.Ny-2;
+		int nz = Dm.Nz-2;
+		int Nx = nx*Dm.nprocx();
+		int Ny = ny*Dm.nprocy();
+		int Nz = nz*Dm.nprocz();
+		for (int k=0; k<nz+2; k++){
+			for (int j=0; j<ny+2; j++){
+				for (int i=0; i<nx+2; i++){
+					int n = k*(nx+2)*(ny+2)+j*(nx+2)+i;
+					Dm.id[n] = Label(Dm.iproc()*nx+i-1,Dm.jproc()*ny+j-1,Dm.kproc()*nz+k-1);
+				}
+			}
+		}
+		if (nprocs != Dm.nprocx()*Dm.nprocy()*Dm.nprocz()) ERROR("TestAggregateLabels: number of ranks must be a power of 2");
+
+		double starttime = MPI_Wtime();
+		Dm.AggregateLabels("TestAggregateLabels.raw");
+		double rawtime = MPI_Wtime() - starttime;
+		starttime = MPI_Wtime();
+		Dm.AggregateLabels("TestAggregateLabels.zraw",true);
+		double ztime = MPI_Wtime() - starttime;
+		MPI_Barrier(comm);
+
+		if (rank == 0){
+			printf("Global size: %i x %i x %i, write raw %f s, compressed %f s \n",Nx,Ny,Nz,rawtime,ztime);
+			size_t N = size_t(Nx)*Ny*Nz;
+			// raw global image
+			std::vector<signed char> image(N,-1);
+			FILE *fid = fopen("TestAggregateLabels.raw","rb");
+			size_t count = fread(image.data(),1,N,fid);
+			if (count != N || fgetc(fid) != EOF){
+				printf("Raw file has the wrong size \n");
+				check++;
+			}
+			fclose(fid);
+			int diff = 0;
+			for (int z=0; z<Nz; z++) for (int y=0; y<Ny; y++) for (int x=0; x<Nx; x++)
+				if (image[size_t(z)*Nx*Ny+y*Nx+x] != Label(x,y,z)) diff++;
+			printf("Raw file: %i labels differ \n",diff);
+			if (diff > 0) check++;
+
+			// compressed chunks
+			int header[16];
+			fid = fopen("TestAggregateLabels.zraw","rb");
+			count = fread(header,sizeof(header),1,fid);
+			int nprocx = header[9], nprocy = header[10], nprocz = header[11];
+			if (count != 1 || strcmp((char*)header,"LBPMZID") != 0 || header[2] != 1 ||
+				header[3] != Nx || header[4] != Ny || header[5] != Nz ||
+				header[6] != nx || header[7] != ny || header[8] != nz || nprocx*nprocy*nprocz != nprocs){
+				printf("Compressed file has a wrong header \n");
+				check++;
+			}
+			std::vector<uint64_t> table(2*nprocs);
+			count = fread(table.data(),16,nprocs,fid);
+			std::fill(image.begin(),image.end(),-1);
+			std::vector<signed char> block(nx*ny*nz);
+			for (int p=0; p<nprocs && check==0; p++){
+				std::vector<Bytef> chunk(table[2*p+1]);
+				fseek(fid,table[2*p],SEEK_SET);
+				count = fread(chunk.data(),1,chunk.size(),fid);
+				uLongf bytes = block.size();
+				if (uncompress((Bytef*)block.data(),&bytes,chunk.data(),chunk.size()) != Z_OK || bytes != block.size()){
+					printf("Chunk %i could not be decompressed \n",p);
+					check++;
+					break;
+				}
+				RankInfoStruct info(p,nprocx,nprocy,nprocz);
+				for (int k=0; k<nz; k++) for (int j=0; j<ny; j++) for (int i=0; i<nx; i++){
+					size_t x = info.ix*nx+i, y = info.jy*ny+j, z = info.kz*nz+k;
+					image[z*Nx*Ny+y*Nx+x] = block[k*nx*ny+j*nx+i];
+				}
+			}
+			fseek(fid,0,SEEK_END);
+			printf("Compressed file: %li bytes (raw %li bytes) \n",ftell(fid),N);
+			fclose(fid);
+			diff = 0;
+			for (int z=0; z<Nz; z++) for (int y=0; y<Ny; y++) for (int x=0; x<Nx; x++)
+				if (image[size_t(z)*Nx*Ny+y*Nx+x] != Label(x,y,z)) diff++;
+			printf("Compressed file: %i labels differ \n",diff);
+			if (diff > 0) check++;
+			remove("TestAggregateLabels.raw");
+			remove("TestAggregateLabels.zraw");
+			if (check == 0) printf("PASS: aggregated labels match the global image \n");
+			else printf("FAIL: aggregated labels differ \n");
+		}
+		check = sumReduce( comm, check );
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
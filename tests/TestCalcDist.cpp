@@ -0,0 +1,137 @@
+//*************************************************************************
+// Test of the exact distance transform in CalcDist (analysis/distance.h)
+// The signed distance to the faces between cells of different phases is
+// computed for a random segmentation on x and z decompositions, with and
+// without periodic boundaries, and compared against a brute force search
+// over all faces of the full image
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include "common/Domain.h"
+#include "common/MPI_Helpers.h"
+#include "analysis/distance.h"
+
+std::shared_ptr<Database> loadInputs( const std::vector<int> &nproc, int n )
+{
+    auto db = std::make_shared<Database>();
+    db->putScalar<int>( "BC", 0 );
+    db->putVector<int>( "nproc", nproc );
+    db->putVector<int>( "n", { n/nproc[0], n/nproc[1], n/nproc[2] } );
+    db->putVector<double>( "L", { 1, 1, 1 } );
+    return db;
+}
+
+// Brute force signed distance to the faces of the full image of size n^3
+std::vector<double> ReferenceDist(const std::vector<char> &image, int n, bool periodic){
+	auto at = [&](int i, int j, int k) -> char { return image[k*n*n+j*n+i]; };
+	std::vector<std::array<double,3>> faces;
+	for (int k=0; k<n; k++){
+		for (int j=0; j<n; j++){
+			for (int i=0; i<n; i++){
+				if (i>0 || periodic){
+					if (at(i,j,k) != at((i+n-1)%n,j,k)) faces.push_back({i-0.5,double(j),double(k)});
+				}
+				if (j>0 || periodic){
+					if (at(i,j,k) != at(i,(j+n-1)%n,k)) faces.push_back({double(i),j-0.5,double(k)});
+				}
+				if (k>0 || periodic){
+					if (at(i,j,k) != at(i,j,(k+n-1)%n)) faces.push_back({double(i),double(j),k-0.5});
+				}
+			}
+		}
+	}
+	std::vector<double> dist(image.size());
+	for (int k=0; k<n; k++){
+		for (int j=0; j<n; j++){
+			for (int i=0; i<n; i++){
+				double d2 = 1e50;
+				for (auto &f : faces){
+					double x = fabs(i-f[0]), y = fabs(j-f[1]), z = fabs(k-f[2]);
+					if (periodic){
+						x = std::min(x,n-x); y = std::min(y,n-y); z = std::min(z,n-z);
+					}
+					d2 = std::min(d2,x*x+y*y+z*z);
+				}
+				dist[k*n*n+j*n+i] = (at(i,j,k) == 0 ? -1.0 : 1.0)*sqrt(d2);
+			}
+		}
+	}
+	return dist;
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestCalcDist	\n");
+			printf("********************************************************\n");
+		}
+		int n = 16;
+		std::vector<char> image(n*n*n);
+		srand(1234);
+		for (auto &x : image) x = (rand()%8 == 0) ? 0 : 1;
+		for (int periodic=0; periodic<2; periodic++){
+			auto ref = ReferenceDist(image,n,periodic==1);
+			std::vector<std::vector<int>> decomp = { { nprocs, 1, 1 }, { 1, 1, nprocs } };
+			for (auto &nproc : decomp){
+				auto db = loadInputs( nproc, n );
+				Domain Dm(db,comm);
+				int Nx = Dm.Nx, Ny = Dm.Ny, Nz = Dm.Nz;
+				Array<char> id(Nx,Ny,Nz);
+				id.fill(0);
+				for (int k=1; k<Nz-1; k++){
+					for (int j=1; j<Ny-1; j++){
+						for (int i=1; i<Nx-1; i++){
+							int x = Dm.iproc()*(Nx-2)+i-1, y = Dm.jproc()*(Ny-2)+j-1, z = Dm.kproc()*(Nz-2)+k-1;
+							id(i,j,k) = image[z*n*n+y*n+x];
+						}
+					}
+				}
+				DoubleArray Distance(Nx,Ny,Nz);
+				bool p = periodic==1;
+				double starttime = MPI_Wtime();
+				CalcDist(Distance,id,Dm,{p,p,p});
+				double walltime = MPI_Wtime() - starttime;
+				double error = 0.0;
+				for (int k=0; k<Nz; k++){
+					for (int j=0; j<Ny; j++){
+						for (int i=0; i<Nx; i++){
+							int x = Dm.iproc()*(Nx-2)+i-1, y = Dm.jproc()*(Ny-2)+j-1, z = Dm.kproc()*(Nz-2)+k-1;
+							if (p){
+								x = (x+n)%n; y = (y+n)%n; z = (z+n)%n;
+							}
+							else if (x<0 || y<0 || z<0 || x>=n || y>=n || z>=n){
+								continue;
+							}
+							error = std::max(error,fabs(Distance(i,j,k)-ref[z*n*n+y*n+x]));
+						}
+					}
+				}
+				error = maxReduce( comm, error );
+				if (rank == 0) printf("nproc = %i,%i,%i, periodic = %i: max error = %e (%f s) \n",
+					nproc[0],nproc[1],nproc[2],periodic,error,walltime);
+				if (error > 1e-12) check++;
+			}
+		}
+		if (rank == 0){
+			if (check == 0) printf("PASS: CalcDist matches the exact distance \n");
+			else printf("FAIL: CalcDist differs from the exact distance \n");
+		}
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
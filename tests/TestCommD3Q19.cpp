@@ -284,6 +284,7 @@ int main(int argc, char **argv)
 		auto neighborList= new int[18*Npad];
 		IntArray Map(Nx,Ny,Nz);
 		Map.fill(-2);		
+		int PoreCount = Np;
 		Np = ScaLBL_Comm.MemoryOptimizedLayoutAA(Map,neighborList,Dm->id,Np);
 		MPI_Barrier(comm);
 		int neighborSize=18*Np*sizeof(int);
@@ -372,6 +373,25 @@ int main(int argc, char **argv)
 		check =	GlobalCheckDebugDist(fq_host, Map, Np, Nx-2, Ny-2, Nz-2,iproc,jproc,kproc,nprocx,nprocy,nprocz,0,ScaLBL_Comm.next);
 		//...........................................................................
 
+		//...........................................................................
+		// Repeat with the edge messages routed through the face neighbors
+		if (rank==0)	printf ("Create ScaLBL_Communicator with aggregated edges \n");
+		db->putScalar<bool>( "AggregateEdges", true );
+		ScaLBL_Communicator ScaLBL_Comm_Aggregate(Dm);
+		IntArray MapAggregate(Nx,Ny,Nz);
+		MapAggregate.fill(-2);
+		ScaLBL_Comm_Aggregate.MemoryOptimizedLayoutAA(MapAggregate,neighborList,Dm->id,PoreCount);
+		GlobalFlipScaLBL_D3Q19_Init(fq_host, MapAggregate, Np, Nx-2, Ny-2, Nz-2, iproc,jproc,kproc,nprocx,nprocy,nprocz);
+		ScaLBL_CopyToDevice(fq, fq_host, 19*dist_mem_size);
+		ScaLBL_DeviceBarrier();
+		ScaLBL_Comm_Aggregate.SendD3Q19AA(fq);
+		ScaLBL_Comm_Aggregate.RecvD3Q19AA(fq);
+		ScaLBL_Comm_Aggregate.SendD3Q19AA(fq);
+		ScaLBL_Comm_Aggregate.RecvD3Q19AA(fq);
+		ScaLBL_CopyToHost(fq_host,fq,19*Np*sizeof(double));
+		check += GlobalCheckDebugDist(fq_host, MapAggregate, Np, Nx-2, Ny-2, Nz-2,iproc,jproc,kproc,nprocx,nprocy,nprocz,0,ScaLBL_Comm_Aggregate.next);
+		//...........................................................................
+
 		int timestep = 0;
 		if (rank==0) printf("********************************************************\n");
 		if (rank==0)	printf("No. of timesteps for timing: %i \n", 100);
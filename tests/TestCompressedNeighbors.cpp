@@ -0,0 +1,152 @@
+//*************************************************************************
+// Check of the compressed (16 bit) neighbor list for the MRT model
+// Runs ScaLBL_MRTModel on a random sphere packing with and without
+// CompressNeighborList and compares the distributions (to round-off)
+//   usage: TestCompressedNeighbors [n] [timesteps] [porosity]
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <algorithm>
+#include "common/ScaLBL.h"
+#include "common/MPI_Helpers.h"
+#include "models/MRTModel.h"
+
+std::shared_ptr<Database> loadInputs( int nprocs, int n, int timesteps, bool compress )
+{
+    auto domain_db = std::make_shared<Database>();
+    domain_db->putScalar<int>( "BC", 0 );
+    domain_db->putVector<int>( "nproc", { 1, 1, nprocs } );
+    domain_db->putVector<int>( "n", { n, n, n } );
+    domain_db->putVector<double>( "L", { 1, 1, 1 } );
+    auto mrt_db = std::make_shared<Database>();
+    mrt_db->putScalar<double>( "tau", 0.7 );
+    mrt_db->putVector<double>( "F", { 0, 0, 1.0e-5 } );
+    mrt_db->putScalar<int>( "timestepMax", timesteps );
+    mrt_db->putScalar<double>( "tolerance", 0.0 );
+    mrt_db->putScalar<bool>( "CompressNeighborList", compress );
+    auto db = std::make_shared<Database>();
+    db->putDatabase( "Domain", domain_db );
+    db->putDatabase( "MRT", mrt_db );
+    return db;
+}
+
+// Overlapping solid spheres placed until the porosity drops below the target
+void SpherePack(ScaLBL_MRTModel &MRT, double porosity, int rank){
+	int Nx = MRT.Nx;
+	int Ny = MRT.Ny;
+	int Nz = MRT.Nz;
+	int N = Nx*Ny*Nz;
+	double radius = 0.08*Nx;
+	for (int n=0; n<N; n++) MRT.Mask->id[n] = 1;
+	srand(1234+rank);
+	double solid = 0.0;
+	while (1.0-solid/double(N) > porosity){
+		double cx = Nx*double(rand())/RAND_MAX;
+		double cy = Ny*double(rand())/RAND_MAX;
+		double cz = Nz*double(rand())/RAND_MAX;
+		for (int k=std::max(int(cz-radius),0);k<std::min(int(cz+radius)+1,Nz);k++){
+			for (int j=std::max(int(cy-radius),0);j<std::min(int(cy+radius)+1,Ny);j++){
+				for (int i=std::max(int(cx-radius),0);i<std::min(int(cx+radius)+1,Nx);i++){
+					int n = k*Nx*Ny+j*Nx+i;
+					double dist = sqrt((i-cx)*(i-cx)+(j-cy)*(j-cy)+(k-cz)*(k-cz));
+					if (dist < radius && MRT.Mask->id[n] > 0){
+						MRT.Mask->id[n] = 0;
+						solid += 1.0;
+					}
+				}
+			}
+		}
+	}
+	for (int k=0;k<Nz;k++){
+		for (int j=0;j<Ny;j++){
+			for (int i=0;i<Nx;i++){
+				int n = k*Nx*Ny+j*Nx+i;
+				MRT.Distance(i,j,k) = (MRT.Mask->id[n] > 0) ? 1.0 : -1.0;
+			}
+		}
+	}
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		int n = 48;
+		int timesteps = 20;
+		double porosity = 0.35;
+		if (argc > 1) n = atoi(argv[1]);
+		if (argc > 2) timesteps = atoi(argv[2]);
+		if (argc > 3) porosity = atof(argv[3]);
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestCompressedNeighbors	\n");
+			printf("********************************************************\n");
+		}
+
+		ScaLBL_MRTModel MRT(rank,nprocs,comm);
+		MRT.ReadParams(loadInputs( nprocs, n, timesteps, false ));
+		MRT.SetDomain();
+		SpherePack(MRT,porosity,rank);
+		MRT.Create();
+		MRT.Initialize();
+		MRT.Run();
+
+		ScaLBL_MRTModel Compressed(rank,nprocs,comm);
+		Compressed.ReadParams(loadInputs( nprocs, n, timesteps, true ));
+		Compressed.SetDomain();
+		SpherePack(Compressed,porosity,rank);
+		Compressed.Create();
+		Compressed.Initialize();
+		Compressed.Run();
+
+		if (MRT.Np != Compressed.Np || MRT.timestep != Compressed.timestep){
+			printf("Rank %i: layouts differ (Np = %i, %i; timestep = %i, %i) \n",rank,MRT.Np,Compressed.Np,MRT.timestep,Compressed.timestep);
+			check = 1;
+		}
+		else {
+			int Np = MRT.Np;
+			double *fq = new double[19*Np];
+			double *fq_compressed = new double[19*Np];
+			ScaLBL_CopyToHost(fq,MRT.fq,19*Np*sizeof(double));
+			ScaLBL_CopyToHost(fq_compressed,Compressed.fq,19*Np*sizeof(double));
+			int count = 0;
+			for (int k=1; k<MRT.Nz-1; k++){
+				for (int j=1; j<MRT.Ny-1; j++){
+					for (int i=1; i<MRT.Nx-1; i++){
+						int idx = MRT.Map(i,j,k);
+						if (!(idx<0)){
+							for (int q=0; q<19; q++){
+								if (fabs(fq[q*Np+idx]-fq_compressed[q*Np+idx]) > 1.0e-12*fabs(fq[q*Np+idx])) count++;
+							}
+						}
+					}
+				}
+			}
+			if (count > 0){
+				printf("Rank %i: %i distribution values differ \n",rank,count);
+				check = 1;
+			}
+			delete [] fq;
+			delete [] fq_compressed;
+		}
+		check = sumReduce( comm, check );
+		if (rank == 0){
+			if (check == 0) printf("PASS: compressed neighbor list matches the full list \n");
+			else printf("FAIL: compressed neighbor list differs from the full list \n");
+		}
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
@@ -0,0 +1,190 @@
+//*************************************************************************
+// Test of the distributed image ingest in Domain::Decomp and Domain::ReadFromFile
+// Random 8 and 16 bit images (with relabeling, checkerboard and mixed
+// reflection layers and an offset) and a double
+// image are decomposed in parallel and compared against the subdomains
+// cut from the full image in serial
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "common/Domain.h"
+#include "common/MPI_Helpers.h"
+
+std::shared_ptr<Database> loadInputs( int nprocs, const std::string &ReadType, bool checker )
+{
+    auto db = std::make_shared<Database>();
+    db->putScalar<int>( "BC", 0 );
+    db->putVector<int>( "nproc", { 1, 1, nprocs } );
+    db->putVector<int>( "n", { 14, 12, 24/nprocs } );
+    db->putVector<int>( "N", { 17, 15, 26 } );
+    db->putVector<int>( "offset", { 2, 1, 0 } );
+    db->putVector<double>( "L", { 1, 1, 1 } );
+    db->putScalar<std::string>( "ReadType", ReadType );
+    db->putVector<int>( "ReadValues", { 0, 1, 2, 3 } );
+    db->putVector<int>( "WriteValues", { 0, 2, 1, 0 } );
+    db->putVector<int>( "InletLayers", { checker ? 2 : 0, 0, 3 } );
+    db->putVector<int>( "OutletLayers", { 0, checker ? 1 : 0, 2 } );
+    if (checker) db->putScalar<int>( "checkerSize", 3 );
+    return db;
+}
+
+// Serial reference: relabel and pattern the full image, then cut the subdomain of rank
+std::vector<signed char> ReferenceDecomp(const std::vector<char> &image, std::shared_ptr<Database> db, int rank){
+	auto n = db->getVector<int>( "n" );
+	auto N = db->getVector<int>( "N" );
+	auto nproc = db->getVector<int>( "nproc" );
+	auto offset = db->getVector<int>( "offset" );
+	auto inlet = db->getVector<int>( "InletLayers" );
+	auto outlet = db->getVector<int>( "OutletLayers" );
+	auto ReadValues = db->getVector<int>( "ReadValues" );
+	auto WriteValues = db->getVector<int>( "WriteValues" );
+	bool checker = db->keyExists( "checkerSize" );
+	int checkerSize = checker ? db->getScalar<int>( "checkerSize" ) : N[0];
+	int phase_in = 1, phase_out = 2;
+	int64_t Nx = N[0], Ny = N[1], Nz = N[2];
+	std::vector<char> SegData(image);
+	for (auto &value : SegData){
+		for (size_t idx=0; idx<ReadValues.size(); idx++){
+			if (value == (signed char) ReadValues[idx]){ value = WriteValues[idx]; break; }
+		}
+	}
+	auto at = [&](int64_t i, int64_t j, int64_t k) -> char& { return SegData[k*Nx*Ny+j*Nx+i]; };
+	if (checker){
+		for (int k=0; k<Nz; k++) for (int j=0; j<Ny; j++) for (int i=offset[0]; i<offset[0]+inlet[0]; i++)
+			at(i,j,k) = ((j/checkerSize + k/checkerSize)%2 == 0) ? 2 : 0;
+		for (int k=offset[2]; k<offset[2]+inlet[2]; k++) for (int j=0; j<Ny; j++) for (int i=0; i<Nx; i++)
+			at(i,j,k) = ((i/checkerSize + j/checkerSize)%2 == 0) ? phase_in : 0;
+		for (int k=0; k<Nz; k++) for (int j=offset[1]+n[1]*nproc[1]-outlet[1]; j<offset[1]+n[1]*nproc[1]; j++) for (int i=0; i<Nx; i++)
+			if (j < Ny) at(i,j,k) = ((i/checkerSize + k/checkerSize)%2 == 0) ? 2 : 0;
+		for (int k=offset[2]+n[2]*nproc[2]-outlet[2]; k<offset[2]+n[2]*nproc[2]; k++) for (int j=0; j<Ny; j++) for (int i=0; i<Nx; i++)
+			if (k < Nz) at(i,j,k) = ((i/checkerSize + j/checkerSize)%2 == 0) ? phase_out : 0;
+	}
+	else {
+		int64_t zlast = offset[2]+n[2]*nproc[2]-1;
+		for (int k=offset[2]; k<offset[2]+inlet[2]; k++) for (int j=0; j<Ny; j++) for (int i=0; i<Nx; i++){
+			signed char local_id = at(i,j,k);
+			signed char reflection_id = (zlast < Nz) ? at(i,j,zlast) : 0;
+			if (local_id < 1 && reflection_id > 0) at(i,j,k) = reflection_id;
+		}
+		for (int k=offset[2]+n[2]*nproc[2]-outlet[2]; k<offset[2]+n[2]*nproc[2]; k++) for (int j=0; j<Ny; j++) for (int i=0; i<Nx; i++){
+			if (!(k < Nz)) continue;
+			signed char local_id = at(i,j,k);
+			signed char reflection_id = at(i,j,offset[2]);
+			if (local_id < 1 && reflection_id > 0) at(i,j,k) = reflection_id;
+		}
+	}
+	int64_t z_transition_size = (nproc[2]*n[2] - (Nz - offset[2]))/2;
+	if (z_transition_size < 0) z_transition_size = 0;
+	RankInfoStruct info(rank,nproc[0],nproc[1],nproc[2]);
+	std::vector<signed char> loc_id((n[0]+2)*(n[1]+2)*(n[2]+2));
+	for (int k=0; k<n[2]+2; k++){
+		for (int j=0; j<n[1]+2; j++){
+			for (int i=0; i<n[0]+2; i++){
+				int64_t x = offset[0] + info.ix*n[0] + i-1;
+				int64_t y = offset[1] + info.jy*n[1] + j-1;
+				int64_t z = offset[2] + info.kz*n[2] + k-1 - z_transition_size;
+				x = std::min<int64_t>(std::max<int64_t>(x,offset[0]),Nx-1);
+				y = std::min<int64_t>(std::max<int64_t>(y,offset[1]),Ny-1);
+				z = std::min<int64_t>(std::max<int64_t>(z,offset[2]),Nz-1);
+				loc_id[k*(n[0]+2)*(n[1]+2)+j*(n[0]+2)+i] = at(x,y,z);
+			}
+		}
+	}
+	return loc_id;
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestDecomp	\n");
+			printf("********************************************************\n");
+		}
+		const char *types[2] = { "8bit", "16bit" };
+		for (int t=0; t<2; t++){
+			for (int checker=0; checker<2; checker++){
+				auto db = loadInputs( nprocs, types[t], checker==1 );
+				auto N = db->getVector<int>( "N" );
+				size_t size = N[0]*N[1]*N[2];
+				std::vector<char> image(size);
+				srand(1234);
+				for (auto &value : image) value = rand()%4;
+				if (rank == 0){
+					FILE *fid = fopen("TestDecomp.raw","wb");
+					if (t == 0){
+						fwrite(image.data(),1,size,fid);
+					}
+					else {
+						std::vector<short int> image16(image.begin(),image.end());
+						fwrite(image16.data(),2,size,fid);
+					}
+					fclose(fid);
+				}
+				MPI_Barrier(comm);
+				Domain Dm(db,comm);
+				Dm.Decomp("TestDecomp.raw");
+				auto loc_id = ReferenceDecomp(image,db,rank);
+				int count = 0;
+				for (size_t n=0; n<loc_id.size(); n++){
+					if (Dm.id[n] != loc_id[n]) count++;
+				}
+				count = sumReduce( comm, count );
+				if (rank == 0) printf("Decomp (%s, checker = %i): %i values differ \n",types[t],checker,count);
+				if (count > 0) check++;
+			}
+		}
+
+		// double precision input
+		auto db = loadInputs( nprocs, "8bit", false );
+		auto n = db->getVector<int>( "n" );
+		auto N = db->getVector<int>( "N" );
+		auto offset = db->getVector<int>( "offset" );
+		std::vector<double> data(N[0]*N[1]*N[2]);
+		for (size_t m=0; m<data.size(); m++) data[m] = 0.5*m;
+		if (rank == 0){
+			FILE *fid = fopen("TestDecomp.raw","wb");
+			fwrite(data.data(),8,data.size(),fid);
+			fclose(fid);
+		}
+		MPI_Barrier(comm);
+		Domain Dm(db,comm);
+		std::vector<double> UserData((n[0]+2)*(n[1]+2)*(n[2]+2));
+		Dm.ReadFromFile("TestDecomp.raw","double",UserData.data());
+		int count = 0;
+		for (int k=0; k<n[2]+2; k++){
+			for (int j=0; j<n[1]+2; j++){
+				for (int i=0; i<n[0]+2; i++){
+					int64_t x = std::min<int64_t>(std::max<int64_t>(offset[0]+i-1,offset[0]),N[0]-1);
+					int64_t y = std::min<int64_t>(std::max<int64_t>(offset[1]+j-1,offset[1]),N[1]-1);
+					int64_t z = std::min<int64_t>(std::max<int64_t>(offset[2]+rank*n[2]+k-1,offset[2]),N[2]-1);
+					if (UserData[k*(n[0]+2)*(n[1]+2)+j*(n[0]+2)+i] != data[z*N[0]*N[1]+y*N[0]+x]) count++;
+				}
+			}
+		}
+		count = sumReduce( comm, count );
+		if (rank == 0) printf("ReadFromFile: %i values differ \n",count);
+		if (count > 0) check++;
+		MPI_Barrier(comm);
+		if (rank == 0) remove("TestDecomp.raw");
+
+		if (rank == 0){
+			if (check == 0) printf("PASS: distributed decomposition matches the serial decomposition \n");
+			else printf("FAIL: distributed decomposition differs \n");
+		}
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
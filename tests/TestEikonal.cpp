@@ -0,0 +1,103 @@
+//*************************************************************************
+// Test of the fast sweeping Eikonal solver (analysis/distance.h)
+// A distorted level set of a sphere is reinitialized and compared against
+// the analytical signed distance, on the full domain and in a narrow band
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "common/Domain.h"
+#include "common/MPI_Helpers.h"
+#include "analysis/distance.h"
+
+std::shared_ptr<Database> loadInputs( int nprocs, int n )
+{
+    auto db = std::make_shared<Database>();
+    db->putScalar<int>( "BC", 0 );
+    db->putVector<int>( "nproc", { 1, 1, nprocs } );
+    db->putVector<int>( "n", { n, n, n/nprocs } );
+    db->putVector<double>( "L", { 1, 1, 1 } );
+    return db;
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestEikonal	\n");
+			printf("********************************************************\n");
+		}
+		int n = 40;
+		auto db = loadInputs( nprocs, n );
+		Domain Dm(db,comm);
+		int Nx = Dm.Nx, Ny = Dm.Ny, Nz = Dm.Nz;
+		double R = 0.3*n, c = 0.5*n;
+		DoubleArray TrueDist(Nx,Ny,Nz);
+		Array<char> id(Nx,Ny,Nz);
+		for (int k=0; k<Nz; k++){
+			for (int j=0; j<Ny; j++){
+				for (int i=0; i<Nx; i++){
+					double x = i-1, y = j-1, z = Dm.kproc()*(Nz-2)+k-1;
+					TrueDist(i,j,k) = sqrt((x-c)*(x-c)+(y-c)*(y-c)+(z-c)*(z-c)) - R;
+					id(i,j,k) = TrueDist(i,j,k) > 0.0 ? 1 : 0;
+				}
+			}
+		}
+		double band[2] = { 0.0, 4.0 };
+		for (int b=0; b<2; b++){
+			// level set with the same zero contour and a gradient between 0.8 and 1.2
+			DoubleArray Distance(Nx,Ny,Nz);
+			for (int k=0; k<Nz; k++){
+				for (int j=0; j<Ny; j++){
+					for (int i=0; i<Nx; i++){
+						double x = i-1;
+						Distance(i,j,k) = TrueDist(i,j,k)*(1.0+0.2*sin(0.3*x));
+					}
+				}
+			}
+			double starttime = MPI_Wtime();
+			Eikonal(Distance,id,Dm,100,{false,false,false},band[b]);
+			double walltime = MPI_Wtime() - starttime;
+			// first order upwinding overestimates the distance away from the surface, so the
+			// maximum error is checked within three cells and the mean error in the band
+			double error = 0.0, mean = 0.0, count = 0.0;
+			for (int k=1; k<Nz-1; k++){
+				for (int j=1; j<Ny-1; j++){
+					for (int i=1; i<Nx-1; i++){
+						double exact = TrueDist(i,j,k);
+						if (band[b] > 0.0 && fabs(exact) > band[b]-1.0){
+							// cells outside the band are clamped
+							if (fabs(exact) > band[b]+1.0 && fabs(fabs(Distance(i,j,k))-band[b]) > 0.0) error = 1e10;
+							continue;
+						}
+						if (fabs(exact) < 3.0) error = std::max(error,fabs(Distance(i,j,k)-exact));
+						mean += fabs(Distance(i,j,k)-exact);
+						count += 1.0;
+					}
+				}
+			}
+			error = maxReduce( comm, error );
+			mean = sumReduce( comm, mean ) / sumReduce( comm, count );
+			if (rank == 0) printf("band = %f: max error near the surface = %f, mean error = %f (%f s) \n",band[b],error,mean,walltime);
+			if (!(error < 0.6 && mean < 0.25)) check++;
+		}
+		if (rank == 0){
+			if (check == 0) printf("PASS: Eikonal matches the distance to the sphere \n");
+			else printf("FAIL: Eikonal differs from the distance to the sphere \n");
+		}
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
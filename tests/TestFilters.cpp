@@ -0,0 +1,144 @@
+//*************************************************************************
+// Test of the median and non-local means filters (analysis/filters.h)
+// Both filters are applied to a random image and compared against a
+// brute force median (full sort of each window) and the brute force
+// window means and weights of the non-local means
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include "common/Array.h"
+#include "common/MPI_Helpers.h"
+#include "analysis/filters.h"
+
+// Brute force median of the 3x3x3 windows
+void ReferenceMed3D( const Array<float> &Input, Array<float> &Output ){
+	int Nx = int(Input.size(0)), Ny = int(Input.size(1)), Nz = int(Input.size(2));
+	std::vector<float> List(27);
+	for (int k=1; k<Nz-1; k++){
+		for (int j=1; j<Ny-1; j++){
+			for (int i=1; i<Nx-1; i++){
+				int Number=0;
+				for (int kk=k-1; kk<k+2; kk++)
+					for (int jj=j-1; jj<j+2; jj++)
+						for (int ii=i-1; ii<i+2; ii++)
+							List[Number++] = Input(ii,jj,kk);
+				std::sort(List.begin(),List.end());
+				Output(i,j,k) = List[13];
+			}
+		}
+	}
+}
+
+// Brute force window means and non-local means
+void ReferenceNLM3D( const Array<float> &Input, Array<float> &Mean, 
+    const Array<float> &Distance, Array<float> &Output, const int d, const float h){
+	int Nx = int(Input.size(0)), Ny = int(Input.size(1)), Nz = int(Input.size(2));
+	for (int k=1; k<Nz-1; k++){
+		for (int j=1; j<Ny-1; j++){
+			for (int i=1; i<Nx-1; i++){
+				double sum = 0, weight = 0;
+				for (int kk=std::max(0,k-d); kk<std::min(Nz-1,k+d); kk++)
+					for (int jj=std::max(0,j-d); jj<std::min(Ny-1,j+d); jj++)
+						for (int ii=std::max(0,i-d); ii<std::min(Nx-1,i+d); ii++){
+							sum += Input(ii,jj,kk);
+							weight++;
+						}
+				Mean(i,j,k) = sum / weight;
+			}
+		}
+	}
+	for (int k=1; k<Nz-1; k++){
+		for (int j=1; j<Ny-1; j++){
+			for (int i=1; i<Nx-1; i++){
+				if (!(fabs(Distance(i,j,k)) < d)){
+					Output(i,j,k) = Mean(i,j,k);
+					continue;
+				}
+				double sum = 0, weight = 0;
+				for (int kk=std::max(0,k-d); kk<std::min(Nz-1,k+d); kk++)
+					for (int jj=std::max(0,j-d); jj<std::min(Ny-1,j+d); jj++)
+						for (int ii=std::max(0,i-d); ii<std::min(Nx-1,i+d); ii++){
+							double tmp = Mean(i,j,k) - Mean(ii,jj,kk);
+							sum += exp(-tmp*tmp*h)*Input(ii,jj,kk);
+							weight += exp(-tmp*tmp*h);
+						}
+				Output(i,j,k) = sum / weight;
+			}
+		}
+	}
+}
+
+double MaxDifference( const Array<float> &x, const Array<float> &y ){
+	double error = 0.0;
+	for (size_t k=1; k<x.size(2)-1; k++)
+		for (size_t j=1; j<x.size(1)-1; j++)
+			for (size_t i=1; i<x.size(0)-1; i++)
+				error = std::max(error,fabs(double(x(i,j,k))-double(y(i,j,k))));
+	return error;
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestFilters	\n");
+			printf("********************************************************\n");
+		}
+		int Nx = 37, Ny = 30, Nz = 26;
+		Array<float> Input(Nx,Ny,Nz), Distance(Nx,Ny,Nz);
+		srand(1234);
+		for (size_t n=0; n<Input.length(); n++){
+			// repeated values exercise ties in the median
+			Input(n) = float(rand()%50)/49.0f;
+			Distance(n) = 8.0f*float(rand())/RAND_MAX - 4.0f;
+		}
+
+		// Median filter
+		Array<float> Med(Nx,Ny,Nz), MedRef(Nx,Ny,Nz);
+		Med.fill(0); MedRef.fill(0);
+		double starttime = MPI_Wtime();
+		Med3D( Input, Med );
+		double walltime = MPI_Wtime() - starttime;
+		ReferenceMed3D( Input, MedRef );
+		double error = MaxDifference( Med, MedRef );
+		if (rank == 0) printf("Med3D: max difference = %e (%f s) \n",error,walltime);
+		if (error > 0.0) check++;
+
+		// Non-local means
+		for (int d=1; d<4; d++){
+			Array<float> Mean(Nx,Ny,Nz), MeanRef(Nx,Ny,Nz), NLM(Nx,Ny,Nz), NLMRef(Nx,Ny,Nz);
+			Mean.fill(0.5); MeanRef.fill(0.5);
+			float h = 10.0;
+			starttime = MPI_Wtime();
+			NLM3D( Input, Mean, Distance, NLM, d, h );
+			walltime = MPI_Wtime() - starttime;
+			ReferenceNLM3D( Input, MeanRef, Distance, NLMRef, d, h );
+			double error_mean = MaxDifference( Mean, MeanRef );
+			double error_nlm = MaxDifference( NLM, NLMRef );
+			if (rank == 0) printf("NLM3D (d = %i): max difference in mean = %e, output = %e (%f s) \n",d,error_mean,error_nlm,walltime);
+			if (error_mean > 1e-6 || error_nlm > 1e-5) check++;
+		}
+
+		if (rank == 0){
+			if (check == 0) printf("PASS: filters match the brute force filters \n");
+			else printf("FAIL: filters differ from the brute force filters \n");
+		}
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
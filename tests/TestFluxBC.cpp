@@ -8,7 +8,9 @@ std::shared_ptr<Database> loadInputs( int nprocs )
   //auto db = std::make_shared<Database>( "Domain.in" );
     auto db = std::make_shared<Database>();
     db->putScalar<int>( "BC", 0 );
-    db->putVector<int>( "nproc", { 1, 1, 1 } );
+    // split the inlet over two ranks in y and the rest of the ranks in z
+    int py = (nprocs > 1) ? 2 : 1;
+    db->putVector<int>( "nproc", { 1, py, nprocs/py } );
     db->putVector<int>( "n", { 16, 16, 16 } );
     db->putScalar<int>( "nspheres", 1 );
     db->putVector<double>( "L", { 1, 1, 1 } );
@@ -26,10 +28,6 @@ int main (int argc, char **argv)
 	// Note: the error code should be consistent across all processors
 	int error = 0;
 
-	if (nprocs != 1){
-		printf("FAIL: Unit test TestFluxBC requires 1 MPI process! \n");
-		ASSERT(nprocs==1);
-	}
 	{
 	  int i,j,k,n,Np;
 		double din,dout;
@@ -138,14 +136,14 @@ int main (int argc, char **argv)
 
 		din = ScaLBL_Comm->D3Q19_Flux_BC_z(NeighborList, fq, flux, timestep);
 		
-		printf("Computed pressure for flux = %f\n",din);
+		if (rank==0) printf("Computed pressure for flux = %f\n",din);
 		
-		printf("Compute velocity \n");
+		if (rank==0) printf("Compute velocity \n");
 		double *dvc_vel;
 		ScaLBL_AllocateDeviceMemory((void **) &dvc_vel, 3*Np*sizeof(double));
 		ScaLBL_D3Q19_Momentum(fq,dvc_vel,Np);
 
-		printf("Copying velocity to host \n");
+		if (rank==0) printf("Copying velocity to host \n");
     	double *VEL;
     	VEL= new double [3*Np];
     	int SIZE=3*Np*sizeof(double);
@@ -154,7 +152,7 @@ int main (int argc, char **argv)
 
     	double Q = 0.f;    	
     	k=1;
-    	for (j=1;j<Ny-1;j++){
+    	for (j=1;j<Ny-1 && Dm->kproc()==0;j++){
     		for (i=1;i<Nx-1;i++){
     			n = k*Nx*Ny+j*Nx+i;
     			if (Dm->id[n] > 0){
@@ -163,13 +161,15 @@ int main (int argc, char **argv)
     			}
     		}
     	}
+    	Q = sumReduce( comm, Q );
 
     	// respect backwards read / write!!!
-		printf("Inlet Flux: input=%f, output=%f \n",flux,Q);
+		if (rank==0) printf("Inlet Flux: input=%f, output=%f \n",flux,Q);
+		// the inlet velocities are differences of O(1) distributions, so the roundoff grows with the inlet area
 		double err = fabs(flux + Q);
-		if (err > 1e-12){
+		if (err > 1e-10){
 			error = 1;
-			printf("  Inlet error %f \n",err);
+			if (rank==0) printf("  Inlet error %e \n",err);
 		}		
 		
 		// Consider a larger number of timesteps and simulate flow
@@ -182,7 +182,7 @@ int main (int argc, char **argv)
 		Fx = 0; Fy = 0; Fz = 0.f;
 		ScaLBL_D3Q19_Init(fq, Np);
 		timestep=1;
-		printf("*** Running 2000 timesteps as a test *** \n");
+		if (rank==0) printf("*** Running 2000 timesteps as a test *** \n");
 
 		while (timestep < 2000) {
 
@@ -207,45 +207,47 @@ int main (int argc, char **argv)
 
 		}
 		
-		printf("Compute velocity \n");
+		if (rank==0) printf("Compute velocity \n");
 		ScaLBL_D3Q19_Momentum(fq,dvc_vel,Np);
 
-		printf("Copying velocity to host \n");
+		if (rank==0) printf("Copying velocity to host \n");
 		ScaLBL_CopyToHost(&VEL[0],&dvc_vel[0],SIZE);
 
-		printf("Printing velocity profile \n");
-		j=4;
-		for (k=1;k<Nz-1;k++){
-			for (i=1;i<Nx-1;i++){ 
-				n = k*Nx*Ny+j*Nx+i;
-				if (Dm->id[n] > 0){
-					int idx = Map(i,j,k);
-					double vz = VEL[2*Np+idx];
-					printf("%f ",vz);
+		if (nprocs==1){
+			printf("Printing velocity profile \n");
+			j=4;
+			for (k=1;k<Nz-1;k++){
+				for (i=1;i<Nx-1;i++){ 
+					n = k*Nx*Ny+j*Nx+i;
+					if (Dm->id[n] > 0){
+						int idx = Map(i,j,k);
+						double vz = VEL[2*Np+idx];
+						printf("%f ",vz);
+					}
 				}
+				printf("\n");
 			}
-			printf("\n");
-		}
 		
 
 
-		printf("Printing INLET  velocity profile \n");
-		k=1;
-		for (j=1;j<Ny-1;j++){
-			for (i=1;i<Nx-1;i++){ 
-				n = k*Nx*Ny+j*Nx+i;
-				if (Dm->id[n] > 0){
-					int idx = Map(i,j,k);
-					double vz = VEL[2*Np+idx];
-					printf("%f ",vz);
+			printf("Printing INLET  velocity profile \n");
+			k=1;
+			for (j=1;j<Ny-1;j++){
+				for (i=1;i<Nx-1;i++){ 
+					n = k*Nx*Ny+j*Nx+i;
+					if (Dm->id[n] > 0){
+						int idx = Map(i,j,k);
+						double vz = VEL[2*Np+idx];
+						printf("%f ",vz);
+					}
 				}
+				printf("\n");
 			}
-			printf("\n");
 		}
-		
+
     	Q = 0.f;    	
     	k=1;
-    	for (j=1;j<Ny-1;j++){
+    	for (j=1;j<Ny-1 && Dm->kproc()==0;j++){
     		for (i=1;i<Nx-1;i++){
     			n = k*Nx*Ny+j*Nx+i;
     			if (Dm->id[n] > 0){
@@ -254,12 +256,13 @@ int main (int argc, char **argv)
     			}
     		}
     	}
+    	Q = sumReduce( comm, Q );
 
-		printf("Inlet Flux: input=%f, output=%f \n",flux,Q);
+		if (rank==0) printf("Inlet Flux: input=%f, output=%f \n",flux,Q);
 		err = fabs(flux - Q);
-		if (err > 1e-12){
+		if (err > 1e-10){
 			error = 1;
-			printf("  Inlet error %f \n",err);
+			if (rank==0) printf("  Inlet error %e \n",err);
 		}
 		
 
@@ -0,0 +1,179 @@
+//*************************************************************************
+// Test of the global blob ids (ComputeGlobalBlobIDs in analysis/analysis.h)
+// A random periodic two-phase image with solid is labeled on several
+// decompositions and compared against the labels of the full image computed
+// on a single rank (whose blob sizes are checked with a flood fill): the
+// blobs must be the same sets of cells, numbered by decreasing size
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "analysis/analysis.h"
+#include "common/MPI_Helpers.h"
+#include "common/Utilities.h"
+
+// Periodic random field of about eight cells wavelength
+struct RandomField {
+	std::vector<double> kx, ky, kz, phase;
+	RandomField( int n, int Nwaves, int seed ){
+		srand(seed);
+		for (int m=0; m<Nwaves; m++){
+			kx.push_back(2.0*M_PI*(rand()%(2*(n/8)+1) - n/8)/n);
+			ky.push_back(2.0*M_PI*(rand()%(2*(n/8)+1) - n/8)/n);
+			kz.push_back(2.0*M_PI*(rand()%(2*(n/8)+1) - n/8)/n);
+			phase.push_back(2.0*M_PI*double(rand())/RAND_MAX);
+		}
+	}
+	double operator()( int x, int y, int z ) const {
+		double value = 0.0;
+		for (size_t m=0; m<kx.size(); m++) value += cos(kx[m]*x+ky[m]*y+kz[m]*z+phase[m]);
+		return value;
+	}
+};
+
+// Sizes of the periodic 6-connected components of the full image, largest first
+std::vector<int64_t> FloodFillSizes( int n )
+{
+	RandomField fluid(n,16,1234), solid(n,16,4321);
+	std::vector<char> isPhase(n*n*n);
+	for (int k=0; k<n; k++)
+		for (int j=0; j<n; j++)
+			for (int i=0; i<n; i++)
+				isPhase[k*n*n+j*n+i] = (fluid(i,j,k) > 0.0 && solid(i,j,k)+2.0 > 0.0) ? 1 : 0;
+	std::vector<int64_t> sizes;
+	std::vector<int> stack;
+	for (int start=0; start<n*n*n; start++){
+		if (!isPhase[start]) continue;
+		int64_t size = 0;
+		isPhase[start] = 0;
+		stack.push_back(start);
+		while (!stack.empty()){
+			int p = stack.back();
+			stack.pop_back();
+			size++;
+			int i = p%n, j = (p/n)%n, k = p/(n*n);
+			int neighbors[6] = { k*n*n+j*n+(i+1)%n, k*n*n+j*n+(i+n-1)%n, k*n*n+((j+1)%n)*n+i,
+				k*n*n+((j+n-1)%n)*n+i, ((k+1)%n)*n*n+j*n+i, ((k+n-1)%n)*n*n+j*n+i };
+			for (int q=0; q<6; q++){
+				if (isPhase[neighbors[q]]){
+					isPhase[neighbors[q]] = 0;
+					stack.push_back(neighbors[q]);
+				}
+			}
+		}
+		sizes.push_back(size);
+	}
+	std::sort(sizes.rbegin(),sizes.rend());
+	return sizes;
+}
+
+// Label the image of size n^3 on the process grid nproc
+int GlobalIDs( const std::vector<int> &nproc, int n, MPI_Comm comm, BlobIDArray &GlobalBlobID, int &x0, int &y0, int &z0 )
+{
+	int rank = comm_rank(comm);
+	RankInfoStruct rank_info(rank,nproc[0],nproc[1],nproc[2]);
+	int nx = n/nproc[0], ny = n/nproc[1], nz = n/nproc[2];
+	x0 = rank_info.ix*nx; y0 = rank_info.jy*ny; z0 = rank_info.kz*nz;
+	RandomField fluid(n,16,1234), solid(n,16,4321);
+	DoubleArray Phase(nx+2,ny+2,nz+2), SignDist(nx+2,ny+2,nz+2);
+	for (int k=0; k<nz+2; k++){
+		for (int j=0; j<ny+2; j++){
+			for (int i=0; i<nx+2; i++){
+				int x = (x0+i-1+n)%n, y = (y0+j-1+n)%n, z = (z0+k-1+n)%n;
+				Phase(i,j,k) = fluid(x,y,z);
+				SignDist(i,j,k) = solid(x,y,z) + 2.0;
+			}
+		}
+	}
+	return ComputeGlobalBlobIDs(nx,ny,nz,rank_info,Phase,SignDist,0.0,0.0,GlobalBlobID,comm);
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestGlobalBlobIDs	\n");
+			printf("********************************************************\n");
+		}
+		int n = 48;
+		// Reference labels of the full image
+		BlobIDArray Reference;
+		int x0, y0, z0;
+		int nref = GlobalIDs({1,1,1},n,MPI_COMM_SELF,Reference,x0,y0,z0);
+		std::vector<int64_t> ref_size(nref,0);
+		for (int k=1; k<=n; k++)
+			for (int j=1; j<=n; j++)
+				for (int i=1; i<=n; i++)
+					if (Reference(i,j,k) >= 0) ref_size[Reference(i,j,k)]++;
+		if (rank == 0) printf("%i blobs in the full image, largest has %i cells \n",nref,nref>0?int(ref_size[0]):0);
+		if (FloodFillSizes(n) != ref_size){
+			if (rank == 0) printf("Blob sizes of the full image differ from a flood fill \n");
+			check++;
+		}
+		std::vector<std::vector<int>> decomp = { { nprocs, 1, 1 }, { 1, nprocs, 1 }, { 1, 1, nprocs } };
+		if (nprocs == 4) decomp.push_back( { 2, 1, 2 } );
+		for (auto &nproc : decomp){
+			BlobIDArray GlobalBlobID;
+			double starttime = MPI_Wtime();
+			int nblobs = GlobalIDs(nproc,n,comm,GlobalBlobID,x0,y0,z0);
+			double walltime = MPI_Wtime() - starttime;
+			int nx = n/nproc[0], ny = n/nproc[1], nz = n/nproc[2];
+			// Each blob must map to a single reference blob of the same size (ids of blobs
+			// with the same size may differ), and the blob sizes must decrease with the id
+			int errors = (nblobs == nref) ? 0 : 1;
+			std::vector<double> size(nblobs,0.0), match(nblobs,-1.0);
+			for (int k=1; k<=nz; k++){
+				for (int j=1; j<=ny; j++){
+					for (int i=1; i<=nx; i++){
+						int id = GlobalBlobID(i,j,k);
+						int id0 = Reference(x0+i,y0+j,z0+k);
+						if ((id < 0) != (id0 < 0) || id >= nblobs){
+							errors++;
+							continue;
+						}
+						if (id < 0) continue;
+						size[id] += 1.0;
+						if (match[id] < 0.0) match[id] = id0;
+						else if (match[id] != id0) errors++;
+					}
+				}
+			}
+			std::vector<double> global_size(nblobs,0.0), global_match(nblobs,0.0);
+			MPI_Allreduce(size.data(),global_size.data(),nblobs,MPI_DOUBLE,MPI_SUM,comm);
+			MPI_Allreduce(match.data(),global_match.data(),nblobs,MPI_DOUBLE,MPI_MAX,comm);
+			for (int id=0; id<nblobs && id<nref; id++){
+				if (global_size[id] != ref_size[id]) errors++;
+				int id0 = int(global_match[id]);
+				if (id0 < 0 || ref_size[id0] != ref_size[id]) errors++;
+			}
+			// the reference blob of each blob must be the same on every rank
+			for (int id=0; id<nblobs; id++){
+				if (match[id] >= 0.0 && match[id] != global_match[id]) errors++;
+			}
+			errors = sumReduce( comm, errors );
+			if (rank == 0) printf("nproc = %i,%i,%i: %i blobs, %i errors (%f s) \n",
+				nproc[0],nproc[1],nproc[2],nblobs,errors,walltime);
+			if (errors > 0) check++;
+		}
+		if (rank == 0){
+			if (check == 0) printf("PASS: global blob ids match the full image \n");
+			else printf("FAIL: global blob ids differ from the full image \n");
+		}
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
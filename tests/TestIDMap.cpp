@@ -0,0 +1,100 @@
+//*************************************************************************
+// Test of the blob id map between timesteps (computeIDMap in analysis/analysis.h)
+// Two synthetic id fields with known 1-1 mappings, created and destroyed
+// blobs, a split, a merge and a merge/split are decomposed along each
+// direction; every rank must get the same map with the exact overlaps
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "analysis/analysis.h"
+#include "common/MPI_Helpers.h"
+#include "common/Utilities.h"
+
+// Ids of the cell (x,y,z) in the two fields: blocks of two cells in x with a different event each
+void getIDs( int x, int y, int z, int& id1, int& id2 )
+{
+	int block = x/2;
+	bool ly = y < 8, lz = z < 8;
+	switch (block){
+		case 0: id1 = 0;           id2 = 0;           break;   // 1-1
+		case 1: id1 = 1;           id2 = ly ? 1 : 2;  break;   // split
+		case 2: id1 = ly ? 2 : 3;  id2 = 3;           break;   // merge
+		case 3: id1 = ly ? 4 : 5;  id2 = lz ? 4 : 5;  break;   // merge/split
+		case 4: id1 = 6;           id2 = -1;          break;   // destroyed
+		case 5: id1 = -1;          id2 = 6;           break;   // created
+		case 6: id1 = 7;           id2 = 8;           break;   // 1-1
+		default: id1 = 8;          id2 = 7;           break;   // 1-1
+	}
+}
+
+// Compare the map with the expected map
+int checkMap( const ID_map_struct& map )
+{
+	typedef std::vector<BlobIDType> ids;
+	int errors = 0;
+	std::vector<std::pair<BlobIDType,BlobIDType> > src_dst = { {0,0}, {8,7}, {7,8} };
+	if ( map.src_dst != src_dst ) errors++;
+	if ( map.created != ids({6}) ) errors++;
+	if ( map.destroyed != ids({6}) ) errors++;
+	if ( map.split.size()!=1 || map.split[0] != BlobIDSplitStruct(1,ids({1,2})) ) errors++;
+	if ( map.merge.size()!=1 || map.merge[0] != BlobIDMergeStruct(ids({2,3}),3) ) errors++;
+	if ( map.merge_split.size()!=1 || map.merge_split[0] != BlobIDMergeSplitStruct(ids({4,5}),ids({4,5})) ) errors++;
+	std::map<OverlapID,int64_t> overlap = { { {1,1}, 256 }, { {1,2}, 256 }, { {2,3}, 256 }, { {3,3}, 256 },
+		{ {4,4}, 128 }, { {4,5}, 128 }, { {5,4}, 128 }, { {5,5}, 128 } };
+	if ( map.overlap != overlap ) errors++;
+	return errors;
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestIDMap	\n");
+			printf("********************************************************\n");
+		}
+		int n = 16;
+		std::vector<std::vector<int>> decomp = { { nprocs, 1, 1 }, { 1, nprocs, 1 }, { 1, 1, nprocs } };
+		for (auto &nproc : decomp){
+			RankInfoStruct rank_info(rank,nproc[0],nproc[1],nproc[2]);
+			int nx = n/nproc[0], ny = n/nproc[1], nz = n/nproc[2];
+			int x0 = rank_info.ix*nx, y0 = rank_info.jy*ny, z0 = rank_info.kz*nz;
+			// The ghost cells hold ids that must be ignored
+			BlobIDArray ID1(nx+2,ny+2,nz+2), ID2(nx+2,ny+2,nz+2);
+			ID1.fill(99);
+			ID2.fill(99);
+			for (int k=1; k<=nz; k++){
+				for (int j=1; j<=ny; j++){
+					for (int i=1; i<=nx; i++){
+						int id1, id2;
+						getIDs(x0+i-1,y0+j-1,z0+k-1,id1,id2);
+						ID1(i,j,k) = id1;
+						ID2(i,j,k) = id2;
+					}
+				}
+			}
+			ID_map_struct map = computeIDMap(nx,ny,nz,ID1,ID2,comm);
+			int errors = sumReduce( comm, checkMap(map) );
+			if (rank == 0) printf("nproc = %i,%i,%i: %i errors \n",nproc[0],nproc[1],nproc[2],errors);
+			if (errors > 0) check++;
+		}
+		if (rank == 0){
+			if (check == 0) printf("PASS: blob id map matches the expected map \n");
+			else printf("FAIL: blob id map differs from the expected map \n");
+		}
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
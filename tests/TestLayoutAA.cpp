@@ -0,0 +1,207 @@
+//*************************************************************************
+// Benchmark for the site ordering used by MemoryOptimizedLayoutAA
+// Runs the MRT model on a random sphere packing with each Layout option,
+// reports MLUPS and the locality of the neighbor list, and checks that
+// every layout produces the same distributions (to round-off)
+//   usage: TestLayoutAA [n] [timesteps] [porosity]
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "common/ScaLBL.h"
+#include "common/MPI_Helpers.h"
+#include "models/MRTModel.h"
+
+std::shared_ptr<Database> loadInputs( int nprocs, int n, int timesteps, const std::string &layout )
+{
+    auto domain_db = std::make_shared<Database>();
+    domain_db->putScalar<int>( "BC", 0 );
+    domain_db->putVector<int>( "nproc", { 1, 1, nprocs } );
+    domain_db->putVector<int>( "n", { n, n, n } );
+    domain_db->putVector<double>( "L", { 1, 1, 1 } );
+    domain_db->putScalar<std::string>( "Layout", layout );
+    auto mrt_db = std::make_shared<Database>();
+    mrt_db->putScalar<double>( "tau", 0.7 );
+    mrt_db->putVector<double>( "F", { 0, 0, 1.0e-5 } );
+    mrt_db->putScalar<int>( "timestepMax", timesteps );
+    auto db = std::make_shared<Database>();
+    db->putDatabase( "Domain", domain_db );
+    db->putDatabase( "MRT", mrt_db );
+    return db;
+}
+
+// Overlapping solid spheres placed until the porosity drops below the target
+void SpherePack(ScaLBL_MRTModel &MRT, double porosity, int rank){
+	int Nx = MRT.Nx;
+	int Ny = MRT.Ny;
+	int Nz = MRT.Nz;
+	int N = Nx*Ny*Nz;
+	double radius = 0.08*Nx;
+	for (int n=0; n<N; n++) MRT.Mask->id[n] = 1;
+	srand(1234+rank);
+	double solid = 0.0;
+	while (1.0-solid/double(N) > porosity){
+		double cx = Nx*double(rand())/RAND_MAX;
+		double cy = Ny*double(rand())/RAND_MAX;
+		double cz = Nz*double(rand())/RAND_MAX;
+		for (int k=0;k<Nz;k++){
+			for (int j=0;j<Ny;j++){
+				for (int i=0;i<Nx;i++){
+					int n = k*Nx*Ny+j*Nx+i;
+					double dist = sqrt((i-cx)*(i-cx)+(j-cy)*(j-cy)+(k-cz)*(k-cz));
+					if (dist < radius && MRT.Mask->id[n] > 0){
+						MRT.Mask->id[n] = 0;
+						solid += 1.0;
+					}
+				}
+			}
+		}
+	}
+	for (int k=0;k<Nz;k++){
+		for (int j=0;j<Ny;j++){
+			for (int i=0;i<Nx;i++){
+				int n = k*Nx*Ny+j*Nx+i;
+				MRT.Distance(i,j,k) = (MRT.Mask->id[n] > 0) ? 1.0 : -1.0;
+			}
+		}
+	}
+}
+
+// Time loop from ScaLBL_MRTModel::Run without the analysis
+double TimedRun(ScaLBL_MRTModel &MRT, MPI_Comm comm){
+	double rlx_setA=1.0/MRT.tau;
+	double rlx_setB = 8.f*(2.f-rlx_setA)/(8.f-rlx_setA);
+	auto ScaLBL_Comm = MRT.ScaLBL_Comm;
+	int Np = MRT.Np;
+	MPI_Barrier(comm);
+	double starttime = MPI_Wtime();
+	MRT.timestep=0;
+	while (MRT.timestep < MRT.timestepMax) {
+		MRT.timestep++;
+		ScaLBL_Comm->SendD3Q19AA(MRT.fq);
+		ScaLBL_D3Q19_AAodd_MRT(MRT.NeighborList, MRT.fq,  ScaLBL_Comm->FirstInterior(), ScaLBL_Comm->LastInterior(), Np, rlx_setA, rlx_setB, MRT.Fx, MRT.Fy, MRT.Fz);
+		ScaLBL_Comm->RecvD3Q19AA(MRT.fq);
+		ScaLBL_D3Q19_AAodd_MRT(MRT.NeighborList, MRT.fq, 0, ScaLBL_Comm->LastExterior(), Np, rlx_setA, rlx_setB, MRT.Fx, MRT.Fy, MRT.Fz);
+		ScaLBL_DeviceBarrier();
+		MRT.timestep++;
+		ScaLBL_Comm->SendD3Q19AA(MRT.fq);
+		ScaLBL_D3Q19_AAeven_MRT(MRT.fq, ScaLBL_Comm->FirstInterior(), ScaLBL_Comm->LastInterior(), Np, rlx_setA, rlx_setB, MRT.Fx, MRT.Fy, MRT.Fz);
+		ScaLBL_Comm->RecvD3Q19AA(MRT.fq);
+		ScaLBL_D3Q19_AAeven_MRT(MRT.fq, 0, ScaLBL_Comm->LastExterior(), Np, rlx_setA, rlx_setB, MRT.Fx, MRT.Fy, MRT.Fz);
+		ScaLBL_DeviceBarrier();
+	}
+	MPI_Barrier(comm);
+	return MPI_Wtime() - starttime;
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		int n = 48;
+		int timesteps = 10;
+		double porosity = 0.35;
+		if (argc > 1) n = atoi(argv[1]);
+		if (argc > 2) timesteps = atoi(argv[2]);
+		if (argc > 3) porosity = atof(argv[3]);
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestLayoutAA	\n");
+			printf("   sub-domain %i^3, %i timesteps, porosity %f \n",n,timesteps,porosity);
+			printf("********************************************************\n");
+		}
+		const char *layouts[4] = { "lexicographic", "morton", "hilbert", "brick" };
+		std::vector<double> reference;
+		for (int l=0; l<4; l++){
+			auto db = loadInputs( nprocs, n, timesteps, layouts[l] );
+			ScaLBL_MRTModel MRT(rank,nprocs,comm);
+			MRT.ReadParams(db);
+			MRT.SetDomain();
+			SpherePack(MRT,porosity,rank);
+			MRT.Create();
+			MRT.Initialize();
+			double walltime = TimedRun(MRT,comm);
+			int Np = MRT.Np;
+			int Nx = MRT.Nx;
+			int Ny = MRT.Ny;
+			int Nz = MRT.Nz;
+			int N = Nx*Ny*Nz;
+
+			// Locality of the neighbor reads: distinct 64 byte cache lines touched by each block of 256 sites
+			int *neighborList = new int[18*Np];
+			ScaLBL_CopyToHost(neighborList,MRT.NeighborList,18*Np*sizeof(int));
+			double lines = 0.0;
+			std::vector<int> block;
+			int ranges[2][2] = { { 0, MRT.ScaLBL_Comm->LastExterior() },
+					{ MRT.ScaLBL_Comm->FirstInterior(), MRT.ScaLBL_Comm->LastInterior() } };
+			for (int r=0; r<2; r++){
+				for (int start=ranges[r][0]; start<ranges[r][1]; start+=256){
+					int finish = std::min(start+256,ranges[r][1]);
+					block.clear();
+					for (int idx=start; idx<finish; idx++){
+						for (int q=0; q<18; q++) block.push_back(neighborList[q*Np+idx]/8);
+					}
+					std::sort(block.begin(),block.end());
+					lines += double(std::unique(block.begin(),block.end()) - block.begin());
+				}
+			}
+			delete [] neighborList;
+			double sites = sumReduce( comm, double(MRT.ScaLBL_Comm->LastExterior() + MRT.ScaLBL_Comm->LastInterior() - MRT.ScaLBL_Comm->FirstInterior()) );
+			lines = sumReduce( comm, lines );
+			double MLUPS = sites*timesteps/walltime/1.0e6;
+			if (rank == 0){
+				printf("%-14s MLUPS = %8.2f   cache lines per site = %6.2f \n",layouts[l],MLUPS,lines/sites);
+			}
+
+			// Distributions in the regular layout must not depend on the ordering
+			double *fq = new double[19*Np];
+			ScaLBL_CopyToHost(fq,MRT.fq,19*Np*sizeof(double));
+			std::vector<double> regular(19*N,0.0);
+			for (int k=1; k<Nz-1; k++){
+				for (int j=1; j<Ny-1; j++){
+					for (int i=1; i<Nx-1; i++){
+						int idx = MRT.Map(i,j,k);
+						if (!(idx<0)){
+							for (int q=0; q<19; q++) regular[q*N+k*Nx*Ny+j*Nx+i] = fq[q*Np+idx];
+						}
+					}
+				}
+			}
+			delete [] fq;
+			if (l == 0){
+				reference = regular;
+			}
+			else {
+				// vectorized kernels may round a site differently depending on its position in the loop
+				int count = 0;
+				for (size_t m=0; m<regular.size(); m++){
+					if (fabs(regular[m]-reference[m]) > 1.0e-12*fabs(reference[m])) count++;
+				}
+				if (count > 0){
+					printf("Rank %i: layout %s differs from lexicographic at %i values \n",rank,layouts[l],count);
+					check++;
+				}
+			}
+		}
+		check = sumReduce( comm, check );
+		if (rank == 0){
+			if (check == 0) printf("PASS: all layouts produce identical distributions \n");
+			else printf("FAIL: layouts produce different distributions \n");
+		}
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
@@ -0,0 +1,137 @@
+//*************************************************************************
+// Regression test for the MRT time loop without per-step global barriers
+// The distributions from ScaLBL_MRTModel::Run must match bit-for-bit
+// the result of the same loop synchronized with MPI_Barrier after each step
+//*************************************************************************
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+#include "common/ScaLBL.h"
+#include "common/MPI_Helpers.h"
+#include "models/MRTModel.h"
+
+std::shared_ptr<Database> loadInputs( int nprocs )
+{
+    auto domain_db = std::make_shared<Database>();
+    domain_db->putScalar<int>( "BC", 0 );
+    domain_db->putVector<int>( "nproc", { 1, 1, nprocs } );
+    domain_db->putVector<int>( "n", { 16, 16, 16 } );
+    domain_db->putVector<double>( "L", { 1, 1, 1 } );
+    auto mrt_db = std::make_shared<Database>();
+    mrt_db->putScalar<double>( "tau", 0.7 );
+    mrt_db->putVector<double>( "F", { 0, 1.0e-6, 1.0e-5 } );
+    mrt_db->putScalar<int>( "timestepMax", 100 );
+    auto db = std::make_shared<Database>();
+    db->putDatabase( "Domain", domain_db );
+    db->putDatabase( "MRT", mrt_db );
+    return db;
+}
+
+void ParallelPlates(ScaLBL_MRTModel &MRT){
+	int Nx = MRT.Nx;
+	int Ny = MRT.Ny;
+	int Nz = MRT.Nz;
+	for (int k=0;k<Nz;k++){
+		for (int j=0;j<Ny;j++){
+			for (int i=0;i<Nx;i++){
+				int n = k*Nx*Ny+j*Nx+i;
+				if (i<2 || i>Nx-3) MRT.Mask->id[n] = 0;
+				else MRT.Mask->id[n] = 1;
+				MRT.Distance(i,j,k) = (MRT.Mask->id[n] > 0) ? 1.0 : -1.0;
+			}
+		}
+	}
+}
+
+// Reference time loop with a global barrier after every half step
+void RunWithBarriers(ScaLBL_MRTModel &MRT, MPI_Comm comm){
+	double rlx_setA=1.0/MRT.tau;
+	double rlx_setB = 8.f*(2.f-rlx_setA)/(8.f-rlx_setA);
+	auto ScaLBL_Comm = MRT.ScaLBL_Comm;
+	int Np = MRT.Np;
+	MRT.timestep=0;
+	while (MRT.timestep < MRT.timestepMax) {
+		MRT.timestep++;
+		ScaLBL_Comm->SendD3Q19AA(MRT.fq);
+		ScaLBL_D3Q19_AAodd_MRT(MRT.NeighborList, MRT.fq,  ScaLBL_Comm->FirstInterior(), ScaLBL_Comm->LastInterior(), Np, rlx_setA, rlx_setB, MRT.Fx, MRT.Fy, MRT.Fz);
+		ScaLBL_Comm->RecvD3Q19AA(MRT.fq);
+		ScaLBL_D3Q19_AAodd_MRT(MRT.NeighborList, MRT.fq, 0, ScaLBL_Comm->LastExterior(), Np, rlx_setA, rlx_setB, MRT.Fx, MRT.Fy, MRT.Fz);
+		ScaLBL_DeviceBarrier(); MPI_Barrier(comm);
+		MRT.timestep++;
+		ScaLBL_Comm->SendD3Q19AA(MRT.fq);
+		ScaLBL_D3Q19_AAeven_MRT(MRT.fq, ScaLBL_Comm->FirstInterior(), ScaLBL_Comm->LastInterior(), Np, rlx_setA, rlx_setB, MRT.Fx, MRT.Fy, MRT.Fz);
+		ScaLBL_Comm->RecvD3Q19AA(MRT.fq);
+		ScaLBL_D3Q19_AAeven_MRT(MRT.fq, 0, ScaLBL_Comm->LastExterior(), Np, rlx_setA, rlx_setB, MRT.Fx, MRT.Fy, MRT.Fz);
+		ScaLBL_DeviceBarrier(); MPI_Barrier(comm);
+	}
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestMRTBarrier	\n");
+			printf("********************************************************\n");
+		}
+		auto db = loadInputs( nprocs );
+
+		// Model time loop (neighbor synchronization only)
+		ScaLBL_MRTModel MRT(rank,nprocs,comm);
+		MRT.ReadParams(db);
+		MRT.SetDomain();
+		ParallelPlates(MRT);
+		MRT.Create();
+		MRT.Initialize();
+		MRT.Run();
+
+		// Reference time loop (global barrier after each step)
+		ScaLBL_MRTModel Ref(rank,nprocs,comm);
+		Ref.ReadParams(db);
+		Ref.SetDomain();
+		ParallelPlates(Ref);
+		Ref.Create();
+		Ref.Initialize();
+		RunWithBarriers(Ref,comm);
+
+		if (MRT.Np != Ref.Np || MRT.timestep != Ref.timestep){
+			printf("Rank %i: layouts differ (Np = %i, %i; timestep = %i, %i) \n",rank,MRT.Np,Ref.Np,MRT.timestep,Ref.timestep);
+			check = 1;
+		}
+		else {
+			size_t size = 19*MRT.Np;
+			double *fq = new double[size];
+			double *fq_ref = new double[size];
+			ScaLBL_CopyToHost(fq,MRT.fq,size*sizeof(double));
+			ScaLBL_CopyToHost(fq_ref,Ref.fq,size*sizeof(double));
+			int count = 0;
+			for (size_t n=0; n<size; n++){
+				if (memcmp(&fq[n],&fq_ref[n],sizeof(double)) != 0) count++;
+			}
+			if (count > 0){
+				printf("Rank %i: %i of %i distribution values differ \n",rank,count,int(size));
+				check = 1;
+			}
+			delete [] fq;
+			delete [] fq_ref;
+		}
+		check = sumReduce( comm, check );
+		if (rank == 0){
+			if (check == 0) printf("PASS: barrier-free time loop is bit-identical \n");
+			else printf("FAIL: barrier-free time loop differs from the synchronized loop \n");
+		}
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
@@ -0,0 +1,207 @@
+//*************************************************************************
+// Validation of the single precision storage mode of the MRT model
+// Poiseuille flow between parallel plates and flow through a sphere pack
+// are run with Precision = "double" and "single"; the velocity fields must
+// agree to the resolution of single precision deviations from rest, and the
+// plates must match the analytical profile of TestPoiseuille in both modes
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include "common/ScaLBL.h"
+#include "common/MPI_Helpers.h"
+#include "models/MRTModel.h"
+
+std::shared_ptr<Database> loadInputs( int nprocs, int n, int timesteps, const std::string &precision )
+{
+    auto domain_db = std::make_shared<Database>();
+    domain_db->putScalar<int>( "BC", 0 );
+    domain_db->putVector<int>( "nproc", { 1, 1, nprocs } );
+    domain_db->putVector<int>( "n", { n, n, n } );
+    domain_db->putVector<double>( "L", { 1, 1, 1 } );
+    auto mrt_db = std::make_shared<Database>();
+    mrt_db->putScalar<double>( "tau", 1.0 );
+    mrt_db->putVector<double>( "F", { 0, 0, 1.0e-5 } );
+    mrt_db->putScalar<int>( "timestepMax", timesteps );
+    mrt_db->putScalar<double>( "tolerance", 0.0 );
+    mrt_db->putScalar<std::string>( "Precision", precision );
+    auto db = std::make_shared<Database>();
+    db->putDatabase( "Domain", domain_db );
+    db->putDatabase( "MRT", mrt_db );
+    return db;
+}
+
+void ParallelPlates(ScaLBL_MRTModel &MRT){
+	int Nx = MRT.Nx;
+	int Ny = MRT.Ny;
+	int Nz = MRT.Nz;
+	for (int k=0;k<Nz;k++){
+		for (int j=0;j<Ny;j++){
+			for (int i=0;i<Nx;i++){
+				int n = k*Nx*Ny+j*Nx+i;
+				if (i<2 || i>Nx-3) MRT.Mask->id[n] = 0;
+				else MRT.Mask->id[n] = 1;
+				MRT.Distance(i,j,k) = (MRT.Mask->id[n] > 0) ? 1.0 : -1.0;
+			}
+		}
+	}
+}
+
+// Overlapping solid spheres placed until the porosity drops below the target
+void SpherePack(ScaLBL_MRTModel &MRT, double porosity, int rank){
+	int Nx = MRT.Nx;
+	int Ny = MRT.Ny;
+	int Nz = MRT.Nz;
+	int N = Nx*Ny*Nz;
+	double radius = 0.15*Nx;
+	for (int n=0; n<N; n++) MRT.Mask->id[n] = 1;
+	srand(1234+rank);
+	double solid = 0.0;
+	while (1.0-solid/double(N) > porosity){
+		double cx = Nx*double(rand())/RAND_MAX;
+		double cy = Ny*double(rand())/RAND_MAX;
+		double cz = Nz*double(rand())/RAND_MAX;
+		for (int k=0;k<Nz;k++){
+			for (int j=0;j<Ny;j++){
+				for (int i=0;i<Nx;i++){
+					int n = k*Nx*Ny+j*Nx+i;
+					double dist = sqrt((i-cx)*(i-cx)+(j-cy)*(j-cy)+(k-cz)*(k-cz));
+					if (dist < radius && MRT.Mask->id[n] > 0){
+						MRT.Mask->id[n] = 0;
+						solid += 1.0;
+					}
+				}
+			}
+		}
+	}
+	for (int k=0;k<Nz;k++){
+		for (int j=0;j<Ny;j++){
+			for (int i=0;i<Nx;i++){
+				int n = k*Nx*Ny+j*Nx+i;
+				MRT.Distance(i,j,k) = (MRT.Mask->id[n] > 0) ? 1.0 : -1.0;
+			}
+		}
+	}
+}
+
+// z velocity in the regular layout (zero in the solid and the halo)
+void VelocityZ(ScaLBL_MRTModel &MRT, DoubleArray &Vz){
+	int Np = MRT.Np;
+	double *Velocity;
+	ScaLBL_AllocateDeviceMemory((void **) &Velocity, 3*sizeof(double)*Np);
+	if (MRT.SinglePrecision) ScaLBL_D3Q19_Momentum_Single(MRT.fq_single,Velocity,Np);
+	else ScaLBL_D3Q19_Momentum(MRT.fq,Velocity,Np);
+	ScaLBL_DeviceBarrier();
+	Vz.resize(MRT.Nx,MRT.Ny,MRT.Nz);
+	Vz.fill(0.0);
+	MRT.ScaLBL_Comm->RegularLayout(MRT.Map,&Velocity[2*Np],Vz);
+	ScaLBL_FreeDeviceMemory(Velocity);
+}
+
+// Runs one geometry in both storage modes and returns the number of failed checks
+int Compare(const char *name, int geometry, int n, int timesteps, int rank, int nprocs, MPI_Comm comm){
+	DoubleArray Vz[2];
+	const char *precision[2] = { "double", "single" };
+	for (int p=0; p<2; p++){
+		auto db = loadInputs( nprocs, n, timesteps, precision[p] );
+		ScaLBL_MRTModel MRT(rank,nprocs,comm);
+		MRT.ReadParams(db);
+		MRT.SetDomain();
+		if (geometry == 0) ParallelPlates(MRT);
+		else SpherePack(MRT,0.6,rank);
+		MRT.Create();
+		MRT.Initialize();
+		MPI_Barrier(comm);
+		double starttime = MPI_Wtime();
+		MRT.Run();
+		double walltime = MPI_Wtime() - starttime;
+		VelocityZ(MRT,Vz[p]);
+		double sites = sumReduce( comm, double(MRT.Np) );
+		if (rank == 0) printf("%s (%s): MLUPS = %f \n",name,precision[p],sites*timesteps/walltime/1.0e6);
+	}
+	int Nx = Vz[0].size(0);
+	int Ny = Vz[0].size(1);
+	int Nz = Vz[0].size(2);
+	double diff = 0.0, norm = 0.0, flow[2] = { 0.0, 0.0 };
+	for (int k=1; k<Nz-1; k++){
+		for (int j=1; j<Ny-1; j++){
+			for (int i=1; i<Nx-1; i++){
+				diff = std::max(diff, fabs(Vz[1](i,j,k)-Vz[0](i,j,k)));
+				norm = std::max(norm, fabs(Vz[0](i,j,k)));
+				flow[0] += Vz[0](i,j,k);
+				flow[1] += Vz[1](i,j,k);
+			}
+		}
+	}
+	diff = maxReduce( comm, diff );
+	norm = maxReduce( comm, norm );
+	flow[0] = sumReduce( comm, flow[0] );
+	flow[1] = sumReduce( comm, flow[1] );
+	int check = 0;
+	if (rank == 0){
+		printf("%s: max |u_single - u_double| / max |u_double| = %e \n",name,diff/norm);
+		printf("%s: flow rate double = %e, single = %e \n",name,flow[0],flow[1]);
+	}
+	if (!(diff < 1.0e-3*norm)) check++;
+	if (!(fabs(flow[1]-flow[0]) < 1.0e-4*fabs(flow[0]))) check++;
+
+	if (geometry == 0){
+		// analytical profile between the plates as in TestPoiseuille (walls half way between the last
+		// solid and first fluid node); both storage modes are checked over the whole channel and the
+		// single precision error may only exceed the discretization error of double storage by round-off
+		double nu = (1.0-0.5)/3.0;
+		double width = Nx-4;
+		double error[2] = { 0.0, 0.0 }, umax = 0.0;
+		for (int k=1; k<Nz-1; k++){
+			for (int j=1; j<Ny-1; j++){
+				for (int i=2; i<Nx-2; i++){
+					double x = i-1.5;
+					double u = 1.0e-5/(2.0*nu)*x*(width-x);
+					for (int p=0; p<2; p++) error[p] = std::max(error[p], fabs(Vz[p](i,j,k)-u));
+					umax = std::max(umax, u);
+				}
+			}
+		}
+		error[0] = maxReduce( comm, error[0] );
+		error[1] = maxReduce( comm, error[1] );
+		umax = maxReduce( comm, umax );
+		if (rank == 0){
+			printf("%s: error relative to the analytical profile, double = %e, single = %e \n",name,error[0]/umax,error[1]/umax);
+		}
+		if (!(error[0] < 2.0e-2*umax)) check++;
+		if (!(error[1] < 2.0e-2*umax)) check++;
+		if (!(error[1] < error[0] + 1.0e-3*umax)) check++;
+	}
+	return check;
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestMRTPrecision	\n");
+			printf("********************************************************\n");
+		}
+		check += Compare("Parallel plates",0,16,3000,rank,nprocs,comm);
+		check += Compare("Sphere pack",1,24,2000,rank,nprocs,comm);
+		if (rank == 0){
+			if (check == 0) printf("PASS: single precision storage matches double precision \n");
+			else printf("FAIL: single precision storage differs from double precision \n");
+		}
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
@@ -0,0 +1,185 @@
+//*************************************************************************
+// Test of the distance map based morphological opening (analysis/morphology.h)
+// A distance field of random balls on a periodic domain is opened in parallel and
+// compared against a serial opening with explicit sphere windows on the full
+// domain.  The one pass curve must reproduce the same configuration when the
+// invasion radius is thresholded at the final critical radius.
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include "common/Domain.h"
+#include "common/MPI_Helpers.h"
+#include "analysis/distance.h"
+#include "analysis/morphology.h"
+
+std::shared_ptr<Database> loadInputs( int nprocs )
+{
+    auto db = std::make_shared<Database>();
+    db->putScalar<int>( "BC", 0 );
+    db->putVector<int>( "nproc", { 1, 1, nprocs } );
+    db->putVector<int>( "n", { 20, 18, 24/nprocs } );
+    db->putVector<double>( "L", { 1, 1, 1 } );
+    return db;
+}
+
+// Serial opening on the full periodic domain with explicit sphere windows
+double ReferenceOpen(const std::vector<double> &dist, std::vector<signed char> &id, int Nx, int Ny, int Nz, double VoidFraction){
+	double total = 0.0, maxdist = -200.0;
+	for (size_t n=0; n<dist.size(); n++){
+		maxdist = std::max(maxdist,dist[n]);
+		if (id[n] == 2) total += 1.0;
+	}
+	double void_fraction = 1.0, Rcrit = maxdist;
+	while (void_fraction > VoidFraction){
+		Rcrit -= 0.05*Rcrit;
+		int W = int(ceil(Rcrit));
+		std::vector<signed char> id0(id);
+		for (int k=0; k<Nz; k++){
+			for (int j=0; j<Ny; j++){
+				for (int i=0; i<Nx; i++){
+					if (!(dist[k*Nx*Ny+j*Nx+i] > Rcrit)) continue;
+					for (int kk=k-W; kk<=k+W; kk++){
+						for (int jj=j-W; jj<=j+W; jj++){
+							for (int ii=i-W; ii<=i+W; ii++){
+								double dsq = double((ii-i)*(ii-i)+(jj-j)*(jj-j)+(kk-k)*(kk-k));
+								int nn = ((kk+Nz)%Nz)*Nx*Ny + ((jj+Ny)%Ny)*Nx + (ii+Nx)%Nx;
+								if (id0[nn] == 2 && dsq <= Rcrit*Rcrit) id[nn] = 1;
+							}
+						}
+					}
+				}
+			}
+		}
+		double count = 0.0;
+		for (size_t n=0; n<id.size(); n++){
+			if (id[n] == 2) count += 1.0;
+		}
+		void_fraction = count/total;
+	}
+	return Rcrit;
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestMorphOpen	\n");
+			printf("********************************************************\n");
+		}
+		// Squared distance transform against brute force
+		Array<double> f(9,7,8);
+		std::vector<int> seeds = { 3, 100, 257, 400 };
+		f.fill(1e50);
+		for (auto s : seeds) f(s) = 0.0;
+		CalcSquaredEDT(f);
+		int count = 0;
+		for (int k=0; k<8; k++){
+			for (int j=0; j<7; j++){
+				for (int i=0; i<9; i++){
+					double d2 = 1e50;
+					for (auto s : seeds){
+						int si = s%9, sj = (s/9)%7, sk = s/63;
+						d2 = std::min(d2,double((i-si)*(i-si)+(j-sj)*(j-sj)+(k-sk)*(k-sk)));
+					}
+					if (f(i,j,k) != d2) count++;
+				}
+			}
+		}
+		if (rank == 0) printf("CalcSquaredEDT: %i values differ \n",count);
+		if (count > 0) check++;
+
+		// Random distance field on the global periodic domain
+		auto db = loadInputs( nprocs );
+		auto Dm = std::make_shared<Domain>(db,comm);
+		int Nx = Dm->Nx, Ny = Dm->Ny, Nz = Dm->Nz;
+		int gx = Nx-2, gy = Ny-2, gz = nprocs*(Nz-2);
+		std::vector<double> dist(gx*gy*gz);
+		// pore space made of overlapping balls with radii between 1.5 and 4.5
+		srand(1234);
+		for (auto &x : dist) x = -1.0;
+		for (int b=0; b<16; b++){
+			double cx = gx*double(rand())/RAND_MAX;
+			double cy = gy*double(rand())/RAND_MAX;
+			double cz = gz*double(rand())/RAND_MAX;
+			double r = 1.5 + 3.0*double(rand())/RAND_MAX;
+			for (int k=0; k<gz; k++){
+				for (int j=0; j<gy; j++){
+					for (int i=0; i<gx; i++){
+						double x = fabs(i-cx), y = fabs(j-cy), z = fabs(k-cz);
+						x = std::min(x,gx-x); y = std::min(y,gy-y); z = std::min(z,gz-z);
+						double &value = dist[k*gx*gy+j*gx+i];
+						value = std::max(value,r-sqrt(x*x+y*y+z*z));
+					}
+				}
+			}
+		}
+		std::vector<signed char> id_ref(dist.size());
+		for (size_t n=0; n<dist.size(); n++) id_ref[n] = dist[n] > 0.0 ? 2 : 0;
+		double VoidFraction = 0.3;
+		double Rcrit = ReferenceOpen(dist,id_ref,gx,gy,gz,VoidFraction);
+
+		DoubleArray SignDist(Nx,Ny,Nz);
+		std::vector<signed char> id(Nx*Ny*Nz), id_curve(Nx*Ny*Nz);
+		auto global = [&](int i, int j, int k) -> int {
+			int x = (i-1+gx)%gx;
+			int y = (j-1+gy)%gy;
+			int z = (Dm->kproc()*(Nz-2)+k-1+gz)%gz;
+			return z*gx*gy+y*gx+x;
+		};
+		for (int k=0; k<Nz; k++){
+			for (int j=0; j<Ny; j++){
+				for (int i=0; i<Nx; i++){
+					int n = k*Nx*Ny+j*Nx+i;
+					SignDist(i,j,k) = dist[global(i,j,k)];
+					id[n] = SignDist(i,j,k) > 0.0 ? 2 : 0;
+					id_curve[n] = id[n];
+				}
+			}
+		}
+		MorphOpen(SignDist,id.data(),Dm,VoidFraction,2,1);
+		DoubleArray Radius;
+		auto curve = MorphOpenCurve(SignDist,id_curve.data(),Dm,2,1,Radius);
+		int count_open = 0, count_curve = 0;
+		for (int k=0; k<Nz; k++){
+			for (int j=0; j<Ny; j++){
+				for (int i=0; i<Nx; i++){
+					int n = k*Nx*Ny+j*Nx+i;
+					signed char ref = id_ref[global(i,j,k)];
+					if (id[n] != ref) count_open++;
+					signed char value = (Radius(i,j,k) >= Rcrit) ? 1 : (SignDist(i,j,k) > 0.0 ? 2 : 0);
+					if (value != ref) count_curve++;
+				}
+			}
+		}
+		count_open = sumReduce( comm, count_open );
+		count_curve = sumReduce( comm, count_curve );
+		if (rank == 0){
+			printf("MorphOpen (critical radius %f): %i values differ \n",Rcrit,count_open);
+			printf("MorphOpenCurve (%i radii): %i values differ \n",int(curve.size()),count_curve);
+		}
+		if (count_open > 0 || count_curve > 0) check++;
+		MPI_Barrier(comm);
+		if (rank == 0) remove("morphopen.csv");
+
+		if (rank == 0){
+			if (check == 0) printf("PASS: morphological opening matches the sphere windows \n");
+			else printf("FAIL: morphological opening differs \n");
+		}
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
@@ -0,0 +1,140 @@
+//*************************************************************************
+// Test of the built-in profiler (common/Profiler.h)
+// Nested regions with known sleep times are timed on every rank, including
+// one region that only some of the ranks enter, one above the enabled level,
+// one timed on another thread and regions whose names are built at run time.
+// The saved times and the report combined over the ranks are checked.
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include "common/Profiler.h"
+#include "common/Utilities.h"
+#include "common/MPI_Helpers.h"
+
+// Read the calls and time of a region from a file written by Profiler::save
+bool ReadRegion( const char *filename, const std::string &region, long long &calls, double &time ){
+	FILE *fid = fopen(filename,"r");
+	if (fid == NULL) return false;
+	char line[512];
+	bool found = false;
+	std::string key = "\"" + region + "\",";
+	while (fgets(line,sizeof(line),fid) != NULL){
+		if (strncmp(line,key.c_str(),key.size()) == 0){
+			found = sscanf(line+key.size(),"%lli,%le",&calls,&time) == 2;
+		}
+	}
+	fclose(fid);
+	return found;
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestProfiler	\n");
+			printf("********************************************************\n");
+		}
+		Utilities::Profiler::reset();
+		Utilities::Profiler::enable(1);
+		Utilities::Profiler::start("outer");
+		for (int n=0; n<4; n++){
+			PROFILE_SCOPED(timer,"inner",1);
+			Utilities::sleep_ms(5);
+		}
+		if (rank%2 == 0){
+			Utilities::Profiler::start("even ranks");
+			Utilities::sleep_ms(10);
+			Utilities::Profiler::stop("even ranks");
+		}
+		Utilities::Profiler::start("ignored",2);
+		Utilities::Profiler::stop("ignored",2);
+		std::thread worker([]{
+			PROFILE_START("thread",1);
+			Utilities::sleep_ms(5);
+			PROFILE_STOP("thread",1);
+		});
+		worker.join();
+		for (int n=0; n<3; n++){
+			// the same call site with a different region each time
+			std::string name = "dynamic " + std::to_string(n%2);
+			PROFILE_START(name,1);
+			PROFILE_STOP(name,1);
+		}
+		Utilities::Profiler::stop("outer");
+		Utilities::Profiler::save("TestProfiler",true);
+
+		char filename[100];
+		sprintf(filename,"TestProfiler.%i.timer",rank);
+		long long calls_inner = 0, calls_outer = 0, calls_ignored = 0;
+		double time_inner = 0.0, time_outer = 0.0, time_ignored = 0.0;
+		bool found_inner = ReadRegion(filename,"inner",calls_inner,time_inner);
+		bool found_outer = ReadRegion(filename,"outer",calls_outer,time_outer);
+		bool found_ignored = ReadRegion(filename,"ignored",calls_ignored,time_ignored);
+		if (!found_inner || calls_inner != 4 || time_inner < 0.019){
+			printf("Rank %i: inner region has %lli calls and %f s \n",rank,calls_inner,time_inner);
+			check++;
+		}
+		if (!found_outer || calls_outer != 1 || time_outer < time_inner){
+			printf("Rank %i: outer region has %lli calls and %f s \n",rank,calls_outer,time_outer);
+			check++;
+		}
+		long long calls_thread = 0, calls_dynamic0 = 0, calls_dynamic1 = 0;
+		double time_thread = 0.0, time_dynamic = 0.0;
+		bool found_thread = ReadRegion(filename,"thread",calls_thread,time_thread);
+		bool found_dynamic = ReadRegion(filename,"dynamic 0",calls_dynamic0,time_dynamic) &&
+			ReadRegion(filename,"dynamic 1",calls_dynamic1,time_dynamic);
+		if (!found_thread || calls_thread != 1 || time_thread < 0.004){
+			printf("Rank %i: thread region has %lli calls and %f s \n",rank,calls_thread,time_thread);
+			check++;
+		}
+		if (!found_dynamic || calls_dynamic0 != 2 || calls_dynamic1 != 1){
+			printf("Rank %i: dynamic regions have %lli and %lli calls \n",rank,calls_dynamic0,calls_dynamic1);
+			check++;
+		}
+		if (found_ignored){
+			printf("Rank %i: region above the enabled level was timed \n",rank);
+			check++;
+		}
+		remove(filename);
+
+		// combined report
+		FILE *fid = (rank == 0) ? tmpfile() : NULL;
+		Utilities::Profiler::report(comm,fid);
+		if (rank == 0){
+			rewind(fid);
+			char line[512];
+			int regions = 0;
+			while (fgets(line,sizeof(line),fid) != NULL){
+				printf("%s",line);
+				if (strstr(line,"inner") || strstr(line,"outer") || strstr(line,"even ranks")) regions++;
+			}
+			fclose(fid);
+			if (regions != 3){
+				printf("Report lists %i of the 3 regions \n",regions);
+				check++;
+			}
+		}
+		check = sumReduce( comm, check );
+		if (rank == 0){
+			if (check == 0) printf("PASS: profiler records the regions \n");
+			else printf("FAIL: profiler regions differ \n");
+		}
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
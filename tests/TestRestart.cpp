@@ -0,0 +1,185 @@
+//*************************************************************************
+// Test of the restart files (common/Restart.h)
+// Writes the densities and distributions with and without O_DIRECT and in
+// the legacy interleaved format, reads them back and compares the values.
+// A shared restart file is written on a z decomposition and read on an x
+// decomposition of the same global domain
+//   usage: TestRestart [Np]
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <vector>
+#include "common/Restart.h"
+#include "common/Communication.h"
+#include "common/MPI_Helpers.h"
+
+// Legacy writer (one write per value, densities then distributions site by site)
+void WriteLegacyRestart(const char *filename, const double *Den, const double *fq, int N){
+	double value;
+	std::ofstream File(filename,std::ios::binary);
+	for (int n=0; n<N; n++){
+		value = Den[n];
+		File.write((char*) &value, sizeof(value));
+		value = Den[N+n];
+		File.write((char*) &value, sizeof(value));
+	}
+	for (int n=0; n<N; n++){
+		for (int q=0; q<19; q++){
+			value = fq[q*N+n];
+			File.write((char*) &value, sizeof(value));
+		}
+	}
+	File.close();
+}
+
+// Sites of a global 12 x 12 x (12 nprocs) domain on the decomposition rank_info
+// (every third node solid, sites numbered in reverse order)
+IntArray SharedRestartMap(const RankInfoStruct &rank_info, int nx, int ny, int nz, int &Np){
+	IntArray Map(nx+2,ny+2,nz+2);
+	Map.fill(-1);
+	Np = 0;
+	for (int k=nz; k>0; k--){
+		for (int j=ny; j>0; j--){
+			for (int i=nx; i>0; i--){
+				int gi = rank_info.ix*nx+i-1;
+				int gj = rank_info.jy*ny+j-1;
+				int gk = rank_info.kz*nz+k-1;
+				if ((gi+gj+gk)%3 != 0) Map(i,j,k) = Np++;
+			}
+		}
+	}
+	return Map;
+}
+
+double SharedRestartValue(const RankInfoStruct &rank_info, int nx, int ny, int nz, int i, int j, int k, int c){
+	int gi = rank_info.ix*nx+i-1;
+	int gj = rank_info.jy*ny+j-1;
+	int gk = rank_info.kz*nz+k-1;
+	return gi + 100.0*gj + 10000.0*gk + 1.0e7*c;
+}
+
+int Compare(const std::vector<double> &x, const std::vector<double> &y){
+	int count = 0;
+	for (size_t n=0; n<x.size(); n++){
+		if (x[n] != y[n]) count++;
+	}
+	return count;
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int check=0;
+	{
+		int Np = 100003;
+		if (argc > 1) Np = atoi(argv[1]);
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running Unit Test: TestRestart	\n");
+			printf("********************************************************\n");
+		}
+		char filename[40];
+		sprintf(filename,"TestRestart.%05d",rank);
+		std::vector<double> Den(2*Np), fq(19*Np);
+		srand(1234+rank);
+		for (auto &x : Den) x = double(rand())/RAND_MAX;
+		for (auto &x : fq) x = double(rand())/RAND_MAX;
+
+		// Block files written with buffered and direct I/O
+		for (int direct=0; direct<2; direct++){
+			double starttime = MPI_Wtime();
+			WriteRestartFile(filename, Np, 1000+direct, "morton", { { Den.data(), 2 }, { fq.data(), 19 } }, direct==1);
+			double walltime = MPI_Wtime() - starttime;
+			std::vector<double> Den2(2*Np,0.0), fq2(19*Np,0.0);
+			starttime = MPI_Wtime();
+			int timestep = ReadRestartFile(filename, Np, "morton", { { Den2.data(), 2 }, { fq2.data(), 19 } });
+			double readtime = MPI_Wtime() - starttime;
+			int count = Compare(Den,Den2) + Compare(fq,fq2);
+			if (rank == 0) printf("block restart (direct = %i): write %f s, read %f s \n",direct,walltime,readtime);
+			if (count > 0 || timestep != 1000+direct){
+				printf("Rank %i: block restart differs at %i values (timestep %i) \n",rank,count,timestep);
+				check++;
+			}
+		}
+
+		// Legacy interleaved file
+		double starttime = MPI_Wtime();
+		WriteLegacyRestart(filename, Den.data(), fq.data(), Np);
+		double walltime = MPI_Wtime() - starttime;
+		std::vector<double> Den2(2*Np,0.0), fq2(19*Np,0.0);
+		starttime = MPI_Wtime();
+		int timestep = ReadRestartFile(filename, Np, "morton", { { Den2.data(), 2 }, { fq2.data(), 19 } });
+		double readtime = MPI_Wtime() - starttime;
+		int count = Compare(Den,Den2) + Compare(fq,fq2);
+		if (rank == 0) printf("legacy restart: write %f s, read %f s \n",walltime,readtime);
+		if (count > 0 || timestep != -1){
+			printf("Rank %i: legacy restart differs at %i values (timestep %i) \n",rank,count,timestep);
+			check++;
+		}
+		remove(filename);
+
+		// Shared file written on nprocs in z and read on nprocs in x
+		int n = 12;
+		RankInfoStruct info_z(rank,1,1,nprocs);
+		RankInfoStruct info_x(rank,nprocs,1,1);
+		int Np_z, Np_x;
+		IntArray Map_z = SharedRestartMap(info_z,n,n,n,Np_z);
+		IntArray Map_x = SharedRestartMap(info_x,n/nprocs,n,n*nprocs,Np_x);
+		std::vector<double> Den_z(2*Np_z), fq_z(19*Np_z);
+		for (int k=1; k<=n; k++){
+			for (int j=1; j<=n; j++){
+				for (int i=1; i<=n; i++){
+					int idx = Map_z(i,j,k);
+					if (idx < 0) continue;
+					for (int c=0; c<2; c++) Den_z[c*Np_z+idx] = SharedRestartValue(info_z,n,n,n,i,j,k,c);
+					for (int c=0; c<19; c++) fq_z[c*Np_z+idx] = SharedRestartValue(info_z,n,n,n,i,j,k,c+2);
+				}
+			}
+		}
+		starttime = MPI_Wtime();
+		WriteSharedRestartFile("TestRestart.shared", info_z, Map_z, Np_z, 2000, { { Den_z.data(), 2 }, { fq_z.data(), 19 } }, 0, comm);
+		walltime = MPI_Wtime() - starttime;
+		std::vector<double> Den_x(2*Np_x,0.0), fq_x(19*Np_x,0.0);
+		timestep = ReadSharedRestartFile("TestRestart.shared", info_x, Map_x, Np_x, { { Den_x.data(), 2 }, { fq_x.data(), 19 } }, comm);
+		count = 0;
+		for (int k=1; k<=n*nprocs; k++){
+			for (int j=1; j<=n; j++){
+				for (int i=1; i<=n/nprocs; i++){
+					int idx = Map_x(i,j,k);
+					if (idx < 0) continue;
+					for (int c=0; c<2; c++){
+						if (Den_x[c*Np_x+idx] != SharedRestartValue(info_x,n/nprocs,n,n*nprocs,i,j,k,c)) count++;
+					}
+					for (int c=0; c<19; c++){
+						if (fq_x[c*Np_x+idx] != SharedRestartValue(info_x,n/nprocs,n,n*nprocs,i,j,k,c+2)) count++;
+					}
+				}
+			}
+		}
+		if (rank == 0) printf("shared restart: write %f s \n",walltime);
+		if (count > 0 || timestep != 2000){
+			printf("Rank %i: shared restart differs at %i values after redistribution (timestep %i) \n",rank,count,timestep);
+			check++;
+		}
+		MPI_Barrier(comm);
+		if (rank == 0) remove("TestRestart.shared");
+
+		check = sumReduce( comm, check );
+		if (rank == 0){
+			if (check == 0) printf("PASS: restart files read back exactly \n");
+			else printf("FAIL: restart files differ \n");
+		}
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return check;
+}
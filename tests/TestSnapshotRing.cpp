@@ -0,0 +1,128 @@
+//*************************************************************************
+// Test of the ring of snapshot buffers handed to the analysis threads
+// (runAnalysis::SnapshotRing): the drop policy is driven with more cycles
+// than buffers while the analysis of each snapshot is held busy, the wait
+// policy must wait for the owner, and a reused buffer must come back with
+// its fields invalidated
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "analysis/runAnalysis.h"
+#include "common/MPI_Helpers.h"
+#include "common/Utilities.h"
+
+// Analysis work item that holds its snapshot until released
+class HoldWorkItem: public ThreadPool::WorkItemRet<void>
+{
+public:
+	HoldWorkItem( const std::atomic<bool>& release_, int sleep_ms_ ): release(release_), sleep_ms(sleep_ms_) { }
+	virtual void run() {
+		while ( !release )
+			std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+		std::this_thread::sleep_for( std::chrono::milliseconds(sleep_ms) );
+	}
+private:
+	const std::atomic<bool>& release;
+	int sleep_ms;
+};
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	int errors=0;
+	{
+		if (rank == 0){
+			printf("-----------------------------------------------------------\n");
+			printf("Testing the snapshot ring\n");
+			printf("-----------------------------------------------------------\n");
+		}
+		ThreadPool tpool( 2 );
+
+		// Drop policy: 2 buffers, 6 cycles with the analysis of each snapshot held busy
+		std::atomic<bool> release( false );
+		runAnalysis::SnapshotRing ring( 2, "drop" );
+		std::vector<std::shared_ptr<runAnalysis::Snapshot>> taken;
+		for (int cycle=0; cycle<6; cycle++){
+			auto snapshot = ring.get( tpool, comm );
+			if ( snapshot ) {
+				snapshot->Phase.resize(4,4,4);
+				snapshot->Phase.fill(cycle);
+				snapshot->has_tminus = true;
+				snapshot->has_state = true;
+				snapshot->owner = tpool.add_work( new HoldWorkItem( release, 0 ) );
+				taken.push_back( snapshot );
+			}
+		}
+		if ( taken.size() != 2 || taken[0] == taken[1] ) {
+			printf("drop: expected the 2 buffers to be taken (got %i)\n",(int)taken.size());
+			errors++;
+		}
+		if ( ring.taken() != 2 || ring.dropped() != 4 ) {
+			printf("drop: %i taken, %i dropped (expected 2, 4)\n",ring.taken(),ring.dropped());
+			errors++;
+		}
+		release = true;
+		tpool.wait_pool_finished();
+		// The buffers are reused in order with their fields invalidated
+		for (int cycle=0; cycle<2; cycle++){
+			auto snapshot = ring.get( tpool, comm );
+			if ( !snapshot || snapshot != taken[cycle] ) {
+				printf("drop: buffer %i was not reused in order\n",cycle);
+				errors++;
+			} else if ( snapshot->has_tplus || snapshot->has_tminus || snapshot->has_state ) {
+				printf("drop: reused buffer %i still holds the fields of an older timestep\n",cycle);
+				errors++;
+			}
+		}
+		if ( ring.taken() != 4 || ring.dropped() != 4 ) {
+			printf("drop: %i taken, %i dropped after reuse (expected 4, 4)\n",ring.taken(),ring.dropped());
+			errors++;
+		}
+		if ( ring.waitTime() != 0 ) {
+			printf("drop: the drop policy waited %f s\n",ring.waitTime());
+			errors++;
+		}
+
+		// Wait policy: 1 buffer, every cycle waits for the analysis of the previous snapshot
+		runAnalysis::SnapshotRing wait_ring( 1, "wait" );
+		std::atomic<bool> go( true );
+		for (int cycle=0; cycle<3; cycle++){
+			auto snapshot = wait_ring.get( tpool, comm );
+			if ( !snapshot ) {
+				printf("wait: cycle %i returned no buffer\n",cycle);
+				errors++;
+				continue;
+			}
+			if ( !snapshot->owner.finished() ) {
+				printf("wait: cycle %i got a buffer that is still in use\n",cycle);
+				errors++;
+			}
+			snapshot->has_state = true;
+			snapshot->owner = tpool.add_work( new HoldWorkItem( go, 20 ) );
+		}
+		if ( wait_ring.taken() != 3 || wait_ring.dropped() != 0 || wait_ring.waitTime() <= 0 ) {
+			printf("wait: %i taken, %i dropped, waited %f s\n",wait_ring.taken(),wait_ring.dropped(),wait_ring.waitTime());
+			errors++;
+		}
+		tpool.wait_pool_finished();
+	}
+	errors = sumReduce(comm,errors);
+	if (rank == 0){
+		if (errors == 0) printf("PASS: snapshot ring drops, waits and reuses buffers as expected \n");
+		else printf("FAIL: %i errors in the snapshot ring \n",errors);
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return errors;
+}
@@ -0,0 +1,539 @@
+//*************************************************************************
+// Lattice update rate benchmark
+// Synthetic geometries (open box, sphere pack, random porous media) are built
+// in memory and the MRT, BGK, color, DFH and greyscale kernels and the D3Q19
+// halo exchange are timed with the AA pattern, as in the model Run loops.
+// Each subdomain has n^3 nodes (weak scaling), the ranks are factored into a
+// 3D process grid and the domain is periodic.
+//   usage: lbpm_benchmark [n] [timesteps] [porosity ...]
+// (porosities of the random media, 0.8 and 0.5 by default)
+// One line per kernel and geometry is printed and appended to
+// lbpm_benchmark.csv:
+//   kernel,geometry,porosity,ranks,n,sites,timesteps,time,MLUPS,MLUPS_per_rank,bytes_per_site,GB_per_s,comm_fraction
+// bytes_per_site is the minimum memory traffic of a time step: every array
+// the kernels stream is counted once, with the neighbor lists averaged over
+// the odd and even steps (it is not defined for the exchange alone and
+// printed as 0).  comm_fraction is the share of the time spent in
+// the communicator (packing, waiting and unpacking), averaged over the ranks.
+//*************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <string>
+#include <functional>
+#include "common/ScaLBL.h"
+#include "common/Communication.h"
+#include "common/MPI_Helpers.h"
+#include "common/SpherePack.h"
+#include "common/Utilities.h"
+
+// Process grid with the smallest subdomain surface for nprocs ranks
+std::vector<int> ProcessGrid( int nprocs )
+{
+	std::vector<int> nproc = { 1, 1, 1 };
+	auto factors = Utilities::factor( nprocs );
+	for (auto f=factors.rbegin(); f!=factors.rend(); ++f){
+		int d = 0;
+		if (nproc[1] < nproc[d]) d = 1;
+		if (nproc[2] < nproc[d]) d = 2;
+		nproc[d] *= *f;
+	}
+	return nproc;
+}
+
+std::shared_ptr<Database> loadInputs( int nprocs, int n )
+{
+	auto db = std::make_shared<Database>();
+	db->putScalar<int>( "BC", 0 );
+	db->putVector<int>( "nproc", ProcessGrid( nprocs ) );
+	db->putVector<int>( "n", { n, n, n } );
+	db->putVector<double>( "L", { 1, 1, 1 } );
+	return db;
+}
+
+// Copy the halo of the id field from the neighboring subdomains
+void FillHaloID( std::shared_ptr<Domain> Dm )
+{
+	int Nx = Dm->Nx, Ny = Dm->Ny, Nz = Dm->Nz;
+	Array<char> id(Nx,Ny,Nz);
+	for (size_t n=0; n<id.length(); n++) id(n) = Dm->id[n];
+	fillHalo<char> fill(Dm->Comm,Dm->rank_info,{Nx-2,Ny-2,Nz-2},{1,1,1},0,1);
+	fill.fill(id);
+	for (size_t n=0; n<id.length(); n++) Dm->id[n] = id(n);
+}
+
+// Solid spheres of radius n/5 from common/SpherePack with porosity close to 0.6
+void SpherePackGeometry( std::shared_ptr<Domain> Dm )
+{
+	int Nx = Dm->Nx, Ny = Dm->Ny, Nz = Dm->Nz;
+	int npx = Dm->nprocx(), npy = Dm->nprocy(), npz = Dm->nprocz();
+	double Lx = Nx*npx-1, Ly = Ny*npy-1, Lz = Nz*npz-1;
+	double radius = std::max(2.0,0.2*(Nx-2));
+	int nspheres = int(ceil(-log(0.6)*(Lx*Ly*Lz)/(4.0/3.0*M_PI*radius*radius*radius)));
+	std::vector<double> cx(nspheres), cy(nspheres), cz(nspheres), rad(nspheres,radius);
+	srand(1234);
+	for (int p=0; p<nspheres; p++){
+		cx[p] = Lx*double(rand())/RAND_MAX;
+		cy[p] = Ly*double(rand())/RAND_MAX;
+		cz[p] = Lz*double(rand())/RAND_MAX;
+	}
+	AssignLocalSolidID((char*) Dm->id,nspheres,cx.data(),cy.data(),cz.data(),rad.data(),Lx,Ly,Lz,Nx,Ny,Nz,
+		Dm->iproc(),Dm->jproc(),Dm->kproc(),npx,npy,npz);
+	FillHaloID(Dm);
+}
+
+// Random porous medium: periodic sum of random waves thresholded at the target porosity
+void RandomGeometry( std::shared_ptr<Domain> Dm, double porosity )
+{
+	int Nx = Dm->Nx, Ny = Dm->Ny, Nz = Dm->Nz;
+	int gx = (Nx-2)*Dm->nprocx(), gy = (Ny-2)*Dm->nprocy(), gz = (Nz-2)*Dm->nprocz();
+	const int Nwaves = 16;
+	std::vector<double> kx(Nwaves), ky(Nwaves), kz(Nwaves), phase(Nwaves);
+	srand(4321);
+	for (int m=0; m<Nwaves; m++){
+		// wavelengths of about eight nodes that are periodic on the global domain
+		kx[m] = 2.0*M_PI*(rand()%(2*(gx/8)+1) - gx/8)/gx;
+		ky[m] = 2.0*M_PI*(rand()%(2*(gy/8)+1) - gy/8)/gy;
+		kz[m] = 2.0*M_PI*(rand()%(2*(gz/8)+1) - gz/8)/gz;
+		phase[m] = 2.0*M_PI*double(rand())/RAND_MAX;
+	}
+	DoubleArray field(Nx,Ny,Nz);
+	for (int k=0; k<Nz; k++){
+		for (int j=0; j<Ny; j++){
+			for (int i=0; i<Nx; i++){
+				double x = Dm->iproc()*(Nx-2)+i-1;
+				double y = Dm->jproc()*(Ny-2)+j-1;
+				double z = Dm->kproc()*(Nz-2)+k-1;
+				double value = 0.0;
+				for (int m=0; m<Nwaves; m++) value += cos(kx[m]*x+ky[m]*y+kz[m]*z+phase[m]);
+				field(i,j,k) = value;
+			}
+		}
+	}
+	// bisection for the threshold that gives the porosity over the global domain
+	double low = -Nwaves, high = Nwaves;
+	double total = double(gx)*double(gy)*double(gz);
+	for (int it=0; it<50; it++){
+		double threshold = 0.5*(low+high);
+		double count = 0.0;
+		for (int k=1; k<Nz-1; k++)
+			for (int j=1; j<Ny-1; j++)
+				for (int i=1; i<Nx-1; i++)
+					if (field(i,j,k) < threshold) count += 1.0;
+		count = sumReduce( Dm->Comm, count );
+		if (count/total < porosity) low = threshold;
+		else high = threshold;
+	}
+	for (size_t n=0; n<field.length(); n++) Dm->id[n] = (field(n) < high) ? 1 : 0;
+}
+
+// Sites, layout and communicators of one geometry
+struct Lattice {
+	std::shared_ptr<Domain> Dm;
+	std::shared_ptr<ScaLBL_Communicator> Comm, CommRegular;
+	IntArray Map;
+	int *NeighborList;
+	int *dvcMap;
+	int Np;
+	int Nx, Ny, Nz;
+	double sites;
+};
+
+void CreateLattice( Lattice &lattice )
+{
+	auto Dm = lattice.Dm;
+	lattice.Nx = Dm->Nx; lattice.Ny = Dm->Ny; lattice.Nz = Dm->Nz;
+	int Nx = Dm->Nx, Ny = Dm->Ny, Nz = Dm->Nz;
+	Dm->CommInit();
+	int Np = Dm->PoreCount();
+	lattice.Comm = std::shared_ptr<ScaLBL_Communicator>(new ScaLBL_Communicator(Dm));
+	lattice.CommRegular = std::shared_ptr<ScaLBL_Communicator>(new ScaLBL_Communicator(Dm));
+	int Npad = (Np/16 + 2)*16;
+	lattice.Map.resize(Nx,Ny,Nz);
+	lattice.Map.fill(-2);
+	std::vector<int> neighborList(18*Npad);
+	Np = lattice.Comm->MemoryOptimizedLayoutAA(lattice.Map,neighborList.data(),Dm->id,Np);
+	lattice.Np = Np;
+	ScaLBL_AllocateDeviceMemory((void **) &lattice.NeighborList, 18*Np*sizeof(int));
+	ScaLBL_CopyToDevice(lattice.NeighborList, neighborList.data(), 18*Np*sizeof(int));
+	// Np includes the padding of the layout, so the fluid sites are counted from the map
+	std::vector<int> TmpMap(Np,0);
+	double sites = 0.0;
+	for (int k=1; k<Nz-1; k++){
+		for (int j=1; j<Ny-1; j++){
+			for (int i=1; i<Nx-1; i++){
+				int idx = lattice.Map(i,j,k);
+				if (!(idx < 0)){
+					TmpMap[idx] = k*Nx*Ny+j*Nx+i;
+					sites += 1.0;
+				}
+			}
+		}
+	}
+	ScaLBL_AllocateDeviceMemory((void **) &lattice.dvcMap, sizeof(int)*Np);
+	ScaLBL_CopyToDevice(lattice.dvcMap, TmpMap.data(), sizeof(int)*Np);
+	ScaLBL_DeviceBarrier();
+	lattice.sites = sumReduce( Dm->Comm, sites );
+}
+
+void DestroyLattice( Lattice &lattice )
+{
+	ScaLBL_FreeDeviceMemory(lattice.NeighborList);
+	ScaLBL_FreeDeviceMemory(lattice.dvcMap);
+	lattice.Comm.reset();
+	lattice.CommRegular.reset();
+}
+
+// Wall time of a set of time steps (two per call of step) and the time spent in the communicator
+struct Timing {
+	double time;
+	double comm;
+};
+
+Timing TimeSteps( MPI_Comm comm, int timesteps, const std::function<void(double&)> &step )
+{
+	double comm_time = 0.0;
+	// warm up
+	step(comm_time);
+	comm_time = 0.0;
+	ScaLBL_DeviceBarrier();
+	MPI_Barrier(comm);
+	double starttime = MPI_Wtime();
+	for (int t=0; t<timesteps; t+=2) step(comm_time);
+	ScaLBL_DeviceBarrier();
+	MPI_Barrier(comm);
+	Timing timing;
+	timing.time = MPI_Wtime() - starttime;
+	timing.comm = sumReduce( comm, comm_time/timing.time ) / comm_size( comm );
+	return timing;
+}
+
+// Time a communicator call
+#define COMM_TIMED( X ) do { double t0 = MPI_Wtime(); X; comm_time += MPI_Wtime() - t0; } while (0)
+
+Timing RunMRT( Lattice &L, int timesteps, bool bgk )
+{
+	int Np = L.Np;
+	auto Comm = L.Comm;
+	int *NeighborList = L.NeighborList;
+	double *fq;
+	ScaLBL_AllocateDeviceMemory((void **) &fq, 19*Np*sizeof(double));
+	ScaLBL_D3Q19_Init(fq, Np);
+	double rlx_setA = 1.0, rlx_setB = 8.f*(2.f-rlx_setA)/(8.f-rlx_setA);
+	double Fx = 0, Fy = 0, Fz = 1.0e-5;
+	auto step = [&]( double &comm_time ){
+		COMM_TIMED( Comm->SendD3Q19AA(fq) );
+		if (bgk) ScaLBL_D3Q19_AAodd_BGK(NeighborList, fq, Comm->FirstInterior(), Comm->LastInterior(), Np, rlx_setA, Fx, Fy, Fz);
+		else ScaLBL_D3Q19_AAodd_MRT(NeighborList, fq, Comm->FirstInterior(), Comm->LastInterior(), Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+		COMM_TIMED( Comm->RecvD3Q19AA(fq) );
+		if (bgk) ScaLBL_D3Q19_AAodd_BGK(NeighborList, fq, 0, Comm->LastExterior(), Np, rlx_setA, Fx, Fy, Fz);
+		else ScaLBL_D3Q19_AAodd_MRT(NeighborList, fq, 0, Comm->LastExterior(), Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+		ScaLBL_DeviceBarrier();
+		COMM_TIMED( Comm->SendD3Q19AA(fq) );
+		if (bgk) ScaLBL_D3Q19_AAeven_BGK(fq, Comm->FirstInterior(), Comm->LastInterior(), Np, rlx_setA, Fx, Fy, Fz);
+		else ScaLBL_D3Q19_AAeven_MRT(fq, Comm->FirstInterior(), Comm->LastInterior(), Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+		COMM_TIMED( Comm->RecvD3Q19AA(fq) );
+		if (bgk) ScaLBL_D3Q19_AAeven_BGK(fq, 0, Comm->LastExterior(), Np, rlx_setA, Fx, Fy, Fz);
+		else ScaLBL_D3Q19_AAeven_MRT(fq, 0, Comm->LastExterior(), Np, rlx_setA, rlx_setB, Fx, Fy, Fz);
+		ScaLBL_DeviceBarrier();
+	};
+	auto timing = TimeSteps( L.Dm->Comm, timesteps, step );
+	ScaLBL_FreeDeviceMemory(fq);
+	return timing;
+}
+
+Timing RunGreyscale( Lattice &L, int timesteps )
+{
+	int Np = L.Np;
+	auto Comm = L.Comm;
+	int *NeighborList = L.NeighborList;
+	double *fq, *Poros, *Perm, *Velocity, *Pressure;
+	ScaLBL_AllocateDeviceMemory((void **) &fq, 19*Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Poros, Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Perm, Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Velocity, 3*Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Pressure, Np*sizeof(double));
+	// grey nodes with porosity 0.5 and permeability 0.1 in lattice units
+	std::vector<double> poros(Np,0.5), perm(Np,0.1);
+	ScaLBL_CopyToDevice(Poros, poros.data(), Np*sizeof(double));
+	ScaLBL_CopyToDevice(Perm, perm.data(), Np*sizeof(double));
+	double Den = 1.0;
+	ScaLBL_D3Q19_GreyIMRT_Init(fq, Np, Den);
+	double rlx = 1.0, rlx_eff = 1.0;
+	double Fx = 0, Fy = 0, Fz = 1.0e-5;
+	auto step = [&]( double &comm_time ){
+		COMM_TIMED( Comm->SendD3Q19AA(fq) );
+		ScaLBL_D3Q19_AAodd_Greyscale_IMRT(NeighborList, fq, Comm->FirstInterior(), Comm->LastInterior(), Np, rlx, rlx_eff, Fx, Fy, Fz, Poros, Perm, Velocity, Den, Pressure);
+		COMM_TIMED( Comm->RecvD3Q19AA(fq) );
+		ScaLBL_D3Q19_AAodd_Greyscale_IMRT(NeighborList, fq, 0, Comm->LastExterior(), Np, rlx, rlx_eff, Fx, Fy, Fz, Poros, Perm, Velocity, Den, Pressure);
+		ScaLBL_DeviceBarrier();
+		COMM_TIMED( Comm->SendD3Q19AA(fq) );
+		ScaLBL_D3Q19_AAeven_Greyscale_IMRT(fq, Comm->FirstInterior(), Comm->LastInterior(), Np, rlx, rlx_eff, Fx, Fy, Fz, Poros, Perm, Velocity, Den, Pressure);
+		COMM_TIMED( Comm->RecvD3Q19AA(fq) );
+		ScaLBL_D3Q19_AAeven_Greyscale_IMRT(fq, 0, Comm->LastExterior(), Np, rlx, rlx_eff, Fx, Fy, Fz, Poros, Perm, Velocity, Den, Pressure);
+		ScaLBL_DeviceBarrier();
+	};
+	auto timing = TimeSteps( L.Dm->Comm, timesteps, step );
+	ScaLBL_FreeDeviceMemory(fq);
+	ScaLBL_FreeDeviceMemory(Poros);
+	ScaLBL_FreeDeviceMemory(Perm);
+	ScaLBL_FreeDeviceMemory(Velocity);
+	ScaLBL_FreeDeviceMemory(Pressure);
+	return timing;
+}
+
+// Phase indicator of two fluid layers stacked in z (regular layout)
+std::vector<double> TwoFluidLayers( Lattice &L )
+{
+	int Nx = L.Nx, Ny = L.Ny, Nz = L.Nz;
+	std::vector<double> phase(Nx*Ny*Nz);
+	for (int k=0; k<Nz; k++){
+		for (int j=0; j<Ny; j++){
+			for (int i=0; i<Nx; i++){
+				int n = k*Nx*Ny+j*Nx+i;
+				phase[n] = (L.Dm->id[n] == 0) ? 0.0 : ((k < Nz/2) ? 1.0 : -1.0);
+			}
+		}
+	}
+	return phase;
+}
+
+Timing RunColor( Lattice &L, int timesteps )
+{
+	int Np = L.Np, Nx = L.Nx, Ny = L.Ny, Nz = L.Nz, N = Nx*Ny*Nz;
+	auto Comm = L.Comm;
+	auto CommRegular = L.CommRegular;
+	int *NeighborList = L.NeighborList;
+	int *dvcMap = L.dvcMap;
+	double *fq, *Aq, *Bq, *Den, *Phi, *Velocity;
+	ScaLBL_AllocateDeviceMemory((void **) &fq, 19*Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Aq, 7*Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Bq, 7*Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Den, 2*Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Phi, N*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Velocity, 3*Np*sizeof(double));
+	auto phase = TwoFluidLayers( L );
+	ScaLBL_CopyToDevice(Phi, phase.data(), N*sizeof(double));
+	ScaLBL_D3Q19_Init(fq, Np);
+	ScaLBL_PhaseField_Init(dvcMap, Phi, Den, Aq, Bq, 0, Comm->LastExterior(), Np);
+	ScaLBL_PhaseField_Init(dvcMap, Phi, Den, Aq, Bq, Comm->FirstInterior(), Comm->LastInterior(), Np);
+	double rhoA = 1.0, rhoB = 1.0, tauA = 1.0, tauB = 1.0, alpha = 0.005, beta = 0.95;
+	double Fx = 0, Fy = 0, Fz = 1.0e-5;
+	auto step = [&]( double &comm_time ){
+		// odd time step
+		COMM_TIMED( Comm->BiSendD3Q7AA(Aq,Bq) );
+		ScaLBL_D3Q7_AAodd_PhaseField(NeighborList, dvcMap, Aq, Bq, Den, Phi, Comm->FirstInterior(), Comm->LastInterior(), Np);
+		COMM_TIMED( Comm->BiRecvD3Q7AA(Aq,Bq) );
+		ScaLBL_D3Q7_AAodd_PhaseField(NeighborList, dvcMap, Aq, Bq, Den, Phi, 0, Comm->LastExterior(), Np);
+		ScaLBL_DeviceBarrier();
+		COMM_TIMED( Comm->SendD3Q19AA(fq) );
+		COMM_TIMED( CommRegular->SendHalo(Phi) );
+		ScaLBL_D3Q19_AAodd_Color(NeighborList, dvcMap, fq, Aq, Bq, Den, Phi, Velocity, rhoA, rhoB, tauA, tauB,
+				alpha, beta, Fx, Fy, Fz, Nx, Nx*Ny, Comm->FirstInterior(), Comm->LastInterior(), Np);
+		COMM_TIMED( CommRegular->RecvHalo(Phi) );
+		COMM_TIMED( Comm->RecvD3Q19AA(fq) );
+		ScaLBL_D3Q19_AAodd_Color(NeighborList, dvcMap, fq, Aq, Bq, Den, Phi, Velocity, rhoA, rhoB, tauA, tauB,
+				alpha, beta, Fx, Fy, Fz, Nx, Nx*Ny, 0, Comm->LastExterior(), Np);
+		ScaLBL_DeviceBarrier();
+		// even time step
+		COMM_TIMED( Comm->BiSendD3Q7AA(Aq,Bq) );
+		ScaLBL_D3Q7_AAeven_PhaseField(dvcMap, Aq, Bq, Den, Phi, Comm->FirstInterior(), Comm->LastInterior(), Np);
+		COMM_TIMED( Comm->BiRecvD3Q7AA(Aq,Bq) );
+		ScaLBL_D3Q7_AAeven_PhaseField(dvcMap, Aq, Bq, Den, Phi, 0, Comm->LastExterior(), Np);
+		ScaLBL_DeviceBarrier();
+		COMM_TIMED( Comm->SendD3Q19AA(fq) );
+		COMM_TIMED( CommRegular->SendHalo(Phi) );
+		ScaLBL_D3Q19_AAeven_Color(dvcMap, fq, Aq, Bq, Den, Phi, Velocity, rhoA, rhoB, tauA, tauB,
+				alpha, beta, Fx, Fy, Fz, Nx, Nx*Ny, Comm->FirstInterior(), Comm->LastInterior(), Np);
+		COMM_TIMED( CommRegular->RecvHalo(Phi) );
+		COMM_TIMED( Comm->RecvD3Q19AA(fq) );
+		ScaLBL_D3Q19_AAeven_Color(dvcMap, fq, Aq, Bq, Den, Phi, Velocity, rhoA, rhoB, tauA, tauB,
+				alpha, beta, Fx, Fy, Fz, Nx, Nx*Ny, 0, Comm->LastExterior(), Np);
+		ScaLBL_DeviceBarrier();
+	};
+	auto timing = TimeSteps( L.Dm->Comm, timesteps, step );
+	ScaLBL_FreeDeviceMemory(fq);
+	ScaLBL_FreeDeviceMemory(Aq);
+	ScaLBL_FreeDeviceMemory(Bq);
+	ScaLBL_FreeDeviceMemory(Den);
+	ScaLBL_FreeDeviceMemory(Phi);
+	ScaLBL_FreeDeviceMemory(Velocity);
+	return timing;
+}
+
+Timing RunDFH( Lattice &L, int timesteps )
+{
+	int Np = L.Np, Nx = L.Nx, Ny = L.Ny, Nz = L.Nz;
+	auto Comm = L.Comm;
+	int *NeighborList = L.NeighborList;
+	double *fq, *Aq, *Bq, *Den, *Phi, *Gradient, *SolidPotential;
+	ScaLBL_AllocateDeviceMemory((void **) &fq, 19*Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Aq, 7*Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Bq, 7*Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Den, 2*Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Phi, Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &Gradient, 3*Np*sizeof(double));
+	ScaLBL_AllocateDeviceMemory((void **) &SolidPotential, 3*Np*sizeof(double));
+	// the DFH phase field is stored in the memory optimized layout
+	auto phase = TwoFluidLayers( L );
+	std::vector<double> phi(Np,0.0), zero(3*Np,0.0);
+	for (int k=1; k<Nz-1; k++){
+		for (int j=1; j<Ny-1; j++){
+			for (int i=1; i<Nx-1; i++){
+				int idx = L.Map(i,j,k);
+				if (!(idx < 0)) phi[idx] = phase[k*Nx*Ny+j*Nx+i];
+			}
+		}
+	}
+	ScaLBL_CopyToDevice(Phi, phi.data(), Np*sizeof(double));
+	ScaLBL_CopyToDevice(SolidPotential, zero.data(), 3*Np*sizeof(double));
+	ScaLBL_D3Q19_Init(fq, Np);
+	ScaLBL_DFH_Init(Phi, Den, Aq, Bq, 0, Comm->LastExterior(), Np);
+	ScaLBL_DFH_Init(Phi, Den, Aq, Bq, Comm->FirstInterior(), Comm->LastInterior(), Np);
+	double rhoA = 1.0, rhoB = 1.0, tauA = 1.0, tauB = 1.0, alpha = 0.005, beta = 0.95;
+	double Fx = 0, Fy = 0, Fz = 1.0e-5;
+	auto step = [&]( double &comm_time ){
+		// odd time step
+		COMM_TIMED( Comm->BiSendD3Q7AA(Aq,Bq) );
+		ScaLBL_D3Q7_AAodd_DFH(NeighborList, Aq, Bq, Den, Phi, Comm->FirstInterior(), Comm->LastInterior(), Np);
+		COMM_TIMED( Comm->BiRecvD3Q7AA(Aq,Bq) );
+		ScaLBL_D3Q7_AAodd_DFH(NeighborList, Aq, Bq, Den, Phi, 0, Comm->LastExterior(), Np);
+		ScaLBL_D3Q19_Gradient_DFH(NeighborList, Phi, Gradient, Comm->FirstInterior(), Comm->LastInterior(), Np);
+		COMM_TIMED( Comm->SendHalo(Phi) );
+		ScaLBL_D3Q19_Gradient_DFH(NeighborList, Phi, Gradient, 0, Comm->LastExterior(), Np);
+		COMM_TIMED( Comm->RecvGrad(Phi,Gradient) );
+		COMM_TIMED( Comm->SendD3Q19AA(fq) );
+		ScaLBL_D3Q19_AAodd_DFH(NeighborList, fq, Aq, Bq, Den, Phi, Gradient, SolidPotential, rhoA, rhoB, tauA, tauB,
+				alpha, beta, Fx, Fy, Fz, Comm->FirstInterior(), Comm->LastInterior(), Np);
+		COMM_TIMED( Comm->RecvD3Q19AA(fq) );
+		ScaLBL_D3Q19_AAodd_DFH(NeighborList, fq, Aq, Bq, Den, Phi, Gradient, SolidPotential, rhoA, rhoB, tauA, tauB,
+				alpha, beta, Fx, Fy, Fz, 0, Comm->LastExterior(), Np);
+		ScaLBL_DeviceBarrier();
+		// even time step
+		COMM_TIMED( Comm->BiSendD3Q7AA(Aq,Bq) );
+		ScaLBL_D3Q7_AAeven_DFH(Aq, Bq, Den, Phi, Comm->FirstInterior(), Comm->LastInterior(), Np);
+		COMM_TIMED( Comm->BiRecvD3Q7AA(Aq,Bq) );
+		ScaLBL_D3Q7_AAeven_DFH(Aq, Bq, Den, Phi, 0, Comm->LastExterior(), Np);
+		ScaLBL_D3Q19_Gradient_DFH(NeighborList, Phi, Gradient, Comm->FirstInterior(), Comm->LastInterior(), Np);
+		COMM_TIMED( Comm->SendHalo(Phi) );
+		ScaLBL_D3Q19_Gradient_DFH(NeighborList, Phi, Gradient, 0, Comm->LastExterior(), Np);
+		COMM_TIMED( Comm->RecvGrad(Phi,Gradient) );
+		COMM_TIMED( Comm->SendD3Q19AA(fq) );
+		ScaLBL_D3Q19_AAeven_DFH(NeighborList, fq, Aq, Bq, Den, Phi, Gradient, SolidPotential, rhoA, rhoB, tauA, tauB,
+				alpha, beta, Fx, Fy, Fz, Comm->FirstInterior(), Comm->LastInterior(), Np);
+		COMM_TIMED( Comm->RecvD3Q19AA(fq) );
+		ScaLBL_D3Q19_AAeven_DFH(NeighborList, fq, Aq, Bq, Den, Phi, Gradient, SolidPotential, rhoA, rhoB, tauA, tauB,
+				alpha, beta, Fx, Fy, Fz, 0, Comm->LastExterior(), Np);
+		ScaLBL_DeviceBarrier();
+	};
+	auto timing = TimeSteps( L.Dm->Comm, timesteps, step );
+	ScaLBL_FreeDeviceMemory(fq);
+	ScaLBL_FreeDeviceMemory(Aq);
+	ScaLBL_FreeDeviceMemory(Bq);
+	ScaLBL_FreeDeviceMemory(Den);
+	ScaLBL_FreeDeviceMemory(Phi);
+	ScaLBL_FreeDeviceMemory(Gradient);
+	ScaLBL_FreeDeviceMemory(SolidPotential);
+	return timing;
+}
+
+// D3Q19 halo exchange alone
+Timing RunExchange( Lattice &L, int timesteps )
+{
+	int Np = L.Np;
+	auto Comm = L.Comm;
+	double *fq;
+	ScaLBL_AllocateDeviceMemory((void **) &fq, 19*Np*sizeof(double));
+	ScaLBL_D3Q19_Init(fq, Np);
+	auto step = [&]( double &comm_time ){
+		for (int t=0; t<2; t++){
+			COMM_TIMED( Comm->SendD3Q19AA(fq) );
+			COMM_TIMED( Comm->RecvD3Q19AA(fq) );
+		}
+	};
+	auto timing = TimeSteps( L.Dm->Comm, timesteps, step );
+	ScaLBL_FreeDeviceMemory(fq);
+	return timing;
+}
+
+//***************************************************************************************
+int main(int argc, char **argv)
+{
+	// Initialize MPI
+	int rank,nprocs;
+	MPI_Init(&argc,&argv);
+	MPI_Comm comm = MPI_COMM_WORLD;
+	MPI_Comm_rank(comm,&rank);
+	MPI_Comm_size(comm,&nprocs);
+	{
+		int n = 64, timesteps = 100;
+		std::vector<double> porosities = { 0.8, 0.5 };
+		if (argc > 1) n = atoi(argv[1]);
+		if (argc > 2) timesteps = atoi(argv[2]);
+		if (argc > 3){
+			porosities.clear();
+			for (int i=3; i<argc; i++) porosities.push_back(atof(argv[i]));
+		}
+		timesteps = std::max(2,timesteps - timesteps%2);
+		if (rank == 0){
+			printf("********************************************************\n");
+			printf("Running lbpm_benchmark: %i ranks, %i^3 nodes per rank, %i time steps \n",nprocs,n,timesteps);
+			printf("********************************************************\n");
+		}
+		FILE *csv = NULL;
+		const char *header = "kernel,geometry,porosity,ranks,n,sites,timesteps,time,MLUPS,MLUPS_per_rank,bytes_per_site,GB_per_s,comm_fraction";
+		if (rank == 0){
+			csv = fopen("lbpm_benchmark.csv","a");
+			if (ftell(csv) == 0) fprintf(csv,"%s\n",header);
+			printf("%s\n",header);
+		}
+		// geometries: open box, sphere pack and random media
+		std::vector<std::pair<std::string,double>> geometries = { { "open", 1.0 }, { "spheres", 0.6 } };
+		for (auto p : porosities) geometries.push_back( { "random", p } );
+		for (auto &geometry : geometries){
+			Lattice L;
+			L.Dm = std::shared_ptr<Domain>(new Domain(loadInputs(nprocs,n),comm));
+			if (geometry.first == "open"){
+				for (int i=0; i<L.Dm->Nx*L.Dm->Ny*L.Dm->Nz; i++) L.Dm->id[i] = 1;
+			}
+			else if (geometry.first == "spheres"){
+				SpherePackGeometry( L.Dm );
+			}
+			else {
+				RandomGeometry( L.Dm, geometry.second );
+			}
+			CreateLattice( L );
+			// measured porosity of the geometry
+			double porosity = L.sites/(double(n)*n*n*nprocs);
+			// minimum memory traffic per site and time step (see above)
+			struct Kernel { const char *name; double bytes; std::function<Timing()> run; };
+			std::vector<Kernel> kernels = {
+				{ "MRT", 19*2*8 + 18*4/2, [&](){ return RunMRT(L,timesteps,false); } },
+				{ "BGK", 19*2*8 + 18*4/2, [&](){ return RunMRT(L,timesteps,true); } },
+				{ "greyscale", 19*2*8 + 18*4/2 + 2*8 + 4*8, [&](){ return RunGreyscale(L,timesteps); } },
+				{ "color", (2*7*8 + 6*4/2 + 2*8 + 8 + 4) + (19*2*8 + 18*4/2 + 2*8 + 8 + 4 + 3*8 + 2*7*8), [&](){ return RunColor(L,timesteps); } },
+				{ "DFH", (2*7*8 + 6*4/2 + 2*8 + 8) + (8 + 18*4 + 3*8) + (19*2*8 + 18*4/2 + 2*8 + 8 + 3*8 + 3*8 + 2*7*8), [&](){ return RunDFH(L,timesteps); } },
+				{ "exchange", 0, [&](){ return RunExchange(L,timesteps); } }
+			};
+			for (auto &kernel : kernels){
+				Timing timing = kernel.run();
+				double MLUPS = L.sites*timesteps/timing.time/1.0e6;
+				if (rank == 0){
+					char line[512];
+					sprintf(line,"%s,%s,%.3f,%i,%i,%.0f,%i,%.6f,%.3f,%.3f,%.0f,%.3f,%.3f",kernel.name,geometry.first.c_str(),
+						porosity,nprocs,n,L.sites,timesteps,timing.time,MLUPS,MLUPS/nprocs,kernel.bytes,MLUPS*kernel.bytes/1.0e3,timing.comm);
+					printf("%s\n",line);
+					fprintf(csv,"%s\n",line);
+				}
+			}
+			DestroyLattice( L );
+		}
+		if (rank == 0) fclose(csv);
+	}
+	// ****************************************************
+	MPI_Barrier(comm);
+	MPI_Finalize();
+	// ****************************************************
+	return 0;
+}
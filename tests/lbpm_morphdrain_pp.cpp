@@ -53,7 +53,8 @@ int main(int argc, char **argv)
 		auto nproc = domain_db->getVector<int>( "nproc" );
 		auto ReadValues = domain_db->getVector<int>( "ReadValues" );
 		auto WriteValues = domain_db->getVector<int>( "WriteValues" );
-		SW = domain_db->getScalar<double>("Sw");
+		auto SwList = domain_db->getVector<double>( "Sw" );
+		SW = SwList[0];
 		auto READFILE = domain_db->getScalar<std::string>( "Filename" );
 
 		// Generate the NWP configuration
@@ -124,83 +125,121 @@ int main(int argc, char **argv)
 		MPI_Barrier(comm);
 
 		// Run the morphological opening
-		MorphDrain(SignDist, id, Dm, SW);
-	
-		// calculate distance to non-wetting fluid
-		if (domain_db->keyExists( "HistoryLabels" )){
-			if (rank==0) printf("Relabel solid components that touch fluid 1 \n");
-			auto LabelList = domain_db->getVector<int>( "ComponentLabels" );
-			auto HistoryLabels = domain_db->getVector<int>( "HistoryLabels" );
-			size_t NLABELS=LabelList.size();
-			if (rank==0){
-				for (unsigned int idx=0; idx < NLABELS; idx++){ 
-					signed char VALUE = LabelList[idx];
-					signed char NEWVAL = HistoryLabels[idx];
-					printf("    Relabel component %hhd as %hhd \n", VALUE, NEWVAL);
+		// For a list of saturations the whole drainage curve is computed in one pass and each
+		// configuration is recovered from the critical radius at which the cells were invaded
+		DoubleArray Radius;
+		std::vector<std::pair<double,double>> curve;
+		std::vector<signed char> id_drain;
+		if (SwList.size() == 1){
+			MorphDrain(SignDist, id, Dm, SW);
+		}
+		else {
+			curve = MorphDrainCurve(SignDist, id, Dm, Radius);
+			id_drain.assign(id,id+N);
+		}
+
+		for (size_t config=0; config<SwList.size(); config++){
+			if (SwList.size() > 1){
+				// the radius of the curve closest to the target saturation
+				size_t idx = 0;
+				for (size_t m=1; m<curve.size(); m++){
+					if (fabs(curve[m].first-SwList[config]) < fabs(curve[idx].first-SwList[config])) idx = m;
 				}
-			}
-			for (int k=0;k<nz;k++){
-				for (int j=0;j<ny;j++){
-					for (int i=0;i<nx;i++){
-						int n = k*nx*ny+j*nx+i;
-						// Initialize the solid phase
-						if (id[n] == 1)	id_solid(i,j,k) = 0;
-						else	     	id_solid(i,j,k) = 1;
+				if (rank==0) printf("Configuration for saturation %f: sw=%f, radius=%f \n",SwList[config],curve[idx].first,curve[idx].second);
+				for (int k=0;k<nz;k++){
+					for (int j=0;j<ny;j++){
+						for (int i=0;i<nx;i++){
+							int n = k*nx*ny+j*nx+i;
+							id[n] = id_drain[n];
+							if (SignDist(i,j,k) > 0.0) id[n] = (Radius(i,j,k) >= curve[idx].second) ? 1 : 2;
+						}
 					}
 				}
 			}
-			// Initialize the signed distance function
-			for (int k=0;k<nz;k++){
-				for (int j=0;j<ny;j++){
-					for (int i=0;i<nx;i++){
-						// Initialize distance to +/- 1
-						SignDist(i,j,k) = 2.0*double(id_solid(i,j,k))-1.0;
+
+			// calculate distance to non-wetting fluid
+			if (domain_db->keyExists( "HistoryLabels" )){
+				if (rank==0) printf("Relabel solid components that touch fluid 1 \n");
+				DoubleArray NWPDist(nx,ny,nz);
+				auto LabelList = domain_db->getVector<int>( "ComponentLabels" );
+				auto HistoryLabels = domain_db->getVector<int>( "HistoryLabels" );
+				size_t NLABELS=LabelList.size();
+				if (rank==0){
+					for (unsigned int idx=0; idx < NLABELS; idx++){ 
+						signed char VALUE = LabelList[idx];
+						signed char NEWVAL = HistoryLabels[idx];
+						printf("    Relabel component %hhd as %hhd \n", VALUE, NEWVAL);
 					}
 				}
-			}
-			CalcDist(SignDist,id_solid,*Dm);
-			// re-label IDs near the non-wetting fluid
-			for (int k=0;k<nz;k++){
-				for (int j=0;j<ny;j++){
-					for (int i=0;i<nx;i++){
-						int n = k*nx*ny+j*nx+i;
-						signed char LOCVAL = id[n];
-						for (unsigned int idx=0; idx < NLABELS; idx++){
-							signed char VALUE=LabelList[idx];
-							signed char NEWVALUE=HistoryLabels[idx];
-							if (LOCVAL == VALUE){
-								idx = NLABELS;
-								if (SignDist(i,j,k) < 2.0){
-									id[n] = NEWVALUE;
+				for (int k=0;k<nz;k++){
+					for (int j=0;j<ny;j++){
+						for (int i=0;i<nx;i++){
+							int n = k*nx*ny+j*nx+i;
+							// Initialize the solid phase
+							if (id[n] == 1)	id_solid(i,j,k) = 0;
+							else	     	id_solid(i,j,k) = 1;
+						}
+					}
+				}
+				// Initialize the signed distance function
+				for (int k=0;k<nz;k++){
+					for (int j=0;j<ny;j++){
+						for (int i=0;i<nx;i++){
+							// Initialize distance to +/- 1
+							NWPDist(i,j,k) = 2.0*double(id_solid(i,j,k))-1.0;
+						}
+					}
+				}
+				CalcDist(NWPDist,id_solid,*Dm);
+				// re-label IDs near the non-wetting fluid
+				for (int k=0;k<nz;k++){
+					for (int j=0;j<ny;j++){
+						for (int i=0;i<nx;i++){
+							int n = k*nx*ny+j*nx+i;
+							signed char LOCVAL = id[n];
+							for (unsigned int idx=0; idx < NLABELS; idx++){
+								signed char VALUE=LabelList[idx];
+								signed char NEWVALUE=HistoryLabels[idx];
+								if (LOCVAL == VALUE){
+									idx = NLABELS;
+									if (NWPDist(i,j,k) < 2.0){
+										id[n] = NEWVALUE;
+									}
 								}
 							}
 						}
 					}
 				}
 			}
-		}
 
-		if (rank==0) printf("Writing ID file \n");
-		sprintf(LocalRankFilename,"ID.%05i",rank);
+			if (rank==0) printf("Writing ID file \n");
+			if (SwList.size() == 1) sprintf(LocalRankFilename,"ID.%05i",rank);
+			else sprintf(LocalRankFilename,"ID.sw%.3f.%05i",SwList[config],rank);
 
-		FILE *ID = fopen(LocalRankFilename,"wb");
-		fwrite(id,1,N,ID);
-		fclose(ID);
+			FILE *ID = fopen(LocalRankFilename,"wb");
+			fwrite(id,1,N,ID);
+			fclose(ID);
 		
-		// write the geometry to a single file
-		for (int k=0;k<nz;k++){
-			for (int j=0;j<ny;j++){ 
-				for (int i=0;i<nx;i++){
-					int n = k*nx*ny+j*nx+i;
-					Mask->id[n] = id[n];
+			// write the geometry to a single file
+			for (int k=0;k<nz;k++){
+				for (int j=0;j<ny;j++){ 
+					for (int i=0;i<nx;i++){
+						int n = k*nx*ny+j*nx+i;
+						Mask->id[n] = id[n];
+					}
 				}
 			}
-		}
-		MPI_Barrier(comm);
+			MPI_Barrier(comm);
 
-        auto filename2 = READFILE + ".morphdrain.raw";
-		if (rank==0) printf("Writing file to: %s \n", filename2.data() );
-		Mask->AggregateLabels( filename2 );
+			auto filename2 = READFILE + ".morphdrain.raw";
+			if (SwList.size() > 1){
+				char suffix[40];
+				sprintf(suffix,".morphdrain.sw%.3f.raw",SwList[config]);
+				filename2 = READFILE + suffix;
+			}
+			if (rank==0) printf("Writing file to: %s \n", filename2.data() );
+			Mask->AggregateLabels( filename2 );
+		}
 	}
 
 	MPI_Barrier(comm);
@@ -252,6 +252,100 @@ int testHalo( MPI_Comm comm, int nprocx, int nprocy, int nprocz, int depth )
 }
 
 
+int testMeshHalo( MPI_Comm comm, int nprocx, int nprocy, int nprocz, int N_fields )
+{
+    int rank,nprocs;
+    MPI_Comm_rank(comm,&rank);
+    MPI_Comm_size(comm,&nprocs);
+    if ( rank==0 )
+        printf("\nRunning Mesh halo test %i %i %i %i\n",nprocx,nprocy,nprocz,N_fields);
+
+    const RankInfoStruct rank_info(rank,nprocx,nprocy,nprocz);
+
+    int nx = 10;
+    int ny = 11;
+    int nz = 7;
+    int Nx = nx*nprocx;
+    int Ny = ny*nprocy;
+    int Nz = nz*nprocz;
+    auto value = [&]( int i, int j, int k, int f ) {
+        int iglobal = (i-1 + rank_info.ix*nx + Nx)%Nx;
+        int jglobal = (j-1 + rank_info.jy*ny + Ny)%Ny;
+        int kglobal = (k-1 + rank_info.kz*nz + Nz)%Nz;
+        return double( iglobal + jglobal*Nx + kglobal*Nx*Ny + f*Nx*Ny*Nz );
+    };
+    std::vector<DoubleArray> fields(N_fields,DoubleArray(nx+2,ny+2,nz+2));
+    for (int f=0; f<N_fields; f++) {
+        fields[f].fill(-1);
+        for (int k=1; k<=nz; k++) {
+            for (int j=1; j<=ny; j++) {
+                for (int i=1; i<=nx; i++)
+                    fields[f](i,j,k) = value(i,j,k,f);
+            }
+        }
+    }
+
+    // Send/recv lists of the face and edge neighbors
+    MeshHaloExchange halo(comm,rank_info,0);
+    for (int di=-1; di<=1; di++) {
+        for (int dj=-1; dj<=1; dj++) {
+            for (int dk=-1; dk<=1; dk++) {
+                int nd = abs(di) + abs(dj) + abs(dk);
+                if ( nd==0 || nd==3 )
+                    continue;
+                std::vector<int> sendList, recvList;
+                for (int k=0; k<nz+2; k++) {
+                    for (int j=0; j<ny+2; j++) {
+                        for (int i=0; i<nx+2; i++) {
+                            int n = i + j*(nx+2) + k*(nx+2)*(ny+2);
+                            bool send = ( di==0 ? (i>0 && i<=nx) : i==(di<0?1:nx) ) &&
+                                        ( dj==0 ? (j>0 && j<=ny) : j==(dj<0?1:ny) ) &&
+                                        ( dk==0 ? (k>0 && k<=nz) : k==(dk<0?1:nz) );
+                            bool recv = ( di==0 ? (i>0 && i<=nx) : i==(di<0?0:nx+1) ) &&
+                                        ( dj==0 ? (j>0 && j<=ny) : j==(dj<0?0:ny+1) ) &&
+                                        ( dk==0 ? (k>0 && k<=nz) : k==(dk<0?0:nz+1) );
+                            if ( send )
+                                sendList.push_back(n);
+                            if ( recv )
+                                recvList.push_back(n);
+                        }
+                    }
+                }
+                halo.setLists(di,dj,dk,sendList.size(),sendList.data(),recvList.size(),recvList.data());
+            }
+        }
+    }
+
+    // Communicate the halos of all fields at once
+    std::vector<DoubleArray*> ptr(N_fields);
+    for (int f=0; f<N_fields; f++)
+        ptr[f] = &fields[f];
+    halo.start(ptr);
+    halo.wait();
+
+    // Check the results (the corners are not filled)
+    bool pass = true;
+    for (int f=0; f<N_fields; f++) {
+        for (int k=0; k<nz+2; k++) {
+            for (int j=0; j<ny+2; j++) {
+                for (int i=0; i<nx+2; i++) {
+                    bool corner = (i==0||i==nx+1) && (j==0||j==ny+1) && (k==0||k==nz+1);
+                    double ans = corner ? -1 : value(i,j,k,f);
+                    if ( fields[f](i,j,k) != ans )
+                        pass = false;
+                }
+            }
+        }
+    }
+    int N_errors = 0;
+    if ( !pass ) {
+        std::cout << "Failed mesh halo test\n";
+        N_errors++;
+    }
+    return N_errors;
+}
+
+
 int main(int argc, char **argv)
 {
     // Initialize MPI
@@ -288,6 +382,13 @@ int main(int argc, char **argv)
         N_errors += testHalo<int>( comm, 2, 2, 2, 1 );
     }
 
+    // Run the multi-field mesh halo tests
+    N_errors += testMeshHalo( comm, nprocs, 1, 1, 1 );
+    N_errors += testMeshHalo( comm, 1, nprocs, 1, 3 );
+    N_errors += testMeshHalo( comm, 1, 1, nprocs, 3 );
+    if ( nprocs==4 )
+        N_errors += testMeshHalo( comm, 2, 1, 2, 3 );
+
     // Finished
     MPI_Barrier(comm);
     int N_errors_global=0;